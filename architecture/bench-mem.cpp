@@ -0,0 +1,224 @@
+/************************************************************************
+ IMPORTANT NOTE : this file contains two clearly delimited sections :
+ the ARCHITECTURE section (in two parts) and the USER section. Each section
+ is governed by its own copyright and license. Please check individually
+ each section for license and copyright information.
+ *************************************************************************/
+
+/******************* BEGIN bench-mem.cpp ****************/
+/************************************************************************
+ FAUST Architecture File
+ Copyright (C) 2003-2022 GRAME, Centre National de Creation Musicale
+ ---------------------------------------------------------------------
+ This Architecture section is free software; you can redistribute it
+ and/or modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 3 of
+ the License, or (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program; If not, see <http://www.gnu.org/licenses/>.
+ 
+ EXCEPTION : As a special exception, you may create a larger work
+ that contains this FAUST architecture section and distribute
+ that work under terms of your choice, so long as this FAUST
+ architecture section is not modified.
+ 
+ ************************************************************************
+ ************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "faust/gui/UI.h"
+#include "faust/gui/meta.h"
+#include "faust/dsp/dsp-memory-manager.h"
+
+// Compare the arena_memory_manager with a heap allocation of the voices of a polyphonic instrument:
+// faust -mem -a bench-mem.cpp foo.dsp -o foo.cpp && c++ -std=c++11 -O3 foo.cpp -o foo && ./foo [voices]
+
+/******************************************************************************
+ *******************************************************************************
+ 
+ VECTOR INTRINSICS
+ 
+ *******************************************************************************
+ *******************************************************************************/
+
+<<includeIntrinsic>>
+
+/********************END ARCHITECTURE SECTION (part 1/2)****************/
+
+/**************************BEGIN USER SECTION **************************/
+
+<<includeclass>>
+
+/***************************END USER SECTION ***************************/
+
+/*******************BEGIN ARCHITECTURE SECTION (part 2/2)***************/
+
+using namespace std;
+
+#define SAMPLE_RATE 48000
+#define BUFFER_SIZE 64
+#define ROUNDS 5000
+
+// Heap allocation, with the voices scattered in a heap used by other allocations (like in a running host)
+
+struct heap_memory_manager : public dsp_memory_manager {
+    
+    vector<void*> fNoise;
+    mt19937 fRandom;
+    
+    heap_memory_manager():fRandom(0) {}
+    
+    virtual ~heap_memory_manager()
+    {
+        for (const auto& it : fNoise) free(it);
+    }
+    
+    virtual void* allocate(size_t size)
+    {
+        for (int i = 0; i < 8; i++) {
+            fNoise.push_back(malloc(32 + fRandom() % 8192));
+        }
+        return malloc(size);
+    }
+    
+    virtual void destroy(void* ptr) { free(ptr); }
+    
+};
+
+// Hardware cache misses counter of the calling thread, when available
+
+struct cache_misses {
+    
+    int fFD = -1;
+    
+    cache_misses()
+    {
+    #ifdef __linux__
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fFD = int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    #endif
+    }
+    
+    virtual ~cache_misses()
+    {
+    #ifdef __linux__
+        if (fFD >= 0) close(fFD);
+    #endif
+    }
+    
+    void start()
+    {
+    #ifdef __linux__
+        if (fFD >= 0) {
+            ioctl(fFD, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fFD, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    #endif
+    }
+    
+    long long stop()
+    {
+        long long count = -1;
+    #ifdef __linux__
+        if (fFD >= 0) {
+            ioctl(fFD, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fFD, &count, sizeof(count)) != sizeof(count)) count = -1;
+        }
+    #endif
+        return count;
+    }
+    
+};
+
+// Allocate and render the voices like a polyphonic instrument, all voices being mixed in each buffer
+static void bench(dsp_memory_manager* manager, const string& name, int voices)
+{
+    mydsp::fManager = manager;
+    mydsp::memoryInfo();
+    mydsp::classInit(SAMPLE_RATE);
+    
+    vector<mydsp*> dsps;
+    for (int v = 0; v < voices; v++) {
+        mydsp* dsp = mydsp::create();
+        dsp->instanceInit(SAMPLE_RATE);
+        dsps.push_back(dsp);
+    }
+    
+    int ins = dsps[0]->getNumInputs();
+    int outs = dsps[0]->getNumOutputs();
+    vector<vector<FAUSTFLOAT>> in_buffers(ins, vector<FAUSTFLOAT>(BUFFER_SIZE, FAUSTFLOAT(0.1)));
+    vector<vector<FAUSTFLOAT>> out_buffers(outs, vector<FAUSTFLOAT>(BUFFER_SIZE));
+    vector<FAUSTFLOAT*> inputs, outputs;
+    for (auto& it : in_buffers) inputs.push_back(it.data());
+    for (auto& it : out_buffers) outputs.push_back(it.data());
+    
+    // Warm up
+    for (int r = 0; r < ROUNDS / 10; r++) {
+        for (const auto& it : dsps) it->compute(BUFFER_SIZE, inputs.data(), outputs.data());
+    }
+    
+    cache_misses misses;
+    misses.start();
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (const auto& it : dsps) it->compute(BUFFER_SIZE, inputs.data(), outputs.data());
+    }
+    double usec = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+    long long count = misses.stop();
+    
+    cout << name << " : " << usec / ROUNDS << " usec per buffer, cache misses per buffer : ";
+    if (count >= 0) {
+        cout << double(count) / ROUNDS << endl;
+    } else {
+        cout << "n/a" << endl;
+    }
+    
+    for (const auto& it : dsps) mydsp::destroy(it);
+    mydsp::classDestroy();
+}
+
+int main(int argc, char* argv[])
+{
+    int voices = (argc > 1) ? atoi(argv[1]) : 32;
+    cout << "Voices : " << voices << " buffer size : " << BUFFER_SIZE << endl;
+    
+    heap_memory_manager heap;
+    bench(&heap, "heap", voices);
+    
+    arena_memory_manager arena(voices);
+    bench(&arena, "arena", voices);
+    cout << "arena size : " << arena.getArenaSize() << " bytes, heap fallbacks : " << arena.getFallbacks() << endl;
+    
+    arena_memory_manager huge_arena(voices, true);
+    bench(&huge_arena, "arena (huge pages)", voices);
+    
+    return 0;
+}
+
+/******************** END bench-mem.cpp ****************/
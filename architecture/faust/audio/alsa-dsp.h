@@ -26,11 +26,18 @@
 #define __alsa_dsp__
 
 #include <stdio.h>
+#include <stdint.h>
 #include <pthread.h>
+#include <poll.h>
 #include <sys/types.h>
 #include <pwd.h>
 #include <limits.h>
 #include <algorithm>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include <alsa/asoundlib.h>
 #include "faust/audio/audio.h"
@@ -45,6 +52,11 @@ Some default parameters of Faust's ALSA applications are controlled by the follo
     FAUST2ALSA_FREQUENCY= 44100
     FAUST2ALSA_BUFFER   = 512
     FAUST2ALSA_PERIODS  = 2
+    FAUST2ALSA_MMAP     = 0
+
+With FAUST2ALSA_MMAP = 1 (or '--mmap 1'), the samples are converted directly from/to the memory mapped
+buffers of the devices, and both devices are polled from the audio thread (to be used with small buffers,
+like 16 or 32 frames).
 */
 
 // handle 32/64 bits int size issues
@@ -95,6 +107,180 @@ static bool setRealtimePriority()
     return (err != -1);
 }
 
+/******************************************************************************
+*******************************************************************************
+
+                            SAMPLE CONVERSION KERNELS
+
+*******************************************************************************
+*******************************************************************************/
+
+/**
+ * Scaling of the 16-bits and 32-bits card samples.
+ */
+template <typename T> struct alsa_sample {};
+
+template <> struct alsa_sample<int16_t> {
+    static float inScale() { return 1.0f/float(SHRT_MAX); }
+    static float outScale() { return float(SHRT_MAX); }
+};
+
+template <> struct alsa_sample<int32_t> {
+    static float inScale() { return 1.0f/float(INT_MAX); }
+    static float outScale() { return 2147483520.0f; }   // the largest float below INT_MAX
+};
+
+/**
+ * Convert 'frames' card samples, 'stride' samples apart, to floats
+ * (with stride 1, the loop is vectorized by the compiler).
+ */
+template <typename T>
+static inline void alsaToFloat(const T* src, unsigned int stride, float* dst, unsigned int frames)
+{
+    const float scale = alsa_sample<T>::inScale();
+    for (unsigned int i = 0; i < frames; i++) {
+        dst[i] = float(src[i*stride]) * scale;
+    }
+}
+
+/**
+ * Convert 'frames' floats to card samples, 'stride' samples apart.
+ */
+template <typename T>
+static inline void alsaFromFloat(const float* src, T* dst, unsigned int stride, unsigned int frames)
+{
+    const float scale = alsa_sample<T>::outScale();
+    for (unsigned int i = 0; i < frames; i++) {
+        float x = std::max(std::min(src[i], 1.0f), -1.0f);
+        dst[i*stride] = T(x * scale);
+    }
+}
+
+/**
+ * Deinterleave and convert the samples of a stereo interleaved buffer, starting at frame 'i'.
+ */
+template <typename T>
+static inline void alsaDeinterleave2Scalar(const T* src, float* dst0, float* dst1, unsigned int frames, unsigned int i)
+{
+    const float scale = alsa_sample<T>::inScale();
+    for (; i < frames; i++) {
+        dst0[i] = float(src[2*i]) * scale;
+        dst1[i] = float(src[2*i+1]) * scale;
+    }
+}
+
+/**
+ * Convert and interleave the samples of a stereo interleaved buffer, starting at frame 'i'.
+ */
+template <typename T>
+static inline void alsaInterleave2Scalar(const float* src0, const float* src1, T* dst, unsigned int frames, unsigned int i)
+{
+    const float scale = alsa_sample<T>::outScale();
+    for (; i < frames; i++) {
+        dst[2*i] = T(std::max(std::min(src0[i], 1.0f), -1.0f) * scale);
+        dst[2*i+1] = T(std::max(std::min(src1[i], 1.0f), -1.0f) * scale);
+    }
+}
+
+template <typename T>
+static inline void alsaDeinterleave2(const T* src, float* dst0, float* dst1, unsigned int frames)
+{
+    alsaDeinterleave2Scalar(src, dst0, dst1, frames, 0);
+}
+
+template <typename T>
+static inline void alsaInterleave2(const float* src0, const float* src1, T* dst, unsigned int frames)
+{
+    alsaInterleave2Scalar(src0, src1, dst, frames, 0);
+}
+
+#ifdef __SSE2__
+
+// 4 frames at once, giving the same results as the scalar versions
+
+static inline void alsaShuffle2(__m128 a, __m128 b, float* dst0, float* dst1)
+{
+    _mm_storeu_ps(dst0, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(dst1, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+}
+
+static inline void alsaDeinterleave2(const int32_t* src, float* dst0, float* dst1, unsigned int frames)
+{
+    unsigned int i = 0;
+    const __m128 scale = _mm_set1_ps(alsa_sample<int32_t>::inScale());
+    for (; i + 4 <= frames; i += 4) {
+        __m128 a = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(src + 2*i))), scale);
+        __m128 b = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(src + 2*i + 4))), scale);
+        alsaShuffle2(a, b, dst0 + i, dst1 + i);
+    }
+    alsaDeinterleave2Scalar(src, dst0, dst1, frames, i);
+}
+
+static inline void alsaDeinterleave2(const int16_t* src, float* dst0, float* dst1, unsigned int frames)
+{
+    unsigned int i = 0;
+    const __m128 scale = _mm_set1_ps(alsa_sample<int16_t>::inScale());
+    for (; i + 4 <= frames; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + 2*i));
+        // Sign extension of the 16-bits samples
+        __m128 a = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16)), scale);
+        __m128 b = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16)), scale);
+        alsaShuffle2(a, b, dst0 + i, dst1 + i);
+    }
+    alsaDeinterleave2Scalar(src, dst0, dst1, frames, i);
+}
+
+static inline __m128 alsaClip(const float* src, __m128 scale)
+{
+    return _mm_mul_ps(_mm_max_ps(_mm_min_ps(_mm_loadu_ps(src), _mm_set1_ps(1.0f)), _mm_set1_ps(-1.0f)), scale);
+}
+
+static inline void alsaInterleave2(const float* src0, const float* src1, int32_t* dst, unsigned int frames)
+{
+    unsigned int i = 0;
+    const __m128 scale = _mm_set1_ps(alsa_sample<int32_t>::outScale());
+    for (; i + 4 <= frames; i += 4) {
+        __m128 l = alsaClip(src0 + i, scale);
+        __m128 r = alsaClip(src1 + i, scale);
+        _mm_storeu_si128((__m128i*)(dst + 2*i), _mm_cvttps_epi32(_mm_unpacklo_ps(l, r)));
+        _mm_storeu_si128((__m128i*)(dst + 2*i + 4), _mm_cvttps_epi32(_mm_unpackhi_ps(l, r)));
+    }
+    alsaInterleave2Scalar(src0, src1, dst, frames, i);
+}
+
+static inline void alsaInterleave2(const float* src0, const float* src1, int16_t* dst, unsigned int frames)
+{
+    unsigned int i = 0;
+    const __m128 scale = _mm_set1_ps(alsa_sample<int16_t>::outScale());
+    for (; i + 4 <= frames; i += 4) {
+        __m128 l = alsaClip(src0 + i, scale);
+        __m128 r = alsaClip(src1 + i, scale);
+        __m128i lo = _mm_cvttps_epi32(_mm_unpacklo_ps(l, r));
+        __m128i hi = _mm_cvttps_epi32(_mm_unpackhi_ps(l, r));
+        _mm_storeu_si128((__m128i*)(dst + 2*i), _mm_packs_epi32(lo, hi));
+    }
+    alsaInterleave2Scalar(src0, src1, dst, frames, i);
+}
+
+#endif
+
+/**
+ * Address of the sample at 'offset' in a channel area.
+ */
+template <typename T>
+static inline T* alsaAreaSamples(const snd_pcm_channel_area_t& area, snd_pcm_uframes_t offset)
+{
+    return (T*)((char*)area.addr + (area.first + offset * area.step) / 8);
+}
+
+/**
+ * Whether two channel areas are the left and right channels of a stereo interleaved buffer.
+ */
+static inline bool alsaInterleavedPair(const snd_pcm_channel_area_t& a, const snd_pcm_channel_area_t& b, unsigned int width)
+{
+    return a.addr == b.addr && a.step == 2 * width && b.step == a.step && b.first == a.first + width;
+}
+
 /******************************************************************************
 *******************************************************************************
 
@@ -118,13 +304,16 @@ struct AudioParam
     unsigned int    fSoftInputs;
     unsigned int    fSoftOutputs;
 
+    bool            fMMap;
+
      AudioParam() :
         fCardName("hw:0"),
         fFrequency(44100),
         fBuffering(512),
         fPeriods(2),
         fSoftInputs(2),
-        fSoftOutputs(2)
+        fSoftOutputs(2),
+        fMMap(false)
     {}
 
     AudioParam& cardName(const char* n) { fCardName = n; return *this; }
@@ -133,6 +322,7 @@ struct AudioParam
     AudioParam& periods(int p)          { fPeriods = p; return *this; }
     AudioParam& inputs(int n)           { fSoftInputs = n; return *this; }
     AudioParam& outputs(int n)          { fSoftOutputs = n; return *this; }
+    AudioParam& mmap(bool m)            { fMMap = m; return *this; }
 };
 
 /**
@@ -170,6 +360,15 @@ struct AudioInterface : public AudioParam
     float* fInputSoftChannels[256];
     float* fOutputSoftChannels[256];
 
+    // layout of the audiocard buffers in read/write modes
+    snd_pcm_channel_area_t fInputAreas[256];
+    snd_pcm_channel_area_t fOutputAreas[256];
+
+    // mmap mode : poll descriptors of both devices, and whether they are started together
+    std::vector<struct pollfd> fPollDescriptors;
+    int fOutputPollDescriptors;
+    bool fLinked;
+
     const char* cardName() { return fCardName; }
     int frequency() { return fFrequency; }
     int buffering() { return fBuffering; }
@@ -179,6 +378,7 @@ struct AudioInterface : public AudioParam
     float** outputSoftChannels() { return fOutputSoftChannels; }
 
     bool duplexMode() { return fDuplexMode; }
+    bool mmapMode() { return fSampleAccess == SND_PCM_ACCESS_MMAP_INTERLEAVED || fSampleAccess == SND_PCM_ACCESS_MMAP_NONINTERLEAVED; }
 
     AudioInterface(const AudioParam& ap = AudioParam()) : AudioParam(ap)
     {
@@ -186,6 +386,8 @@ struct AudioInterface : public AudioParam
         fOutputDevice = 0;
         fInputParams  = 0;
         fOutputParams = 0;
+        fOutputPollDescriptors = 0;
+        fLinked = false;
     }
 
     /**
@@ -206,13 +408,17 @@ struct AudioInterface : public AudioParam
         snd_pcm_hw_params_set_channels_near(fOutputDevice, fOutputParams, &fCardOutputs);
         err = snd_pcm_hw_params(fOutputDevice, fOutputParams); check_error(err);
 
-        // allocate alsa output buffers
+        // allocate alsa output buffers (the device buffers are directly accessed in mmap mode)
         if (fSampleAccess == SND_PCM_ACCESS_RW_INTERLEAVED) {
             fOutputCardBuffer = calloc(interleavedBufferSize(fOutputParams), 1);
-        } else {
+            setInterleavedAreas(fOutputAreas, fOutputCardBuffer, fCardOutputs);
+        } else if (fSampleAccess == SND_PCM_ACCESS_RW_NONINTERLEAVED) {
             for (unsigned int i = 0; i < fCardOutputs; i++) {
                 fOutputCardChannels[i] = calloc(noninterleavedBufferSize(fOutputParams), 1);
             }
+            setNonInterleavedAreas(fOutputAreas, fOutputCardChannels, fCardOutputs);
+        } else {
+            setSoftParams(fOutputDevice);
         }
 
         // check for duplex mode (if we need and have an input device)
@@ -244,10 +450,26 @@ struct AudioInterface : public AudioParam
             // allocation of alsa buffers
             if (fSampleAccess == SND_PCM_ACCESS_RW_INTERLEAVED) {
                 fInputCardBuffer = calloc(interleavedBufferSize(fInputParams), 1);
-            } else {
+                setInterleavedAreas(fInputAreas, fInputCardBuffer, fCardInputs);
+            } else if (fSampleAccess == SND_PCM_ACCESS_RW_NONINTERLEAVED) {
                 for (unsigned int i = 0; i < fCardInputs; i++) {
                     fInputCardChannels[i] = calloc(noninterleavedBufferSize(fInputParams), 1);
                 }
+                setNonInterleavedAreas(fInputAreas, fInputCardChannels, fCardInputs);
+            } else {
+                setSoftParams(fInputDevice);
+            }
+        }
+
+        if (mmapMode()) {
+            // both devices are polled by the audio thread, and started together when they can be linked
+            fOutputPollDescriptors = snd_pcm_poll_descriptors_count(fOutputDevice);
+            int input_descriptors = (fDuplexMode) ? snd_pcm_poll_descriptors_count(fInputDevice) : 0;
+            fPollDescriptors.resize(fOutputPollDescriptors + input_descriptors);
+            snd_pcm_poll_descriptors(fOutputDevice, &fPollDescriptors[0], fOutputPollDescriptors);
+            if (fDuplexMode) {
+                snd_pcm_poll_descriptors(fInputDevice, &fPollDescriptors[fOutputPollDescriptors], input_descriptors);
+                fLinked = (snd_pcm_link(fInputDevice, fOutputDevice) == 0);
             }
         }
 
@@ -281,12 +503,27 @@ struct AudioInterface : public AudioParam
         err = snd_pcm_hw_params_any(stream, params);
         check_error_msg(err, "unable to init parameters")
 
-        // set alsa access mode (and fSampleAccess field) either to non interleaved or interleaved
+        // set alsa access mode (and fSampleAccess field) either to non interleaved or interleaved,
+        // using the mmap access if requested (both devices must then use it)
 
-        err = snd_pcm_hw_params_set_access(stream, params, SND_PCM_ACCESS_RW_NONINTERLEAVED);
-        if (err) {
-            err = snd_pcm_hw_params_set_access(stream, params, SND_PCM_ACCESS_RW_INTERLEAVED);
-            check_error_msg(err, "unable to set access mode neither to non-interleaved or to interleaved");
+        if (fMMap) {
+            err = snd_pcm_hw_params_set_access(stream, params, SND_PCM_ACCESS_MMAP_NONINTERLEAVED);
+            if (err) {
+                err = snd_pcm_hw_params_set_access(stream, params, SND_PCM_ACCESS_MMAP_INTERLEAVED);
+            }
+            if (err && stream == fOutputDevice) {
+                printf("Warning : mmap access mode not available, using read/write access mode\n");
+                fMMap = false;
+            } else {
+                check_error_msg(err, "unable to set input device in mmap access mode (use '--mmap 0')");
+            }
+        }
+        if (!fMMap) {
+            err = snd_pcm_hw_params_set_access(stream, params, SND_PCM_ACCESS_RW_NONINTERLEAVED);
+            if (err) {
+                err = snd_pcm_hw_params_set_access(stream, params, SND_PCM_ACCESS_RW_INTERLEAVED);
+                check_error_msg(err, "unable to set access mode neither to non-interleaved or to interleaved");
+            }
         }
         snd_pcm_hw_params_get_access(params, &fSampleAccess);
 
@@ -308,6 +545,44 @@ struct AudioInterface : public AudioParam
         check_error_msg(err, "number of periods not available");
     }
 
+    /**
+     * Stream started by 'start' (and not by the first write), waking up the poll
+     * as soon as a buffer can be read or written.
+     */
+    void setSoftParams(snd_pcm_t* stream)
+    {
+        int err;
+        snd_pcm_sw_params_t* params;
+        snd_pcm_sw_params_alloca(&params);
+
+        err = snd_pcm_sw_params_current(stream, params); check_error(err);
+        snd_pcm_uframes_t boundary;
+        err = snd_pcm_sw_params_get_boundary(params, &boundary); check_error(err);
+        err = snd_pcm_sw_params_set_start_threshold(stream, params, boundary); check_error(err);
+        err = snd_pcm_sw_params_set_avail_min(stream, params, fBuffering); check_error(err);
+        err = snd_pcm_sw_params(stream, params); check_error(err);
+    }
+
+    unsigned int sampleWidth() { return snd_pcm_format_physical_width(fSampleFormat); }
+
+    void setInterleavedAreas(snd_pcm_channel_area_t* areas, void* buffer, unsigned int channels)
+    {
+        for (unsigned int c = 0; c < channels; c++) {
+            areas[c].addr = buffer;
+            areas[c].first = c * sampleWidth();
+            areas[c].step = channels * sampleWidth();
+        }
+    }
+
+    void setNonInterleavedAreas(snd_pcm_channel_area_t* areas, void** buffers, unsigned int channels)
+    {
+        for (unsigned int c = 0; c < channels; c++) {
+            areas[c].addr = buffers[c];
+            areas[c].first = 0;
+            areas[c].step = sampleWidth();
+        }
+    }
+
     ssize_t interleavedBufferSize(snd_pcm_hw_params_t* params)
     {
         _snd_pcm_format format; snd_pcm_hw_params_get_format(params, &format);
@@ -328,13 +603,83 @@ struct AudioInterface : public AudioParam
     void close()
     {}
 
+    /**
+     * Convert the card input samples described by 'areas' to the input soft channels
+     */
+    template <typename T>
+    void readAreas(const snd_pcm_channel_area_t* areas, snd_pcm_uframes_t offset, unsigned int pos, unsigned int frames)
+    {
+        const unsigned int width = sizeof(T) * 8;
+        for (unsigned int c = 0; c < fCardInputs;) {
+            const T* src = alsaAreaSamples<T>(areas[c], offset);
+            if (c + 1 < fCardInputs && alsaInterleavedPair(areas[c], areas[c+1], width)) {
+                alsaDeinterleave2(src, fInputSoftChannels[c] + pos, fInputSoftChannels[c+1] + pos, frames);
+                c += 2;
+            } else {
+                alsaToFloat(src, areas[c].step / width, fInputSoftChannels[c] + pos, frames);
+                c += 1;
+            }
+        }
+    }
+
+    void readAreas(const snd_pcm_channel_area_t* areas, snd_pcm_uframes_t offset, unsigned int pos, unsigned int frames)
+    {
+        if (fSampleFormat == SND_PCM_FORMAT_S16) {
+            readAreas<int16_t>(areas, offset, pos, frames);
+        } else if (fSampleFormat == SND_PCM_FORMAT_S32) {
+            readAreas<int32_t>(areas, offset, pos, frames);
+        } else {
+            printf("unrecognized input sample format : %u\n", fSampleFormat);
+            exit(1);
+        }
+    }
+
+    /**
+     * Convert the output soft channels to the card output samples described by 'areas'
+     */
+    template <typename T>
+    void writeAreas(const snd_pcm_channel_area_t* areas, snd_pcm_uframes_t offset, unsigned int pos, unsigned int frames)
+    {
+        const unsigned int width = sizeof(T) * 8;
+        for (unsigned int c = 0; c < fCardOutputs;) {
+            T* dst = alsaAreaSamples<T>(areas[c], offset);
+            if (c + 1 < fCardOutputs && alsaInterleavedPair(areas[c], areas[c+1], width)) {
+                alsaInterleave2(fOutputSoftChannels[c] + pos, fOutputSoftChannels[c+1] + pos, dst, frames);
+                c += 2;
+            } else {
+                alsaFromFloat(fOutputSoftChannels[c] + pos, dst, areas[c].step / width, frames);
+                c += 1;
+            }
+        }
+    }
+
+    void writeAreas(const snd_pcm_channel_area_t* areas, snd_pcm_uframes_t offset, unsigned int pos, unsigned int frames)
+    {
+        if (fSampleFormat == SND_PCM_FORMAT_S16) {
+            writeAreas<int16_t>(areas, offset, pos, frames);
+        } else if (fSampleFormat == SND_PCM_FORMAT_S32) {
+            writeAreas<int32_t>(areas, offset, pos, frames);
+        } else {
+            printf("unrecognized output sample format : %u\n", fSampleFormat);
+            exit(1);
+        }
+    }
+
     /**
      * Read audio samples from the audio card. Convert samples to floats and take
      * care of interleaved buffers
      */
     void read()
     {
-        if (fSampleAccess == SND_PCM_ACCESS_RW_INTERLEAVED) {
+        if (mmapMode()) {
+
+            // the buffer is dropped if the device is not ready
+            int err = readMMap();
+            if (err < 0 && err != -EAGAIN) {
+                recover();
+            }
+
+        } else if (fSampleAccess == SND_PCM_ACCESS_RW_INTERLEAVED) {
 
             int count = snd_pcm_readi(fInputDevice, fInputCardBuffer, fBuffering);
             if (count < 0) {
@@ -342,25 +687,7 @@ struct AudioInterface : public AudioParam
                  snd_pcm_prepare(fInputDevice);
                  //check_error_msg(err, "preparing input stream");
             }
-
-            if (fSampleFormat == SND_PCM_FORMAT_S16) {
-                short* buffer16b = (short*)fInputCardBuffer;
-                for (unsigned int s = 0; s < fBuffering; s++) {
-                    for (unsigned int c = 0; c < fCardInputs; c++) {
-                        fInputSoftChannels[c][s] = float(buffer16b[c + s*fCardInputs])*(1.0/float(SHRT_MAX));
-                    }
-                }
-            } else if (fSampleFormat == SND_PCM_FORMAT_S32) {
-                int32* buffer32b = (int32*)fInputCardBuffer;
-                for (unsigned int s = 0; s < fBuffering; s++) {
-                    for (unsigned int c = 0; c < fCardInputs; c++) {
-                        fInputSoftChannels[c][s] = float(buffer32b[c + s*fCardInputs])*(1.0/float(INT_MAX));
-                    }
-                }
-            } else {
-                printf("unrecognized input sample format : %u\n", fSampleFormat);
-                exit(1);
-            }
+            readAreas(fInputAreas, 0, 0, fBuffering);
 
         } else if (fSampleAccess == SND_PCM_ACCESS_RW_NONINTERLEAVED) {
 
@@ -370,25 +697,7 @@ struct AudioInterface : public AudioParam
                  snd_pcm_prepare(fInputDevice);
                  //check_error_msg(err, "preparing input stream");
             }
-
-            if (fSampleFormat == SND_PCM_FORMAT_S16) {
-                for (unsigned int c = 0; c < fCardInputs; c++) {
-                    short* chan16b = (short*)fInputCardChannels[c];
-                    for (unsigned int s = 0; s < fBuffering; s++) {
-                        fInputSoftChannels[c][s] = float(chan16b[s])*(1.0/float(SHRT_MAX));
-                    }
-                }
-            } else if (fSampleFormat == SND_PCM_FORMAT_S32) {
-                for (unsigned int c = 0; c < fCardInputs; c++) {
-                    int32* chan32b = (int32*)fInputCardChannels[c];
-                    for (unsigned int s = 0; s < fBuffering; s++) {
-                        fInputSoftChannels[c][s] = float(chan32b[s])*(1.0/float(INT_MAX));
-                    }
-                }
-            } else {
-                printf("unrecognized input sample format : %u\n", fSampleFormat);
-                exit(1);
-            }
+            readAreas(fInputAreas, 0, 0, fBuffering);
 
         } else {
             check_error_msg(-10000, "unknown access mode");
@@ -403,30 +712,17 @@ struct AudioInterface : public AudioParam
     {
         recovery :
 
-        if (fSampleAccess == SND_PCM_ACCESS_RW_INTERLEAVED) {
-
-            if (fSampleFormat == SND_PCM_FORMAT_S16) {
-                short* buffer16b = (short*)fOutputCardBuffer;
-                for (unsigned int f = 0; f < fBuffering; f++) {
-                    for (unsigned int c = 0; c < fCardOutputs; c++) {
-                        float x = fOutputSoftChannels[c][f];
-                        buffer16b[c + f*fCardOutputs] = short(std::max(std::min(x,1.0f),-1.0f) * float(SHRT_MAX)) ;
-                    }
-                }
+        if (mmapMode()) {
 
-            } else if (fSampleFormat == SND_PCM_FORMAT_S32)  {
-                int32* buffer32b = (int32*)fOutputCardBuffer;
-                for (unsigned int f = 0; f < fBuffering; f++) {
-                    for (unsigned int c = 0; c < fCardOutputs; c++) {
-                        float x = fOutputSoftChannels[c][f];
-                        buffer32b[c + f*fCardOutputs] = int(std::max(std::min(x,1.0f),-1.0f) * float(INT_MAX));
-                    }
-                }
-            } else {
-                printf("unrecognized output sample format : %u\n", fSampleFormat);
-                exit(1);
+            // the buffer is dropped if the device is not ready
+            int err = writeMMap();
+            if (err < 0 && err != -EAGAIN) {
+                recover();
             }
 
+        } else if (fSampleAccess == SND_PCM_ACCESS_RW_INTERLEAVED) {
+
+            writeAreas(fOutputAreas, 0, 0, fBuffering);
             int count = snd_pcm_writei(fOutputDevice, fOutputCardBuffer, fBuffering);
             if (count<0) {
                 //display_error_msg(count, "w3");
@@ -437,31 +733,7 @@ struct AudioInterface : public AudioParam
 
         } else if (fSampleAccess == SND_PCM_ACCESS_RW_NONINTERLEAVED) {
 
-            if (fSampleFormat == SND_PCM_FORMAT_S16) {
-
-                for (unsigned int c = 0; c < fCardOutputs; c++) {
-                    short* chan16b = (short*)fOutputCardChannels[c];
-                    for (unsigned int f = 0; f < fBuffering; f++) {
-                        float x = fOutputSoftChannels[c][f];
-                        chan16b[f] = short(std::max(std::min(x,1.0f),-1.0f) * float(SHRT_MAX));
-                    }
-                }
-
-            } else if (fSampleFormat == SND_PCM_FORMAT_S32) {
-
-                for (unsigned int c = 0; c < fCardOutputs; c++) {
-                    int32* chan32b = (int32*)fOutputCardChannels[c];
-                    for (unsigned int f = 0; f < fBuffering; f++) {
-                        float x = fOutputSoftChannels[c][f];
-                        chan32b[f] = int(std::max(std::min(x,1.0f),-1.0f) * float(INT_MAX));
-                    }
-                }
-
-            } else {
-                printf("unrecognized output sample format : %u\n", fSampleFormat);
-                exit(1);
-            }
-
+            writeAreas(fOutputAreas, 0, 0, fBuffering);
             int count = snd_pcm_writen(fOutputDevice, fOutputCardChannels, fBuffering);
             if (count < 0) {
                 //display_error_msg(count, "w3");
@@ -475,6 +747,116 @@ struct AudioInterface : public AudioParam
         }
     }
 
+    /**
+     * mmap mode : convert a buffer directly from the capture device memory,
+     * the buffer may be split in two parts at the end of the ring buffer.
+     */
+    int readMMap()
+    {
+        for (unsigned int pos = 0; pos < fBuffering;) {
+            const snd_pcm_channel_area_t* areas;
+            snd_pcm_uframes_t offset;
+            snd_pcm_uframes_t frames = fBuffering - pos;
+            int err = snd_pcm_mmap_begin(fInputDevice, &areas, &offset, &frames);
+            if (err < 0) return err;
+            if (frames == 0) return -EAGAIN;
+            readAreas(areas, offset, pos, frames);
+            snd_pcm_sframes_t res = snd_pcm_mmap_commit(fInputDevice, offset, frames);
+            if (res < 0 || snd_pcm_uframes_t(res) != frames) return (res < 0) ? res : -EPIPE;
+            pos += frames;
+        }
+        return 0;
+    }
+
+    /**
+     * mmap mode : convert a buffer directly to the playback device memory (or silence
+     * if 'silence' is true).
+     */
+    int writeMMap(bool silence = false)
+    {
+        for (unsigned int pos = 0; pos < fBuffering;) {
+            const snd_pcm_channel_area_t* areas;
+            snd_pcm_uframes_t offset;
+            snd_pcm_uframes_t frames = fBuffering - pos;
+            int err = snd_pcm_mmap_begin(fOutputDevice, &areas, &offset, &frames);
+            if (err < 0) return err;
+            if (frames == 0) return -EAGAIN;
+            if (silence) {
+                snd_pcm_areas_silence(areas, offset, fCardOutputs, frames, fSampleFormat);
+            } else {
+                writeAreas(areas, offset, pos, frames);
+            }
+            snd_pcm_sframes_t res = snd_pcm_mmap_commit(fOutputDevice, offset, frames);
+            if (res < 0 || snd_pcm_uframes_t(res) != frames) return (res < 0) ? res : -EPIPE;
+            pos += frames;
+        }
+        return 0;
+    }
+
+    /**
+     * mmap mode : fill the playback buffer with silence and start both devices.
+     */
+    void start()
+    {
+        snd_pcm_prepare(fOutputDevice);
+        if (fDuplexMode && !fLinked) snd_pcm_prepare(fInputDevice);
+        for (unsigned int p = 0; p < fPeriods; p++) {
+            if (writeMMap(true) < 0) break;
+        }
+        // linked devices are started at once
+        int err = snd_pcm_start(fOutputDevice); display_error_msg(err, "starting output stream");
+        if (fDuplexMode && !fLinked) {
+            err = snd_pcm_start(fInputDevice); display_error_msg(err, "starting input stream");
+        }
+    }
+
+    /**
+     * mmap mode : restart both devices after an xrun (or a suspend).
+     */
+    void recover()
+    {
+        snd_pcm_drop(fOutputDevice);
+        if (fDuplexMode && !fLinked) snd_pcm_drop(fInputDevice);
+        start();
+    }
+
+    /**
+     * mmap mode : wait until a buffer can be read from the capture device and written
+     * to the playback device, both devices being polled at once. Returns false if
+     * the devices had to be restarted.
+     */
+    bool wait()
+    {
+        while (true) {
+            snd_pcm_sframes_t out_avail = snd_pcm_avail_update(fOutputDevice);
+            snd_pcm_sframes_t in_avail = (fDuplexMode) ? snd_pcm_avail_update(fInputDevice) : snd_pcm_sframes_t(fBuffering);
+            if (out_avail < 0 || in_avail < 0) {
+                recover();
+                return false;
+            }
+            if (out_avail >= snd_pcm_sframes_t(fBuffering) && in_avail >= snd_pcm_sframes_t(fBuffering)) {
+                return true;
+            }
+            // one second timeout : the devices are stalled
+            if (poll(&fPollDescriptors[0], fPollDescriptors.size(), 1000) <= 0) {
+                recover();
+                return false;
+            }
+            unsigned short revents = 0;
+            snd_pcm_poll_descriptors_revents(fOutputDevice, &fPollDescriptors[0], fOutputPollDescriptors, &revents);
+            if (fDuplexMode) {
+                unsigned short in_revents = 0;
+                snd_pcm_poll_descriptors_revents(fInputDevice, &fPollDescriptors[fOutputPollDescriptors],
+                                                 fPollDescriptors.size() - fOutputPollDescriptors, &in_revents);
+                revents |= in_revents;
+            }
+            if (revents & (POLLERR | POLLNVAL)) {
+                recover();
+                return false;
+            }
+        }
+    }
+
     /**
      *  print short information on the audio device
      */
@@ -508,6 +890,7 @@ struct AudioInterface : public AudioParam
         printf("Software inputs : %2d, Software outputs : %2d\n", fSoftInputs, fSoftOutputs);
         printf("Hardware inputs : %2d, Hardware outputs : %2d\n", fCardInputs, fCardOutputs);
         printf("Channel inputs  : %2d, Channel outputs  : %2d\n", fChanInputs, fChanOutputs);
+        printf("Access mode : %s\n", snd_pcm_access_name(fSampleAccess));
 
         // affichage des infos de la carte
         err = snd_ctl_open(&ctl_handle, fCardName, 0); check_error(err);
@@ -601,13 +984,15 @@ class alsaaudio : public audio
     alsaaudio(int argc, char* argv[], dsp* DSP) : fDSP(DSP), fRunning(false)
     {
         if (isopt(argv, "-help") || isopt(argv, "-h")) {
-            std::cout << "prog [--device|-d <device> (default \"hw:0\")] [--frequency|-f <f> (default 44100)] [--buffer|-b <bs> (default 512)] [--periods|-p <n> (default 2)]\n";
+            std::cout << "prog [--device|-d <device> (default \"hw:0\")] [--frequency|-f <f> (default 44100)] [--buffer|-b <bs> (default 512)] [--periods|-p <n> (default 2)] [--mmap <0|1> (default 0)]\n";
             exit(1);
         }
         fAudio = new AudioInterface(AudioParam().cardName(lopts1(argc, argv, "--device", "-d", getDefaultEnv("FAUST2ALSA_DEVICE", "hw:0")))
             .frequency(lopt1(argc, argv, "--frequency", "-f", getDefaultEnv("FAUST2ALSA_FREQUENCY", 44100)))
             .buffering(lopt1(argc, argv, "--buffer", "-b", getDefaultEnv("FAUST2ALSA_BUFFER", 512)))
             .periods(lopt1(argc, argv, "--periods", "-p", getDefaultEnv("FAUST2ALSA_PERIODS", 2)))
+            // no short option, '-m' could be taken by the GUI or MIDI options of the program
+            .mmap(lopt1(argc, argv, "--mmap", "--mmap", getDefaultEnv("FAUST2ALSA_MMAP", 0)))
             .inputs(DSP->getNumInputs())
             .outputs(DSP->getNumOutputs()));
     }
@@ -657,7 +1042,17 @@ class alsaaudio : public audio
         bool rt = setRealtimePriority();
         printf(rt ? "RT : ":"NRT: "); fAudio->shortinfo();
         AVOIDDENORMALS;
-        if (fAudio->duplexMode()) {
+        if (fAudio->mmapMode()) {
+            // one cycle per period of both devices, no intermediate buffer
+            fAudio->start();
+            while (fRunning) {
+                if (fAudio->wait()) {
+                    if (fAudio->duplexMode()) fAudio->read();
+                    fDSP->compute(fAudio->buffering(), fAudio->inputSoftChannels(), fAudio->outputSoftChannels());
+                    fAudio->write();
+                }
+            }
+        } else if (fAudio->duplexMode()) {
             fAudio->write();
             fAudio->write();
             while (fRunning) {
@@ -0,0 +1,430 @@
+/************************** BEGIN control-dsp.h ***************************
+FAUST Architecture File
+Copyright (C) 2003-2022 GRAME, Centre National de Creation Musicale
+---------------------------------------------------------------------
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+EXCEPTION : As a special exception, you may create a larger work
+that contains this FAUST architecture section and distribute
+that work under terms of your choice, so long as this FAUST
+architecture section is not modified.
+***************************************************************************/
+
+#ifndef __control_dsp__
+#define __control_dsp__
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+#include "faust/dsp/dsp.h"
+#include "faust/gui/GUI.h"
+#include "faust/gui/DecoratorUI.h"
+#include "faust/gui/ring-buffer.h"
+
+// Events given to 'computeEvents' are remapped and passed to the decorated DSP by chunks of this size
+#ifndef CONTROL_EVENTS_CHUNK
+#define CONTROL_EVENTS_CHUNK 1024
+#endif
+
+/**
+ * A parameter change sent to the audio thread, or a bargraph value sent back by the audio thread.
+ */
+struct dsp_control_command {
+    int fIndex;         // the parameter index, in 'buildUserInterface' order (as in APIUI)
+    FAUSTFLOAT fValue;  // the new value
+};
+
+/**
+ * Control signal processor, that separates the zones seen by the user interfaces from the ones
+ * read and written by 'compute':
+ *
+ *  - the UIs given to 'buildUserInterface' (OSCUI, httpdUI, MidiUI, GUIs...) get 'shadow' zones,
+ *    that they can freely change from their own threads.
+ *  - the changes of the shadow zones are collected by a GUI at each GUI::updateAllGuis refresh
+ *    (or given with setParamValue), and sent as a batch in a single-producer/single-consumer
+ *    command queue, so all the changes of a batch are applied together at the beginning of a block.
+ *  - the changed bargraph values are sent back by the audio thread at the end of each block
+ *    in a telemetry queue, and copied in their shadow zones at the next refresh.
+ *
+ * So 'compute' always sees a coherent set of parameters, and the audio thread only reads
+ * the changed parameters instead of having them polled in its memory.
+ *
+ * The control thread is the one calling GUI::updateAllGuis (or setParamValue and flush),
+ * 'init', 'instanceInit' and 'instanceResetUserInterface' have to be called when the audio is stopped.
+ */
+
+class control_dsp : public decorator_dsp {
+
+    private:
+
+        // Collects the zones of the decorated DSP
+        struct ZoneCollectorUI : public GenericUI {
+
+            std::vector<FAUSTFLOAT*> fZones;
+            std::vector<bool> fOutputs;
+
+            void addZone(FAUSTFLOAT* zone, bool output)
+            {
+                fZones.push_back(zone);
+                fOutputs.push_back(output);
+            }
+
+            void addButton(const char* label, FAUSTFLOAT* zone) { addZone(zone, false); }
+            void addCheckButton(const char* label, FAUSTFLOAT* zone) { addZone(zone, false); }
+            void addVerticalSlider(const char* label, FAUSTFLOAT* zone, FAUSTFLOAT init, FAUSTFLOAT min, FAUSTFLOAT max, FAUSTFLOAT step) { addZone(zone, false); }
+            void addHorizontalSlider(const char* label, FAUSTFLOAT* zone, FAUSTFLOAT init, FAUSTFLOAT min, FAUSTFLOAT max, FAUSTFLOAT step) { addZone(zone, false); }
+            void addNumEntry(const char* label, FAUSTFLOAT* zone, FAUSTFLOAT init, FAUSTFLOAT min, FAUSTFLOAT max, FAUSTFLOAT step) { addZone(zone, false); }
+            void addHorizontalBargraph(const char* label, FAUSTFLOAT* zone, FAUSTFLOAT min, FAUSTFLOAT max) { addZone(zone, true); }
+            void addVerticalBargraph(const char* label, FAUSTFLOAT* zone, FAUSTFLOAT min, FAUSTFLOAT max) { addZone(zone, true); }
+
+        };
+
+        // Gives the shadow zones to a UI
+        struct ShadowUI : public UI {
+
+            control_dsp* fControl;
+            UI* fUI;
+
+            ShadowUI(control_dsp* control, UI* ui):fControl(control), fUI(ui) {}
+
+            FAUSTFLOAT* shadow(FAUSTFLOAT* zone) { return fControl->getShadowZone(zone); }
+
+            void openTabBox(const char* label) { fUI->openTabBox(label); }
+            void openHorizontalBox(const char* label) { fUI->openHorizontalBox(label); }
+            void openVerticalBox(const char* label) { fUI->openVerticalBox(label); }
+            void closeBox() { fUI->closeBox(); }
+
+            void addButton(const char* label, FAUSTFLOAT* zone) { fUI->addButton(label, shadow(zone)); }
+            void addCheckButton(const char* label, FAUSTFLOAT* zone) { fUI->addCheckButton(label, shadow(zone)); }
+            void addVerticalSlider(const char* label, FAUSTFLOAT* zone, FAUSTFLOAT init, FAUSTFLOAT min, FAUSTFLOAT max, FAUSTFLOAT step)
+            {
+                fUI->addVerticalSlider(label, shadow(zone), init, min, max, step);
+            }
+            void addHorizontalSlider(const char* label, FAUSTFLOAT* zone, FAUSTFLOAT init, FAUSTFLOAT min, FAUSTFLOAT max, FAUSTFLOAT step)
+            {
+                fUI->addHorizontalSlider(label, shadow(zone), init, min, max, step);
+            }
+            void addNumEntry(const char* label, FAUSTFLOAT* zone, FAUSTFLOAT init, FAUSTFLOAT min, FAUSTFLOAT max, FAUSTFLOAT step)
+            {
+                fUI->addNumEntry(label, shadow(zone), init, min, max, step);
+            }
+            void addHorizontalBargraph(const char* label, FAUSTFLOAT* zone, FAUSTFLOAT min, FAUSTFLOAT max)
+            {
+                fUI->addHorizontalBargraph(label, shadow(zone), min, max);
+            }
+            void addVerticalBargraph(const char* label, FAUSTFLOAT* zone, FAUSTFLOAT min, FAUSTFLOAT max)
+            {
+                fUI->addVerticalBargraph(label, shadow(zone), min, max);
+            }
+            void addSoundfile(const char* label, const char* filename, Soundfile** sf_zone) { fUI->addSoundfile(label, filename, sf_zone); }
+
+            void declare(FAUSTFLOAT* zone, const char* key, const char* val) { fUI->declare(shadow(zone), key, val); }
+
+        };
+
+        // Sends the changes of an input shadow zone
+        struct uiControlItem : public uiItem {
+
+            control_dsp* fControl;
+            int fIndex;
+
+            uiControlItem(GUI* ui, FAUSTFLOAT* zone, control_dsp* control, int index)
+            :uiItem(ui, zone), fControl(control), fIndex(index)
+            {}
+
+            void reflectZone()
+            {
+                fCache = *fZone;
+                fControl->sendCommand(fIndex, fCache);
+            }
+
+        };
+
+        // Sends the batch of changes and receives the telemetry once per refresh
+        struct ControlGUI : public GUI {
+
+            control_dsp* fControl;
+
+            ControlGUI(control_dsp* control):fControl(control) {}
+
+            void updateAll()
+            {
+                fControl->flush();
+                fControl->receiveTelemetry();
+            }
+
+        };
+
+        std::vector<FAUSTFLOAT*> fZones;                    // zones of the decorated DSP
+        std::vector<FAUSTFLOAT> fShadows;                   // zones of the UIs
+        std::unordered_map<FAUSTFLOAT*, int> fZoneIndex;
+        std::vector<int> fOutputIndexes;                    // bargraphs
+
+        ringbuffer_t* fCommands;
+        ringbuffer_t* fTelemetry;
+
+        // Control thread : batch of commands, with the position of each parameter in the batch (or -1)
+        std::vector<dsp_control_command> fBatch;
+        std::vector<int> fBatchPosition;
+        ControlGUI* fControlGUI;
+
+        // Audio thread : last sent bargraph values
+        std::vector<FAUSTFLOAT> fSent;
+        std::vector<dsp_control_command> fTelemetryBatch;
+        std::vector<dsp_control_event> fEvents;  // CONTROL_EVENTS_CHUNK remapped events
+
+        static ringbuffer_t* createQueue(size_t commands)
+        {
+            ringbuffer_t* queue = ringbuffer_create(std::max<size_t>(commands, 256) * sizeof(dsp_control_command));
+            ringbuffer_mlock(queue);
+            return queue;
+        }
+
+        FAUSTFLOAT* getShadowZone(FAUSTFLOAT* zone)
+        {
+            auto it = fZoneIndex.find(zone);
+            return (it != fZoneIndex.end()) ? &fShadows[it->second] : zone;
+        }
+
+        // Shadow zones take the values of the DSP zones (when the audio is stopped)
+        void resetShadows()
+        {
+            ringbuffer_reset(fCommands);
+            ringbuffer_reset(fTelemetry);
+            fBatch.clear();
+            std::fill(fBatchPosition.begin(), fBatchPosition.end(), -1);
+            for (size_t i = 0; i < fZones.size(); i++) {
+                fShadows[i] = fSent[i] = *fZones[i];
+            }
+        }
+
+        // Audio thread : apply the received batches at the beginning of the block
+        void applyCommands()
+        {
+            dsp_control_command command;
+            for (size_t n = ringbuffer_read_space(fCommands) / sizeof(dsp_control_command); n > 0; n--) {
+                ringbuffer_read(fCommands, (char*)&command, sizeof(dsp_control_command));
+                *fZones[command.fIndex] = command.fValue;
+            }
+        }
+
+        // Audio thread : send the changed bargraphs at the end of the block (or at the next block if the queue is full)
+        void sendTelemetry()
+        {
+            fTelemetryBatch.clear();
+            for (const auto& index : fOutputIndexes) {
+                if (*fZones[index] != fSent[index]) {
+                    fTelemetryBatch.push_back({ index, *fZones[index] });
+                }
+            }
+            size_t size = fTelemetryBatch.size() * sizeof(dsp_control_command);
+            if (size > 0 && ringbuffer_write_space(fTelemetry) >= size) {
+                ringbuffer_write(fTelemetry, (const char*)fTelemetryBatch.data(), size);
+                for (const auto& it : fTelemetryBatch) {
+                    fSent[it.fIndex] = it.fValue;
+                }
+            }
+        }
+
+        void sendCommand(int index, FAUSTFLOAT value)
+        {
+            // Several changes of a parameter in a batch are merged
+            if (fBatchPosition[index] >= 0) {
+                fBatch[fBatchPosition[index]].fValue = value;
+            } else {
+                fBatchPosition[index] = int(fBatch.size());
+                fBatch.push_back({ index, value });
+            }
+        }
+
+    public:
+
+        control_dsp(dsp* dsp):decorator_dsp(dsp)
+        {
+            ZoneCollectorUI collector;
+            fDSP->buildUserInterface(&collector);
+            fZones = collector.fZones;
+            for (size_t i = 0; i < fZones.size(); i++) {
+                fZoneIndex[fZones[i]] = int(i);
+                if (collector.fOutputs[i]) fOutputIndexes.push_back(int(i));
+            }
+
+            // Allocated once, the shadow zones do not move
+            fShadows.resize(fZones.size());
+            fSent.resize(fZones.size());
+            fBatchPosition.resize(fZones.size());
+            fBatch.reserve(fZones.size());
+            fTelemetryBatch.reserve(fOutputIndexes.size());
+            fEvents.resize(CONTROL_EVENTS_CHUNK);
+
+            fCommands = createQueue(2 * fZones.size());
+            fTelemetry = createQueue(2 * fOutputIndexes.size());
+            resetShadows();
+
+            // Input shadow zones are watched by the control GUI
+            fControlGUI = new ControlGUI(this);
+            for (size_t i = 0; i < fZones.size(); i++) {
+                if (!collector.fOutputs[i]) new uiControlItem(fControlGUI, &fShadows[i], this, int(i));
+            }
+        }
+
+        virtual ~control_dsp()
+        {
+            delete fControlGUI;
+            ringbuffer_free(fCommands);
+            ringbuffer_free(fTelemetry);
+        }
+
+        virtual void buildUserInterface(UI* ui_interface)
+        {
+            ShadowUI shadow(this, ui_interface);
+            fDSP->buildUserInterface(&shadow);
+        }
+
+        virtual void init(int sample_rate)
+        {
+            fDSP->init(sample_rate);
+            resetShadows();
+        }
+
+        virtual void instanceInit(int sample_rate)
+        {
+            fDSP->instanceInit(sample_rate);
+            resetShadows();
+        }
+
+        virtual void instanceResetUserInterface()
+        {
+            fDSP->instanceResetUserInterface();
+            resetShadows();
+        }
+
+        virtual control_dsp* clone()
+        {
+            return new control_dsp(fDSP->clone());
+        }
+
+        virtual void compute(int count, FAUSTFLOAT** inputs, FAUSTFLOAT** outputs)
+        {
+            applyCommands();
+            fDSP->compute(count, inputs, outputs);
+            sendTelemetry();
+        }
+
+        virtual void compute(double date_usec, int count, FAUSTFLOAT** inputs, FAUSTFLOAT** outputs)
+        {
+            applyCommands();
+            fDSP->compute(date_usec, count, inputs, outputs);
+            sendTelemetry();
+        }
+
+        /**
+         * Events are given on the shadow zones. They are remapped on the DSP zones in a preallocated
+         * buffer, so any number of events are given by chunks of CONTROL_EVENTS_CHUNK, the block being
+         * split at the date of the first event of each following chunk.
+         */
+        virtual void computeEvents(int count, FAUSTFLOAT** inputs, FAUSTFLOAT** outputs, int nevents, const dsp_control_event* events)
+        {
+            applyCommands();
+            int ins = fDSP->getNumInputs();
+            int outs = fDSP->getNumOutputs();
+            // The same pointer array may be given for inputs and outputs (in-place compute), it is only moved once
+            if (outputs == inputs) {
+                ins = std::max(ins, outs);
+                outs = 0;
+            }
+            int start = 0;
+            int first = 0;
+            do {
+                int last = std::min(first + CONTROL_EVENTS_CHUNK, nevents);
+                // The sub-block ends where the next chunk begins, the last one at the end of the block
+                int end = (last < nevents) ? std::max(start, std::min(events[last].fDate, count)) : count;
+                for (int i = first; i < last; i++) {
+                    dsp_control_event& event = fEvents[i - first];
+                    event = events[i];
+                    event.fDate -= start;
+                    if (event.fZone >= fShadows.data() && event.fZone < fShadows.data() + fShadows.size()) {
+                        event.fZone = fZones[event.fZone - fShadows.data()];
+                    }
+                }
+                fDSP->computeEvents(end - start, inputs, outputs, last - first, fEvents.data());
+                for (int chan = 0; chan < ins; chan++) inputs[chan] += end - start;
+                for (int chan = 0; chan < outs; chan++) outputs[chan] += end - start;
+                start = end;
+                first = last;
+            } while (first < nevents);
+            for (int chan = 0; chan < ins; chan++) inputs[chan] -= start;
+            for (int chan = 0; chan < outs; chan++) outputs[chan] -= start;
+            sendTelemetry();
+        }
+
+        /**
+         * Return the number of parameters (in 'buildUserInterface' order, as in APIUI).
+         */
+        int getParamsCount() { return int(fZones.size()); }
+
+        /**
+         * Control thread : change a parameter, sent with the next 'flush'.
+         */
+        void setParamValue(int index, FAUSTFLOAT value)
+        {
+            fShadows[index] = value;
+            sendCommand(index, value);
+        }
+
+        /**
+         * Control thread : return the value of a parameter, or the last received value of a bargraph.
+         */
+        FAUSTFLOAT getParamValue(int index) { return fShadows[index]; }
+
+        /**
+         * Control thread : send the batch of changes to the audio thread (done at each GUI::updateAllGuis).
+         *
+         * @return false if the command queue is full (the batch is then kept for the next 'flush')
+         */
+        bool flush()
+        {
+            size_t size = fBatch.size() * sizeof(dsp_control_command);
+            if (size == 0) {
+                return true;
+            } else if (ringbuffer_write_space(fCommands) < size) {
+                return false;
+            } else {
+                ringbuffer_write(fCommands, (const char*)fBatch.data(), size);
+                for (const auto& it : fBatch) {
+                    fBatchPosition[it.fIndex] = -1;
+                }
+                fBatch.clear();
+                return true;
+            }
+        }
+
+        /**
+         * Control thread : copy the bargraph values sent by the audio thread in their shadow zones
+         * (done at each GUI::updateAllGuis).
+         */
+        void receiveTelemetry()
+        {
+            dsp_control_command command;
+            while (ringbuffer_read(fTelemetry, (char*)&command, sizeof(dsp_control_command)) == sizeof(dsp_control_command)) {
+                fShadows[command.fIndex] = command.fValue;
+            }
+        }
+
+};
+
+#endif
+/************************** END control-dsp.h **************************/
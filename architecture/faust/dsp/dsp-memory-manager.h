@@ -0,0 +1,324 @@
+/************************** BEGIN dsp-memory-manager.h *********************
+FAUST Architecture File
+Copyright (C) 2003-2022 GRAME, Centre National de Creation Musicale
+---------------------------------------------------------------------
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+EXCEPTION : As a special exception, you may create a larger work
+that contains this FAUST architecture section and distribute
+that work under terms of your choice, so long as this FAUST
+architecture section is not modified.
+***************************************************************************/
+
+#ifndef __dsp_memory_manager__
+#define __dsp_memory_manager__
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#include "faust/dsp/dsp.h"
+
+#define ARENA_CACHE_LINE 64
+#define ARENA_PAGE_SIZE 4096
+#define ARENA_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+/**
+ * A memory manager allocating all the memory zones of a DSP class (static tables, DSP objects,
+ * delay lines...) in a single contiguous and cache line aligned arena, to be used with code
+ * generated with the -mem option:
+ *
+ *  arena_memory_manager manager(voices);
+ *  mydsp::fManager = &manager;
+ *  mydsp::memoryInfo();    // describes the zones and creates the arena
+ *  mydsp::classInit(sample_rate);
+ *  mydsp* dsp = mydsp::create();
+ *
+ * The zones described with 'info' are laid out in 'end':
+ *  - the zones written by 'compute' (the DSP object and its state arrays) are 'hot'. They are grouped
+ *    in one block per instance, ordered by decreasing accesses per byte, so that the small and most used
+ *    ones share the first cache lines and the long delay lines come last. The 'instances' blocks are
+ *    contiguous, so that the voices of a polyphonic instrument are next to each other.
+ *  - the zones only read by 'compute' (the static tables) are 'cold' and placed after the hot blocks.
+ *
+ * The zones are allocated in the order they are described, so 'allocate' matches each request
+ * with the next described zone of the same size (up to the padding of the DSP objects),
+ * and gives it the first free instance block.
+ * Requests that cannot be matched (unknown size or no more free block) are served
+ * by an aligned heap allocation.
+ *
+ * The arena is optionally backed by huge pages (to reduce the TLB misses on large delay lines), and its
+ * pages are touched in 'end' so that they are placed on the NUMA node of the thread calling 'memoryInfo'
+ * (or on 'numa_node' if given, on Linux). This class is not thread safe.
+ */
+class arena_memory_manager : public dsp_memory_manager {
+
+    private:
+
+        struct Zone {
+            size_t fSize;
+            size_t fReads;
+            size_t fWrites;
+            size_t fCapacity;           // the reserved size
+            size_t fOffset;             // in the instance block for hot zones, in the arena for cold ones
+            std::vector<bool> fUsed;    // one flag per instance block (or a single one for cold zones)
+            bool isHot() const { return fWrites > 0; }
+        };
+
+        std::vector<Zone> fZones;
+        size_t fCursor;
+
+        size_t fInstances;
+        bool fHugePages;
+        int fNumaNode;
+
+        char* fArena;
+        size_t fArenaSize;
+        size_t fBlockSize;
+        size_t fHotSize;
+        bool fMapped;
+
+        size_t fFallbacks;
+
+        static size_t alignUp(size_t size, size_t align)
+        {
+            return (size + align - 1) & ~(align - 1);
+        }
+
+        static void* heapAllocate(size_t size)
+        {
+            size = alignUp(std::max<size_t>(size, 1), ARENA_CACHE_LINE);
+        #ifdef _WIN32
+            return _aligned_malloc(size, ARENA_CACHE_LINE);
+        #else
+            void* ptr = nullptr;
+            return (posix_memalign(&ptr, ARENA_CACHE_LINE, size) == 0) ? ptr : nullptr;
+        #endif
+        }
+
+        static void heapDestroy(void* ptr)
+        {
+        #ifdef _WIN32
+            _aligned_free(ptr);
+        #else
+            free(ptr);
+        #endif
+        }
+
+        void createArena()
+        {
+            fMapped = false;
+        #ifdef _WIN32
+            fArenaSize = alignUp(fArenaSize, ARENA_PAGE_SIZE);
+            fArena = static_cast<char*>(_aligned_malloc(fArenaSize, ARENA_PAGE_SIZE));
+        #else
+            void* ptr = MAP_FAILED;
+        #ifdef MAP_HUGETLB
+            if (fHugePages) {
+                // Explicit huge pages, only available if reserved by the system
+                size_t size = alignUp(fArenaSize, ARENA_HUGE_PAGE_SIZE);
+                ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                if (ptr != MAP_FAILED) fArenaSize = size;
+            }
+        #endif
+            if (ptr == MAP_FAILED) {
+                size_t size = alignUp(fArenaSize, fHugePages ? ARENA_HUGE_PAGE_SIZE : ARENA_PAGE_SIZE);
+                ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (ptr != MAP_FAILED) {
+                    fArenaSize = size;
+                #ifdef MADV_HUGEPAGE
+                    // Otherwise ask for transparent huge pages
+                    if (fHugePages) madvise(ptr, fArenaSize, MADV_HUGEPAGE);
+                #endif
+                }
+            }
+            fArena = (ptr == MAP_FAILED) ? nullptr : static_cast<char*>(ptr);
+            fMapped = (fArena != nullptr);
+        #endif
+            if (!fArena) {
+                fArenaSize = 0;
+                return;
+            }
+        #if defined(__linux__) && defined(SYS_mbind)
+            if (fNumaNode >= 0 && fNumaNode < int(sizeof(unsigned long) * 8)) {
+                // MPOL_PREFERRED (1), before the pages are touched
+                unsigned long mask = 1UL << fNumaNode;
+                syscall(SYS_mbind, fArena, fArenaSize, 1, &mask, sizeof(unsigned long) * 8, 0);
+            }
+        #endif
+            // First touch: the pages are allocated (on the current NUMA node) now and not in the audio thread
+            memset(fArena, 0, fArenaSize);
+        }
+
+        void destroyArena()
+        {
+            if (fArena) {
+            #ifdef _WIN32
+                _aligned_free(fArena);
+            #else
+                if (fMapped) munmap(fArena, fArenaSize);
+            #endif
+            }
+            fArena = nullptr;
+            fArenaSize = 0;
+        }
+
+        bool inArena(void* ptr)
+        {
+            return fArena && static_cast<char*>(ptr) >= fArena && static_cast<char*>(ptr) < fArena + fArenaSize;
+        }
+
+        int firstFree(const Zone& zone)
+        {
+            for (size_t slot = 0; slot < zone.fUsed.size(); slot++) {
+                if (!zone.fUsed[slot]) return int(slot);
+            }
+            return -1;
+        }
+
+    public:
+
+        /**
+         * Create a memory manager.
+         *
+         * @param instances - the number of DSP instances to be allocated in the arena (like the number of voices + 1
+         * for a polyphonic instrument, since the voices are cloned from a first instance)
+         * @param huge_pages - whether to use huge pages for the arena
+         * @param numa_node - the NUMA node to allocate the arena on (Linux only), or -1 to use the node
+         * of the thread calling 'memoryInfo'
+         */
+        arena_memory_manager(size_t instances = 1, bool huge_pages = false, int numa_node = -1)
+        :fCursor(0), fInstances(std::max<size_t>(instances, 1)), fHugePages(huge_pages), fNumaNode(numa_node),
+        fArena(nullptr), fArenaSize(0), fBlockSize(0), fHotSize(0), fMapped(false), fFallbacks(0)
+        {}
+
+        virtual ~arena_memory_manager()
+        {
+            destroyArena();
+        }
+
+        virtual void begin(size_t count)
+        {
+            destroyArena();
+            fZones.clear();
+            fZones.reserve(count);
+            fCursor = 0;
+        }
+
+        virtual void info(size_t size, size_t reads, size_t writes)
+        {
+            // The size of the DSP objects does not include their vtable pointer and padding
+            size_t capacity = alignUp(size + 2 * sizeof(void*), ARENA_CACHE_LINE);
+            fZones.push_back({ size, reads, writes, capacity, 0, std::vector<bool>() });
+        }
+
+        virtual void end()
+        {
+            // Hot zones by decreasing accesses per byte
+            std::vector<size_t> hot;
+            for (size_t i = 0; i < fZones.size(); i++) {
+                if (fZones[i].isHot()) hot.push_back(i);
+            }
+            std::stable_sort(hot.begin(), hot.end(), [this](size_t a, size_t b) {
+                const Zone& za = fZones[a];
+                const Zone& zb = fZones[b];
+                return (za.fReads + za.fWrites) * std::max<size_t>(zb.fSize, 1)
+                     > (zb.fReads + zb.fWrites) * std::max<size_t>(za.fSize, 1);
+            });
+
+            fBlockSize = 0;
+            for (size_t i : hot) {
+                fZones[i].fOffset = fBlockSize;
+                fZones[i].fUsed.assign(fInstances, false);
+                fBlockSize += fZones[i].fCapacity;
+            }
+            // Page multiple blocks would put the first lines of all instances in the same cache sets
+            if (fBlockSize > 0 && fBlockSize % ARENA_PAGE_SIZE == 0) fBlockSize += ARENA_CACHE_LINE;
+            fHotSize = fBlockSize * fInstances;
+
+            // Cold zones after the hot blocks
+            fArenaSize = fHotSize;
+            for (auto& zone : fZones) {
+                if (!zone.isHot()) {
+                    zone.fOffset = fArenaSize;
+                    zone.fUsed.assign(1, false);
+                    fArenaSize += zone.fCapacity;
+                }
+            }
+
+            if (fArenaSize > 0) createArena();
+        }
+
+        virtual void* allocate(size_t size)
+        {
+            if (fArena) {
+                // Next described zone of this size, with a free block
+                for (size_t i = 0; i < fZones.size(); i++) {
+                    size_t index = (fCursor + i) % fZones.size();
+                    Zone& zone = fZones[index];
+                    int slot = (zone.fSize <= size && size <= zone.fCapacity) ? firstFree(zone) : -1;
+                    if (slot >= 0) {
+                        zone.fUsed[slot] = true;
+                        fCursor = index + 1;
+                        return (zone.isHot()) ? fArena + slot * fBlockSize + zone.fOffset : fArena + zone.fOffset;
+                    }
+                }
+            }
+            fFallbacks++;
+            return heapAllocate(size);
+        }
+
+        virtual void destroy(void* ptr)
+        {
+            if (!inArena(ptr)) {
+                heapDestroy(ptr);
+                return;
+            }
+            size_t offset = static_cast<char*>(ptr) - fArena;
+            size_t slot = (offset < fHotSize) ? offset / fBlockSize : 0;
+            size_t zone_offset = (offset < fHotSize) ? offset % fBlockSize : offset;
+            for (auto& zone : fZones) {
+                if (zone.fOffset == zone_offset && zone.isHot() == (offset < fHotSize)) {
+                    zone.fUsed[slot] = false;
+                    return;
+                }
+            }
+        }
+
+        /* Return the arena size in bytes */
+        size_t getArenaSize() { return fArenaSize; }
+
+        /* Return the size in bytes of the block of hot zones allocated for each instance */
+        size_t getBlockSize() { return fBlockSize; }
+
+        /* Return the number of allocations which could not be served by the arena */
+        size_t getFallbacks() { return fFallbacks; }
+
+};
+
+#endif
+/************************** END dsp-memory-manager.h **************************/
@@ -26,13 +26,34 @@ architecture section is not modified.
 #define __dsp_optimizer__
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <pwd.h>
 #include <unistd.h>
 #include <typeinfo>
 #include <tuple>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifdef __APPLE__
+#include <sys/sysctl.h>
+#endif
 
 #include "faust/dsp/llvm-dsp.h"
+#include "faust/dsp/libfaust.h"
 #include "faust/dsp/dsp-bench.h"
 
 typedef std::vector<std::string> TOption;
@@ -40,20 +61,34 @@ typedef std::vector<TOption> TOptionTable;
 
 /*
     A class to find optimal Faust compiler parameters for a given DSP.
+ 
+    - candidate option sets are compiled concurrently in background threads, while the already compiled ones
+      are benchmarked in the calling thread. On Linux, the benchmark thread and the compilation threads are pinned
+      on distinct cores of the process affinity mask, so that measures are not disturbed by the compilations.
+    - candidates are pruned by successive-halving: all of them are first measured on a short run,
+      then the best half is measured again with a doubled number of buffers, until a single one remains.
+    - the best option sets are kept in a database file keyed by the DSP SHA key, the CPU model, the LLVM target,
+      the buffer size and the sample type, so that later calls directly return them.
+      The file is set with the FAUST_OPTIMIZER_DB environment variable (default is '~/.faust/optimizer.db',
+      an empty value deactivates the database).
 */
 template <typename REAL>
 class dsp_optimizer_real {
 
     private:
     
+        struct Candidate {
+            TOption fOptions;
+            llvm_dsp_factory* fFactory;
+            std::tuple<double, double, double> fRes;
+        };
+    
         int fBufferSize;     // size of a vector in samples
     
         int fArgc;
         const char** fArgv;
     
-        int fOptLevel;      
-        llvm_dsp_factory* fFactory;
-        llvm_dsp* fDSP;
+        int fOptLevel;
     
         int fRun;
         int fCount;
@@ -68,32 +103,191 @@ class dsp_optimizer_real {
         std::string fTarget;
         std::string fError;
     
+        std::string fDBFile;
+        std::string fDBKey;
+    
+        std::vector<int> fCPUs;     // cores of the process affinity mask, the first one is used to benchmark
+        int fCompileThreads;
+    
         TOptionTable fScalOptionsTable;
         TOptionTable fVecOptionsTable;
     
-        std::tuple<double, double, double> bench(int run)
+        static std::string getCPUModel()
+        {
+            std::string model;
+        #if defined(__linux__)
+            std::ifstream cpuinfo("/proc/cpuinfo");
+            std::string line;
+            while (std::getline(cpuinfo, line)) {
+                if (line.compare(0, 10, "model name") == 0 || line.compare(0, 9, "Processor") == 0) {
+                    model = line.substr(line.find(':') + 1);
+                    break;
+                }
+            }
+        #elif defined(__APPLE__)
+            char buffer[256];
+            size_t size = sizeof(buffer);
+            if (sysctlbyname("machdep.cpu.brand_string", buffer, &size, nullptr, 0) == 0) {
+                model = buffer;
+            }
+        #endif
+            return model;
+        }
+    
+        static std::string getDBFile()
+        {
+            const char* db_file = getenv("FAUST_OPTIMIZER_DB");
+            if (db_file) return db_file;
+            const char* home = getenv("HOME");
+            if (!home) {
+                struct passwd* pw = getpwuid(getuid());
+                home = (pw) ? pw->pw_dir : nullptr;
+            }
+            if (!home) return "";
+            std::string dir = std::string(home) + "/.faust";
+            mkdir(dir.c_str(), 0755);
+            return dir + "/optimizer.db";
+        }
+    
+        // Database entries are lines like: 'key MBytes/sec SD CPU option1 option2...'
+        bool readDB(std::tuple<double, double, double, TOption>& res)
+        {
+            if (fDBFile == "" || fDBKey == "") return false;
+            std::ifstream file(fDBFile);
+            std::string line;
+            while (std::getline(file, line)) {
+                std::stringstream reader(line);
+                std::string key, option;
+                double mbytes, sd, cpu;
+                if ((reader >> key >> mbytes >> sd >> cpu) && key == fDBKey) {
+                    TOption options;
+                    while (reader >> option) options.push_back(option);
+                    res = std::make_tuple(mbytes, sd, cpu, options);
+                    return true;
+                }
+            }
+            return false;
+        }
+    
+        void writeDB(const std::tuple<double, double, double, TOption>& res)
+        {
+            if (fDBFile == "" || fDBKey == "") return;
+            // Keep the other entries, and write in a temporary file renamed at the end, so that concurrent tools see a complete file
+            std::ifstream file(fDBFile);
+            std::stringstream entries;
+            std::string line;
+            while (std::getline(file, line)) {
+                if (line.compare(0, fDBKey.size() + 1, fDBKey + " ") != 0) entries << line << std::endl;
+            }
+            entries << fDBKey << " " << std::get<0>(res) << " " << std::get<1>(res) << " " << std::get<2>(res);
+            for (const auto& option : std::get<3>(res)) entries << " " << option;
+            entries << std::endl;
+            std::string tmp_file = fDBFile + "." + std::to_string(getpid());
+            {
+                std::ofstream out(tmp_file);
+                out << entries.str();
+                if (!out) return;
+            }
+            if (rename(tmp_file.c_str(), fDBFile.c_str()) != 0) {
+                unlink(tmp_file.c_str());
+            }
+        }
+    
+        // The key depends of the DSP and its user options, the machine and the measure setup
+        std::string computeDBKey()
+        {
+            std::string sha_key, error;
+            if (fInput == "") {
+                expandDSPFromFile(fFilename, fArgc, fArgv, sha_key, error);
+            } else {
+                expandDSPFromString("FaustDSP", fInput, fArgc, fArgv, sha_key, error);
+            }
+            if (sha_key == "") return "";
+            std::stringstream key;
+            key << sha_key << getCPUModel() << ((fTarget == "") ? getDSPMachineTarget() : fTarget)
+                << fBufferSize << typeid(REAL).name() << fOptLevel << fControl << fDownSampling << fUpSampling << fFilter;
+            return generateSHA1(key.str());
+        }
+    
+        void initCPUs()
+        {
+        #ifdef __linux__
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+                for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                    if (CPU_ISSET(cpu, &set)) fCPUs.push_back(cpu);
+                }
+            }
+            fCompileThreads = std::max<int>(1, int(fCPUs.size()) - 1);
+        #else
+            fCompileThreads = std::max<int>(1, int(std::thread::hardware_concurrency()) - 1);
+        #endif
+        }
+    
+        // Pin the calling thread: 0 for the benchmark core, > 0 for the compilation ones (on all other cores)
+        void pinThread(int id)
+        {
+        #ifdef __linux__
+            if (fCPUs.size() < 2) return;
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (id == 0) {
+                CPU_SET(fCPUs[0], &set);
+            } else {
+                for (size_t i = 1; i < fCPUs.size(); i++) CPU_SET(fCPUs[i], &set);
+            }
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        #endif
+        }
+    
+        void unpinThread()
+        {
+        #ifdef __linux__
+            if (fCPUs.size() < 2) return;
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (size_t i = 0; i < fCPUs.size(); i++) CPU_SET(fCPUs[i], &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        #endif
+        }
+    
+        std::tuple<double, double, double> bench(dsp* dsp, int count, int run)
         {
-            // First call with fCount = -1 will be used to estimate fCount by giving the wanted measure duration
-            if (fCount == -1) {
-                measure_dsp_real<REAL> mes(fDSP, fBufferSize, 5., fTrace, fControl, fDownSampling, fUpSampling, fFilter);
+            measure_dsp_real<REAL> mes(dsp, fBufferSize, count, fTrace, fControl, fDownSampling, fUpSampling, fFilter);
+            for (int i = 0; i < run; i++) {
+                mes.measure();
+                std::pair<double, double> res = mes.getStats();
+                if (fTrace) {
+                    fprintf(stdout, "%f MBytes/sec, SD : %f%% (DSP CPU : %f%% at %d Hz)\n", res.first, res.second, (mes.getCPULoad() * 100), int(BENCH_SAMPLE_RATE));
+                }
+                FAUSTBENCH_LOG<double>(res.first);
+            }
+            std::pair<double, double> res = mes.getStats();
+            return std::make_tuple(res.first, res.second, mes.getCPULoad());
+        }
+    
+        // First call will be used to estimate fCount by giving the wanted measure duration
+        bool estimateCount()
+        {
+            if (fTrace) fprintf(stdout, "Estimate timing parameters\n");
+            llvm_dsp_factory* factory = createFactory(addArgvItems(fScalOptionsTable[1], fArgc, fArgv), fError);
+            if (!factory) {
+                fprintf(stderr, "Cannot create factory : %s\n", fError.c_str());
+                return false;
+            }
+            dsp* dsp = factory->createDSPInstance();
+            if (dsp) {
+                measure_dsp_real<REAL> mes(dsp, fBufferSize, 5., fTrace, fControl, fDownSampling, fUpSampling, fFilter);
                 mes.measure();
                 // fCount is kept from the first duration measure
                 fCount = mes.getCount();
-                std::pair<double, double> res = mes.getStats();
-                return std::make_tuple(res.first, res.second, mes.getCPULoad());
             } else {
-                measure_dsp_real<REAL> mes(fDSP, fBufferSize, fCount, fTrace, fControl, fDownSampling, fUpSampling, fFilter);
-                for (int i = 0; i < run; i++) {
-                    mes.measure();
-                    std::pair<double, double> res = mes.getStats();
-                    if (fTrace) {
-                        fprintf(stdout, "%f MBytes/sec, SD : %f%% (DSP CPU : %f%% at %d Hz)\n", res.first, res.second, (mes.getCPULoad() * 100), int(BENCH_SAMPLE_RATE));
-                    }
-                    FAUSTBENCH_LOG<double>(res.first);
-                }
-                std::pair<double, double> res = mes.getStats();
-                return std::make_tuple(res.first, res.second, mes.getCPULoad());
+                fprintf(stderr, "Cannot create instance...\n");
             }
+            // dsp is deallocated by measure_dsp
+            deleteDSPFactory(factory);
+            return (dsp != nullptr);
         }
     
         void init()
@@ -230,7 +424,7 @@ class dsp_optimizer_real {
     
         void printItem(const std::vector <std::string>& item)
         {
-            for (int i = 0; i < item.size(); i++) {
+            for (size_t i = 0; i < item.size(); i++) {
                 fprintf(stdout, " %s", item[i].c_str());
             }
             fprintf(stdout, " : ");
@@ -244,68 +438,144 @@ class dsp_optimizer_real {
             }
             return res_item;
         }
-        
-        bool computeOne(const TOption& item, int run, std::tuple<double, double, double>& res)
+    
+        // Can be called from several threads
+        llvm_dsp_factory* createFactory(const TOption& item, std::string& error)
         {
             int argc = 0;
             const char* argv[64];
-            for (int i = 0; i < item.size(); i++) {
+            for (size_t i = 0; i < item.size() && argc < 63; i++) {
                 argv[argc++] = item[i].c_str();
             }
             argv[argc] = nullptr;  // NULL terminated argv
             
             if (fInput == "") {
-                fFactory = createDSPFactoryFromFile(fFilename.c_str(), argc, argv, fTarget, fError, fOptLevel);
+                return createDSPFactoryFromFile(fFilename.c_str(), argc, argv, fTarget, error, fOptLevel);
             } else {
-                fFactory = createDSPFactoryFromString("FaustDSP", fInput, argc, argv, fTarget, fError, fOptLevel);
-            }
-            
-            if (!fFactory) {
-                fprintf(stderr, "Cannot create factory : %s\n", fError.c_str());
-                return false;
+                return createDSPFactoryFromString("FaustDSP", fInput, argc, argv, fTarget, error, fOptLevel);
             }
-            
-            fDSP = fFactory->createDSPInstance();
-            if (!fDSP) {
+        }
+    
+        bool benchOne(Candidate& candidate, int count, int run)
+        {
+            dsp* dsp = candidate.fFactory->createDSPInstance();
+            if (!dsp) {
                 fprintf(stderr, "Cannot create instance...\n");
                 return false;
             }
+            if (fTrace) printItem(candidate.fOptions);
+            // dsp is deallocated by measure_dsp
+            candidate.fRes = bench(dsp, count, run);
+            return true;
+        }
+    
+        // Compile all option sets in background threads, and benchmark each of them in the calling thread as soon as it is available
+        std::vector<Candidate> compileAndBench(const TOptionTable& options, int count, int run)
+        {
+            int size = int(options.size());
+            std::vector<llvm_dsp_factory*> factories(size, nullptr);
+            std::vector<bool> compiled(size, false);
+            std::mutex mutex;
+            std::condition_variable cond;
+            std::atomic<int> next(0);
             
-            if (fTrace) printItem(item);
+            auto compile = [&]() {
+                pinThread(1);
+                int index;
+                while ((index = next++) < size) {
+                    std::string error;
+                    llvm_dsp_factory* factory = createFactory(addArgvItems(options[index], fArgc, fArgv), error);
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!factory) {
+                        fprintf(stderr, "Cannot create factory : %s\n", error.c_str());
+                        fError = error;
+                    }
+                    factories[index] = factory;
+                    compiled[index] = true;
+                    cond.notify_all();
+                }
+            };
             
-            res = bench(run);
-            // fDSP is deallocated by bench calling measure_dsp
+            std::vector<std::thread> threads;
+            for (int i = 0; i < std::min<int>(fCompileThreads, size); i++) {
+                threads.push_back(std::thread(compile));
+            }
             
-            deleteDSPFactory(fFactory);
-            fFactory = nullptr;
-            fDSP = nullptr;
+            pinThread(0);
+            std::vector<Candidate> candidates;
+            for (int index = 0; index < size; index++) {
+                Candidate candidate;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cond.wait(lock, [&]() { return bool(compiled[index]); });
+                    candidate.fFactory = factories[index];
+                }
+                if (!candidate.fFactory) continue;
+                candidate.fOptions = options[index];
+                if (benchOne(candidate, count, run)) {
+                    candidates.push_back(candidate);
+                } else {
+                    deleteDSPFactory(candidate.fFactory);
+                }
+            }
             
-            return true;
+            for (auto& thread : threads) thread.join();
+            unpinThread();
+            return candidates;
+        }
+    
+        static bool compareFun(const Candidate& i, const Candidate& j)
+        {
+            return (std::get<0>(i.fRes) > std::get<0>(j.fRes));
         }
     
         std::tuple<double, double, double, TOption> findOptimizedParametersAux(const TOptionTable& options)
         {
-            std::vector<std::tuple<int, double, double, double> > table_res;
-            std::tuple<double, double, double> res = {0., 0., 0.};
+            // First short measure of all candidates
+            int count = std::max<int>(1, fCount / 16);
+            std::vector<Candidate> candidates = compileAndBench(options, count, 1);
+            if (candidates.size() == 0) {
+                throw std::runtime_error("No candidate could be compiled and measured : " + fError);
+            }
             
-            for (int i = 0; i < options.size(); i++) {
-                if (computeOne(addArgvItems(options[i], fArgc, fArgv), fRun, res)) {
-                    table_res.push_back(std::make_tuple(i, std::get<0>(res), std::get<1>(res), std::get<2>(res)));
-                } else {
-                    fprintf(stderr, "computeOne error...\n");
+            // Successive-halving: keep the best half and measure it again with a doubled number of buffers,
+            // until two candidates are left
+            pinThread(0);
+            while (candidates.size() > 2) {
+                std::sort(candidates.begin(), candidates.end(), compareFun);
+                size_t keep = (candidates.size() + 1) / 2;
+                for (size_t i = keep; i < candidates.size(); i++) {
+                    deleteDSPFactory(candidates[i].fFactory);
+                }
+                candidates.resize(keep);
+                if (candidates.size() == 2) break;
+                count = std::min<int>(count * 2, fCount);
+                if (fTrace) fprintf(stdout, "Keep %d candidates, measured on %d buffers\n", int(candidates.size()), count);
+                for (size_t i = 0; i < candidates.size(); i++) {
+                    if (!benchOne(candidates[i], count, 1)) {
+                        candidates[i].fRes = std::make_tuple(0., 0., 0.);
+                    }
                 }
             }
             
-            sort(table_res.begin(), table_res.end(), compareFun);
-            return std::make_tuple(std::get<1>(table_res[0]),
-                                   std::get<2>(table_res[0]),
-                                   std::get<3>(table_res[0]),
-                                   options[std::get<0>(table_res[0])]);
-        }
-
-        static bool compareFun(std::tuple<int, double, double, double> i, std::tuple<int, double, double, double> j)
-        {
-            return (std::get<1>(i) > std::get<1>(j));
+            // The final round, hence the returned result, uses the complete setup
+            if (fTrace) fprintf(stdout, "Keep %d candidates, measured on %d buffers\n", int(candidates.size()), fCount);
+            for (size_t i = 0; i < candidates.size(); i++) {
+                if (!benchOne(candidates[i], fCount, fRun)) {
+                    candidates[i].fRes = std::make_tuple(0., 0., 0.);
+                }
+            }
+            std::sort(candidates.begin(), candidates.end(), compareFun);
+            for (size_t i = 1; i < candidates.size(); i++) {
+                deleteDSPFactory(candidates[i].fFactory);
+            }
+            unpinThread();
+            
+            deleteDSPFactory(candidates[0].fFactory);
+            return std::make_tuple(std::get<0>(candidates[0].fRes),
+                                   std::get<1>(candidates[0].fRes),
+                                   std::get<2>(candidates[0].fRes),
+                                   candidates[0].fOptions);
         }
     
         bool init(const std::string& filename,
@@ -338,14 +608,17 @@ class dsp_optimizer_real {
             fFilter = filter;
             
             init();
+            initCPUs();
             
-            if (fTrace) fprintf(stdout, "Estimate timing parameters\n");
-            std::tuple<double, double, double> res1 = {0., 0., 0.};
-            if (!computeOne(addArgvItems(fScalOptionsTable[1], fArgc, fArgv), 1, res1)) {
-                fprintf(stderr, "computeOne error...\n");
-                return false;
+            fDBFile = getDBFile();
+            if (fDBFile != "") {
+                fDBKey = computeDBKey();
+                std::tuple<double, double, double, TOption> res;
+                // Timing parameters are not needed if the result is already known
+                if (readDB(res)) return true;
             }
-            return true;
+            
+            return estimateCount();
         }
     
     public:
@@ -381,7 +654,7 @@ class dsp_optimizer_real {
                            int filter = 0)
         {
             if (!init(filename, "", argc, argv, target, buffer_size, run, opt_level, trace, control, ds, us, filter)) {
-                throw std::bad_alloc();
+                throw std::runtime_error("Cannot estimate timing parameters : " + fError);
             }
         }
     
@@ -395,81 +668,53 @@ class dsp_optimizer_real {
          */
         std::tuple<double, double, double, TOption> findOptimizedParameters()
         {
-            if (fTrace) fprintf(stdout, "Discover best parameters option\n");
-            std::tuple<double, double, double, TOption> best_scal = findOptimizedParametersAux(fScalOptionsTable);
-            std::tuple<double, double, double, TOption> best_vec = findOptimizedParametersAux(fVecOptionsTable);
-        
-            TOption best_vec_option = std::get<3>(best_vec);
-            if (fTrace) fprintf(stdout, "Refined with -mcd\n");
-            best_vec_option.push_back("-mcd");
-            best_vec_option.push_back("0");
-            TOptionTable refined_vec_table;
-            refined_vec_table.push_back(best_vec_option);
-            for (int size = 2; size <= fBufferSize; size *= 2) {
-                best_vec_option = std::get<3>(best_vec);
-                best_vec_option.push_back("-mcd");
-                best_vec_option.push_back(std::to_string(size));
-                refined_vec_table.push_back(best_vec_option);
-            }
-        
-            best_vec = findOptimizedParametersAux(refined_vec_table);
-            
-            // Compare best scalar and vector modes
             std::tuple<double, double, double, TOption> best_res;
-            if (std::get<0>(best_scal) > std::get<0>(best_vec)) {
-                best_res = best_scal;
-            } else {
-                best_res = best_vec;
+            if (readDB(best_res)) {
+                if (fTrace) fprintf(stdout, "Best parameters found in '%s'\n", fDBFile.c_str());
+                return best_res;
             }
-           
-            // Current best
-            TOptionTable options_table;
-            {
-                TOption best = std::get<3>(best_res);
-                options_table.push_back(best);
+            if (fCount == -1 && !estimateCount()) {
+                throw std::runtime_error("Cannot estimate timing parameters : " + fError);
             }
-        
-            if (std::get<3>(best_res)[0] == "-vec") {
-                if (fTrace) fprintf(stdout, "Check with -ct 0\n");
-                // Add -ct 0
-                {
-                    TOption best = std::get<3>(best_res);
-                    best.push_back("-ct");
-                    best.push_back("0");
-                    options_table.push_back(best);
-                }
-                if (fTrace) fprintf(stdout, "Check with -g or -dfs\n");
-                // Add -g
-                {
-                    TOption best = std::get<3>(best_res);
-                    best.push_back("-g");
-                    options_table.push_back(best);
-                }
-                // Add -dfs
-                {
-                    TOption best = std::get<3>(best_res);
-                    best.push_back("-dfs");
-                    options_table.push_back(best);
-                }
-                // Add -g and -dfs
-                {
-                    TOption best = std::get<3>(best_res);
-                    best.push_back("-g");
-                    best.push_back("-dfs");
-                    options_table.push_back(best);
+            
+            if (fTrace) fprintf(stdout, "Discover best parameters option\n");
+            TOptionTable options_table = fScalOptionsTable;
+            options_table.insert(options_table.end(), fVecOptionsTable.begin(), fVecOptionsTable.end());
+            best_res = findOptimizedParametersAux(options_table);
+            
+            // Refine the best option set with each additional option
+            TOption best = std::get<3>(best_res);
+            bool is_vec = (best[0] == "-vec");
+            options_table.clear();
+            options_table.push_back(best);
+            auto refine = [&](const TOption& added) {
+                TOption item = best;
+                item.insert(item.end(), added.begin(), added.end());
+                options_table.push_back(item);
+            };
+            
+            if (is_vec) {
+                if (fTrace) fprintf(stdout, "Refined with -mcd, -ct 0, -fm, -g or -dfs\n");
+                refine({"-mcd", "0"});
+                for (int size = 2; size <= fBufferSize; size *= 2) {
+                    refine({"-mcd", std::to_string(size)});
                 }
-                return findOptimizedParametersAux(options_table);
+                refine({"-g"});
+                refine({"-dfs"});
+                refine({"-g", "-dfs"});
             } else {
-                if (fTrace) fprintf(stdout, "Check with -ct 0\n");
-                // Add -ct 0
-                {
-                    TOption best = std::get<3>(best_res);
-                    best.push_back("-ct");
-                    best.push_back("0");
-                    options_table.push_back(best);
-                }
-                return findOptimizedParametersAux(options_table);
+                if (fTrace) fprintf(stdout, "Refined with -dlt, -ct 0 or -fm\n");
+                // '-dlt' can only be used in scalar mode
+                refine({"-dlt", "0"});
+                refine({"-dlt", "1024"});
+                refine({"-dlt", "16384"});
             }
+            refine({"-ct", "0"});
+            refine({"-fm", "def"});
+            best_res = findOptimizedParametersAux(options_table);
+            
+            writeDB(best_res);
+            return best_res;
         }
     
         /**
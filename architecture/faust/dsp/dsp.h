@@ -38,6 +38,16 @@
 struct FAUST_API UI;
 struct FAUST_API Meta;
 
+/**
+ * Dated control event, to be used with 'computeEvents'.
+ */
+
+struct FAUST_API dsp_control_event {
+    int fDate;          // date in frames from the beginning of the block
+    FAUSTFLOAT* fZone;  // the control zone, as given in 'buildUserInterface'
+    FAUSTFLOAT fValue;  // the new value
+};
+
 /**
  * DSP memory manager.
  */
@@ -196,6 +206,47 @@ class FAUST_API dsp {
          * @param outputs - the output audio buffers as an array of non-interleaved FAUSTFLOAT samples (either float, double or quad)
          */
         virtual void compute(double /*date_usec*/, int count, FAUSTFLOAT** inputs, FAUSTFLOAT** outputs) { compute(count, inputs, outputs); }
+    
+        /**
+         * DSP instance computation with sample accurate control changes.
+         * This method will be filled with the -cev (--control-events) option, where events are applied inside the sample loop.
+         * The default implementation calls 'compute' on each slice between successive event dates, without allocating:
+         * the 'inputs' and 'outputs' pointer arrays are moved to each slice, and restored before returning.
+         *
+         * @param count - the number of frames to compute
+         * @param inputs - the input audio buffers as an array of non-interleaved FAUSTFLOAT samples (either float, double or quad)
+         * @param outputs - the output audio buffers as an array of non-interleaved FAUSTFLOAT samples (either float, double or quad)
+         * @param nevents - the number of events
+         * @param events - the events sorted by date, events dated after 'count' are applied at the end of the block
+         */
+        virtual void computeEvents(int count, FAUSTFLOAT** inputs, FAUSTFLOAT** outputs, int nevents, const dsp_control_event* events)
+        {
+            int ins = getNumInputs();
+            int outs = getNumOutputs();
+            // The same pointer array may be given for inputs and outputs (in-place compute), it is only moved once
+            if (outputs == inputs) {
+                ins = (ins > outs) ? ins : outs;
+                outs = 0;
+            }
+            int event = 0;
+            int start = 0;
+            while (start < count) {
+                while (event < nevents && events[event].fDate <= start) {
+                    *events[event].fZone = events[event].fValue;
+                    event++;
+                }
+                int end = (event < nevents && events[event].fDate < count) ? events[event].fDate : count;
+                compute(end - start, inputs, outputs);
+                for (int chan = 0; chan < ins; chan++) inputs[chan] += end - start;
+                for (int chan = 0; chan < outs; chan++) outputs[chan] += end - start;
+                start = end;
+            }
+            for (int chan = 0; chan < ins; chan++) inputs[chan] -= start;
+            for (int chan = 0; chan < outs; chan++) outputs[chan] -= start;
+            for (; event < nevents; event++) {
+                *events[event].fZone = events[event].fValue;
+            }
+        }
        
 };
 
@@ -230,6 +281,7 @@ class FAUST_API decorator_dsp : public dsp {
         virtual void frame(FAUSTFLOAT* inputs, FAUSTFLOAT* outputs) { fDSP->frame(inputs, outputs); }
         virtual void compute(int count, FAUSTFLOAT** inputs, FAUSTFLOAT** outputs) { fDSP->compute(count, inputs, outputs); }
         virtual void compute(double date_usec, int count, FAUSTFLOAT** inputs, FAUSTFLOAT** outputs) { fDSP->compute(date_usec, count, inputs, outputs); }
+        virtual void computeEvents(int count, FAUSTFLOAT** inputs, FAUSTFLOAT** outputs, int nevents, const dsp_control_event* events) { fDSP->computeEvents(count, inputs, outputs, nevents, events); }
     
 };
 
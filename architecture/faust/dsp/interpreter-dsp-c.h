@@ -186,13 +186,48 @@ extern "C"
      */
     LIBFAUST_API void stopMTDSPFactories();
 
+    /**
+     * Set the directory of the persistent cache of compiled factories, shared by the Interpreter,
+     * WebAssembly and LLVM backends (and by all processes using the same directory).
+     * A factory created again from the same DSP code, compilation options and backend is then loaded
+     * from its saved compiled code instead of being compiled. If the DSP code or an imported library
+     * has been modified, but the evaluated DSP is the same, only the parsing and evaluation steps are
+     * done again. Parsed libraries and evaluation results are not cached, only the code
+     * generated after evaluation is. The cache can also be activated by setting the FAUST_CACHE_DIR
+     * environment variable.
+     *
+     * @param path - the cache directory (created if needed), an empty string or a null pointer deactivates the cache
+     *
+     * @return true if the cache directory can be used.
+     */
+    LIBFAUST_API bool setDSPFactoryCacheDirectory(const char* path);
+
+    /**
+     * Set the maximum size of the cache directory (see setDSPFactoryCacheDirectory). When a new factory is saved,
+     * the least recently used ones are removed first. The size can also be set with the FAUST_CACHE_SIZE
+     * environment variable (in bytes).
+     *
+     * @param size - the maximum size in bytes, 0 means unbounded
+     */
+    LIBFAUST_API void setDSPFactoryCacheDirectorySize(size_t size);
+
+    /**
+     * Set the maximum size of the compiled factories kept in memory by the cache (see setDSPFactoryCacheDirectory),
+     * which can be used alone in a long running process. The least recently used factories are removed first.
+     * The memory cache can also be activated by setting the FAUST_CACHE_MEMORY environment variable (in bytes).
+     *
+     * @param size - the maximum size in bytes, 0 deactivates the memory cache
+     */
+    LIBFAUST_API void setDSPFactoryCacheMemorySize(size_t size);
+
     /**
      * Create a Faust DSP factory from a bitcode string. Note that the library keeps an internal cache of all
      * allocated factories so that the compilation of the same DSP code (that is the same bitcode code string) will return
      * the same (reference counted) factory pointer. You will have to explicitly use deleteInterpreterDSPFactory to properly
      * decrement reference counter when the factory is no more needed.
      *
-     * @param bitcode - the bitcode string
+     * @param bitcode - the bitcode string, in text format only: the binary format contains null characters,
+     * so it has to be loaded with readCInterpreterDSPFactoryFromBitcodeFile
      * @param error_msg - the error string to be filled, has to be 4096 characters long
      *
      * @return the DSP factory on success, otherwise a null pointer.
@@ -200,7 +235,7 @@ extern "C"
     LIBFAUST_API interpreter_dsp_factory* readCInterpreterDSPFactoryFromBitcode(const char* bitcode, char* error_msg);
 
     /**
-     * Write a Faust DSP factory into a bitcode string.
+     * Write a Faust DSP factory into a bitcode string (in text format).
      *
      * @param factory - the DSP factory
      *
@@ -214,7 +249,7 @@ extern "C"
      * the same (reference counted) factory pointer. You will have to explicitly use deleteInterpreterDSPFactory to properly
      * decrement reference counter when the factory is no more needed.
      *
-     * @param bit_code_path - the bitcode file pathname
+     * @param bit_code_path - the bitcode file pathname, in text or binary format
      * @param error_msg - the error string to be filled, has to be 4096 characters long
      *
      * @return the DSP factory on success, otherwise a null pointer.
@@ -222,7 +257,7 @@ extern "C"
     LIBFAUST_API interpreter_dsp_factory* readCInterpreterDSPFactoryFromBitcodeFile(const char* bit_code_path, char* error_msg);
 
     /**
-     * Write a Faust DSP factory into a bitcode file.
+     * Write a Faust DSP factory into a bitcode file (in binary format, loaded without parsing).
      *
      * @param factory - the DSP factory
      * @param bit_code_path - the bitcode file pathname
@@ -37,6 +37,16 @@ architecture section is not modified.
 #include <float.h>
 #include <assert.h>
 
+#ifndef EMCC
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+#endif
+
 #include "faust/midi/midi.h"
 #include "faust/dsp/dsp-combiner.h"
 #include "faust/dsp/dsp-adapter.h"
@@ -176,6 +186,9 @@ struct dsp_voice : public MapUI, public decorator_dsp {
     std::vector<std::string> fGatePath; // Paths of 'gate' control
     std::vector<std::string> fGainPath; // Paths of 'gain/vel|velocity' control
     std::vector<std::string> fFreqPath; // Paths of 'freq/key' control
+    std::vector<FAUSTFLOAT*> fGateZone; // Zones of 'gate' control, resolved once to be used in the audio thread
+    std::vector<FAUSTFLOAT*> fGainZone; // Zones of 'gain/vel|velocity' control
+    std::vector<FAUSTFLOAT*> fFreqZone; // Zones of 'freq/key' control
     TransformFunction        fKeyFun;   // MIDI key to freq conversion function
     TransformFunction        fVelFun;   // MIDI velocity to gain conversion function
     
@@ -194,6 +207,9 @@ struct dsp_voice : public MapUI, public decorator_dsp {
         fDate = fRelease = 0;
         fReleaseLengthSec = 0.5;  // A half second is a reasonable default maximum release length.
         extractPaths(fGatePath, fFreqPath, fGainPath);
+        extractZones(fGatePath, fGateZone);
+        extractZones(fFreqPath, fFreqZone);
+        extractZones(fGainPath, fGainZone);
     }
     virtual ~dsp_voice()
     {}
@@ -218,8 +234,8 @@ struct dsp_voice : public MapUI, public decorator_dsp {
         int slice = count/2;
         
         // Reset envelops
-        for (size_t i = 0; i < fGatePath.size(); i++) {
-            setParamValue(fGatePath[i], FAUSTFLOAT(0));
+        for (size_t i = 0; i < fGateZone.size(); i++) {
+            *fGateZone[i] = FAUSTFLOAT(0);
         }
         
         // Compute current voice on half buffer
@@ -256,6 +272,14 @@ struct dsp_voice : public MapUI, public decorator_dsp {
         }
     }
     
+    // Resolve control paths to zones
+    void extractZones(const std::vector<std::string>& paths, std::vector<FAUSTFLOAT*>& zones)
+    {
+        for (const auto& it : paths) {
+            zones.push_back(getParamZone(it));
+        }
+    }
+    
     // Reset voice
     void reset()
     {
@@ -286,14 +310,14 @@ struct dsp_voice : public MapUI, public decorator_dsp {
     // KeyOn with normalized MIDI velocity [0..1]
     void keyOn(int pitch, double velocity)
     {
-        for (size_t i = 0; i < fFreqPath.size(); i++) {
-            setParamValue(fFreqPath[i], fKeyFun(pitch));
+        for (size_t i = 0; i < fFreqZone.size(); i++) {
+            *fFreqZone[i] = FAUSTFLOAT(fKeyFun(pitch));
         }
-        for (size_t i = 0; i < fGatePath.size(); i++) {
-            setParamValue(fGatePath[i], FAUSTFLOAT(1));
+        for (size_t i = 0; i < fGateZone.size(); i++) {
+            *fGateZone[i] = FAUSTFLOAT(1);
         }
-        for (size_t i = 0; i < fGainPath.size(); i++) {
-            setParamValue(fGainPath[i], velocity);
+        for (size_t i = 0; i < fGainZone.size(); i++) {
+            *fGainZone[i] = FAUSTFLOAT(velocity);
         }
         
         fCurNote = pitch;
@@ -302,8 +326,8 @@ struct dsp_voice : public MapUI, public decorator_dsp {
     void keyOff(bool hard = false)
     {
         // No use of velocity for now...
-        for (size_t i = 0; i < fGatePath.size(); i++) {
-            setParamValue(fGatePath[i], FAUSTFLOAT(0));
+        for (size_t i = 0; i < fGateZone.size(); i++) {
+            *fGateZone[i] = FAUSTFLOAT(0);
         }
         
         if (hard) {
@@ -531,6 +555,138 @@ class dsp_poly : public decorator_dsp, public midi, public JSONControl {
     
 };
 
+#ifndef EMCC
+/**
+ * A pool of real-time worker threads used to render voices in parallel.
+ *
+ * Each call to 'run' distributes 'fTaskCount' tasks on the workers and the calling thread:
+ * worker 'w' (the calling thread being worker 0) always gets the contiguous range of tasks
+ * [w * count / fNumWorkers, (w + 1) * count / fNumWorkers), so that the partition only depends
+ * on the number of tasks, and the results can be reduced in a deterministic order.
+ *
+ * Workers spin for a while waiting for the next cycle, then park on a condition variable.
+ */
+class dsp_voice_pool {
+
+    public:
+    
+        typedef void (*WorkerFun)(void* arg, int worker, int first, int last);
+
+    private:
+    
+        std::thread** fThreads;
+        int fNumWorkers;    // Number of workers, including the calling thread
+    
+        std::mutex fMutex;
+        std::condition_variable fCond;
+        std::atomic<int> fCycle;
+        std::atomic<int> fPending;
+        std::atomic<bool> fRunning;
+    
+        WorkerFun fFun;
+        void* fArg;
+        int fTaskCount;
+    
+        void runRange(int worker)
+        {
+            int first = (worker * fTaskCount) / fNumWorkers;
+            int last = ((worker + 1) * fTaskCount) / fNumWorkers;
+            fFun(fArg, worker, first, last);
+        }
+    
+        void workerLoop(int worker)
+        {
+            AVOIDDENORMALS;
+            int cycle = 0;
+            while (true) {
+                // Spin then park until next cycle
+                int spin = 0;
+                while (fCycle.load(std::memory_order_acquire) == cycle && fRunning) {
+                    if (++spin > 10000) {
+                        std::unique_lock<std::mutex> lock(fMutex);
+                        fCond.wait(lock, [=] { return fCycle.load(std::memory_order_acquire) != cycle || !fRunning; });
+                    }
+                }
+                if (!fRunning) return;
+                cycle = fCycle.load(std::memory_order_acquire);
+                runRange(worker);
+                fPending.fetch_sub(1, std::memory_order_release);
+            }
+        }
+    
+        void setRealTime(std::thread* thread)
+        {
+        #ifndef _WIN32
+            struct sched_param param;
+            memset(&param, 0, sizeof(param));
+            param.sched_priority = 60;
+            if (pthread_setschedparam(thread->native_handle(), SCHED_FIFO, &param) != 0) {
+                fprintf(stderr, "dsp_voice_pool : cannot set real-time scheduling, keep default priority\n");
+            }
+        #endif
+        }
+
+    public:
+    
+        /**
+         * Constructor.
+         *
+         * @param num_workers - the number of workers, including the calling thread (so num_workers - 1 threads are created)
+         * @param realtime - whether to try to give workers a real-time priority
+         */
+        dsp_voice_pool(int num_workers, bool realtime = true)
+        :fNumWorkers(std::max(1, num_workers)), fCycle(0), fPending(0), fRunning(true),
+        fFun(nullptr), fArg(nullptr), fTaskCount(0)
+        {
+            fThreads = new std::thread*[fNumWorkers];
+            fThreads[0] = nullptr;
+            for (int i = 1; i < fNumWorkers; i++) {
+                fThreads[i] = new std::thread(&dsp_voice_pool::workerLoop, this, i);
+                if (realtime) setRealTime(fThreads[i]);
+            }
+        }
+    
+        virtual ~dsp_voice_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(fMutex);
+                fRunning = false;
+            }
+            fCond.notify_all();
+            for (int i = 1; i < fNumWorkers; i++) {
+                fThreads[i]->join();
+                delete fThreads[i];
+            }
+            delete [] fThreads;
+        }
+    
+        int getNumWorkers() { return fNumWorkers; }
+    
+        // Run 'count' tasks with 'fun' on all workers, returns when all tasks are done
+        void run(WorkerFun fun, void* arg, int count)
+        {
+            fFun = fun;
+            fArg = arg;
+            fTaskCount = count;
+            fPending.store(fNumWorkers - 1, std::memory_order_relaxed);
+            {
+                // Lock only protects parked workers from missing the wake-up
+                std::lock_guard<std::mutex> lock(fMutex);
+                fCycle.fetch_add(1, std::memory_order_release);
+            }
+            fCond.notify_all();
+        
+            // The calling thread is worker 0
+            runRange(0);
+        
+            while (fPending.load(std::memory_order_acquire) > 0) {
+                std::this_thread::yield();
+            }
+        }
+
+};
+#endif
+
 /**
  * Polyphonic DSP: groups a set of DSP to be played together or triggered by MIDI.
  *
@@ -546,6 +702,16 @@ class mydsp_poly : public dsp_voice_group, public dsp_poly {
         midi_interface* fMidiHandler;   // The midi_interface the DSP is connected to
         int fDate;                      // Current date for managing voices
     
+    #ifndef EMCC
+        dsp_voice_pool* fVoicePool;     // Worker pool used in parallel voice mode
+        bool fVoicePoolRealTime;        // Whether workers use a real-time priority
+        FAUSTFLOAT*** fWorkerMixBuffer; // Intermediate mixing buffers, one per worker
+        FAUSTFLOAT*** fWorkerOutBuffer; // Intermediate output buffers, one per worker
+        std::vector<dsp_voice*> fActiveVoices;  // Voices to render in the current cycle
+        FAUSTFLOAT** fInputs;           // Inputs of the current cycle
+        int fCount;                     // Size of the current cycle
+    #endif
+    
         // Fade out the audio in the buffer
         void fadeOut(int count, FAUSTFLOAT** outBuffer)
         {
@@ -602,6 +768,79 @@ class mydsp_poly : public dsp_voice_group, public dsp_poly {
             }
         }
     
+        // Compute one controlled voice and mix it in outBuffer
+        void computeVoice(dsp_voice* voice, int count, FAUSTFLOAT** inputs, FAUSTFLOAT** mixBuffer, FAUSTFLOAT** outBuffer)
+        {
+            if (voice->fCurNote == kLegatoVoice) {
+                // Play from current note and next note
+                voice->computeLegato(count, inputs, mixBuffer);
+                // FadeOut on first half buffer
+                fadeOut(count/2, mixBuffer);
+                // Mix it in result
+                voice->fLevel = mixCheckVoice(count, mixBuffer, outBuffer);
+            } else if (voice->fCurNote != kFreeVoice) {
+                // Compute current note
+                voice->compute(count, inputs, mixBuffer);
+                // Mix it in result
+                voice->fLevel = mixCheckVoice(count, mixBuffer, outBuffer);
+                // Check the level to possibly set the voice in kFreeVoice again
+                voice->fRelease -= count;
+                if ((voice->fCurNote == kReleaseVoice)
+                    && (voice->fRelease < 0)
+                    && (voice->fLevel < VOICE_STOP_LEVEL)) {
+                    voice->fCurNote = kFreeVoice;
+                }
+            }
+        }
+    
+    #ifndef EMCC
+        // Compute the [first, last) range of active voices in the worker buffers
+        static void computeWorker(void* arg, int worker, int first, int last)
+        {
+            mydsp_poly* poly = static_cast<mydsp_poly*>(arg);
+            FAUSTFLOAT** mixBuffer = poly->fWorkerMixBuffer[worker];
+            FAUSTFLOAT** outBuffer = poly->fWorkerOutBuffer[worker];
+            poly->clear(poly->fCount, outBuffer);
+            for (int i = first; i < last; i++) {
+                dsp_voice* voice = poly->fActiveVoices[i];
+                if (poly->fVoiceControl) {
+                    poly->computeVoice(voice, poly->fCount, poly->fInputs, mixBuffer, outBuffer);
+                } else {
+                    voice->compute(poly->fCount, poly->fInputs, mixBuffer);
+                    poly->mixVoice(poly->fCount, mixBuffer, outBuffer);
+                }
+            }
+        }
+    
+        // Compute active voices on all workers, then reduce the worker buffers in worker order
+        void computeParallel(int count)
+        {
+            fVoicePool->run(computeWorker, this, int(fActiveVoices.size()));
+            for (int worker = 1; worker < fVoicePool->getNumWorkers(); worker++) {
+                mixVoice(count, fWorkerOutBuffer[worker], fOutBuffer);
+            }
+        }
+    
+        void deleteWorkerBuffers()
+        {
+            if (!fVoicePool) return;
+            // Worker 0 uses fMixBuffer/fOutBuffer
+            for (int worker = 1; worker < fVoicePool->getNumWorkers(); worker++) {
+                for (int chan = 0; chan < getNumOutputs(); chan++) {
+                    delete[] fWorkerMixBuffer[worker][chan];
+                    delete[] fWorkerOutBuffer[worker][chan];
+                }
+                delete[] fWorkerMixBuffer[worker];
+                delete[] fWorkerOutBuffer[worker];
+            }
+            delete[] fWorkerMixBuffer;
+            delete[] fWorkerOutBuffer;
+            delete fVoicePool;
+            fVoicePool = nullptr;
+            fWorkerMixBuffer = fWorkerOutBuffer = nullptr;
+        }
+    #endif
+    
         // Get the index of a voice currently playing a specific pitch
         int getPlayingVoice(int pitch)
         {
@@ -722,6 +961,13 @@ class mydsp_poly : public dsp_voice_group, public dsp_poly {
         {
             fDate = 0;
             fMidiHandler = nullptr;
+        #ifndef EMCC
+            fVoicePool = nullptr;
+            fVoicePoolRealTime = true;
+            fWorkerMixBuffer = fWorkerOutBuffer = nullptr;
+            fInputs = nullptr;
+            fCount = 0;
+        #endif
 
             // Create voices
             assert(nvoices > 0);
@@ -744,6 +990,9 @@ class mydsp_poly : public dsp_voice_group, public dsp_poly {
         {
             // Remove from fMidiHandler
             if (fMidiHandler) fMidiHandler->removeMidiIn(this);
+        #ifndef EMCC
+            deleteWorkerBuffers();
+        #endif
             for (int chan = 0; chan < getNumOutputs(); chan++) {
                 delete[] fMixBuffer[chan];
                 delete[] fOutBuffer[chan];
@@ -817,8 +1066,53 @@ class mydsp_poly : public dsp_voice_group, public dsp_poly {
 
         virtual mydsp_poly* clone()
         {
-            return new mydsp_poly(fDSP->clone(), int(fVoiceTable.size()), fVoiceControl, fGroupControl);
+            mydsp_poly* poly = new mydsp_poly(fDSP->clone(), int(fVoiceTable.size()), fVoiceControl, fGroupControl);
+        #ifndef EMCC
+            if (fVoicePool) poly->setNumThreads(fVoicePool->getNumWorkers(), fVoicePoolRealTime);
+        #endif
+            return poly;
+        }
+    
+    #ifndef EMCC
+        /**
+         * Activate the parallel voice mode: active voices are distributed on 'num_threads' workers
+         * (the audio thread being one of them), each one mixing its voices in its own buffer,
+         * the worker buffers being finally summed in a fixed order.
+         * Must not be called while 'compute' is running.
+         *
+         * @param num_threads - the number of workers, 1 (the default) to go back to serial mode,
+         *                      0 to use all available cores
+         * @param realtime - whether to try to give workers a real-time priority
+         */
+        void setNumThreads(int num_threads, bool realtime = true)
+        {
+            deleteWorkerBuffers();
+            if (num_threads == 0) {
+                num_threads = std::max(1, int(std::thread::hardware_concurrency()));
+            }
+            // No need for more workers than voices
+            num_threads = std::min(num_threads, int(fVoiceTable.size()));
+            if (num_threads <= 1) return;
+        
+            fVoicePoolRealTime = realtime;
+            fVoicePool = new dsp_voice_pool(num_threads, realtime);
+            fActiveVoices.reserve(fVoiceTable.size());
+            fWorkerMixBuffer = new FAUSTFLOAT**[num_threads];
+            fWorkerOutBuffer = new FAUSTFLOAT**[num_threads];
+            fWorkerMixBuffer[0] = fMixBuffer;
+            fWorkerOutBuffer[0] = fOutBuffer;
+            for (int worker = 1; worker < num_threads; worker++) {
+                fWorkerMixBuffer[worker] = new FAUSTFLOAT*[getNumOutputs()];
+                fWorkerOutBuffer[worker] = new FAUSTFLOAT*[getNumOutputs()];
+                for (int chan = 0; chan < getNumOutputs(); chan++) {
+                    fWorkerMixBuffer[worker][chan] = new FAUSTFLOAT[MIX_BUFFER_SIZE];
+                    fWorkerOutBuffer[worker][chan] = new FAUSTFLOAT[MIX_BUFFER_SIZE];
+                }
+            }
         }
+    
+        int getNumThreads() { return (fVoicePool) ? fVoicePool->getNumWorkers() : 1; }
+    #endif
 
         void compute(int count, FAUSTFLOAT** inputs, FAUSTFLOAT** outputs)
         {
@@ -827,30 +1121,32 @@ class mydsp_poly : public dsp_voice_group, public dsp_poly {
             // First clear the intermediate fOutBuffer
             clear(count, fOutBuffer);
 
+        #ifndef EMCC
+            if (fVoicePool) {
+                // Collect voices to be rendered, the order of fVoiceTable is kept
+                fActiveVoices.clear();
+                for (size_t i = 0; i < fVoiceTable.size(); i++) {
+                    if (!fVoiceControl || fVoiceTable[i]->fCurNote != kFreeVoice) {
+                        fActiveVoices.push_back(fVoiceTable[i]);
+                    }
+                }
+                fInputs = inputs;
+                fCount = count;
+                if (fActiveVoices.size() > 1) {
+                    computeParallel(count);
+                } else if (fActiveVoices.size() == 1) {
+                    computeWorker(this, 0, 0, 1);
+                }
+                // Finally copy intermediate buffer to outputs
+                copy(count, fOutBuffer, outputs);
+                return;
+            }
+        #endif
+        
             if (fVoiceControl) {
                 // Mix all playing voices
                 for (size_t i = 0; i < fVoiceTable.size(); i++) {
-                    dsp_voice* voice = fVoiceTable[i];
-                    if (voice->fCurNote == kLegatoVoice) {
-                        // Play from current note and next note
-                        voice->computeLegato(count, inputs, fMixBuffer);
-                        // FadeOut on first half buffer
-                        fadeOut(count/2, fMixBuffer);
-                        // Mix it in result
-                        voice->fLevel = mixCheckVoice(count, fMixBuffer, fOutBuffer);
-                    } else if (voice->fCurNote != kFreeVoice) {
-                        // Compute current note
-                        voice->compute(count, inputs, fMixBuffer);
-                        // Mix it in result
-                        voice->fLevel = mixCheckVoice(count, fMixBuffer, fOutBuffer);
-                        // Check the level to possibly set the voice in kFreeVoice again
-                        voice->fRelease -= count;
-                        if ((voice->fCurNote == kReleaseVoice)
-                            && (voice->fRelease < 0)
-                            && (voice->fLevel < VOICE_STOP_LEVEL)) {
-                            voice->fCurNote = kFreeVoice;
-                        }
-                    }
+                    computeVoice(fVoiceTable[i], count, inputs, fMixBuffer, fOutBuffer);
                 }
             } else {
                 // Mix all voices
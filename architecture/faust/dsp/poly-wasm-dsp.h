@@ -150,7 +150,7 @@ wasm_dsp_poly_factory* wasm_dsp_poly_factory::createWasmPolyDSPFactoryFromString
     argv1[argc1] = nullptr;  // NULL terminated argv
     
     wasm_dsp_poly_factory* factory = createWasmPolyDSPFactoryFromString(name_app, dsp_content, argc1, argv1,
-                                                                        wasm_dsp_factory::gErrorMessage, internal_memory);
+                                                                        getWasmErrorMessage(), internal_memory);
     return factory;
 }
 
@@ -26,6 +26,7 @@ architecture section is not modified.
 #define __timed_dsp__
 
 #include <set>
+#include <vector>
 #include <float.h>
 #include <assert.h>
 
@@ -138,22 +139,8 @@ class timed_dsp : public decorator_dsp {
         bool fFirstCallback;
         ZoneUI fZoneUI;
     
-        FAUSTFLOAT** fInputsSlice;
-        FAUSTFLOAT** fOutputsSlice;
+        std::vector<dsp_control_event> fEvents;
     
-        void computeSlice(int offset, int slice, FAUSTFLOAT** inputs, FAUSTFLOAT** outputs) 
-        {
-            if (slice > 0) {
-                for (int chan = 0; chan < fDSP->getNumInputs(); chan++) {
-                    fInputsSlice[chan] = &(inputs[chan][offset]);
-                }
-                for (int chan = 0; chan < fDSP->getNumOutputs(); chan++) {
-                    fOutputsSlice[chan] = &(outputs[chan][offset]);
-                }
-                fDSP->compute(slice, fInputsSlice, fOutputsSlice);
-            } 
-        }
-        
         double convertUsecToSample(double usec)
         {
             return std::max<double>(0., (double(getSampleRate()) * (usec - fDateUsec)) / 1000000.);
@@ -185,48 +172,41 @@ class timed_dsp : public decorator_dsp {
         
         virtual void computeAux(int count, FAUSTFLOAT** inputs, FAUSTFLOAT** outputs, bool convert_ts)
         {
-            int slice, offset = 0;
             ztimedmap::iterator it;
             DatedControl next_control;
+            fEvents.clear();
              
-            // Do audio computation "slice" by "slice"
-            while ((it = getNextControl(next_control)) != GUI::gTimedZoneMap.end()) {
+            // Collect the dated controls in date order, without allocating: the ones that do not fit stay in their ringbuffer until the next block
+            while (fEvents.size() < fEvents.capacity() && (it = getNextControl(next_control)) != GUI::gTimedZoneMap.end()) {
                 
                 // If needed, convert next_control in samples from begining of the buffer, possible moving to 0 (if negative)
                 if (convert_ts) {
                     next_control.fDate = convertUsecToSample(next_control.fDate);
                 }
-                     
-                // Compute audio slice
-                slice = int(next_control.fDate) - offset;
-                computeSlice(offset, slice, inputs, outputs);
-                offset += slice;
-               
-                // Update control
-                ringbuffer_t* control_values = (*it).second;
-                *((*it).first) = next_control.fValue;
+                
+                dsp_control_event event;
+                event.fDate = int(next_control.fDate);
+                event.fZone = (*it).first;
+                event.fValue = next_control.fValue;
+                fEvents.push_back(event);
                 
                 // Move ringbuffer pointer
-                ringbuffer_read_advance(control_values, sizeof(DatedControl));
-            } 
+                ringbuffer_read_advance((*it).second, sizeof(DatedControl));
+            }
             
-            // Compute last audio slice
-            slice = count - offset;
-            computeSlice(offset, slice, inputs, outputs);
+            // A single call, the DSP applies the events at their date (inside its loop if compiled with -cev)
+            fDSP->computeEvents(count, inputs, outputs, int(fEvents.size()), fEvents.data());
         }
 
     public:
 
         timed_dsp(dsp* dsp):decorator_dsp(dsp), fDateUsec(0), fOffsetUsec(0), fFirstCallback(true)
         {
-            fInputsSlice = new FAUSTFLOAT*[dsp->getNumInputs()];
-            fOutputsSlice = new FAUSTFLOAT*[dsp->getNumOutputs()];
+            // Maximum number of events applied in a block, so that the audio thread does not allocate
+            fEvents.reserve(1024);
         }
         virtual ~timed_dsp() 
-        {
-            delete [] fInputsSlice;
-            delete [] fOutputsSlice;
-        }
+        {}
         
         virtual void init(int sample_rate)
         {
@@ -220,6 +220,40 @@ LIFAUST_API void deleteAllWasmDSPFactories();
  */
 LIFAUST_API std::vector<std::string> getAllWasmDSPFactories();
 
+/**
+ * Set the directory of the persistent cache of compiled factories, shared by the Interpreter,
+ * WebAssembly and LLVM backends (and by all processes using the same directory).
+ * A factory created again from the same DSP code, compilation options and backend is then loaded
+ * from its saved compiled code instead of being compiled. If the DSP code or an imported library
+ * has been modified, but the evaluated DSP is the same, only the parsing and evaluation steps are
+ * done again. Parsed libraries and evaluation results are not cached, only the code
+ * generated after evaluation is. The cache can also be activated by setting the FAUST_CACHE_DIR
+ * environment variable.
+ *
+ * @param path - the cache directory (created if needed), an empty string or a null pointer deactivates the cache
+ *
+ * @return true if the cache directory can be used.
+ */
+extern "C" LIFAUST_API bool setDSPFactoryCacheDirectory(const char* path);
+
+/**
+ * Set the maximum size of the cache directory (see setDSPFactoryCacheDirectory). When a new factory is saved,
+ * the least recently used ones are removed first. The size can also be set with the FAUST_CACHE_SIZE
+ * environment variable (in bytes).
+ *
+ * @param size - the maximum size in bytes, 0 means unbounded
+ */
+extern "C" LIFAUST_API void setDSPFactoryCacheDirectorySize(size_t size);
+
+/**
+ * Set the maximum size of the compiled factories kept in memory by the cache (see setDSPFactoryCacheDirectory),
+ * which can be used alone in a long running process. The least recently used factories are removed first.
+ * The memory cache can also be activated by setting the FAUST_CACHE_MEMORY environment variable (in bytes).
+ *
+ * @param size - the maximum size in bytes, 0 deactivates the memory cache
+ */
+extern "C" LIFAUST_API void setDSPFactoryCacheMemorySize(size_t size);
+
 /**
  * Create a Faust DSP factory from a machine code string. Note that the library keeps an internal cache of all
  * allocated factories so that the compilation of the same DSP code (that is the same machine code string) will return
@@ -30,6 +30,7 @@ architecture section is not modified.
 #include <vector>
 #include <stdio.h>
 #include <map>
+#include <unordered_map>
 #include <cstring>
 
 #include "faust/gui/meta.h"
@@ -76,6 +77,9 @@ class APIUI : public PathBuilder, public Meta, public UI
             {}
         };
         std::vector<Item> fItems;
+    
+        // label/shortname/path to index, the first matching item wins
+        std::unordered_map<std::string, int> fIndexMap;
 
         std::vector<std::map<std::string, std::string> > fMetaData;
         std::vector<ZoneControl*> fAcc[3];
@@ -124,6 +128,8 @@ class APIUI : public PathBuilder, public Meta, public UI
             }
             fCurrentScale = kLin;
 
+            fIndexMap.emplace(label, int(fItems.size()));
+            fIndexMap.emplace(path, int(fItems.size()));
             fItems.push_back(Item(label, "", path, converter, zone, init, min, max, step, type));
        
             if (fCurrentAcc.size() > 0 && fCurrentGyr.size() > 0) {
@@ -283,9 +289,15 @@ class APIUI : public PathBuilder, public Meta, public UI
                 // Shortnames can be computed when all fullnames are known
                 computeShortNames();
                 // Fill 'shortname' field for each item
-                for (const auto& it : fFull2Short) {
-                    int index = getParamIndex(it.first.c_str());
-                    fItems[index].fShortname = it.second;
+                for (auto& it : fItems) {
+                    it.fShortname = fFull2Short[it.fPath];
+                }
+                // Rebuild the index map, keeping the items order
+                fIndexMap.clear();
+                for (size_t i = 0; i < fItems.size(); i++) {
+                    fIndexMap.emplace(fItems[i].fLabel, int(i));
+                    fIndexMap.emplace(fItems[i].fShortname, int(i));
+                    fIndexMap.emplace(fItems[i].fPath, int(i));
                 }
             }
         }
@@ -384,10 +396,8 @@ class APIUI : public PathBuilder, public Meta, public UI
          */
         int getParamIndex(const char* str)
         {
-            std::string path = std::string(str);
-            auto it = find_if(fItems.begin(), fItems.end(),
-                              [=](const Item& it) { return (it.fLabel == path) || (it.fShortname == path) || (it.fPath == path); });
-            return (it != fItems.end()) ? int(it - fItems.begin()) : -1;
+            const auto it = fIndexMap.find(str);
+            return (it != fIndexMap.end()) ? it->second : -1;
         }
     
         /**
@@ -27,6 +27,7 @@
 
 #include <list>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <assert.h>
 
@@ -109,7 +110,7 @@ static void deleteClist(clist* cl);
 /**
  * A list containing all groupe uiItemBase objects.
  */
-struct clist : public std::list<uiItemBase*>
+struct clist : public std::vector<uiItemBase*>
 {
     
     virtual ~clist()
@@ -121,7 +122,20 @@ struct clist : public std::list<uiItemBase*>
 
 static void createUiCallbackItem(GUI* ui, FAUSTFLOAT* zone, uiCallback foo, void* data);
 
-typedef std::map<FAUSTFLOAT*, clist*> zmap;
+/**
+ * A zone with its items, and the last value propagated to them.
+ */
+struct zentry
+{
+    FAUSTFLOAT* fZone;
+    FAUSTFLOAT fValue;
+    bool fDirty;
+    clist* fItems;
+    
+    zentry(FAUSTFLOAT* zone):fZone(zone), fValue(*zone), fDirty(true), fItems(new clist()) {}
+};
+
+typedef std::vector<zentry> ztable;
 
 typedef std::map<FAUSTFLOAT*, ringbuffer_t*> ztimedmap;
 
@@ -131,9 +145,26 @@ class GUI : public UI
     private:
      
         static std::list<GUI*> fGuiList;
-        zmap fZoneMap;
+    
+        // Zones are kept in a contiguous table scanned by updateAllZones,
+        // and only the ones whose value has changed are propagated to their items
+        ztable fZoneTable;
+        std::unordered_map<FAUSTFLOAT*, size_t> fZoneIndex;
         bool fStopped;
     
+        // Items are accessed by index, since reflectZone may register new items
+        void updateEntry(size_t index)
+        {
+            FAUSTFLOAT v = *fZoneTable[index].fZone;
+            fZoneTable[index].fValue = v;
+            fZoneTable[index].fDirty = false;
+            clist* cl = fZoneTable[index].fItems;
+            for (size_t i = 0; i < cl->size(); i++) {
+                uiItemBase* c = (*cl)[i];
+                if (c->cache() != v) c->reflectZone();
+            }
+        }
+    
      public:
             
         GUI():fStopped(false)
@@ -144,8 +175,8 @@ class GUI : public UI
         virtual ~GUI() 
         {   
             // delete all items
-            for (const auto& it : fZoneMap) {
-                delete it.second;
+            for (const auto& it : fZoneTable) {
+                delete it.fItems;
             }
             // suppress 'this' in static fGuiList
             fGuiList.remove(this);
@@ -155,23 +186,28 @@ class GUI : public UI
         
         void registerZone(FAUSTFLOAT* z, uiItemBase* c)
         {
-            if (fZoneMap.find(z) == fZoneMap.end()) fZoneMap[z] = new clist();
-            fZoneMap[z]->push_back(c);
+            auto it = fZoneIndex.find(z);
+            if (it == fZoneIndex.end()) {
+                it = fZoneIndex.insert(std::make_pair(z, fZoneTable.size())).first;
+                fZoneTable.push_back(zentry(z));
+            }
+            zentry& entry = fZoneTable[it->second];
+            entry.fItems->push_back(c);
+            // The new item has to be reflected at next update
+            entry.fDirty = true;
         }
     
         void updateZone(FAUSTFLOAT* z)
         {
-            FAUSTFLOAT v = *z;
-            clist* cl = fZoneMap[z];
-            for (const auto& c : *cl) {
-                if (c->cache() != v) c->reflectZone();
-            }
+            const auto it = fZoneIndex.find(z);
+            if (it != fZoneIndex.end()) updateEntry(it->second);
         }
     
         void updateAllZones()
         {
-            for (const auto& m : fZoneMap) {
-                updateZone(m.first);
+            for (size_t i = 0; i < fZoneTable.size(); i++) {
+                const zentry& entry = fZoneTable[i];
+                if (entry.fDirty || *entry.fZone != entry.fValue) updateEntry(i);
             }
         }
     
@@ -27,6 +27,7 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <utility>
 #include <cstdlib>
 #include <sstream>
@@ -93,6 +94,8 @@ struct FAUST_API JSONUIDecoderBase
     virtual bool hasDSPProxy() = 0;
     virtual std::vector<ExtZoneParam*>& getInputControls() = 0;
     virtual std::vector<ExtZoneParam*>& getOutputControls() = 0;
+    virtual int getInputControlIndex(const std::string& path) = 0;
+    virtual int getOutputControlIndex(const std::string& path) = 0;
     virtual void resetUserInterface() = 0;
     virtual void resetUserInterface(char* memory_block, Soundfile* defaultsound = nullptr) = 0;
     virtual void buildUserInterface(UI* ui_interface) = 0;
@@ -151,6 +154,9 @@ struct FAUST_API JSONUIDecoderReal : public JSONUIDecoderBase {
     controlMap fPathInputTable;     // [path, ZoneParam]
     controlMap fPathOutputTable;    // [path, ZoneParam]
     
+    std::unordered_map<std::string, int> fPathInputIndex;   // [path, index in fPathInputTable]
+    std::unordered_map<std::string, int> fPathOutputIndex;  // [path, index in fPathOutputTable]
+    
     bool startWith(const std::string& str, const std::string& prefix)
     {
         return (str.substr(0, prefix.size()) == prefix);
@@ -223,12 +229,14 @@ struct FAUST_API JSONUIDecoderReal : public JSONUIDecoderBase {
             // Meta data declaration for input items
             if (isInput(type)) {
                 ZoneParam* param = new ZoneParam();
+                fPathInputIndex[it.address] = int(fPathInputTable.size());
                 fPathInputTable.push_back(param);
                 param->fZone = it.init;
             }
             // Meta data declaration for output items
             else if (isOutput(type)) {
                 ZoneParam* param = new ZoneParam();
+                fPathOutputIndex[it.address] = int(fPathOutputTable.size());
                 fPathOutputTable.push_back(param);
                 param->fZone = REAL(0);
             }
@@ -578,6 +586,18 @@ struct FAUST_API JSONUIDecoderReal : public JSONUIDecoderBase {
         return fPathOutputTable;
     }
     
+    // Resolve a path once, to later access the control in getInputControls/getOutputControls (-1 if not found)
+    int getInputControlIndex(const std::string& path)
+    {
+        const auto it = fPathInputIndex.find(path);
+        return (it != fPathInputIndex.end()) ? it->second : -1;
+    }
+    int getOutputControlIndex(const std::string& path)
+    {
+        const auto it = fPathOutputIndex.find(path);
+        return (it != fPathOutputIndex.end()) ? it->second : -1;
+    }
+    
 };
 
 // FAUSTFLOAT templated decoder
@@ -30,9 +30,11 @@
 #endif
 #include <sndfile.h>
 #include <string.h>
+#include <limits.h>
 #include <assert.h>
 #include <iostream>
 #include <fstream>
+#include <vector>
 
 #include "faust/gui/Soundfile.h"
 
@@ -148,12 +150,134 @@ struct VFLibsndfile {
  
 };
 
+/*
+ A libsndfile resource incrementally read in one part of a soundfile, possibly resampled.
+ */
+
+struct LibsndfileStream : public SoundfileStream {
+    
+    typedef sf_count_t (* sample_read)(SNDFILE* sndfile, void* buffer, sf_count_t frames);
+    
+    SNDFILE* fFile;
+    SF_INFO fInfo;
+    int fChannels;
+    sample_read fReader;
+    std::vector<char> fBufferIn;
+    
+#ifdef _SAMPLERATE
+    SRC_STATE* fResampler;
+    double fRatio;
+    std::vector<float> fSrcBufferIn;
+    std::vector<float> fSrcBufferOut;
+    std::vector<char> fBufferOut;
+#endif
+    
+    LibsndfileStream(Soundfile* soundfile, SNDFILE* snd_file, const SF_INFO& snd_info, int part, int offset, int end, int max_chan, int driver_sr)
+    :SoundfileStream(soundfile, part, offset, end), fFile(snd_file), fInfo(snd_info)
+    {
+        assert(fFile);
+        fChannels = std::min<int>(max_chan, fInfo.channels);
+        size_t sample_size = (soundfile->fIsDouble) ? sizeof(double) : sizeof(float);
+        fBufferIn.resize(BUFFER_SIZE * sample_size * fInfo.channels);
+        if (soundfile->fIsDouble) {
+            fReader = reinterpret_cast<sample_read>(sf_readf_double);
+        } else {
+            fReader = reinterpret_cast<sample_read>(sf_readf_float);
+        }
+    #ifdef _SAMPLERATE
+        fResampler = nullptr;
+        fRatio = 1.;
+        if (driver_sr > 0 && driver_sr != fInfo.samplerate) {
+            int error;
+            fResampler = src_new(SRC_SINC_FASTEST, fInfo.channels, &error);
+            if (error != 0) {
+                std::cerr << "ERROR : src_new " << src_strerror(error) << std::endl;
+                sf_close(fFile);
+                throw -1;
+            }
+            fRatio = double(driver_sr)/double(fInfo.samplerate);
+            if (soundfile->fIsDouble) {
+                // Additional buffers for SRC resampling
+                fSrcBufferIn.resize(BUFFER_SIZE * fInfo.channels);
+                fSrcBufferOut.resize(BUFFER_SIZE * fInfo.channels);
+            }
+            fBufferOut.resize(BUFFER_SIZE * sample_size * fInfo.channels);
+        }
+    #endif
+    }
+    
+    virtual ~LibsndfileStream()
+    {
+        sf_close(fFile);
+    #ifdef _SAMPLERATE
+        if (fResampler) src_delete(fResampler);
+    #endif
+    }
+    
+    int read(int frames) override
+    {
+        int written = 0;
+        while (!fEnded && written < frames) {
+            // Read and fill fInfo.channels number of channels
+            sf_count_t nbf = fReader(fFile, fBufferIn.data(), BUFFER_SIZE);
+            fEnded = (nbf < BUFFER_SIZE);
+        #ifdef _SAMPLERATE
+            if (fResampler) {
+                written += resample(int(nbf));
+                continue;
+            }
+        #endif
+            written += write(int(nbf), fChannels, fInfo.channels, fBufferIn.data());
+        }
+        return written;
+    }
+    
+#ifdef _SAMPLERATE
+    int resample(int nbf)
+    {
+        int written = 0;
+        int in_offset = 0;
+        SRC_DATA src_data;
+        src_data.src_ratio = fRatio;
+        if (fSoundfile->fIsDouble) {
+            for (int frame = 0; frame < (nbf * fInfo.channels); frame++) {
+                fSrcBufferIn[frame] = float(reinterpret_cast<double*>(fBufferIn.data())[frame]);
+            }
+        }
+        do {
+            if (fSoundfile->fIsDouble) {
+                src_data.data_in = fSrcBufferIn.data() + in_offset * fInfo.channels;
+                src_data.data_out = fSrcBufferOut.data();
+            } else {
+                src_data.data_in = reinterpret_cast<const float*>(fBufferIn.data()) + in_offset * fInfo.channels;
+                src_data.data_out = reinterpret_cast<float*>(fBufferOut.data());
+            }
+            src_data.input_frames = nbf - in_offset;
+            src_data.output_frames = BUFFER_SIZE;
+            src_data.end_of_input = fEnded;
+            int res = src_process(fResampler, &src_data);
+            if (res != 0) {
+                std::cerr << "ERROR : src_process " << src_strerror(res) << std::endl;
+                throw -1;
+            }
+            if (fSoundfile->fIsDouble) {
+                for (int frame = 0; frame < (src_data.output_frames_gen * fInfo.channels); frame++) {
+                    reinterpret_cast<double*>(fBufferOut.data())[frame] = double(fSrcBufferOut[frame]);
+                }
+            }
+            written += write(int(src_data.output_frames_gen), fChannels, fInfo.channels, fBufferOut.data());
+            in_offset += src_data.input_frames_used;
+        } while (in_offset < nbf || (fEnded && src_data.output_frames_gen > 0));
+        return written;
+    }
+#endif
+
+};
+
 struct LibsndfileReader : public SoundfileReader {
 	
     LibsndfileReader() {}
 	
-    typedef sf_count_t (* sample_read)(SNDFILE* sndfile, void* buffer, sf_count_t frames);
-	
     // Check file
     bool checkFile(const std::string& path_name) override
     {
@@ -246,11 +370,18 @@ struct LibsndfileReader : public SoundfileReader {
         readFileAux(soundfile, snd_file, snd_info, part, offset, max_chan);
     }
 	
-    // Will be called to fill all parts from 0 to MAX_SOUNDFILE_PARTS-1
-    void readFileAux(Soundfile* soundfile, SNDFILE* snd_file, const SF_INFO& snd_info, int part, int& offset, int max_chan)
+    // Open the file to be streamed
+    SoundfileStream* openStream(Soundfile* soundfile, const std::string& path_name, int part, int offset, int length, int max_chan) override
+    {
+        SF_INFO snd_info;
+        snd_info.format = 0;
+        SNDFILE* snd_file = sf_open(path_name.c_str(), SFM_READ, &snd_info);
+        fillPart(soundfile, snd_info, part, offset);
+        return new LibsndfileStream(soundfile, snd_file, snd_info, part, offset, offset + length, max_chan, fDriverSR);
+    }
+    
+    void fillPart(Soundfile* soundfile, const SF_INFO& snd_info, int part, int offset)
     {
-        assert(snd_file);
-        int channels = std::min<int>(max_chan, snd_info.channels);
     #ifdef _SAMPLERATE
         if (isResampling(snd_info.samplerate)) {
             soundfile->fLength[part] = int(double(snd_info.frames) * double(fDriverSR) / double(snd_info.samplerate));
@@ -264,99 +395,17 @@ struct LibsndfileReader : public SoundfileReader {
         soundfile->fSR[part] = snd_info.samplerate;
     #endif
         soundfile->fOffset[part] = offset;
-		
-        // Read and fill snd_info.channels number of channels
-        sf_count_t nbf;
-        
-        sample_read reader;
-        void* buffer_in = nullptr;
-        if (soundfile->fIsDouble) {
-            buffer_in = static_cast<double*>(alloca(BUFFER_SIZE * sizeof(double) * snd_info.channels));
-            reader = reinterpret_cast<sample_read>(sf_readf_double);
-        } else {
-            buffer_in = static_cast<float*>(alloca(BUFFER_SIZE * sizeof(float) * snd_info.channels));
-            reader = reinterpret_cast<sample_read>(sf_readf_float);
-        }
-        
-    #ifdef _SAMPLERATE
-        // Resampling
-        SRC_STATE* resampler = nullptr;
-        float* src_buffer_out = nullptr;
-        float* src_buffer_in = nullptr;
-        void* buffer_out = nullptr;
-        if  (isResampling(snd_info.samplerate)) {
-            int error;
-            resampler = src_new(SRC_SINC_FASTEST, channels, &error);
-            if (error != 0) {
-                std::cerr << "ERROR : src_new " << src_strerror(error) << std::endl;
-                throw -1;
-            }
-            if (soundfile->fIsDouble) {
-                // Additional buffers for SRC resampling
-                src_buffer_in = static_cast<float*>(alloca(BUFFER_SIZE * sizeof(float) * snd_info.channels));
-                src_buffer_out = static_cast<float*>(alloca(BUFFER_SIZE * sizeof(float) * snd_info.channels));
-                buffer_out = static_cast<double*>(alloca(BUFFER_SIZE * sizeof(double) * snd_info.channels));
-            } else {
-                buffer_out = static_cast<float*>(alloca(BUFFER_SIZE * sizeof(float) * snd_info.channels));
-            }
-        }
-    #endif
-        
-        do {
-            nbf = reader(snd_file, buffer_in, BUFFER_SIZE);
-        #ifdef _SAMPLERATE
-            // Resampling
-            if  (isResampling(snd_info.samplerate)) {
-                int in_offset = 0;
-                SRC_DATA src_data;
-                src_data.src_ratio = double(fDriverSR)/double(snd_info.samplerate);
-                if (soundfile->fIsDouble) {
-                    for (int frame = 0; frame < (BUFFER_SIZE * snd_info.channels); frame++) {
-                        src_buffer_in[frame] = float(static_cast<float*>(buffer_in)[frame]);
-                    }
-                }
-                do {
-                    if (soundfile->fIsDouble) {
-                        src_data.data_in = src_buffer_in;
-                        src_data.data_out = src_buffer_out;
-                    } else {
-                        src_data.data_in = static_cast<const float*>(buffer_in);
-                        src_data.data_out = static_cast<float*>(buffer_out);
-                    }
-                    src_data.input_frames = nbf - in_offset;
-                    src_data.output_frames = BUFFER_SIZE;
-                    src_data.end_of_input = (nbf < BUFFER_SIZE);
-                    int res = src_process(resampler, &src_data);
-                    if (res != 0) {
-                        std::cerr << "ERROR : src_process " << src_strerror(res) << std::endl;
-                        throw -1;
-                    }
-                    if (soundfile->fIsDouble) {
-                        for (int frame = 0; frame < (BUFFER_SIZE * snd_info.channels); frame++) {
-                            static_cast<double*>(buffer_out)[frame] = double(src_buffer_out[frame]);
-                        }
-                    }
-                    soundfile->copyToOut(src_data.output_frames_gen, channels, snd_info.channels, offset, buffer_out);
-                    in_offset += src_data.input_frames_used;
-                    // Update offset
-                    offset += src_data.output_frames_gen;
-                } while (in_offset < nbf);
-            } else {
-                soundfile->copyToOut(nbf, channels, snd_info.channels, offset, buffer_in);
-                // Update offset
-                offset += nbf;
-            }
-        #else
-            soundfile->copyToOut(nbf, channels, snd_info.channels, offset, buffer_in);
-            // Update offset
-            offset += nbf;
-        #endif
-        } while (nbf == BUFFER_SIZE);
-		
-        sf_close(snd_file);
-    #ifdef _SAMPLERATE
-        if (resampler) src_delete(resampler);
-    #endif
+    }
+	
+    // Will be called to fill all parts from 0 to MAX_SOUNDFILE_PARTS-1
+    void readFileAux(Soundfile* soundfile, SNDFILE* snd_file, const SF_INFO& snd_info, int part, int& offset, int max_chan)
+    {
+        fillPart(soundfile, snd_info, part, offset);
+        // The whole buffer space after 'offset' is available
+        LibsndfileStream stream(soundfile, snd_file, snd_info, part, offset, INT_MAX, max_chan, fDriverSR);
+        stream.readAll();
+        // Update offset
+        offset = stream.fOffset;
     }
 
 };
@@ -27,6 +27,7 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <string>
 #include <stdio.h>
 
@@ -43,6 +44,9 @@
  *
  * Simple 'labels', 'shortname' and complete 'paths' (to fully discriminate between possible same
  * 'labels' at different location in the UI hierachy) can be used to access a given parameter.
+ *
+ * A parameter can also be resolved once with 'getParamIndex', then accessed with the
+ * index based API, without any string comparison or allocation (so in the audio thread).
  ******************************************************************************/
 
 class FAUST_API MapUI : public UI, public PathBuilder
@@ -59,6 +63,50 @@ class FAUST_API MapUI : public UI, public PathBuilder
         // Full path map
         std::map<std::string, FAUSTFLOAT*> fPathZoneMap;
     
+        // Maps entries in index order, built when the UI is closed
+        typedef std::map<std::string, FAUSTFLOAT*>::const_iterator ZoneMapIt;
+        std::vector<ZoneMapIt> fPathTable;
+        std::vector<ZoneMapIt> fShortnameTable;
+        std::vector<ZoneMapIt> fLabelTable;
+    
+        // label/shortname/path to index
+        std::unordered_map<std::string, int> fIndexMap;
+    
+        // Also called lazily, if the UI has been filled without closing its top-level box
+        void buildTables()
+        {
+            fPathTable.clear();
+            fShortnameTable.clear();
+            fLabelTable.clear();
+            fIndexMap.clear();
+            std::unordered_map<FAUSTFLOAT*, int> zone_index;
+            for (ZoneMapIt it = fPathZoneMap.begin(); it != fPathZoneMap.end(); it++) {
+                zone_index[it->second] = int(fPathTable.size());
+                fPathTable.push_back(it);
+            }
+            for (ZoneMapIt it = fShortnameZoneMap.begin(); it != fShortnameZoneMap.end(); it++) {
+                fShortnameTable.push_back(it);
+            }
+            for (ZoneMapIt it = fLabelZoneMap.begin(); it != fLabelZoneMap.end(); it++) {
+                fLabelTable.push_back(it);
+            }
+            // Same priority as the string based API: path, then shortname, then label
+            for (const auto& it : fPathZoneMap) {
+                fIndexMap.emplace(it.first, zone_index[it.second]);
+            }
+            for (const auto& it : fShortnameZoneMap) {
+                fIndexMap.emplace(it.first, zone_index[it.second]);
+            }
+            for (const auto& it : fLabelZoneMap) {
+                fIndexMap.emplace(it.first, zone_index[it.second]);
+            }
+        }
+    
+        void checkTables()
+        {
+            if (fPathTable.size() != fPathZoneMap.size()) buildTables();
+        }
+    
         void addZoneLabel(const std::string& label, FAUSTFLOAT* zone)
         {
             std::string path = buildPath(label);
@@ -94,6 +142,7 @@ class FAUST_API MapUI : public UI, public PathBuilder
                 for (const auto& it : fFullPaths) {
                     fShortnameZoneMap[fFull2Short[it]] = fPathZoneMap[it];
                 }
+                buildTables();
             }
         }
         
@@ -210,6 +259,38 @@ class FAUST_API MapUI : public UI, public PathBuilder
          */
         int getParamsCount() { return int(fPathZoneMap.size()); }
         
+        /**
+         * Return the param index, to be used with the index based API.
+         *
+         * @param str - the UI parameter label/shortname/path
+         *
+         * @return the param index (in the full path map order), or -1 if not found.
+         */
+        int getParamIndex(const std::string& str)
+        {
+            checkTables();
+            const auto it = fIndexMap.find(str);
+            return (it != fIndexMap.end()) ? it->second : -1;
+        }
+    
+        /**
+         * Set the param value.
+         *
+         * @param index - the UI parameter index, as returned by getParamIndex
+         * @param value - the UI parameter value
+         *
+         */
+        void setParamValue(int index, FAUSTFLOAT value) { *fPathTable[size_t(index)]->second = value; }
+    
+        /**
+         * Return the param value.
+         *
+         * @param index - the UI parameter index, as returned by getParamIndex
+         *
+         * @return the param value.
+         */
+        FAUSTFLOAT getParamValue(int index) { return *fPathTable[size_t(index)]->second; }
+    
         /**
          * Return the param path.
          *
@@ -219,24 +300,14 @@ class FAUST_API MapUI : public UI, public PathBuilder
          */
         std::string getParamAddress(int index)
         {
-            if (index < 0 || index > int(fPathZoneMap.size())) {
-                return "";
-            } else {
-                auto it = fPathZoneMap.begin();
-                while (index-- > 0 && it++ != fPathZoneMap.end()) {}
-                return it->first;
-            }
+            checkTables();
+            return (index < 0 || index >= int(fPathTable.size())) ? "" : fPathTable[size_t(index)]->first;
         }
         
         const char* getParamAddress1(int index)
         {
-            if (index < 0 || index > int(fPathZoneMap.size())) {
-                return nullptr;
-            } else {
-                auto it = fPathZoneMap.begin();
-                while (index-- > 0 && it++ != fPathZoneMap.end()) {}
-                return it->first.c_str();
-            }
+            checkTables();
+            return (index < 0 || index >= int(fPathTable.size())) ? nullptr : fPathTable[size_t(index)]->first.c_str();
         }
     
         /**
@@ -248,24 +319,14 @@ class FAUST_API MapUI : public UI, public PathBuilder
          */
         std::string getParamShortname(int index)
         {
-            if (index < 0 || index > int(fShortnameZoneMap.size())) {
-                return "";
-            } else {
-                auto it = fShortnameZoneMap.begin();
-                while (index-- > 0 && it++ != fShortnameZoneMap.end()) {}
-                return it->first;
-            }
+            checkTables();
+            return (index < 0 || index >= int(fShortnameTable.size())) ? "" : fShortnameTable[size_t(index)]->first;
         }
         
         const char* getParamShortname1(int index)
         {
-            if (index < 0 || index > int(fShortnameZoneMap.size())) {
-                return nullptr;
-            } else {
-                auto it = fShortnameZoneMap.begin();
-                while (index-- > 0 && it++ != fShortnameZoneMap.end()) {}
-                return it->first.c_str();
-            }
+            checkTables();
+            return (index < 0 || index >= int(fShortnameTable.size())) ? nullptr : fShortnameTable[size_t(index)]->first.c_str();
         }
     
         /**
@@ -277,24 +338,14 @@ class FAUST_API MapUI : public UI, public PathBuilder
          */
         std::string getParamLabel(int index)
         {
-            if (index < 0 || index > int(fLabelZoneMap.size())) {
-                return "";
-            } else {
-                auto it = fLabelZoneMap.begin();
-                while (index-- > 0 && it++ != fLabelZoneMap.end()) {}
-                return it->first;
-            }
+            checkTables();
+            return (index < 0 || index >= int(fLabelTable.size())) ? "" : fLabelTable[size_t(index)]->first;
         }
         
         const char* getParamLabel1(int index)
         {
-            if (index < 0 || index > int(fLabelZoneMap.size())) {
-                return nullptr;
-            } else {
-                auto it = fLabelZoneMap.begin();
-                while (index-- > 0 && it++ != fLabelZoneMap.end()) {}
-                return it->first.c_str();
-            }
+            checkTables();
+            return (index < 0 || index >= int(fLabelTable.size())) ? nullptr : fLabelTable[size_t(index)]->first.c_str();
         }
     
         /**
@@ -348,13 +399,8 @@ class FAUST_API MapUI : public UI, public PathBuilder
          */
         FAUSTFLOAT* getParamZone(int index)
         {
-            if (index < 0 || index > int(fPathZoneMap.size())) {
-                return nullptr;
-            } else {
-                auto it = fPathZoneMap.begin();
-                while (index-- > 0 && it++ != fPathZoneMap.end()) {}
-                return it->second;
-            }
+            checkTables();
+            return (index < 0 || index >= int(fPathTable.size())) ? nullptr : fPathTable[size_t(index)]->second;
         }
     
         static bool endsWith(const std::string& str, const std::string& end)
@@ -61,6 +61,11 @@ static MemoryReader gReader;
 static LibsndfileReader gReader;
 #endif
 
+// Streaming mode, where soundfile parts are read in a background thread
+#ifdef SOUNDFILE_STREAMING
+#include "faust/gui/SoundfileStreamer.h"
+#endif
+
 // To be used by DSP code if no SoundUI is used
 static std::vector<std::string> gPathNameList;
 static Soundfile* defaultsound = nullptr;
@@ -77,6 +82,12 @@ class SoundUI : public SoundUIInterface
         // The soundfile reader
         std::shared_ptr<SoundfileReader> fSoundReader;
         bool fIsDouble;
+    #ifdef SOUNDFILE_STREAMING
+        // Number of frames read in each part when the soundfile is created, 0 to read parts entirely
+        int fHeadFrames;
+        // Declared after fSoundfileMap, so that it is deleted before the soundfiles
+        std::unique_ptr<SoundfileStreamer> fStreamer;
+    #endif
 
      public:
     
@@ -99,6 +110,9 @@ class SoundUI : public SoundUIInterface
                 : std::shared_ptr<SoundfileReader>(std::shared_ptr<SoundfileReader>{}, &gReader);
             fSoundReader->setSampleRate(sample_rate);
             fIsDouble = is_double;
+        #ifdef SOUNDFILE_STREAMING
+            fHeadFrames = 0;
+        #endif
             if (!defaultsound) defaultsound = gReader.createSoundfile(gPathNameList, MAX_CHAN, is_double);
         }
     
@@ -121,11 +135,51 @@ class SoundUI : public SoundUIInterface
                 : std::shared_ptr<SoundfileReader>(std::shared_ptr<SoundfileReader>{}, &gReader);
             fSoundReader->setSampleRate(sample_rate);
             fIsDouble = is_double;
+        #ifdef SOUNDFILE_STREAMING
+            fHeadFrames = 0;
+        #endif
             if (!defaultsound) defaultsound = gReader.createSoundfile(gPathNameList, MAX_CHAN, is_double);
         }
     
         virtual ~SoundUI()
         {}
+    
+    #ifdef SOUNDFILE_STREAMING
+        /**
+         * Activate the streaming mode for the soundfiles added after this call: only the first 'head_frames' frames
+         * of each part are read when the soundfile is created, the remaining ones are read in a background thread,
+         * up to 'read_ahead' frames after the play position given with 'prefetch'.
+         * Only readers implementing SoundfileReader::openStream (like LibsndfileReader) stream, the others read parts entirely.
+         * The audio side checks Soundfile::getReadyFrames before playing a range of a streamed part.
+         *
+         * @param head_frames - the number of frames read in each part, or 0 to read parts entirely
+         * @param read_ahead - the number of frames read after the play position, or a negative value to read parts entirely
+         */
+        void setStreaming(int head_frames, int read_ahead = STREAM_READ_AHEAD)
+        {
+            fHeadFrames = head_frames;
+            if (head_frames > 0 && !fStreamer) fStreamer.reset(new SoundfileStreamer(read_ahead));
+        }
+    
+        /**
+         * Move the play position of a part of a streamed soundfile, and ask for it to be read before the other ones,
+         * typically when a note starts, then regularly while it plays.
+         * Can be called from the audio thread (from a single thread only).
+         *
+         * @param soundfile - the soundfile, as set in the DSP 'sf_zone'
+         * @param part - the part number
+         * @param frame - the play position in the part
+         *
+         * @return false if the request cannot be sent.
+         */
+        bool prefetch(Soundfile* soundfile, int part, int frame = 0)
+        {
+            return (fStreamer) ? fStreamer->prefetch(soundfile, part, frame) : false;
+        }
+    
+        // The number of parts not yet completely read
+        int getPendingParts() { return (fStreamer) ? fStreamer->getPendingParts() : 0; }
+    #endif
 
         // -- soundfiles
         virtual void addSoundfile(const char* label, const char* url, Soundfile** sf_zone)
@@ -143,7 +197,18 @@ class SoundUI : public SoundUIInterface
                 // Check all files and get their complete path
                 std::vector<std::string> path_name_list = fSoundReader->checkFiles(fSoundfileDir, file_name_list);
                 // Read them and create the Soundfile
+            #ifdef SOUNDFILE_STREAMING
+                Soundfile* sound_file = nullptr;
+                if (fHeadFrames > 0) {
+                    std::vector<SoundfileStream*> streams;
+                    sound_file = fSoundReader->createSoundfile(path_name_list, MAX_CHAN, fIsDouble, fHeadFrames, streams);
+                    fStreamer->addStreams(streams);
+                } else {
+                    sound_file = fSoundReader->createSoundfile(path_name_list, MAX_CHAN, fIsDouble);
+                }
+            #else
                 Soundfile* sound_file = fSoundReader->createSoundfile(path_name_list, MAX_CHAN, fIsDouble);
+            #endif
                 if (sound_file) {
                     fSoundfileMap[saved_url_real] = std::shared_ptr<Soundfile>(sound_file);
                 } else {
@@ -25,9 +25,13 @@
 #ifndef __Soundfile__
 #define __Soundfile__
 
+#include <stdlib.h>
 #include <string.h>
 #include <string>
 #include <vector>
+#include <new>
+#include <algorithm>
+#include <atomic>
 
 #ifndef FAUSTFLOAT
 #define FAUSTFLOAT float
@@ -71,12 +75,17 @@ struct Soundfile {
     int fChannels;  // max number of channels of all concatenated files
     int fParts;     // the total number of loaded parts
     bool fIsDouble; // keep the sample format (float or double)
+    std::atomic<int>* fReady; // number of frames of each part already written in fBuffers (not accessed by the DSP code)
 
     Soundfile(int cur_chan, int length, int max_chan, int total_parts, bool is_double)
     {
         fLength   = new int[MAX_SOUNDFILE_PARTS];
         fSR       = new int[MAX_SOUNDFILE_PARTS];
         fOffset   = new int[MAX_SOUNDFILE_PARTS];
+        fReady    = new std::atomic<int>[MAX_SOUNDFILE_PARTS];
+        for (int part = 0; part < MAX_SOUNDFILE_PARTS; part++) {
+            fReady[part].store(0, std::memory_order_relaxed);
+        }
         fIsDouble = is_double;
         fChannels = cur_chan;
         fParts    = total_parts;
@@ -92,8 +101,9 @@ struct Soundfile {
     {
         REAL** buffers = new REAL*[max_chan];
         for (int chan = 0; chan < cur_chan; chan++) {
-            buffers[chan] = new REAL[length];
-            memset(buffers[chan], 0, sizeof(REAL) * length);
+            // calloc gives zeroed pages which only become resident when written, so that parts streamed later on do not use memory before being read
+            buffers[chan] = static_cast<REAL*>(calloc(length, sizeof(REAL)));
+            if (!buffers[chan]) throw std::bad_alloc();
         }
         return buffers;
     }
@@ -139,11 +149,30 @@ struct Soundfile {
         }
     }
     
+    /**
+     * Publish the number of frames of a part written in fBuffers, they are then visible
+     * to a thread reading getReadyFrames.
+     */
+    void setReadyFrames(int part, int frames)
+    {
+        fReady[part].store(frames, std::memory_order_release);
+    }
+    
+    /**
+     * The number of frames of a part that can be read in fBuffers. In streaming mode, it grows
+     * while the part is read in background: the audio side checks it before playing a range.
+     */
+    int getReadyFrames(int part) const
+    {
+        return fReady[part].load(std::memory_order_acquire);
+    }
+    
     void emptyFile(int part, int& offset)
     {
         fLength[part] = BUFFER_SIZE;
         fSR[part] = SAMPLE_RATE;
         fOffset[part] = offset;
+        setReadyFrames(part, fLength[part]);
         // Update offset
         offset += fLength[part];
     }
@@ -153,24 +182,74 @@ struct Soundfile {
         // Free the real channels only
         if (fIsDouble) {
             for (int chan = 0; chan < fChannels; chan++) {
-                delete[] static_cast<double**>(fBuffers)[chan];
+                free(static_cast<double**>(fBuffers)[chan]);
             }
             delete[] static_cast<double**>(fBuffers);
         } else {
             for (int chan = 0; chan < fChannels; chan++) {
-                delete[] static_cast<float**>(fBuffers)[chan];
+                free(static_cast<float**>(fBuffers)[chan]);
             }
             delete[] static_cast<float**>(fBuffers);
         }
         delete[] fLength;
         delete[] fSR;
         delete[] fOffset;
+        delete[] fReady;
     }
 
     typedef std::vector<std::string> Directories;
     
 } POST_PACKED_STRUCTURE;
 
+/*
+ An opened sound resource, incrementally read in the space of one part of a soundfile.
+ Used in streaming mode, where only the head of each part is read when the soundfile is created,
+ the remaining frames being read later on by a background thread (see SoundfileStreamer.h).
+ */
+
+struct SoundfileStream {
+    
+    Soundfile* fSoundfile;
+    int fPart;
+    int fOffset;    // next frame to be written in the soundfile buffers
+    int fEnd;       // end of the part space in the soundfile buffers
+    bool fEnded;    // the end of the resource has been reached
+    
+    SoundfileStream(Soundfile* soundfile, int part, int offset, int end)
+    :fSoundfile(soundfile), fPart(part), fOffset(offset), fEnd(end), fEnded(false)
+    {}
+    virtual ~SoundfileStream() {}
+    
+    /**
+     * Read the next frames of the resource in the soundfile buffers.
+     *
+     * @param frames - the wanted number of frames
+     *
+     * @return the number of frames actually written in the soundfile buffers, fEnded is set at the end of the resource.
+     */
+    virtual int read(int frames) = 0;
+    
+    // Read the complete remaining part of the resource
+    void readAll()
+    {
+        while (!fEnded) { read(BUFFER_SIZE); }
+    }
+    
+    // Write 'size' interleaved frames at the current offset, without overflowing the part space, and publish them
+    int write(int size, int channels, int max_channels, void* buffer)
+    {
+        size = std::max<int>(0, std::min<int>(size, fEnd - fOffset));
+        fSoundfile->copyToOut(size, channels, max_channels, fOffset, buffer);
+        fOffset += size;
+        fSoundfile->setReadyFrames(fPart, getFrames());
+        return size;
+    }
+    
+    // The number of frames of the part already written
+    int getFrames() { return fOffset - fSoundfile->fOffset[fPart]; }
+
+};
+
 /*
  The generic soundfile reader.
  */
@@ -264,6 +343,21 @@ class SoundfileReader {
      *
      */
     virtual void readFile(Soundfile* soundfile, unsigned char* buffer, size_t size, int part, int& offset, int max_chan) {}
+    
+    /**
+     * Open one sound resource to be incrementally read, and fill the 'soundfile' part description accordingly.
+     * Readers which cannot stream return nullptr, then the resource is entirely read with readFile.
+     *
+     * @param soundfile - the soundfile to be filled
+     * @param path_name - the name of the file, or sound resource identified this way
+     * @param part - the part number to be filled in the soundfile
+     * @param offset - the offset of the part in the soundfile buffers
+     * @param length - the space reserved for the part, as returned by getParamsFile
+     * @param max_chan - the maximum number of mono channels to fill
+     *
+     * @return the stream, to be deleted by the caller.
+     */
+    virtual SoundfileStream* openStream(Soundfile* soundfile, const std::string& path_name, int part, int offset, int length, int max_chan) { return nullptr; }
 
   public:
     
@@ -274,9 +368,33 @@ class SoundfileReader {
    
     Soundfile* createSoundfile(const std::vector<std::string>& path_name_list, int max_chan, bool is_double)
     {
+        std::vector<SoundfileStream*> streams;
+        return createSoundfile(path_name_list, max_chan, is_double, 0, streams);
+    }
+    
+    /**
+     * Create a soundfile in streaming mode: only the first 'head_frames' frames of each part are read,
+     * and the streams to read the remaining frames are returned.
+     *
+     * @param path_name_list - the list of resources, as returned by checkFiles
+     * @param max_chan - the maximum number of mono channels to fill
+     * @param is_double - whether soundfile buffers have to be in double
+     * @param head_frames - the number of frames read in each part, or 0 to read all parts entirely
+     * @param streams - the vector to be filled with the unfinished streams, to be deleted by the caller
+     *
+     * @return the soundfile, or nullptr in case of failure.
+     */
+    Soundfile* createSoundfile(const std::vector<std::string>& path_name_list,
+                               int max_chan,
+                               bool is_double,
+                               int head_frames,
+                               std::vector<SoundfileStream*>& streams)
+    {
+        Soundfile* soundfile = nullptr;
         try {
             int cur_chan = 1; // At least one channel
             int total_length = 0;
+            std::vector<int> lengths;
             
             // Compute total length and channels max of all files
             for (size_t part = 0; part < path_name_list.size(); part++) {
@@ -289,13 +407,14 @@ class SoundfileReader {
                 }
                 cur_chan = std::max<int>(cur_chan, chan);
                 total_length += length;
+                lengths.push_back(length);
             }
            
             // Complete with empty parts
             total_length += (MAX_SOUNDFILE_PARTS - path_name_list.size()) * BUFFER_SIZE;
             
             // Create the soundfile
-            Soundfile* soundfile = new Soundfile(cur_chan, total_length, max_chan, path_name_list.size(), is_double);
+            soundfile = new Soundfile(cur_chan, total_length, max_chan, path_name_list.size(), is_double);
             
             // Init offset
             int offset = 0;
@@ -304,8 +423,25 @@ class SoundfileReader {
             for (size_t part = 0; part < path_name_list.size(); part++) {
                 if (path_name_list[part] == "__empty_sound__") {
                     soundfile->emptyFile(part, offset);
+                    continue;
+                }
+                SoundfileStream* stream = (head_frames > 0)
+                    ? openStream(soundfile, path_name_list[part], part, offset, lengths[part], max_chan)
+                    : nullptr;
+                if (stream) {
+                    // The reserved space is kept, since the part is not completely read yet
+                    offset += lengths[part];
+                    while (!stream->fEnded && stream->getFrames() < head_frames) {
+                        stream->read(head_frames - stream->getFrames());
+                    }
+                    if (stream->fEnded) {
+                        delete stream;
+                    } else {
+                        streams.push_back(stream);
+                    }
                 } else {
                     readFile(soundfile, path_name_list[part], part, offset, max_chan);
+                    soundfile->setReadyFrames(part, soundfile->fLength[part]);
                 }
             }
             
@@ -319,6 +455,9 @@ class SoundfileReader {
             return soundfile;
             
         } catch (...) {
+            for (size_t i = 0; i < streams.size(); i++) { delete streams[i]; }
+            streams.clear();
+            delete soundfile;
             return nullptr;
         }
     }
@@ -0,0 +1,213 @@
+/************************** BEGIN SoundfileStreamer.h **************************
+ FAUST Architecture File
+ Copyright (C) 2003-2022 GRAME, Centre National de Creation Musicale
+ ---------------------------------------------------------------------
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 2.1 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+ EXCEPTION : As a special exception, you may create a larger work
+ that contains this FAUST architecture section and distribute
+ that work under terms of your choice, so long as this FAUST
+ architecture section is not modified.
+ ********************************************************************/
+
+#ifndef __SoundfileStreamer__
+#define __SoundfileStreamer__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "faust/gui/Soundfile.h"
+#include "faust/gui/ring-buffer.h"
+
+#define STREAM_CHUNK_SIZE BUFFER_SIZE * 16
+#define STREAM_READ_AHEAD STREAM_CHUNK_SIZE * 4
+#define STREAM_REQUEST_SIZE 256
+
+/*
+ Reads the remaining frames of the streamed soundfile parts in a background thread,
+ in the spirit of the sound_dtd_player direct-to-disk player (see dsp/sound-player.h).
+
+ Since the DSP code directly indexes the soundfile buffers, the whole part space stays allocated,
+ but its pages only become resident when the stream writes them.
+
+ Each part is read by chunks of STREAM_CHUNK_SIZE frames, up to 'read_ahead' frames after its
+ play position, which starts at 0 and is moved with 'prefetch'. A negative 'read_ahead' reads parts
+ entirely. A requested part is read before the other ones. Requests are sent through a lock-free
+ ring buffer, so that 'prefetch' can be called from the audio or MIDI thread (from a single thread only).
+
+ The frames written in a part are published with Soundfile::setReadyFrames after each chunk,
+ the audio side checks them with Soundfile::getReadyFrames before playing a range.
+ */
+
+class SoundfileStreamer {
+
+    private:
+
+        struct Request {
+            Soundfile* fSoundfile;
+            int fPart;
+            int fFrame;
+        };
+
+        struct Item {
+            std::unique_ptr<SoundfileStream> fStream;
+            int fPosition;  // the last play position in the part
+            Item(SoundfileStream* stream):fStream(stream), fPosition(0) {}
+        };
+
+        // Streams added by the UI thread, to be moved in fItems by the streamer thread
+        std::vector<SoundfileStream*> fNewStreams;
+        std::mutex fMutex;
+
+        // Only accessed by the streamer thread
+        std::list<Item> fItems;
+
+        ringbuffer_t* fRequests;
+        std::atomic<bool> fRunning;
+        std::atomic<int> fPending;
+        std::thread fThread;
+        int fReadAhead;
+
+        void moveNewStreams()
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            for (size_t i = 0; i < fNewStreams.size(); i++) {
+                fItems.push_back(Item(fNewStreams[i]));
+            }
+            fNewStreams.clear();
+        }
+
+        void handleRequests()
+        {
+            Request request;
+            while (ringbuffer_read_space(fRequests) >= sizeof(Request)) {
+                ringbuffer_read(fRequests, (char*)&request, sizeof(Request));
+                for (std::list<Item>::iterator it = fItems.begin(); it != fItems.end(); it++) {
+                    if ((*it).fStream->fSoundfile == request.fSoundfile && (*it).fStream->fPart == request.fPart) {
+                        // Move it in front to be read first
+                        (*it).fPosition = std::max<int>((*it).fPosition, request.fFrame);
+                        fItems.splice(fItems.begin(), fItems, it);
+                        break;
+                    }
+                }
+            }
+        }
+
+        // The number of frames still to be read in the window of the item
+        int getMissingFrames(const Item& item)
+        {
+            if (fReadAhead < 0) return STREAM_CHUNK_SIZE;
+            return std::min<int>(STREAM_CHUNK_SIZE, item.fPosition + fReadAhead - item.fStream->getFrames());
+        }
+
+        // Read one chunk of the first part to be read, return false if there is nothing to read
+        bool readChunk()
+        {
+            for (std::list<Item>::iterator it = fItems.begin(); it != fItems.end(); it++) {
+                int frames = getMissingFrames(*it);
+                if (frames > 0) {
+                    try {
+                        (*it).fStream->read(frames);
+                    } catch (...) {
+                        std::cerr << "SoundfileStreamer : cannot read part " << (*it).fStream->fPart << std::endl;
+                        (*it).fStream->fEnded = true;
+                    }
+                    if ((*it).fStream->fEnded) {
+                        fItems.erase(it);
+                        fPending--;
+                    }
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void run()
+        {
+            while (fRunning) {
+                moveNewStreams();
+                handleRequests();
+                if (!readChunk()) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                }
+            }
+        }
+
+    public:
+
+        /**
+         * @param read_ahead - the number of frames read after the play position of each part,
+         * or a negative value to read parts entirely
+         */
+        SoundfileStreamer(int read_ahead = STREAM_READ_AHEAD):fRunning(true), fPending(0), fReadAhead(read_ahead)
+        {
+            fRequests = ringbuffer_create(STREAM_REQUEST_SIZE * sizeof(Request));
+            fThread = std::thread(&SoundfileStreamer::run, this);
+        }
+
+        // Has to be deleted before the soundfiles of its streams
+        virtual ~SoundfileStreamer()
+        {
+            fRunning = false;
+            fThread.join();
+            for (size_t i = 0; i < fNewStreams.size(); i++) {
+                delete fNewStreams[i];
+            }
+            ringbuffer_free(fRequests);
+        }
+
+        // Take ownership of the streams returned by SoundfileReader::createSoundfile
+        void addStreams(const std::vector<SoundfileStream*>& streams)
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            fNewStreams.insert(fNewStreams.end(), streams.begin(), streams.end());
+            fPending += int(streams.size());
+        }
+
+        /**
+         * Move the play position of a part, and ask for it to be read before the other ones.
+         * Can be called from the audio thread.
+         *
+         * @param soundfile - the soundfile
+         * @param part - the part number
+         * @param frame - the play position in the part, the part is read up to 'frame + read_ahead'
+         *
+         * @return false if the request cannot be sent.
+         */
+        bool prefetch(Soundfile* soundfile, int part, int frame = 0)
+        {
+            Request request = { soundfile, part, frame };
+            if (ringbuffer_write_space(fRequests) >= sizeof(Request)) {
+                ringbuffer_write(fRequests, (const char*)&request, sizeof(Request));
+                return true;
+            } else {
+                return false;
+            }
+        }
+
+        // The number of parts not yet completely read
+        int getPendingParts() { return fPending; }
+
+};
+
+#endif
+/**************************  END  SoundfileStreamer.h **************************/
@@ -27,6 +27,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <atomic>
 
 #ifdef WIN32
 # pragma warning (disable: 4334)
@@ -40,6 +41,15 @@ typedef struct {
 }
 ringbuffer_data_t;
 
+/*
+ Single-producer/single-consumer ring buffer: the data is copied before the write
+ pointer is published (release), and read after the write pointer is seen (acquire),
+ so that a block written with a single ringbuffer_write is seen at once by the reader.
+ */
+
+#define ringbuffer_acquire() std::atomic_thread_fence(std::memory_order_acquire)
+#define ringbuffer_release() std::atomic_thread_fence(std::memory_order_release)
+
 typedef struct {
     char *buf;
     volatile size_t write_ptr;
@@ -160,6 +170,7 @@ ringbuffer_read_space (const ringbuffer_t * rb)
 
 	w = rb->write_ptr;
 	r = rb->read_ptr;
+	ringbuffer_acquire();
 
 	if (w > r) {
 		return w - r;
@@ -179,6 +190,7 @@ ringbuffer_write_space (const ringbuffer_t * rb)
 
 	w = rb->write_ptr;
 	r = rb->read_ptr;
+	ringbuffer_acquire();
 
 	if (w > r) {
 		return ((r - w + rb->size) & rb->size_mask) - 1;
@@ -217,13 +229,14 @@ ringbuffer_read (ringbuffer_t * rb, char *dest, size_t cnt)
 	}
 
 	memcpy (dest, &(rb->buf[rb->read_ptr]), n1);
-	rb->read_ptr = (rb->read_ptr + n1) & rb->size_mask;
 
 	if (n2) {
-		memcpy (dest + n1, &(rb->buf[rb->read_ptr]), n2);
-		rb->read_ptr = (rb->read_ptr + n2) & rb->size_mask;
+		memcpy (dest + n1, rb->buf, n2);
 	}
 
+	ringbuffer_release();
+	rb->read_ptr = (rb->read_ptr + to_read) & rb->size_mask;
+
 	return to_read;
 }
 
@@ -296,13 +309,15 @@ ringbuffer_write (ringbuffer_t * rb, const char *src, size_t cnt)
 	}
 
 	memcpy (&(rb->buf[rb->write_ptr]), src, n1);
-	rb->write_ptr = (rb->write_ptr + n1) & rb->size_mask;
 
 	if (n2) {
-		memcpy (&(rb->buf[rb->write_ptr]), src + n1, n2);
-		rb->write_ptr = (rb->write_ptr + n2) & rb->size_mask;
+		memcpy (rb->buf, src + n1, n2);
 	}
 
+	// The whole block is published at once
+	ringbuffer_release();
+	rb->write_ptr = (rb->write_ptr + to_write) & rb->size_mask;
+
 	return to_write;
 }
 
@@ -312,6 +327,7 @@ static void
 ringbuffer_read_advance (ringbuffer_t * rb, size_t cnt)
 {
 	size_t tmp = (rb->read_ptr + cnt) & rb->size_mask;
+	ringbuffer_release();
 	rb->read_ptr = tmp;
 }
 
@@ -321,6 +337,7 @@ static void
 ringbuffer_write_advance (ringbuffer_t * rb, size_t cnt)
 {
 	size_t tmp = (rb->write_ptr + cnt) & rb->size_mask;
+	ringbuffer_release();
 	rb->write_ptr = tmp;
 }
 
@@ -339,6 +356,7 @@ ringbuffer_get_read_vector (const ringbuffer_t * rb,
 
 	w = rb->write_ptr;
 	r = rb->read_ptr;
+	ringbuffer_acquire();
 
 	if (w > r) {
 		free_cnt = w - r;
@@ -383,6 +401,7 @@ ringbuffer_get_write_vector (const ringbuffer_t * rb,
 
 	w = rb->write_ptr;
 	r = rb->read_ptr;
+	ringbuffer_acquire();
 
 	if (w > r) {
 		free_cnt = ((r - w + rb->size) & rb->size_mask) - 1;
@@ -35,6 +35,13 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <math.h>
+#include <stdint.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include <atomic>
+#include <chrono>
 
 // For AVOIDDENORMALS
 #include "faust/dsp/dsp.h"
@@ -54,12 +61,23 @@ static int GetPID()
 #endif
 }
 
+/*
+ Environment variables :
+ - OMP_NUM_THREADS : number of threads (default is the number of CPUs the process can use)
+ - OMP_PIN_THREADS : when set to 1, pin each thread on its own CPU (Linux only, CPUs of the same NUMA node first)
+ - OMP_STEALING_DUR : time before a thread looking for tasks yields the processor (in usec)
+ - OMP_SPIN_DUR : maximum time a thread spins between two cycles before sleeping (in usec)
+ - OMP_TASK_STATS : when set to 1, display steal and task timing counters when the scheduler is deleted
+ - OMP_REALTIME, OMP_DYN_THREAD : real-time threads, dynamic adaptation of the number of threads
+ */
+
 #define WORK_STEALING_INDEX 0
 #define LAST_TASK_INDEX 1
 
 #define MASTER_THREAD 0
 #define MAX_STEAL_DUR 50                        // in usec
-#define DEFAULT_CLOCKS_PER_SEC 2500000000       // in cycles (2,5 Ghz)
+#define MAX_SPIN_DUR 200                        // in usec
+#define MIN_SPIN_DUR 2                          // in usec
 #define JACK_SCHED_POLICY SCHED_FIFO
 #define KDSPMESURE 50
 
@@ -121,6 +139,12 @@ static int GetPID()
   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 */
 
+// pthread functions return the error code instead of setting 'errno'
+static void ThreadError(const char* msg, int res)
+{
+    printf("%s res = %d err = %s\n", msg, res, strerror(res));
+}
+
 /**
    Unnamed (process local) counting semaphore.
 
@@ -280,64 +304,18 @@ inline bool Semaphore::try_wait()
 static void Yield();
 
 /**
- * Returns the number of clock cycles elapsed since the last reset
- * of the processor
+ * Returns a monotonic time in nanoseconds
  */
-static INLINE UInt64 DSP_rdtsc(void)
+static INLINE uint64_t GetTicks()
 {
-	union {
-		UInt32 i32[2];
-		UInt64 i64;
-	} count;
-	
-	__asm__ __volatile__("rdtsc" : "=a" (count.i32[0]), "=d" (count.i32[1]));
-    return count.i64;
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
 }
 
-#if defined(__i386__) || defined(__x86_64__)
-
-#define LOCK "lock ; "
-
-static INLINE void NOP(void)
-{
-    /*
-    #ifndef __APPLE__
-	__asm__ __volatile__("nop \n\t");
-    #endif
-    */
-}
-
-static INLINE char CAS1(volatile void* addr, volatile int value, int newvalue)
+static INLINE int atomic_xadd(volatile int* atomic, int val)
 {
-    return __sync_bool_compare_and_swap((int*)addr, value, newvalue);
-}
-
-static INLINE int atomic_xadd(volatile int* atomic, int val) 
-{ 
      return __sync_add_and_fetch(atomic, val);
-} 
-
-#endif
-
-/*
-static INLINE int INC_ATOMIC(volatile int* val)
-{
-    int actual;
-    do {
-        actual = *val;
-    } while (!CAS1(val, actual, actual + 1));
-    return actual;
-}
-
-static INLINE int DEC_ATOMIC(volatile int* val)
-{
-    int actual;
-    do {
-        actual = *val;
-    } while (!CAS1(val, actual, actual - 1));
-    return actual;
 }
-*/
 
 static INLINE int INC_ATOMIC(volatile int* val)
 {
@@ -348,36 +326,16 @@ static INLINE int DEC_ATOMIC(volatile int* val)
 {
     return atomic_xadd(val, -1);
 }
- 
-// To be used in lock-free queue
-struct AtomicCounter 
-{
-    union {
-        struct {
-            short fHead;	
-            short fTail;	
-        } scounter;
-        int fValue;
-    } info;
-    
-    INLINE AtomicCounter()
-	{
-        info.fValue = 0;
-    }
-      
- 	INLINE AtomicCounter& operator=(AtomicCounter& obj)
-    {
-        info.fValue = obj.info.fValue;
-        return *this;
-    }
-    
-	INLINE AtomicCounter& operator=(volatile AtomicCounter& obj)
-	{
-        info.fValue = obj.info.fValue;
-        return *this;
-    }
-    
-};
+
+// Busy waiting hint for the processor
+static INLINE void Pause()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
 
 /* use 512KB stack per thread - the default is way too high to be feasible
  * with mlockall() on many systems */
@@ -562,12 +520,6 @@ static void SetRealTime()
     SetThreadToPriority(pthread_self(), 96, true, gPeriod, gComputation, gConstraint);
 }
 
-static void CancelThread(pthread_t fThread)
-{
-    mach_port_t machThread = pthread_mach_thread_np(fThread);
-    thread_terminate(machThread);
-}
-
 static void Yield()
 {
     //sched_yield();
@@ -604,29 +556,98 @@ static void SetRealTime()
     pthread_setschedparam(pthread_self(), faust_sched_policy, &faust_rt_param);
 }
 
-static void CancelThread(pthread_t fThread)
-{
-    pthread_cancel(fThread);
-    pthread_join(fThread, NULL);
-}
-
 static void Yield()
 {
-    pthread_yield();
+    sched_yield();
 }
 
-// TODO
 static UInt64 GetMicroSeconds(void)
 {	
-    return 0;
+    return GetTicks() / 1000;
+}
+
+/*
+ CPUs the process is allowed to run on (as set by 'taskset' or a cgroup), ordered by NUMA node
+ so that threads with consecutive numbers share the same memory node.
+ */
+static int get_cpu_list(int* cpu_list)
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return 0;
+    }
+    
+    cpu_set_t added;
+    CPU_ZERO(&added);
+    int count = 0;
+    
+    for (int node = 0; node < 64; node++) {
+        char path[64];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        FILE* file = fopen(path, "r");
+        if (!file) {
+            continue;
+        }
+        // List like "0-7,16-23"
+        int first, last;
+        while (fscanf(file, "%d", &first) == 1) {
+            last = first;
+            if (fscanf(file, "-%d", &last) < 0) {
+                last = first;
+            }
+            for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+                if (CPU_ISSET(cpu, &allowed) && !CPU_ISSET(cpu, &added)) {
+                    CPU_SET(cpu, &added);
+                    cpu_list[count++] = cpu;
+                }
+            }
+            if (fscanf(file, ",") < 0) {
+                break;
+            }
+        }
+        fclose(file);
+    }
+    
+    // No NUMA information
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed) && !CPU_ISSET(cpu, &added)) {
+            cpu_list[count++] = cpu;
+        }
+    }
+    return count;
 }
 
 static void get_affinity(pthread_t thread) {}
-static void set_affinity(pthread_t thread, int tag) {}
+
+// With OMP_PIN_THREADS=1, thread 'tag' is pinned on the 'tag' CPU of the NUMA ordered list
+static void set_affinity(pthread_t thread, int tag)
+{
+    if (!(getenv("OMP_PIN_THREADS") && strtol(getenv("OMP_PIN_THREADS"), NULL, 10))) {
+        return;
+    }
+    static int cpu_list[CPU_SETSIZE];
+    int count = get_cpu_list(cpu_list);
+    if (count > 0) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(cpu_list[tag % count], &cpu_set);
+        int res = pthread_setaffinity_np(thread, sizeof(cpu_set), &cpu_set);
+        if (res) {
+            ThreadError("Cannot set thread affinity", res);
+        }
+    }
+}
 
 int get_max_cpu()
 {
-    return sysconf(_SC_NPROCESSORS_ONLN);
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        return CPU_COUNT(&allowed);
+    } else {
+        return sysconf(_SC_NPROCESSORS_ONLN);
+    }
 }
 
 #endif
@@ -727,113 +748,119 @@ class DynThreadAdapter {
         }
 };
 
-#define Value(e) (e).info.fValue
-
-#define Head(e) (e).info.scounter.fHead
-#define IncHead(e) (e).info.scounter.fHead++
-#define DecHead(e) (e).info.scounter.fHead--
+/*
+ Chase-Lev work-stealing deque (see "Correct and Efficient Work-Stealing for Weak Memory Models",
+ N. M. Le, A. Pop, A. Cohen, F. Zappa Nardelli, PPoPP 2013).
 
-#define Tail(e) (e).info.scounter.fTail
-#define IncTail(e) (e).info.scounter.fTail++
-#define DecTail(e) (e).info.scounter.fTail--
+ The owner thread pushes and pops tasks at the bottom (PushHead/PopHead), the other threads steal
+ them at the top (PopTail). Since a given task is activated only once per cycle, a buffer of
+ 'task_queue_size' (rounded to a power of two) cannot overflow. Indexes are never reset, so
+ that a thief still reading the queue of the previous cycle always sees a consistent state.
+ */
 
 class TaskQueue 
 {
     private:
     
-        int* fTaskList;
-        int fTaskQueueSize;
-        volatile AtomicCounter fCounter;
+        // Top and bottom are written by different threads, so are kept on different cache lines
+        std::atomic<int64_t> fTop;
+        char fPad1[64];
+        std::atomic<int64_t> fBottom;
+        std::atomic<int>* fTaskList;
+        int64_t fMask;
         
-        UInt64 fStealingStart;
-        UInt64 fMaxStealing;
+        uint64_t fStealingStart;
+        uint64_t fMaxStealing;
+        char fPad2[64];
      
     public:
   
-        INLINE TaskQueue()
+        INLINE TaskQueue():fTop(0), fBottom(0), fTaskList(NULL), fMask(0)
         {}
         
         INLINE void Init(int task_queue_size)
         {
-            fTaskQueueSize = task_queue_size;
-            fTaskList = new int[fTaskQueueSize];
-            for (int i = 0; i < fTaskQueueSize; i++) {
-                fTaskList[i] = -1;
+            int size = 1;
+            while (size < task_queue_size) {
+                size <<= 1;
+            }
+            fMask = size - 1;
+            fTaskList = new std::atomic<int>[size];
+            for (int i = 0; i < size; i++) {
+                fTaskList[i].store(WORK_STEALING_INDEX, std::memory_order_relaxed);
             }
             fStealingStart = 0;
-             
-            int clock_per_microsec = (getenv("CLOCKSPERSEC") 
-                ? strtoll(getenv("CLOCKSPERSEC"), NULL, 10) 
-                : DEFAULT_CLOCKS_PER_SEC) / 1000000;
-                
-            fMaxStealing = getenv("OMP_STEALING_DUR") 
-                ? strtoll(getenv("OMP_STEALING_DUR"), NULL, 10) * clock_per_microsec 
-                : MAX_STEAL_DUR * clock_per_microsec;
+            fMaxStealing = (getenv("OMP_STEALING_DUR") 
+                ? strtoll(getenv("OMP_STEALING_DUR"), NULL, 10) 
+                : MAX_STEAL_DUR) * 1000;
         }
         
         INLINE ~TaskQueue()
         {
             delete[] fTaskList;
         }
-         
-        INLINE void InitOne()
-        {
-            for (int i = 0; i < fTaskQueueSize; i++) {
-                fTaskList[i] = -1;
-            }
-            fCounter.info.fValue = 0;
-            fStealingStart = 0;
-        }
         
+        // Owner only
         INLINE void PushHead(int item)
         {
-            fTaskList[Head(fCounter)] = item;
-            IncHead(fCounter);
+            int64_t bottom = fBottom.load(std::memory_order_relaxed);
+            fTaskList[bottom & fMask].store(item, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            fBottom.store(bottom + 1, std::memory_order_relaxed);
         }
         
+        // Owner only
         INLINE int PopHead()
         {
-            AtomicCounter old_val;
-            AtomicCounter new_val;
+            int64_t bottom = fBottom.load(std::memory_order_relaxed) - 1;
+            fBottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = fTop.load(std::memory_order_relaxed);
             
-            do {
-                old_val = fCounter;
-                new_val = old_val;
-                if (Head(old_val) == Tail(old_val)) {
-                    return WORK_STEALING_INDEX;
-                } else {
-                    DecHead(new_val);
-                }
-            } while (!CAS1(&fCounter, Value(old_val), Value(new_val)));
+            if (top > bottom) {
+                // Empty queue
+                fBottom.store(bottom + 1, std::memory_order_relaxed);
+                return WORK_STEALING_INDEX;
+            }
             
-            return fTaskList[Head(old_val) - 1];
+            int item = fTaskList[bottom & fMask].load(std::memory_order_relaxed);
+            if (top == bottom) {
+                // Last item : race with the thieves
+                if (!fTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    item = WORK_STEALING_INDEX;
+                }
+                fBottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+            return item;
         }
         
+        // Any thread
         INLINE int PopTail()
         {   
-            AtomicCounter old_val;
-            AtomicCounter new_val;
-
-            do {
-                old_val = fCounter;
-                new_val = old_val;
-                if (Head(old_val) == Tail(old_val)) {
-                    return WORK_STEALING_INDEX;
-                } else {
-                    IncTail(new_val);
+            int64_t top = fTop.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t bottom = fBottom.load(std::memory_order_acquire);
+            
+            if (top < bottom) {
+                int item = fTaskList[top & fMask].load(std::memory_order_relaxed);
+                if (fTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    return item;
                 }
-            } while (!CAS1(&fCounter, Value(old_val), Value(new_val)));
-
-            return fTaskList[Tail(old_val)];
+            }
+            // Empty queue or lost race
+            return WORK_STEALING_INDEX;
         }
 
+        // Thieves yield the processor after having stolen nothing for OMP_STEALING_DUR usec
 		INLINE void MeasureStealingDur()
 		{
             // Takes first timestamp
             if (fStealingStart == 0) {
-                fStealingStart = DSP_rdtsc();
-            } else if ((DSP_rdtsc() - fStealingStart) > fMaxStealing) {
+                fStealingStart = GetTicks();
+            } else if ((GetTicks() - fStealingStart) > fMaxStealing) {
                 Yield();
+            } else {
+                Pause();
             }
 		}
 
@@ -841,26 +868,6 @@ class TaskQueue
 		{
             fStealingStart = 0;
 		}
-           
-        static INLINE int GetNextTask(TaskQueue* task_queue_list, int cur_thread, int num_threads)
-        {
-            int tasknum;
-            for (int i = 0; i < num_threads; i++) {
-                if ((tasknum = task_queue_list[i].PopTail()) != WORK_STEALING_INDEX) {
-                #ifdef __linux__
-                    //if (cur_thread != MASTER_THREAD)
-                        task_queue_list[cur_thread].ResetStealingDur();
-                #endif
-                    return tasknum;    // Task is found
-                }
-            }
-            //NOP();
-        #ifdef __linux__
-			//if (cur_thread != MASTER_THREAD)
-                task_queue_list[cur_thread].MeasureStealingDur();
-        #endif
-            return WORK_STEALING_INDEX;    // Otherwise will try "workstealing" again next cycle...
-        }
          
         INLINE void InitTaskList(int task_list_size, int* task_list, int thread_num, int cur_thread)
         {
@@ -879,13 +886,6 @@ class TaskQueue
                 }
             }
         }
-        
-        static INLINE void InitAll(TaskQueue* task_queue_list, int num_threads)
-        {
-            for (int i = 0; i < num_threads; i++) {
-                task_queue_list[i].InitOne();
-            }
-        }
      
 };
 
@@ -968,7 +968,7 @@ class DSPThreadPool {
     
         DSPThread** fThreadPool;
         int fThreadCount; 
-        volatile int fCurThreadCount;
+        std::atomic<int> fCurThreadCount;
       
     public:
         
@@ -983,16 +983,23 @@ class DSPThreadPool {
         
         void SignalOne()
         {
-            DEC_ATOMIC(&fCurThreadCount);
+            fCurThreadCount.fetch_sub(1);
         }
 
         bool IsFinished()
         {
-            return (fCurThreadCount == 0);
+            return (fCurThreadCount.load() == 0);
         }
 
 };
 
+/*
+ Worker thread: after each cycle, the thread first spins while waiting for the next one (since in an
+ audio callback it usually comes soon), then parks on its semaphore. The spin duration adapts :
+ it grows when the thread is woken up just after having parked, and shrinks when it sleeps
+ for long, up to OMP_SPIN_DUR usec.
+ */
+
 class DSPThread {
 
     private:
@@ -1004,6 +1011,15 @@ class DSPThread {
         int fNumThread;
         void* fDSP;
         
+        // Incremented for each cycle, 'fParked' is set when waiting on the semaphore
+        std::atomic<int> fCycle;
+        std::atomic<bool> fParked;
+        std::atomic<bool> fRunning;
+        int fLastCycle;
+        
+        uint64_t fSpin;     // in nsec
+        uint64_t fMaxSpin;  // in nsec
+        
         static void* ThreadHandler(void* arg)
         {
             DSPThread* thread = static_cast<DSPThread*>(arg);
@@ -1017,32 +1033,68 @@ class DSPThread {
                 SetRealTime();
             }
                       
-            while (true) {
+            while (thread->fRunning) {
                 thread->Run();
             }
             
             return NULL;
         }
+        
+        void Wait()
+        {
+            uint64_t start = GetTicks();
+            while (fCycle.load() == fLastCycle) {
+                uint64_t waited = GetTicks() - start;
+                if (waited < fSpin) {
+                    Pause();
+                    continue;
+                }
+                fParked.store(true);
+                if (fCycle.load() != fLastCycle && fParked.exchange(false)) {
+                    // Signaled while parking, nothing to wait for
+                    break;
+                }
+                fSemaphore.wait();
+                // Adapt the spin duration
+                waited = GetTicks() - start;
+                if (waited < 2 * fSpin) {
+                    fSpin = std::min<uint64_t>(fSpin * 2, fMaxSpin);
+                } else {
+                    fSpin = std::max<uint64_t>(fSpin / 2, MIN_SPIN_DUR * 1000);
+                }
+                break;
+            }
+            fLastCycle = fCycle.load();
+        }
     
     public: 
     
         DSPThread(int num_thread, DSPThreadPool* pool, void* dsp)
-            :fThreadPool(pool), fSemaphore(0), fRealTime(false), fNumThread(num_thread), fDSP(dsp) 
-        {}
+            :fThreadPool(pool), fSemaphore(0), fRealTime(false), fNumThread(num_thread), fDSP(dsp),
+            fCycle(0), fParked(false), fRunning(false), fLastCycle(0)
+        {
+            fMaxSpin = (getenv("OMP_SPIN_DUR") ? strtoll(getenv("OMP_SPIN_DUR"), NULL, 10) : MAX_SPIN_DUR) * 1000;
+            fSpin = std::max<uint64_t>(fMaxSpin / 2, MIN_SPIN_DUR * 1000);
+        }
 
         virtual ~DSPThread()
         {}
         
         void Run()
         {
-            fSemaphore.wait();
-            computeThreadExternal(fDSP, fNumThread + 1);
-            //fThreadPool->SignalOne();
+            Wait();
+            if (fRunning) {
+                computeThreadExternal(fDSP, fNumThread + 1);
+                fThreadPool->SignalOne();
+            }
         }
                 
         void Signal()
         {
-            fSemaphore.post();
+            fCycle.fetch_add(1);
+            if (fParked.exchange(false)) {
+                fSemaphore.post();
+            }
         }
         
         int Start(bool realtime)
@@ -1061,24 +1113,24 @@ class DSPThread {
             }
                                    
             if ((res = pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_JOINABLE))) {
-                printf("Cannot request joinable thread creation for real-time thread res = %d err = %s\n", res, strerror(errno));
+                ThreadError("Cannot request joinable thread creation for real-time thread", res);
                 return -1;
             }
 
             if ((res = pthread_attr_setscope(&attributes, PTHREAD_SCOPE_SYSTEM))) {
-                printf("Cannot set scheduling scope for real-time thread res = %d err = %s\n", res, strerror(errno));
+                ThreadError("Cannot set scheduling scope for real-time thread", res);
                 return -1;
             }
 
             if (realtime) {
                 
                 if ((res = pthread_attr_setinheritsched(&attributes, PTHREAD_EXPLICIT_SCHED))) {
-                    printf("Cannot request explicit scheduling for RT thread res = %d err = %s\n", res, strerror(errno));
+                    ThreadError("Cannot request explicit scheduling for RT thread", res);
                     return -1;
                 }
             
                 if ((res = pthread_attr_setschedpolicy(&attributes, JACK_SCHED_POLICY))) {
-                    printf("Cannot set RR scheduling class for RT thread res = %d err = %s\n", res, strerror(errno));
+                    ThreadError("Cannot set RR scheduling class for RT thread", res);
                     return -1;
                 }
                 
@@ -1086,25 +1138,27 @@ class DSPThread {
                 rt_param.sched_priority = priority;
 
                 if ((res = pthread_attr_setschedparam(&attributes, &rt_param))) {
-                    printf("Cannot set scheduling priority for RT thread res = %d err = %s\n", res, strerror(errno));
+                    ThreadError("Cannot set scheduling priority for RT thread", res);
                     return -1;
                 }
 
             } else {
                 
                 if ((res = pthread_attr_setinheritsched(&attributes, PTHREAD_INHERIT_SCHED))) {
-                    printf("Cannot request explicit scheduling for RT thread res = %d err = %s\n", res, strerror(errno));
+                    ThreadError("Cannot request explicit scheduling for RT thread", res);
                     return -1;
                 }
             }
          
             if ((res = pthread_attr_setstacksize(&attributes, THREAD_STACK))) {
-                printf("Cannot set thread stack size res = %d err = %s\n", res, strerror(errno));
+                ThreadError("Cannot set thread stack size", res);
                 return -1;
             }
             
+            fRunning = true;
             if ((res = pthread_create(&fThread, &attributes, ThreadHandler, this))) {
-                printf("Cannot create thread res = %d err = %s\n", res, strerror(errno));
+                ThreadError("Cannot create thread", res);
+                fRunning = false;
                 return -1;
             }
             
@@ -1115,9 +1169,14 @@ class DSPThread {
             return 0;
         }
         
+        // The thread leaves its loop when woken up with 'fRunning' cleared, and is then joined
         void Stop()
         {
-            CancelThread(fThread);
+            if (!fRunning.exchange(false)) {
+                return;
+            }
+            Signal();
+            pthread_join(fThread, NULL);
         }
 
 };
@@ -1193,12 +1252,68 @@ class WorkStealingScheduler {
         int fReadyTaskListSize;
         int fReadyTaskListIndex;
     
+        /*
+         Per-thread counters, activated with OMP_TASK_STATS=1 and displayed when the scheduler is deleted.
+         A task is timed from the moment the scheduler gives it to the thread until the next scheduler
+         call of the thread, so it includes the tasks directly chained after it in the generated code.
+         */
+        struct ThreadStats {
+            int fTask;
+            uint64_t fStart;
+            uint64_t fSteals;
+            uint64_t fFailedSteals;
+            uint64_t* fTaskTime;
+            uint64_t* fTaskCount;
+            char fPad[64];
+        };
+        
+        ThreadStats* fStats;
+        int fTaskQueueSize;
+        
+        INLINE void EndTask(int cur_thread)
+        {
+            if (fStats && fStats[cur_thread].fTask != WORK_STEALING_INDEX) {
+                ThreadStats& stats = fStats[cur_thread];
+                stats.fTaskTime[stats.fTask] += GetTicks() - stats.fStart;
+                stats.fTaskCount[stats.fTask]++;
+                stats.fTask = WORK_STEALING_INDEX;
+            }
+        }
+        
+        INLINE void StartTask(int cur_thread, int task_num)
+        {
+            if (fStats && task_num != WORK_STEALING_INDEX) {
+                fStats[cur_thread].fTask = task_num;
+                fStats[cur_thread].fStart = GetTicks();
+            }
+        }
+        
+        void PrintStats()
+        {
+            printf("Scheduler statistics (%d threads)\n", fStaticNumThreads);
+            for (int thread = 0; thread < fStaticNumThreads; thread++) {
+                printf("Thread %d : steals = %llu failed steals = %llu\n", thread,
+                       (unsigned long long)fStats[thread].fSteals, (unsigned long long)fStats[thread].fFailedSteals);
+            }
+            for (int task = LAST_TASK_INDEX; task < fTaskQueueSize; task++) {
+                uint64_t time = 0, count = 0;
+                for (int thread = 0; thread < fStaticNumThreads; thread++) {
+                    time += fStats[thread].fTaskTime[task];
+                    count += fStats[thread].fTaskCount[task];
+                }
+                if (count > 0) {
+                    printf("Task %d : count = %llu mean = %.3f usec\n", task, (unsigned long long)count, double(time) / double(count) / 1000.);
+                }
+            }
+        }
+    
     public:
     
         WorkStealingScheduler(int task_queue_size, int init_task_list_size)
         {
-            fStaticNumThreads = get_max_cpu();
-            fDynamicNumThreads = getenv("OMP_NUM_THREADS") ? atoi(getenv("OMP_NUM_THREADS")) : fStaticNumThreads;
+            // OMP_NUM_THREADS can be used to force the number of threads
+            fStaticNumThreads = getenv("OMP_NUM_THREADS") ? Range(1, 1024, atoi(getenv("OMP_NUM_THREADS"))) : get_max_cpu();
+            fDynamicNumThreads = fStaticNumThreads;
             
             fThreadPool = new DSPThreadPool(fStaticNumThreads);
             fTaskGraph = new TaskGraph(task_queue_size);
@@ -1210,6 +1325,22 @@ class WorkStealingScheduler {
             fReadyTaskListSize = init_task_list_size;
             fReadyTaskList = new int[fReadyTaskListSize];
             fReadyTaskListIndex = 0;
+            
+            fTaskQueueSize = task_queue_size;
+            fStats = NULL;
+            if (getenv("OMP_TASK_STATS") && strtol(getenv("OMP_TASK_STATS"), NULL, 10)) {
+                fStats = new ThreadStats[fStaticNumThreads];
+                for (int i = 0; i < fStaticNumThreads; i++) {
+                    fStats[i].fTask = WORK_STEALING_INDEX;
+                    fStats[i].fStart = 0;
+                    fStats[i].fSteals = 0;
+                    fStats[i].fFailedSteals = 0;
+                    fStats[i].fTaskTime = new uint64_t[task_queue_size];
+                    fStats[i].fTaskCount = new uint64_t[task_queue_size];
+                    memset(fStats[i].fTaskTime, 0, sizeof(uint64_t) * task_queue_size);
+                    memset(fStats[i].fTaskCount, 0, sizeof(uint64_t) * task_queue_size);
+                }
+            }
         }
         
         ~WorkStealingScheduler()
@@ -1218,6 +1349,14 @@ class WorkStealingScheduler {
             delete fTaskGraph;
             delete[] fTaskQueueList;
             delete[] fReadyTaskList;
+            if (fStats) {
+                PrintStats();
+                for (int i = 0; i < fStaticNumThreads; i++) {
+                    delete[] fStats[i].fTaskTime;
+                    delete[] fStats[i].fTaskCount;
+                }
+                delete[] fStats;
+            }
         }
         
         void AddReadyTask(int task_num)
@@ -1244,7 +1383,13 @@ class WorkStealingScheduler {
         
         void SyncAll()
         {
-            //while (!fThreadPool->IsFinished()) {}
+            // Wait for the threads to leave the cycle, so that the queues can be filled again
+            while (!fThreadPool->IsFinished()) {
+                Pause();
+            }
+            for (int i = 0; i < fDynamicNumThreads; i++) {
+                EndTask(i);
+            }
             fDynThreadAdapter.StopMeasure(fStaticNumThreads, fDynamicNumThreads);
         }
         
@@ -1253,9 +1398,28 @@ class WorkStealingScheduler {
             fTaskQueueList[cur_thread].PushHead(task_num);
         }
           
+        // Own queue first, then steal in the other ones starting with the next thread
         int GetNextTask(int cur_thread)
         {
-            return TaskQueue::GetNextTask(fTaskQueueList, cur_thread, fDynamicNumThreads);
+            EndTask(cur_thread);
+            int task_num = fTaskQueueList[cur_thread].PopHead();
+            for (int i = 1; i < fDynamicNumThreads && task_num == WORK_STEALING_INDEX; i++) {
+                task_num = fTaskQueueList[(cur_thread + i) % fDynamicNumThreads].PopTail();
+                if (fStats && task_num != WORK_STEALING_INDEX) {
+                    fStats[cur_thread].fSteals++;
+                }
+            }
+            if (task_num != WORK_STEALING_INDEX) {
+                fTaskQueueList[cur_thread].ResetStealingDur();
+                StartTask(cur_thread, task_num);
+            } else {
+                if (fStats) {
+                    fStats[cur_thread].fFailedSteals++;
+                }
+                // Otherwise will try "workstealing" again next cycle...
+                fTaskQueueList[cur_thread].MeasureStealingDur();
+            }
+            return task_num;
         }
         
         void InitTask(int task_num, int count)
@@ -1265,29 +1429,34 @@ class WorkStealingScheduler {
         
         void ActivateOutputTask(int cur_thread, int task, int* task_num)
         {
+            EndTask(cur_thread);
             fTaskGraph->ActivateOutputTask(fTaskQueueList[cur_thread], task, task_num);
         }
         
         void ActivateOutputTask(int cur_thread, int task)
         {
+            EndTask(cur_thread);
             fTaskGraph->ActivateOutputTask(fTaskQueueList[cur_thread], task);
         }
         
         void ActivateOneOutputTask(int cur_thread, int task, int* task_num)
         {
+            EndTask(cur_thread);
             fTaskGraph->ActivateOneOutputTask(fTaskQueueList[cur_thread], task, task_num);
+            StartTask(cur_thread, *task_num);
         }
                 
         void GetReadyTask(int cur_thread, int* task_num)
         {
+            EndTask(cur_thread);
             fTaskGraph->GetReadyTask(fTaskQueueList[cur_thread], task_num);
+            StartTask(cur_thread, *task_num);
         }
         
         void InitTaskList(int cur_thread)
         {
-            TaskQueue::InitAll(fTaskQueueList, fDynamicNumThreads);
             if (cur_thread == -1) {
-                // Dispatch on all WSQ
+                // Dispatch on all WSQ (the other threads are not running yet)
                 for (int i = 0; i < fDynamicNumThreads; i++) {
                     fTaskQueueList[i].InitTaskList(fReadyTaskListSize, fReadyTaskList, fDynamicNumThreads, i);
                 }
@@ -0,0 +1,19 @@
+#!/bin/bash
+# Measure the Interpreter backend on all DSP files, using 'faustbench-interp' (see tools/benchmark)
+# Usage : bench-interp.sh [additional Faust options]
+BENCH=${FAUSTBENCH_INTERP:-faustbench-interp}
+DST=results-interp-$(date +%y%m%d.%H%M%S)
+
+echo "Faust Interpreter Benchmark : " $@ > $DST
+uname -a >> $DST
+date  >> $DST
+
+for d in *.dsp; do
+	echo $d
+	$BENCH $@ $d | grep "DSP CPU" >> $DST
+done
+
+for d in *.dsp; do
+	echo $d
+	$BENCH -vec -lv 1 -vs 32 $@ $d | grep "DSP CPU" >> $DST
+done
@@ -33,6 +33,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <map>
 #include <ostream>
 #include <set>
@@ -41,6 +42,12 @@
 #include <string>
 #include <utility>
 #include <vector>
+#ifndef EMCC
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#endif
 
 #include "blockSchema.h"
 #include "boxcomplexity.hh"
@@ -121,8 +128,16 @@
 
 using namespace std;
 
+// A top level diagram, generated and waiting to be drawn in its file
+struct schemaFile {
+    string  fName;
+    schema* fSchema;
+};
+
 // prototypes of internal functions
-static void    writeSchemaFile(Tree bd);
+static schemaFile generateSchemaFile(Tree bd);
+static void       drawSchemaFiles(const vector<schemaFile>& files);
+
 static schema* generateDiagramSchema(Tree bd);
 static schema* generateInsideSchema(Tree t);
 static void    scheduleDrawing(Tree t);
@@ -152,10 +167,14 @@ void drawSchema(Tree bd, const char* projname, const char* dev)
 
     scheduleDrawing(bd);  // schedule the initial drawing
 
-    Tree t;
+    // Generating the schemas schedules the folded sub-diagrams and uses the tree properties,
+    // so it is done sequentially. The files are then drawn independently.
+    vector<schemaFile> files;
+    Tree               t;
     while (pendingDrawing(t)) {
-        writeSchemaFile(t);  // generate all the pending drawing
+        files.push_back(generateSchemaFile(t));  // generate all the pending drawing
     }
+    drawSchemaFiles(files);
 
     choldDir();  // return to current directory
 }
@@ -224,11 +243,11 @@ static bool pendingDrawing(Tree& t)
 //------------------------ dealing with files -------------------------
 
 /**
- * Write a top level diagram. A top level diagram
+ * Generate a top level diagram. A top level diagram
  * is decorated with its definition name property
  * and is drawn in an individual file.
  */
-static void writeSchemaFile(Tree bd)
+static schemaFile generateSchemaFile(Tree bd)
 {
     Tree    id;
     schema* ts;
@@ -236,7 +255,6 @@ static void writeSchemaFile(Tree bd)
 
     char temp[1024];
 
-    gGlobal->gOccurrences = new Occur(bd);
     getBoxType(bd, &ins, &outs);
 
     bool hasname = getDefNameProperty(bd, id);
@@ -257,25 +275,84 @@ static void writeSchemaFile(Tree bd)
     string link = gGlobal->gBackLink[bd];
     ts = makeTopSchema(addSchemaOutputs(outs, addSchemaInputs(ins, generateInsideSchema(bd))), 20,
                        tree2str(id), link);
-    // draw to the device defined by gDevSuffix
+    return {res1, ts};
+}
+
+/**
+ * Place a top level diagram and draw it to a device.
+ */
+static void drawSchemaFile(schema* ts, device& dev)
+{
+    ts->place(0, 0, kLeftRight);
+    ts->draw(dev);
+    {
+        collector c;
+        ts->collectTraits(c);
+        c.draw(dev);
+    }
+}
+
+/**
+ * Draw a top level diagram to the device defined by gDevSuffix.
+ * Only reads the drawing options in gGlobal.
+ */
+static void drawSchemaFile(const schemaFile& file)
+{
+    schema* ts = file.fSchema;
     if (strcmp(gGlobal->gDevSuffix, "svg") == 0) {
-        SVGDev dev(res1.c_str(), ts->width(), ts->height());
-        ts->place(0, 0, kLeftRight);
-        ts->draw(dev);
-        {
-            collector c;
-            ts->collectTraits(c);
-            c.draw(dev);
-        }
+        SVGDev dev(file.fName.c_str(), ts->width(), ts->height());
+        drawSchemaFile(ts, dev);
     } else {
-        PSDev dev(res1.c_str(), ts->width(), ts->height());
-        ts->place(0, 0, kLeftRight);
-        ts->draw(dev);
-        {
-            collector c;
-            ts->collectTraits(c);
-            c.draw(dev);
+        PSDev dev(file.fName.c_str(), ts->width(), ts->height());
+        drawSchemaFile(ts, dev);
+    }
+}
+
+/**
+ * Draw all the generated diagrams. Each schema is only placed
+ * and drawn by one thread, so SVG files are drawn in parallel.
+ * PS files are numbered in drawing order, thus drawn sequentially.
+ */
+static void drawSchemaFiles(const vector<schemaFile>& files)
+{
+#ifndef EMCC
+    size_t threads = 1;
+    if (strcmp(gGlobal->gDevSuffix, "svg") == 0) {
+        threads = std::min<size_t>(std::max(thread::hardware_concurrency(), 1u), files.size());
+    }
+    if (threads > 1) {
+        global*        global_ctx = gGlobal;
+        atomic<size_t> next(0);
+        mutex          error_lock;
+        exception_ptr  error;
+        vector<thread> workers;
+        for (size_t i = 0; i < threads; i++) {
+            workers.emplace_back([&]() {
+                gGlobal = global_ctx;
+                for (size_t j = next++; j < files.size(); j = next++) {
+                    try {
+                        drawSchemaFile(files[j]);
+                    } catch (...) {
+                        lock_guard<mutex> lock(error_lock);
+                        if (!error) {
+                            error = current_exception();
+                        }
+                        next = files.size();
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
         }
+        if (error) {
+            rethrow_exception(error);
+        }
+        return;
+    }
+#endif
+    for (const auto& file : files) {
+        drawSchemaFile(file);
     }
 }
 
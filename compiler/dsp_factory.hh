@@ -37,7 +37,7 @@
 #define COMPILATION_OPTIONS_KEY "compile_options"
 #define COMPILATION_OPTIONS "declare compile_options "
 
-extern std::vector<std::string> gWarningMessages;
+extern thread_local std::vector<std::string> gWarningMessages;
 
 /*
  In order to better separate compilation and execution for dynamic backends (LLVM, Interpreter,
@@ -200,10 +200,21 @@ class CTree;
 typedef CTree*              Signal;
 typedef std::vector<Signal> tvec;
 
+struct dsp_factory_cache_context;
+
 dsp_factory_base* createFactory(const std::string& name_app, const std::string& dsp_content,
                                 int argc, const char* argv[], std::string& error_msg,
                                 bool generate);
 
+/*
+ Used by the dynamic backends: after evaluation, the DSP is not compiled if the code of the same
+ evaluated DSP is already in the factory cache. In this case nullptr is returned with
+ 'cache.fCached' set, and the code has to be read with 'cache.fProcessKey'.
+ */
+dsp_factory_base* createFactory(const std::string& name_app, const std::string& dsp_content,
+                                int argc, const char* argv[], std::string& error_msg,
+                                dsp_factory_cache_context& cache);
+
 dsp_factory_base* createFactory(const std::string& name_app, tvec signals, int argc,
                                 const char* argv[], std::string& error_msg);
 
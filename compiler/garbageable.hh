@@ -24,10 +24,54 @@
 
 #include <stdio.h>
 #include <new>
+#include <vector>
 
 #include "exception.hh"
 #include "faust/export.h"
 
+/*
+ Arena backing the Garbageable objects of a compilation: allocation is a pointer bump in large chunks,
+ and all memory is released at once by 'Garbageable::cleanup'. Live objects are chained using a header
+ placed before each of them, so that their destructors can be called at cleanup time. An explicitly
+ deleted object is unlinked in constant time, and its memory kept in a free list of its size to be reused.
+*/
+
+class GarbageableArena {
+   public:
+    struct Header {
+        Header* fPrev;
+        Header* fNext;
+    };
+
+    static const size_t kAlign      = 16;       // alignment of the allocated objects
+    static const size_t kHeaderSize = 16;       // 'Header' size rounded to kAlign
+    static const size_t kChunkSize  = 1 << 20;  // objects are bump allocated in chunks of this size
+
+   private:
+    std::vector<char*> fChunks;  // allocated chunks and large blocks
+    char*              fCurrent;
+    char*              fEnd;
+    Header*            fObjects;    // live objects, most recently allocated first
+    std::vector<Header*> fFreeLists;  // deleted blocks (chained with 'fNext'), indexed by size / kAlign
+
+    static size_t blockSize(size_t size)
+    {
+        // HACK : add 16 bytes to avoid unsolved memory smashing bug...
+        return kHeaderSize + ((size + 16 + kAlign - 1) & ~(kAlign - 1));
+    }
+
+   public:
+    GarbageableArena() : fCurrent(nullptr), fEnd(nullptr), fObjects(nullptr) {}
+    ~GarbageableArena() { release(); }
+
+    void* allocate(size_t size);
+    void  unlink(void* ptr, size_t size);
+    void  release();
+
+    Header*      first() const { return fObjects; }
+    static void* object(Header* header) { return reinterpret_cast<char*>(header) + kHeaderSize; }
+};
+
 // To be inherited by all garbageable classes
 
 class LIBFAUST_API Garbageable {
@@ -37,8 +81,8 @@ class LIBFAUST_API Garbageable {
 
     void* operator new(size_t size);
     void* operator new[](size_t size);
-    void  operator delete(void* ptr);
-    void  operator delete[](void* ptr);
+    void  operator delete(void* ptr, size_t size);
+    void  operator delete[](void* ptr, size_t size);
 
     static void cleanup();
 };
@@ -43,7 +43,7 @@ using namespace std;
  architecture file (doing the proper cast on arguments and return value when needed)
  */
 
-map<string, bool> CInstVisitor::gFunctionSymbolTable;
+thread_local map<string, bool> CInstVisitor::gFunctionSymbolTable;
 
 dsp_factory_base* CCodeContainer::produceFactory()
 {
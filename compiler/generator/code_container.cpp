@@ -98,7 +98,7 @@ CodeContainer::CodeContainer()
     }
 }
 
-int ZoneArray::gInternalMemorySize = 0;
+thread_local int ZoneArray::gInternalMemorySize = 0;
 
 CodeContainer::~CodeContainer()
 {
@@ -473,6 +473,11 @@ void CodeContainer::processFIR(void)
         CodeLoop::groupSeqLoops(fCurLoop, visited);
     }
 
+    // Possibly groups cheap tasks using the cost model
+    if (gGlobal->gVectorSwitch && gGlobal->gTaskCostThreshold > 0) {
+        CodeLoop::groupCheapLoops(fCurLoop, gGlobal->gTaskCostThreshold, &cerr);
+    }
+
     if (gGlobal->gMemoryManager >= 0) {
         createMemoryLayout();
     }
@@ -59,7 +59,7 @@ as local variables at the begining of 'compute'.
  - soundfile primitive support: https://rnbo.cycling74.com/learn/audio-files-in-rnbo
  */
 
-map<string, bool> CodeboxInstVisitor::gFunctionSymbolTable;
+thread_local map<string, bool> CodeboxInstVisitor::gFunctionSymbolTable;
 
 dsp_factory_base* CodeboxCodeContainer::produceFactory()
 {
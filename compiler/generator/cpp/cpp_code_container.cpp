@@ -43,7 +43,7 @@ using namespace std;
  architecture file (doing the proper cast on arguments and return value when needed)
  */
 
-map<string, bool> CPPInstVisitor::gFunctionSymbolTable;
+thread_local map<string, bool> CPPInstVisitor::gFunctionSymbolTable;
 
 dsp_factory_base* CPPCodeContainer::produceFactory()
 {
@@ -845,6 +845,10 @@ void CPPCodeContainer::produceClass()
         *fOut << "dsp_memory_manager* " << fKlassName << "::fManager = nullptr;" << endl;
     }
 
+    if (gGlobal->gBatchSize > 0) {
+        generateBatch(n);
+    }
+
     // Generate user interface macros if needed
     printMacros(*fOut, n);
 
@@ -899,6 +903,245 @@ void CPPScalarCodeContainer::generateCompute(int n)
 
     back(1, *fOut);
     *fOut << "}";
+
+    if (gGlobal->gControlEvents) {
+        generateComputeEvents(n);
+    }
+}
+
+/*
+ With -cev, 'computeEvents' gets a list of control events sorted by date. The block is computed
+ by sub-blocks between successive dates: the events are written in their zones, then the control
+ part of 'compute' is executed again and the sample loop runs on the sub-block, all in one call.
+*/
+void CPPScalarCodeContainer::generateComputeEvents(int n)
+{
+    tab(n + 1, *fOut);
+    tab(n + 1, *fOut);
+    if (gGlobal->gInPlace) {
+        *fOut << genVirtual()
+              << subst("void computeEvents(int $0, $1** inputs, $1** outputs, int nevents, const "
+                       "dsp_control_event* events) {",
+                       fFullCount, xfloat());
+    } else {
+        *fOut << genVirtual()
+              << subst("void computeEvents(int $0, $1** RESTRICT inputs, $1** RESTRICT outputs, "
+                       "int nevents, const dsp_control_event* events) {",
+                       fFullCount, xfloat());
+    }
+    tab(n + 2, *fOut);
+    *fOut << "int iEvent = 0;";
+    tab(n + 2, *fOut);
+    *fOut << "int iStart = 0;";
+    tab(n + 2, *fOut);
+    *fOut << "while (iStart < " << fFullCount << ") {";
+    tab(n + 3, *fOut);
+    *fOut << "while (iEvent < nevents && events[iEvent].fDate <= iStart) {";
+    tab(n + 4, *fOut);
+    *fOut << "*events[iEvent].fZone = events[iEvent].fValue;";
+    tab(n + 4, *fOut);
+    *fOut << "iEvent++;";
+    tab(n + 3, *fOut);
+    *fOut << "}";
+    tab(n + 3, *fOut);
+    *fOut << "int iEnd = (iEvent < nevents && events[iEvent].fDate < " << fFullCount
+          << ") ? events[iEvent].fDate : " << fFullCount << ";";
+    tab(n + 3, *fOut);
+    fCodeProducer->Tab(n + 3);
+
+    // Generates local variables declaration and setup
+    generateComputeBlock(fCodeProducer);
+
+    // Generates the scalar loop on the sub-block
+    ForLoopInst* loop = fCurLoop->generateScalarSubLoop("iStart", "iEnd");
+    loop->accept(fCodeProducer);
+
+    generatePostComputeBlock(fCodeProducer);
+
+    *fOut << "iStart = iEnd;";
+    tab(n + 2, *fOut);
+    *fOut << "}";
+    tab(n + 2, *fOut);
+    *fOut << "// Events dated after the end of the block";
+    tab(n + 2, *fOut);
+    *fOut << "for (; iEvent < nevents; iEvent++) {";
+    tab(n + 3, *fOut);
+    *fOut << "*events[iEvent].fZone = events[iEvent].fValue;";
+    tab(n + 2, *fOut);
+    *fOut << "}";
+    tab(n + 1, *fOut);
+    *fOut << "}";
+}
+
+/*
+ With -bs <n>, a '<klass>Batch' class computes <n> instances of the DSP in lockstep. Their fields are
+ laid out as structure of arrays (see BatchLaneRewriter), and the sample loop runs on the instances
+ in an inner loop, which can be vectorized by the C++ compiler even for recursive DSPs.
+ Each 'computeBatch' buffer is a DSP input or output channel with the samples of the instances
+ interleaved: 'inputs[chan][frame * instances + lane]'. Only the first 'getBatchSize()' instances are
+ computed when 'instances' is larger.
+*/
+static ForLoopInst* genLaneLoop(BlockInst* code, ValueInst* end)
+{
+    DeclareVarInst* loop_decl =
+        IB::genDecLoopVar("lane", IB::genInt32Typed(), IB::genInt32NumInst(0));
+    return IB::genForLoopInst(loop_decl, IB::genLessThan(loop_decl->load(), end),
+                              loop_decl->store(IB::genAdd(loop_decl->load(), 1)), code);
+}
+
+void CPPScalarCodeContainer::generateBatch(int n)
+{
+    int        size  = gGlobal->gBatchSize;
+    BlockInst* empty = IB::genBlockInst();
+    BatchLaneRewriter rewriter(size, fDeclarationInstructions, "lane", Address::kLoop);
+
+    // Generates a method running 'block' on all lanes
+    auto generateLaneMethod = [&](const string& proto, BlockInst* block) {
+        BlockInst* code = IB::genBlockInst();
+        code->pushBackInst(genLaneLoop(rewriter.getCode(block), IB::genInt32NumInst(size)));
+        tab(n + 1, *fOut);
+        tab(n + 1, *fOut);
+        *fOut << proto << " {";
+        tab(n + 2, *fOut);
+        fCodeProducer->Tab(n + 2);
+        code->accept(fCodeProducer);
+        back(1, *fOut);
+        *fOut << "}";
+    };
+
+    tab(n, *fOut);
+    *fOut << "class " << fKlassName << "Batch {";
+    tab(n + 1, *fOut);
+    tab(n, *fOut);
+    *fOut << " private:";
+    tab(n + 1, *fOut);
+
+    // Fields of all lanes
+    fCodeProducer->Tab(n + 1);
+    tab(n + 1, *fOut);
+    for (const auto& it : fDeclarationInstructions->fCode) {
+        DeclareVarInst* dec = dynamic_cast<DeclareVarInst*>(it);
+        if (dec && dec->fAddress->isStruct()) {
+            rewriter.genDecLaneVar(dec->getName(), dec->fType, Address::kStruct)
+                ->accept(fCodeProducer);
+        }
+    }
+
+    tab(n, *fOut);
+    *fOut << " public:";
+
+    tab(n + 1, *fOut);
+    *fOut << "int getBatchSize() { return " << size << "; }";
+    tab(n + 1, *fOut);
+    *fOut << "int getNumInputs() { return " << fNumInputs << "; }";
+    tab(n + 1, *fOut);
+    *fOut << "int getNumOutputs() { return " << fNumOutputs << "; }";
+    tab(n + 1, *fOut);
+
+    // Static tables are shared with the DSP class
+    tab(n + 1, *fOut);
+    *fOut << "static void classInit(int sample_rate) { " << fKlassName
+          << "::classInit(sample_rate); }";
+
+    BlockInst* init = IB::genBlockInst();
+    init->merge(fInitInstructions);
+    init->merge(fPostInitInstructions);
+    generateLaneMethod("void instanceConstants(int sample_rate)", init);
+    generateLaneMethod("void instanceResetUserInterface()", fResetUserInterfaceInstructions);
+    generateLaneMethod("void instanceClear()", fClearInstructions);
+    tab(n + 1, *fOut);
+
+    tab(n + 1, *fOut);
+    *fOut << "void init(int sample_rate) {";
+    tab(n + 2, *fOut);
+    *fOut << "classInit(sample_rate);";
+    tab(n + 2, *fOut);
+    *fOut << "instanceInit(sample_rate);";
+    tab(n + 1, *fOut);
+    *fOut << "}";
+    tab(n + 1, *fOut);
+    tab(n + 1, *fOut);
+    *fOut << "void instanceInit(int sample_rate) {";
+    tab(n + 2, *fOut);
+    *fOut << "instanceConstants(sample_rate);";
+    tab(n + 2, *fOut);
+    *fOut << "instanceResetUserInterface();";
+    tab(n + 2, *fOut);
+    *fOut << "instanceClear();";
+    tab(n + 1, *fOut);
+    *fOut << "}";
+    tab(n + 1, *fOut);
+
+    // User interface of a given lane
+    {
+        BatchLaneRewriter ui_rewriter(size, fDeclarationInstructions, "lane", Address::kFunArgs);
+        tab(n + 1, *fOut);
+        *fOut << "void buildUserInterface(UI* ui_interface, int lane) {";
+        tab(n + 2, *fOut);
+        fCodeProducer->Tab(n + 2);
+        ui_rewriter.getCode(fUserInterfaceInstructions)->accept(fCodeProducer);
+        back(1, *fOut);
+        *fOut << "}";
+        tab(n + 1, *fOut);
+    }
+
+    // Compute block: the variables not depending of the lane (like buffers) are kept,
+    // the other ones are computed for each lane
+    rewriter.fLaneCount = "instances";
+    BlockInst* declarations = IB::genBlockInst();
+    BlockInst* control      = IB::genBlockInst();
+    for (const auto& it : fComputeBlockInstructions->fCode) {
+        DeclareVarInst* dec = dynamic_cast<DeclareVarInst*>(it);
+        if (dec && dec->fAddress->isStack()) {
+            if (dec->fValue && !rewriter.dependsOnLane(dec->fValue)) {
+                declarations->pushBackInst(dec->clone(&rewriter));
+                rewriter.fLaneBufs.insert(dec->getName());
+            } else {
+                ValueInst* value = (dec->fValue) ? dec->fValue->clone(&rewriter) : nullptr;
+                declarations->pushBackInst(
+                    rewriter.genDecLaneVar(dec->getName(), dec->fType, Address::kStack));
+                rewriter.fLaneVars.insert(dec->getName());
+                if (value) {
+                    control->pushBackInst(IB::genStoreVarInst(
+                        IB::genIndexedAddress(IB::genNamedAddress(dec->getName(), Address::kStack),
+                                              rewriter.genLane()),
+                        value));
+                }
+            }
+        } else {
+            control->pushBackInst(it->clone(&rewriter));
+        }
+    }
+
+    // The sample loop runs on all lanes in its inner loop
+    ForLoopInst* loop = fCurLoop->generateScalarLoop(fFullCount);
+    BlockInst*   body = rewriter.getCode(loop->fCode);
+    loop->fCode       = IB::genBlockInst();
+    loop->fCode->pushBackInst(genLaneLoop(body, IB::genLoadStackVar("lanes")));
+
+    tab(n + 1, *fOut);
+    *fOut << subst(
+        "void computeBatch(int instances, int $0, $1** RESTRICT inputs, $1** RESTRICT outputs) {",
+        fFullCount, xfloat());
+    tab(n + 2, *fOut);
+    // The state only has room for the batch size
+    *fOut << subst("int lanes = (instances < $0) ? instances : $0;", std::to_string(size));
+    tab(n + 2, *fOut);
+    fCodeProducer->Tab(n + 2);
+    declarations->accept(fCodeProducer);
+    genLaneLoop(control, IB::genLoadStackVar("lanes"))->accept(fCodeProducer);
+    loop->accept(fCodeProducer);
+    genLaneLoop((fPostComputeBlockInstructions->fCode.size() > 0)
+                    ? rewriter.getCode(fPostComputeBlockInstructions)
+                    : empty,
+                IB::genLoadStackVar("lanes"))
+        ->accept(fCodeProducer);
+    back(1, *fOut);
+    *fOut << "}";
+
+    tab(n, *fOut);
+    tab(n, *fOut);
+    *fOut << "};" << endl;
 }
 
 // Vector
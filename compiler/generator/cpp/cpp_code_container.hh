@@ -50,6 +50,9 @@ class CPPCodeContainer : public virtual CodeContainer {
     std::string genVirtual();
     std::string genFinal();
 
+    // Batch class generated with -bs, only available in scalar mode
+    virtual void generateBatch(int n) {}
+
     inline bool isPtr(const std::string& type)
     {
         return (type == "kFloat_ptr" || type == "kDouble_ptr" || type == "kQuad_ptr" ||
@@ -210,6 +213,8 @@ class CPPScalarCodeContainer : public CPPCodeContainer {
     virtual ~CPPScalarCodeContainer() {}
 
     void generateCompute(int tab);
+    void generateComputeEvents(int tab);
+    void generateBatch(int tab);
 };
 
 /**
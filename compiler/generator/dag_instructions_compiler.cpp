@@ -329,6 +329,12 @@ ValueInst* DAGInstructionsCompiler::generateCacheCode(Tree sig, ValueInst* exp)
                 if (d < gGlobal->gMaxCopyDelay) {
                     // return subst("$0[i]", vname);
                     return IB::genLoadArrayVar(vname, access, getCurrentLoopIndex());
+                } else if (d >= gGlobal->gMinBlockDelay) {
+                    // we use a block ring buffer
+                    string vname_idx = vname + "_idx";
+                    // return subst("$0[$0_idx+i]", vname);
+                    FIRIndex index1 = getCurrentLoopIndex() + IB::genLoadStructVar(vname_idx);
+                    return IB::genLoadArrayStructVar(vname, index1);
                 } else {
                     // we use a ring buffer
                     string vname_idx = vname + "_idx";
@@ -468,6 +474,18 @@ ValueInst* DAGInstructionsCompiler::generateDelayAccess(Tree sig, Tree exp, Tree
             FIRIndex index = getCurrentLoopIndex() - CS(delay);
             return generateCacheCode(sig, IB::genLoadArrayStackVar(vname, index));
         }
+    } else if (mxd >= gGlobal->gMinBlockDelay) {
+        // long delay : we use a block ring buffer, indexed without wrapping
+        string vname_idx = vname + "_idx";
+
+        // return subst("$0[$0_idx+i-$1]", vname, CS(delay));
+        FIRIndex index1 = getCurrentLoopIndex() + IB::genLoadStructVar(vname_idx);
+        if (isSigInt(delay, &d) && d == 0) {
+            return generateCacheCode(sig, IB::genLoadArrayStructVar(vname, index1));
+        } else {
+            FIRIndex index2 = index1 - CS(delay);
+            return generateCacheCode(sig, IB::genLoadArrayStructVar(vname, index2));
+        }
     } else {
         // long delay : we use a ring buffer of size 2^x
         int    N         = pow2limit(mxd + gGlobal->gVecSize);
@@ -592,6 +610,47 @@ void DAGInstructionsCompiler::generateDlineLoop(BasicTyped* ctype, const string&
         // Set desired variable access
         access = Address::kStack;
 
+    } else if (delay >= gGlobal->gMinBlockDelay) {
+        // Implementation of a block ring-buffer delayline: the samples of each block are written
+        // after the 'delay' previous ones, so that they are read without index wrapping. When the
+        // next block does not fit, the last 'delay' samples are moved at the beginning of the
+        // buffer, the buffer being large enough to do it at most once every 'delay' samples.
+        int size = delay + std::max<int>(delay, gGlobal->gVecSize);
+
+        // create names for temporary and permanent storage
+        string idx      = subst("$0_idx", vname);
+        string idx_save = subst("$0_idx_save", vname);
+
+        // allocate permanent storage for delayed samples
+        pushClearMethod(generateInitArray(vname, ctype, size));
+        pushDeclare(IB::genDecStructVar(idx, IB::genInt32Typed()));
+        pushDeclare(IB::genDecStructVar(idx_save, IB::genInt32Typed()));
+
+        // init permanent memory
+        pushClearMethod(IB::genStoreStructVar(idx, IB::genInt32NumInst(delay)));
+        pushClearMethod(IB::genStoreStructVar(idx_save, IB::genInt32NumInst(0)));
+
+        // -- update index
+        FIRIndex index1 = FIRIndex(IB::genLoadStructVar(idx)) + IB::genLoadStructVar(idx_save);
+        pushPreComputeDSPMethod(IB::genStoreStructVar(idx, index1));
+
+        // -- move the last samples at the beginning of the buffer when the block does not fit
+        BlockInst* then_block = IB::genBlockInst();
+        then_block->pushBackInst(generateMoveArray(vname, idx, delay));
+        then_block->pushBackInst(IB::genStoreStructVar(idx, IB::genInt32NumInst(delay)));
+        FIRIndex index2 = FIRIndex(IB::genLoadStructVar(idx)) + gGlobal->gVecSize;
+        pushPreComputeDSPMethod(IB::genIfInst(FIRIndex(size) < index2, then_block));
+
+        // -- compute the new samples
+        FIRIndex index3 = getCurrentLoopIndex() + IB::genLoadStructVar(idx);
+        pushComputeDSPMethod(IB::genStoreArrayStructVar(vname, index3, exp));
+
+        // -- save index
+        pushPostComputeDSPMethod(IB::genStoreStructVar(idx_save, vsize));
+
+        // Set desired variable access
+        access = Address::kStruct;
+
     } else {
         // Implementation of a ring-buffer delayline, the size should be large enough and aligned on
         // a power of two
@@ -630,6 +689,26 @@ void DAGInstructionsCompiler::generateDlineLoop(BasicTyped* ctype, const string&
     }
 }
 
+StatementInst* DAGInstructionsCompiler::generateMoveArray(const string& vname, const string& idx,
+                                                          int size)
+{
+    string index = gGlobal->getFreshID("j");
+
+    // Generates move loop
+    DeclareVarInst* loop_decl =
+        IB::genDecLoopVar(index, IB::genInt32Typed(), IB::genInt32NumInst(0));
+    ValueInst*    loop_end       = IB::genLessThan(loop_decl->load(), IB::genInt32NumInst(size));
+    StoreVarInst* loop_increment = loop_decl->store(IB::genAdd(loop_decl->load(), 1));
+
+    ForLoopInst* loop = IB::genForLoopInst(loop_decl, loop_end, loop_increment);
+
+    FIRIndex   load_index = (FIRIndex(IB::genLoadStructVar(idx)) - size) + loop_decl->load();
+    ValueInst* load_value = IB::genLoadArrayStructVar(vname, load_index);
+
+    loop->pushFrontInst(IB::genStoreArrayStructVar(vname, loop_decl->load(), load_value));
+    return loop;
+}
+
 StatementInst* DAGInstructionsCompiler::generateCopyBackArray(const string& vname_to,
                                                               const string& vname_from,
                                                               ValueInst* vec_size, int size)
@@ -57,6 +57,7 @@ class DAGInstructionsCompiler : public InstructionsCompiler {
                                          const std::string& vname, int mxd,
                                          Address::AccessType& access, ValueInst* ccs) override;
 
+    StatementInst* generateMoveArray(const std::string& vname, const std::string& idx, int size);
     StatementInst* generateCopyBackArray(const std::string& vname_to, const std::string& vname_from,
                                          ValueInst* vec_size, int size);
 
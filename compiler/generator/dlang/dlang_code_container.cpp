@@ -28,7 +28,7 @@
 
 using namespace std;
 
-map<string, bool> DLangInstVisitor::gFunctionSymbolTable;
+thread_local map<string, bool> DLangInstVisitor::gFunctionSymbolTable;
 
 dsp_factory_base* DLangCodeContainer::produceFactory()
 {
@@ -0,0 +1,453 @@
+/************************************************************************
+ ************************************************************************
+    FAUST compiler
+    Copyright (C) 2024 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ ************************************************************************
+ ************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifdef _WIN32
+#include <sys/utime.h>
+#else
+#include <dirent.h>
+#include <utime.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include "compatibility.hh"
+#include "dsp_factory_cache.hh"
+#include "libfaust.h"
+
+#define CACHE_MAGIC "FAUSTCACHE2"
+#define CACHE_EXTENSION ".fcache"
+
+using namespace std;
+
+// A library an entry depends on, with its size and modification date (-1 when not checked)
+struct Library {
+    string    fPath;
+    long long fSize;
+    long long fDate;  // in nsec
+};
+
+struct Entry {
+    vector<string>         fParts;
+    vector<Library>        fLibraries;
+    size_t                 fSize = 0;
+    list<string>::iterator fUse;
+};
+
+static mutex gCacheLock;
+
+// Initialized with the FAUST_CACHE_DIR environment variable, possibly changed with 'setDirectory'
+static string gCacheDirectory = (getenv("FAUST_CACHE_DIR")) ? getenv("FAUST_CACHE_DIR") : "";
+
+// Initialized with the FAUST_CACHE_SIZE environment variable, possibly changed with 'setDirectorySize'
+static size_t gDirectorySize =
+    (getenv("FAUST_CACHE_SIZE")) ? size_t(strtoull(getenv("FAUST_CACHE_SIZE"), nullptr, 10)) : 0;
+
+// Initialized with the FAUST_CACHE_MEMORY environment variable, possibly changed with 'setMemorySize'
+static size_t gMemorySize =
+    (getenv("FAUST_CACHE_MEMORY")) ? size_t(strtoull(getenv("FAUST_CACHE_MEMORY"), nullptr, 10)) : 0;
+static size_t                       gMemoryUsed = 0;
+static list<string>                 gMemoryUse;  // Keys from the most to the least recently used
+static unordered_map<string, Entry> gMemoryTable;
+
+static string getPath(const string& directory, const string& key)
+{
+    return directory + "/" + key + CACHE_EXTENSION;
+}
+
+// Mark a file entry as the most recently used one, using its modification date
+static void touchFileEntry(const string& path)
+{
+#ifdef _WIN32
+    _utime(path.c_str(), nullptr);
+#else
+    utime(path.c_str(), nullptr);
+#endif
+}
+
+// Modification date in nsec, so that a file modified several times in the same second is seen as modified
+static long long getDate(const struct stat& info)
+{
+#if defined(_WIN32)
+    // Only seconds are available
+    return (long long)info.st_mtime * 1000000000LL;
+#elif defined(__APPLE__)
+    return (long long)info.st_mtimespec.tv_sec * 1000000000LL + (long long)info.st_mtimespec.tv_nsec;
+#else
+    return (long long)info.st_mtim.tv_sec * 1000000000LL + (long long)info.st_mtim.tv_nsec;
+#endif
+}
+
+// The pathnames of the entries in the cache directory
+static vector<string> getFileEntries(const string& directory)
+{
+    vector<string> entries;
+    string         extension = CACHE_EXTENSION;
+#ifdef _WIN32
+    WIN32_FIND_DATAA data;
+    HANDLE           handle = FindFirstFileA((directory + "/*" + extension).c_str(), &data);
+    if (handle != INVALID_HANDLE_VALUE) {
+        do {
+            entries.push_back(directory + "/" + data.cFileName);
+        } while (FindNextFileA(handle, &data));
+        FindClose(handle);
+    }
+#else
+    DIR* dir = opendir(directory.c_str());
+    if (dir) {
+        struct dirent* it;
+        while ((it = readdir(dir))) {
+            string name = it->d_name;
+            if (name.size() > extension.size() &&
+                name.compare(name.size() - extension.size(), extension.size(), extension) == 0) {
+                entries.push_back(directory + "/" + name);
+            }
+        }
+        closedir(dir);
+    }
+#endif
+    return entries;
+}
+
+// Remove the least recently used file entries until the directory size is below 'max_size'
+static void removeFileEntries(const string& directory, size_t max_size)
+{
+    struct File {
+        string    fPath;
+        long long fSize;
+        long long fDate;
+    };
+    vector<File> files;
+    size_t       used = 0;
+    for (const auto& it : getFileEntries(directory)) {
+        struct stat info;
+        if (stat(it.c_str(), &info) == 0) {
+            files.push_back({it, (long long)info.st_size, getDate(info)});
+            used += size_t(info.st_size);
+        }
+    }
+    sort(files.begin(), files.end(),
+         [](const File& a, const File& b) { return a.fDate < b.fDate; });
+    // Entries possibly removed by another process in the meantime are just skipped
+    for (size_t i = 0; i < files.size() && used > max_size; i++) {
+        remove(files[i].fPath.c_str());
+        used -= size_t(files[i].fSize);
+    }
+}
+
+static Library getLibrary(const string& path)
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0) {
+        return {path, (long long)info.st_size, getDate(info)};
+    } else {
+        // Typically a library loaded from an URL
+        return {path, -1, -1};
+    }
+}
+
+static bool checkLibraries(const vector<Library>& libraries)
+{
+    for (const auto& it : libraries) {
+        if (it.fSize >= 0) {
+            Library library = getLibrary(it.fPath);
+            if (library.fSize != it.fSize || library.fDate != it.fDate) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Has to be called with 'gCacheLock' taken
+static void removeMemoryEntries(size_t max_size)
+{
+    while (gMemoryUsed > max_size) {
+        auto it = gMemoryTable.find(gMemoryUse.back());
+        gMemoryUsed -= (*it).second.fSize;
+        gMemoryTable.erase(it);
+        gMemoryUse.pop_back();
+    }
+}
+
+static bool readMemoryEntry(const string& key, Entry& entry)
+{
+    lock_guard<mutex> lock(gCacheLock);
+    auto              it = gMemoryTable.find(key);
+    if (it == gMemoryTable.end()) {
+        return false;
+    }
+    // Now the most recently used
+    gMemoryUse.splice(gMemoryUse.begin(), gMemoryUse, (*it).second.fUse);
+    entry = (*it).second;
+    return true;
+}
+
+static void writeMemoryEntry(const string& key, Entry entry)
+{
+    lock_guard<mutex> lock(gCacheLock);
+    for (const auto& it : entry.fParts) {
+        entry.fSize += it.size();
+    }
+    if (entry.fSize > gMemorySize) {
+        return;
+    }
+    auto it = gMemoryTable.find(key);
+    if (it != gMemoryTable.end()) {
+        gMemoryUsed -= (*it).second.fSize;
+        gMemoryUse.erase((*it).second.fUse);
+        gMemoryTable.erase(it);
+    }
+    removeMemoryEntries(gMemorySize - entry.fSize);
+    gMemoryUse.push_front(key);
+    entry.fUse = gMemoryUse.begin();
+    gMemoryUsed += entry.fSize;
+    gMemoryTable[key] = entry;
+}
+
+static bool readFileEntry(const string& directory, const string& key, Entry& entry)
+{
+    ifstream reader(getPath(directory, key).c_str(), ifstream::in | ifstream::binary);
+    if (!reader.is_open()) {
+        return false;
+    }
+
+    // Header : magic, compiler version, number of libraries and number of parts
+    string magic, version;
+    size_t libraries = 0, count = 0;
+    reader >> magic >> version >> libraries >> count;
+    if (!reader || magic != CACHE_MAGIC || version != FAUSTVERSION) {
+        return false;
+    }
+
+    // Each library : size, date and pathname size then pathname
+    for (size_t i = 0; i < libraries; i++) {
+        Library library;
+        size_t  size = 0;
+        reader >> library.fSize >> library.fDate >> size;
+        if (!reader || reader.get() != '\n') {
+            return false;
+        }
+        library.fPath.resize(size);
+        if (size > 0 && !reader.read(&library.fPath[0], size)) {
+            return false;
+        }
+        entry.fLibraries.push_back(library);
+    }
+
+    // Each part : size then content
+    for (size_t i = 0; i < count; i++) {
+        size_t size = 0;
+        reader >> size;
+        if (!reader || reader.get() != '\n') {
+            return false;
+        }
+        string part(size, '\0');
+        if (size > 0 && !reader.read(&part[0], size)) {
+            return false;
+        }
+        entry.fParts.push_back(part);
+    }
+
+    return true;
+}
+
+static bool writeFileEntry(const string& directory, const string& key, const Entry& entry)
+{
+    // Unique temporary name, so that several threads or processes can write the same entry
+    stringstream tmp_path;
+    tmp_path << getPath(directory, key) << "." << hash<thread::id>()(this_thread::get_id()) << "-"
+             << chrono::high_resolution_clock::now().time_since_epoch().count() << ".tmp";
+
+    {
+        ofstream writer(tmp_path.str().c_str(), ofstream::out | ofstream::binary);
+        if (!writer.is_open()) {
+            return false;
+        }
+        writer << CACHE_MAGIC << " " << FAUSTVERSION << " " << entry.fLibraries.size() << " "
+               << entry.fParts.size() << "\n";
+        for (const auto& it : entry.fLibraries) {
+            writer << it.fSize << " " << it.fDate << " " << it.fPath.size() << "\n";
+            writer.write(it.fPath.data(), it.fPath.size());
+        }
+        for (const auto& it : entry.fParts) {
+            writer << it.size() << "\n";
+            writer.write(it.data(), it.size());
+        }
+        if (!writer) {
+            writer.close();
+            remove(tmp_path.str().c_str());
+            return false;
+        }
+    }
+
+    // Atomically publish the entry (on Windows 'rename' fails if an entry has already been written)
+    if (rename(tmp_path.str().c_str(), getPath(directory, key).c_str()) != 0) {
+        remove(tmp_path.str().c_str());
+        return false;
+    }
+    return true;
+}
+
+static bool readEntry(const string& key, Entry& entry)
+{
+    if (dsp_factory_cache::getMemorySize() > 0 && readMemoryEntry(key, entry)) {
+        return checkLibraries(entry.fLibraries);
+    }
+    string directory = dsp_factory_cache::getDirectory();
+    if (directory != "" && readFileEntry(directory, key, entry)) {
+        if (!checkLibraries(entry.fLibraries)) {
+            return false;
+        }
+        touchFileEntry(getPath(directory, key));
+        if (dsp_factory_cache::getMemorySize() > 0) {
+            writeMemoryEntry(key, entry);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool dsp_factory_cache::setDirectory(const string& path)
+{
+    if (path != "") {
+        int status = faust_mkdir(path.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+        if (status != 0 && errno != EEXIST) {
+            return false;
+        }
+    }
+    lock_guard<mutex> lock(gCacheLock);
+    gCacheDirectory = path;
+    return true;
+}
+
+string dsp_factory_cache::getDirectory()
+{
+    lock_guard<mutex> lock(gCacheLock);
+    return gCacheDirectory;
+}
+
+void dsp_factory_cache::setMemorySize(size_t size)
+{
+    lock_guard<mutex> lock(gCacheLock);
+    gMemorySize = size;
+    removeMemoryEntries(size);
+}
+
+void dsp_factory_cache::setDirectorySize(size_t size)
+{
+    string directory;
+    {
+        lock_guard<mutex> lock(gCacheLock);
+        gDirectorySize = size;
+        directory      = gCacheDirectory;
+    }
+    if (directory != "" && size > 0) {
+        removeFileEntries(directory, size);
+    }
+}
+
+size_t dsp_factory_cache::getDirectorySize()
+{
+    lock_guard<mutex> lock(gCacheLock);
+    return gDirectorySize;
+}
+
+size_t dsp_factory_cache::getMemorySize()
+{
+    lock_guard<mutex> lock(gCacheLock);
+    return gMemorySize;
+}
+
+string dsp_factory_cache::getKey(const string& backend, const string& sha_key)
+{
+    return generateSHA1(string(FAUSTVERSION) + " " + backend + " " + sha_key);
+}
+
+bool dsp_factory_cache::contains(const string& key)
+{
+    Entry entry;
+    return readEntry(key, entry);
+}
+
+bool dsp_factory_cache::read(const string& key, vector<string>& parts)
+{
+    Entry entry;
+    if (readEntry(key, entry)) {
+        parts = entry.fParts;
+        return true;
+    } else {
+        return false;
+    }
+}
+
+bool dsp_factory_cache::write(const string& key, const vector<string>& parts,
+                              const vector<string>& libraries)
+{
+    Entry entry;
+    entry.fParts = parts;
+    for (const auto& it : libraries) {
+        entry.fLibraries.push_back(getLibrary(it));
+    }
+    if (getMemorySize() > 0) {
+        writeMemoryEntry(key, entry);
+    }
+    string directory = getDirectory();
+    if (directory == "") {
+        return isActive();
+    }
+    bool   res  = writeFileEntry(directory, key, entry);
+    size_t size = getDirectorySize();
+    if (res && size > 0) {
+        removeFileEntries(directory, size);
+    }
+    return res;
+}
+
+// External API
+
+extern "C" LIBFAUST_API bool setDSPFactoryCacheDirectory(const char* path)
+{
+    return dsp_factory_cache::setDirectory((path) ? path : "");
+}
+
+extern "C" LIBFAUST_API void setDSPFactoryCacheDirectorySize(size_t size)
+{
+    dsp_factory_cache::setDirectorySize(size);
+}
+
+extern "C" LIBFAUST_API void setDSPFactoryCacheMemorySize(size_t size)
+{
+    dsp_factory_cache::setMemorySize(size);
+}
@@ -0,0 +1,141 @@
+/************************************************************************
+ ************************************************************************
+    FAUST compiler
+    Copyright (C) 2024 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ ************************************************************************
+ ************************************************************************/
+
+#ifndef DSP_FACTORY_CACHE_H
+#define DSP_FACTORY_CACHE_H
+
+#include <string>
+#include <vector>
+
+#include "faust/export.h"
+
+/*
+ Persistent on-disk cache of the code produced by the dynamic backends (Interpreter, WebAssembly
+ and LLVM), so that a factory created again from the same DSP in another process is loaded
+ instead of being compiled.
+
+ Entries are content addressed: the key combines the compiler version, the backend (with its
+ own parameters like the LLVM target) and the factory SHA key, itself computed from the DSP name,
+ the DSP code and the normalized compilation options. The pathnames of the imported libraries
+ are kept with the entry, with their size and modification date (in nsec where the platform
+ provides it): the entry is ignored if one of them has been modified since (libraries loaded
+ from an URL are not checked).
+
+ A compiled DSP is also saved with the key of its evaluated version (the expanded DSP, where
+ all definitions and imported libraries have been evaluated). When the DSP source or a library
+ is modified, the DSP is parsed and evaluated again, but if the evaluated DSP did not change
+ (like when only comments, formatting, unused definitions or unrelated library code were
+ edited), the code is then loaded from this entry and the normalization, type inference and
+ code generation steps are skipped.
+
+ So only what comes after evaluation is cached: parsing the DSP and its libraries and evaluating
+ it are always done again when the source key is not found. Parsed trees cannot be kept between
+ compilations, since they are owned by the compiler state which is deallocated at the end of
+ each compilation.
+
+ Each entry is one file containing a header followed by the list of saved parts (typically the
+ compiled code and possibly helpers). Files are written in a temporary file then renamed, so
+ that concurrent processes sharing the same directory never read a partially written entry.
+
+ The directory size can be bounded: the least recently used entries (the ones with the oldest
+ modification date, which is updated each time an entry is read) are then removed when a new
+ entry is written.
+
+ Entries can also be kept in memory (for instance in a long running compilation service), in a
+ process wide table of limited size where the least recently used entries are removed first.
+
+ The cache is disabled by default, and activated with 'setDSPFactoryCacheDirectory' or by
+ setting the FAUST_CACHE_DIR environment variable, and/or with 'setDSPFactoryCacheMemorySize'.
+ The directory size is bounded with 'setDSPFactoryCacheDirectorySize' or the FAUST_CACHE_SIZE
+ environment variable.
+ */
+
+class dsp_factory_cache {
+   public:
+    // Set the cache directory (created if needed), an empty path deactivates the cache
+    static bool setDirectory(const std::string& path);
+
+    static std::string getDirectory();
+
+    // Set the maximum size in bytes of the cache directory, 0 means unbounded
+    static void setDirectorySize(size_t size);
+
+    static size_t getDirectorySize();
+
+    // Set the maximum size in bytes of the entries kept in memory, 0 deactivates the memory cache
+    static void setMemorySize(size_t size);
+
+    static size_t getMemorySize();
+
+    static bool isActive() { return getDirectory() != "" || getMemorySize() > 0; }
+
+    // Compute the cache key of a factory
+    static std::string getKey(const std::string& backend, const std::string& sha_key);
+
+    // Return true if the key is found in the cache with unchanged libraries
+    static bool contains(const std::string& key);
+
+    // Return true and fill 'parts' if the key is found in the cache with unchanged libraries
+    static bool read(const std::string& key, std::vector<std::string>& parts);
+
+    // Save an entry, with the pathnames of the libraries it depends on
+    static bool write(const std::string& key, const std::vector<std::string>& parts,
+                      const std::vector<std::string>& libraries = {});
+};
+
+// Cache related informations exchanged with 'createFactory' by the dynamic backends
+struct dsp_factory_cache_context {
+    std::string              fBackend;         // In : backend part of the cache keys
+    std::string              fProcessKey;      // Out : key of the evaluated DSP
+    std::vector<std::string> fLibraries;       // Out : pathnames of the imported libraries
+    bool                     fCached = false;  // Out : the evaluated DSP is already in the cache
+
+    dsp_factory_cache_context(const std::string& backend) : fBackend(backend) {}
+};
+
+/**
+ * Set the directory of the persistent cache of compiled factories, shared by the Interpreter,
+ * WebAssembly and LLVM backends. The directory is created if needed.
+ *
+ * @param path - the cache directory, an empty string or nullptr deactivates the cache
+ *
+ * @return true if the cache directory can be used.
+ */
+extern "C" LIBFAUST_API bool setDSPFactoryCacheDirectory(const char* path);
+
+/**
+ * Set the maximum size of the cache directory, where the least recently used factories are
+ * removed first. The size can also be set with the FAUST_CACHE_SIZE environment variable (in bytes).
+ *
+ * @param size - the maximum size in bytes, 0 means unbounded
+ */
+extern "C" LIBFAUST_API void setDSPFactoryCacheDirectorySize(size_t size);
+
+/**
+ * Set the maximum size of the compiled factories kept in memory by the cache, shared by the
+ * Interpreter, WebAssembly and LLVM backends. The memory cache can also be activated by setting
+ * the FAUST_CACHE_MEMORY environment variable (in bytes).
+ *
+ * @param size - the maximum size in bytes, 0 deactivates the memory cache
+ */
+extern "C" LIBFAUST_API void setDSPFactoryCacheMemorySize(size_t size);
+
+#endif
@@ -28,8 +28,8 @@
     Global outside of the global context, compiled here
     to be defined in libfaust and libfaustmachine libraries.
 */
-std::vector<std::string> gWarningMessages;
-bool                     gAllWarning = false;
+thread_local std::vector<std::string> gWarningMessages;
+thread_local bool                     gAllWarning = false;
 
 // External libfaust API
 
@@ -22,6 +22,7 @@
 #ifndef _FIR_TO_FIR_H
 #define _FIR_TO_FIR_H
 
+#include <set>
 #include <stack>
 
 #include "code_container.hh"
@@ -830,4 +831,142 @@ struct NoControlArrayToPointer : public BasicCloneVisitor {
     }
 };
 
+/*
+ Used in the C++ batch class (-bs <n> option) which computes <n> instances of the DSP in lockstep.
+ The fields of the instances are laid out as structure of arrays: a scalar field 'x' becomes 'x[n]',
+ and an array field 'x[size]' becomes 'x[size * n]' with 'x[i]' accessed as 'x[i * n + lane]', so
+ that the code of successive lanes accesses contiguous memory in the inner loop on lanes.
+ */
+struct BatchLaneRewriter : public BasicCloneVisitor {
+    int                           fBatchSize;
+    std::string                   fLane;
+    Address::AccessType           fLaneAccess;
+    std::map<std::string, Typed*> fFields;     // DSP fields with their original type
+    std::set<std::string>         fLaneVars;   // Stack variables kept as one value per lane
+    std::set<std::string>         fLaneBufs;   // Stack buffers with interleaved lanes
+    std::string                   fLaneCount;  // Number of interleaved lanes in buffers
+
+    // Check if a value depends of the lane
+    struct LaneChecker : public DispatchVisitor {
+        BatchLaneRewriter* fRewriter;
+        bool               fDepends;
+
+        LaneChecker(BatchLaneRewriter* rewriter) : fRewriter(rewriter), fDepends(false) {}
+
+        using DispatchVisitor::visit;
+
+        void visit(NamedAddress* address)
+        {
+            fDepends = fDepends || fRewriter->isField(address) ||
+                       fRewriter->fLaneVars.count(address->getName()) > 0;
+        }
+    };
+
+    BatchLaneRewriter(int batch_size, BlockInst* declarations, const std::string& lane,
+                      Address::AccessType lane_access)
+        : fBatchSize(batch_size), fLane(lane), fLaneAccess(lane_access)
+    {
+        for (const auto& it : declarations->fCode) {
+            DeclareVarInst* dec = dynamic_cast<DeclareVarInst*>(it);
+            if (dec && dec->fAddress->isStruct()) {
+                fFields[dec->getName()] = dec->fType;
+            }
+        }
+    }
+
+    bool isField(Address* address)
+    {
+        return address->isStruct() && fFields.find(address->getName()) != fFields.end();
+    }
+
+    bool dependsOnLane(ValueInst* value)
+    {
+        LaneChecker checker(this);
+        value->accept(&checker);
+        return checker.fDepends;
+    }
+
+    ValueInst* genLane() { return IB::genLoadVarInst(IB::genNamedAddress(fLane, fLaneAccess)); }
+
+    // Declaration of a variable for all lanes, its type replaces the original one in the global
+    // name <===> type table, so that the typing of indexed accesses stays correct
+    DeclareVarInst* genDecLaneVar(const std::string& name, Typed* type, Address::AccessType access)
+    {
+        ArrayTyped* array_typed = dynamic_cast<ArrayTyped*>(type);
+        Typed*      lane_type =
+            (array_typed && access == Address::kStruct)
+                ? IB::genArrayTyped(array_typed->fType->clone(this), array_typed->fSize * fBatchSize)
+                : IB::genArrayTyped(type->clone(this), fBatchSize);
+        gGlobal->gVarTypeTable[name] = lane_type;
+        return IB::genDeclareVarInst(IB::genNamedAddress(name, access), lane_type);
+    }
+
+    // UI zones are given by name, the zone of a field becomes its lane entry
+    std::string genZone(const std::string& zone)
+    {
+        return (fFields.find(zone) != fFields.end()) ? zone + "[" + fLane + "]" : zone;
+    }
+
+    virtual StatementInst* visit(AddMetaDeclareInst* inst)
+    {
+        return new AddMetaDeclareInst(genZone(inst->fZone), inst->fKey, inst->fValue);
+    }
+    virtual StatementInst* visit(AddButtonInst* inst)
+    {
+        return new AddButtonInst(inst->fLabel, genZone(inst->fZone), inst->fType);
+    }
+    virtual StatementInst* visit(AddSliderInst* inst)
+    {
+        return new AddSliderInst(inst->fLabel, genZone(inst->fZone), inst->fInit, inst->fMin,
+                                 inst->fMax, inst->fStep, inst->fType);
+    }
+    virtual StatementInst* visit(AddBargraphInst* inst)
+    {
+        return new AddBargraphInst(inst->fLabel, genZone(inst->fZone), inst->fMin, inst->fMax,
+                                   inst->fType);
+    }
+    virtual StatementInst* visit(AddSoundfileInst* inst)
+    {
+        return new AddSoundfileInst(inst->fLabel, inst->fURL, genZone(inst->fSFZone));
+    }
+
+    virtual Address* visit(NamedAddress* address)
+    {
+        if (isField(address)) {
+            if (dynamic_cast<ArrayTyped*>(fFields[address->getName()])) {
+                throw faustexception("ERROR : '-bs' option cannot be used when the '" +
+                                     address->getName() + "' array is used as a whole\n");
+            }
+            return IB::genIndexedAddress(BasicCloneVisitor::visit(address), genLane());
+        } else if (address->isStack() && fLaneVars.count(address->getName()) > 0) {
+            return IB::genIndexedAddress(BasicCloneVisitor::visit(address), genLane());
+        } else {
+            return BasicCloneVisitor::visit(address);
+        }
+    }
+
+    virtual Address* visit(IndexedAddress* address)
+    {
+        NamedAddress* named = dynamic_cast<NamedAddress*>(address->fAddress);
+        if (named && address->fIndices.size() == 1) {
+            ValueInst* index = address->getIndex()->clone(this);
+            if (isField(named)) {
+                Int32NumInst* num   = dynamic_cast<Int32NumInst*>(index);
+                ValueInst*    start = (num) ? IB::genInt32NumInst(num->fNum * fBatchSize)
+                                            : IB::genMul(index, IB::genInt32NumInst(fBatchSize));
+                return IB::genIndexedAddress(BasicCloneVisitor::visit(named),
+                                             IB::genAdd(start, genLane()));
+            } else if (named->isStack() && fLaneVars.count(named->getName()) > 0) {
+                return IB::genIndexedAddress(
+                    IB::genIndexedAddress(BasicCloneVisitor::visit(named), genLane()), index);
+            } else if (named->isStack() && fLaneBufs.count(named->getName()) > 0) {
+                return IB::genIndexedAddress(
+                    BasicCloneVisitor::visit(named),
+                    IB::genAdd(IB::genMul(index, IB::genLoadFunArgsVar(fLaneCount)), genLane()));
+            }
+        }
+        return BasicCloneVisitor::visit(address);
+    }
+};
+
 #endif
@@ -37,14 +37,15 @@ using namespace std;
 //   3: long double precision float
 //   4: fixed-point float
 
-static const char* mathsuffix[5];       // suffix for math functions
-static const char* numsuffix[5];        // suffix for numeric constants
-static const char* floatname[5];        // float types
-static const char* floatptrname[5];     // float ptr types
-static const char* floatptrptrname[5];  // float ptr ptr types
-static const char* castname[5];         // float castings
-static double      floatmin[5];         // minimum float values before denormals
-static int64_t     floatmax[5];         // maximum float values
+// Set for each compilation according to the backend, thus thread-local like gGlobal
+static thread_local const char* mathsuffix[5];       // suffix for math functions
+static thread_local const char* numsuffix[5];        // suffix for numeric constants
+static thread_local const char* floatname[5];        // float types
+static thread_local const char* floatptrname[5];     // float ptr types
+static thread_local const char* floatptrptrname[5];  // float ptr ptr types
+static thread_local const char* castname[5];         // float castings
+static thread_local double      floatmin[5];         // minimum float values before denormals
+static thread_local int64_t     floatmax[5];         // maximum float values
 
 void initFaustFloat()
 {
@@ -30,9 +30,9 @@
 using namespace std;
 
 // Used when inlining functions
-stack<BlockInst*> BasicCloneVisitor::fBlockStack;
+thread_local stack<BlockInst*> BasicCloneVisitor::fBlockStack;
 
-vector<string> NamedTyped::AttributeMap = {" ", " RESTRICT "};
+const vector<string> NamedTyped::AttributeMap = {" ", " RESTRICT "};
 
 BasicTyped* IB::genItFloatTyped()
 {
@@ -580,9 +580,9 @@ Tree  typeArray(int n, Tree t) { return tree(TYPEARRAY, tree(n), t); }
 bool  isTypeArray(Tree t, int* n, Tree& u) { Tree x; return isTree(t, TYPEARRAY, x, u) &&
 isInt(x->node(), n); }
 
-static property<DeclareTypeInst* > gFirTypeProperty;
 
-map<string, int> IB::fIDCounters;
+
+thread_local map<string, int> IB::fIDCounters;
 
 static Tree signalTypeToSharedType(AudioType* type)
 {
@@ -606,7 +606,7 @@ DeclareTypeInst* IB::genType(AudioType* type)
     Tree shared_type = signalTypeToSharedType(type);
     DeclareTypeInst* dec_type;
 
-    if (gFirTypeProperty.get(shared_type, dec_type)) {
+    if (gGlobal->gFirTypeProperty->get(shared_type, dec_type)) {
         return dec_type;
     } else {
         if (isSimpleType(type)) {
@@ -630,7 +630,7 @@ DeclareTypeInst* IB::genType(AudioType* type)
         }
     }
 
-    gFirTypeProperty.set(shared_type, dec_type);
+    gGlobal->gFirTypeProperty->set(shared_type, dec_type);
     return dec_type;
 }
 
@@ -659,12 +659,12 @@ DeclareTypeInst* IB::genType(AudioType* type)
     Tree shared_type = signalTypeToSharedType(type);
     DeclareTypeInst* dec_type;
 
-    if (gFirTypeProperty.get(shared_type, dec_type)) {
+    if (gGlobal->gFirTypeProperty->get(shared_type, dec_type)) {
         return dec_type;
     } else {
         DeclareTypeInst* dec_type
             = genDeclareTypeInst(getFreshID("vecType"), sharedTypeToFirType(shared_type));
-        gFirTypeProperty.set(shared_type, dec_type);
+        gGlobal->gFirTypeProperty->set(shared_type, dec_type);
         return dec_type;
     }
 }
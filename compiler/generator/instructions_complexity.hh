@@ -38,11 +38,14 @@
 class InstComplexityVisitor : public DispatchVisitor {
    private:
     InstComplexity fIComp;
+    int            fDiv;    // number of divisions and modulos
+    bool           fTyped;  // whether binops are typed in the symbol table
 
    public:
     using DispatchVisitor::visit;
 
-    InstComplexityVisitor() {}
+    // 'typed' has to be false when visiting code where all variables are not yet declared
+    InstComplexityVisitor(bool typed = true) : fDiv(0), fTyped(typed) {}
 
     virtual ~InstComplexityVisitor() {}
 
@@ -73,6 +76,14 @@ class InstComplexityVisitor : public DispatchVisitor {
     virtual void visit(BinopInst* inst)
     {
         fIComp.fBinop++;
+        if (inst->fOpcode == kDiv || inst->fOpcode == kRem) {
+            fDiv++;
+        }
+        if (!fTyped) {
+            fIComp.fBinopSymbolTable[std::string(gBinOpTable[inst->fOpcode]->fName)]++;
+            DispatchVisitor::visit(inst);
+            return;
+        }
         Typed::VarType type1 = TypingVisitor::getType(inst->fInst1);
         Typed::VarType type2 = TypingVisitor::getType(inst->fInst2);
         if (isRealType(type1) || isRealType(type2)) {
@@ -109,17 +120,19 @@ class InstComplexityVisitor : public DispatchVisitor {
         inst->fCond->accept(this);
 
         // Max of the 2 branches
-        InstComplexityVisitor then_branch;
+        InstComplexityVisitor then_branch(fTyped);
         inst->fThen->accept(&then_branch);
 
-        InstComplexityVisitor else_branch;
-        inst->fThen->accept(&else_branch);
+        InstComplexityVisitor else_branch(fTyped);
+        inst->fElse->accept(&else_branch);
 
         // Takes the max of both then/else branches
         if (then_branch.cost() > else_branch.cost()) {
             fIComp = fIComp + then_branch.fIComp;
+            fDiv += then_branch.fDiv;
         } else {
             fIComp = fIComp + else_branch.fIComp;
+            fDiv += else_branch.fDiv;
         }
     }
 
@@ -158,10 +171,15 @@ class InstComplexityVisitor : public DispatchVisitor {
              << " Loop = " << fIComp.fLoop << "\n";
     }
 
+    /*
+     Estimated cost in 'simple operation' units: loads, stores, integer and real arithmetic, casts
+     count for 1, selects for 2, divisions and modulos for 8 and math functions calls for 16.
+     Numbers and declarations are considered free.
+     */
     int cost()
     {
-        // A polynom based on measured values
-        return 0;
+        return fIComp.fLoad + fIComp.fStore + (fIComp.fBinop - fDiv) + fDiv * 8 + fIComp.fCast +
+               fIComp.fSelect * 2 + fIComp.fMathop * 16;
     }
 
     InstComplexity getInstComplexity() { return fIComp; }
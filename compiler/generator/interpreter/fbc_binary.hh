@@ -0,0 +1,309 @@
+/************************************************************************
+ ************************************************************************
+    FAUST compiler
+    Copyright (C) 2003-2018 GRAME, Centre National de Creation Musicale
+    ---------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ ************************************************************************
+ ************************************************************************/
+
+#ifndef _FBC_BINARY_H
+#define _FBC_BINARY_H
+
+#include <stdint.h>
+#include <string.h>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "exception.hh"
+
+/*
+ Binary FBC container, written instead of the text format when a factory is written in 'binary' mode,
+ and loaded without any parsing:
+
+ - a fixed size header: magic, versions, factory fields and the table of sections
+ - a string pool: names, labels, keys and values are referenced by their index in the pool
+ - the meta and user interface records
+ - the code records: each block is a header record giving its size, followed by its fixed width
+   instructions. Sub-blocks are referenced by their offset (in records) relative to the instruction,
+   so the code section does not depend on the address it is loaded at.
+ - the int and real constant pools, used by kBlockStoreInt and kBlockStoreReal
+
+ Sections are 8 bytes aligned and in the native byte order, so a file read or mapped at an aligned
+ address is accessed in place.
+ */
+
+#define FBC_BINARY_MAGIC "FBCB"
+#define FBC_BINARY_VERSION 1
+#define FBC_BINARY_ENDIAN 0x01020304
+#define FBC_BINARY_BLOCK -1  // Opcode of a block header record
+
+enum FBCBinarySectionKind {
+    kFBCStringSection,
+    kFBCCharSection,
+    kFBCMetaSection,
+    kFBCUISection,
+    kFBCCodeSection,
+    kFBCIntSection,
+    kFBCRealSection,
+    kFBCSectionCount
+};
+
+enum FBCBinaryBlockKind {
+    kFBCStaticInitBlock,
+    kFBCInitBlock,
+    kFBCResetUIBlock,
+    kFBCClearBlock,
+    kFBCComputeBlock,
+    kFBCComputeDSPBlock,
+    kFBCBlockCount
+};
+
+struct FBCBinarySection {
+    uint32_t fOffset;  // In bytes from the beginning of the file
+    uint32_t fCount;   // In records
+};
+
+struct FBCBinaryHeader {
+    char     fMagic[4];
+    uint32_t fFormatVersion;
+    uint32_t fFileVersion;  // INTERP_FILE_VERSION
+    uint32_t fEndian;
+    uint32_t fRealSize;
+
+    int32_t fNumInputs;
+    int32_t fNumOutputs;
+    int32_t fIntHeapSize;
+    int32_t fRealHeapSize;
+    int32_t fSROffset;
+    int32_t fCountOffset;
+    int32_t fIOTAOffset;
+    int32_t fOptLevel;
+
+    // String indexes
+    uint32_t fFaustVersion;
+    uint32_t fCompileOptions;
+    uint32_t fName;
+    uint32_t fSHAKey;
+
+    int32_t          fBlocks[kFBCBlockCount];  // Index of the top-level block header records
+    FBCBinarySection fSections[kFBCSectionCount];
+    uint32_t         fSize;  // Of the whole file
+};
+
+struct FBCBinaryString {
+    uint32_t fOffset;  // In the char section
+    uint32_t fSize;
+};
+
+struct FBCBinaryMeta {
+    uint32_t fKey;
+    uint32_t fValue;
+};
+
+struct FBCBinaryUI {
+    int32_t  fOpcode;
+    int32_t  fOffset;
+    uint32_t fLabel;
+    uint32_t fKey;
+    uint32_t fValue;
+    uint32_t fPad;
+    double   fInit;
+    double   fMin;
+    double   fMax;
+    double   fStep;
+};
+
+struct FBCBinaryInstruction {
+    int32_t  fOpcode;    // Or FBC_BINARY_BLOCK for a block header
+    int32_t  fIntValue;  // Number of instructions for a block header, table size for kBlockStoreXXX
+    int32_t  fOffset1;
+    int32_t  fOffset2;
+    int32_t  fBranch1;  // Relative index of the sub-block header, or 0
+    int32_t  fBranch2;
+    uint32_t fName;
+    uint32_t fPool;  // Index of the first value in the int or real pool for kBlockStoreXXX
+    double   fRealValue;
+};
+
+static_assert(sizeof(FBCBinaryHeader) % 8 == 0, "FBCBinaryHeader must be 8 bytes aligned");
+static_assert(sizeof(FBCBinaryUI) == 56, "FBCBinaryUI must be packed");
+static_assert(sizeof(FBCBinaryInstruction) == 40, "FBCBinaryInstruction must be packed");
+
+static inline bool isFBCBinary(const char* buffer, size_t size)
+{
+    return size >= 4 && memcmp(buffer, FBC_BINARY_MAGIC, 4) == 0;
+}
+
+// Collects the sections, then writes the file
+template <class REAL>
+struct FBCBinaryWriter {
+    FBCBinaryHeader                 fHeader;
+    std::vector<FBCBinaryString>    fStrings;
+    std::string                     fChars;
+    std::map<std::string, uint32_t> fStringMap;
+    std::vector<FBCBinaryMeta>        fMetas;
+    std::vector<FBCBinaryUI>          fUIs;
+    std::vector<FBCBinaryInstruction> fCode;
+    std::vector<int32_t>              fIntPool;
+    std::vector<REAL>                 fRealPool;
+
+    FBCBinaryWriter()
+    {
+        memset(&fHeader, 0, sizeof(FBCBinaryHeader));
+        memcpy(fHeader.fMagic, FBC_BINARY_MAGIC, 4);
+        fHeader.fFormatVersion = FBC_BINARY_VERSION;
+        fHeader.fEndian        = FBC_BINARY_ENDIAN;
+        fHeader.fRealSize      = sizeof(REAL);
+        addString("");  // Index 0
+    }
+
+    uint32_t addString(const std::string& str)
+    {
+        auto it = fStringMap.find(str);
+        if (it != fStringMap.end()) {
+            return it->second;
+        }
+        uint32_t index = uint32_t(fStrings.size());
+        fStrings.push_back({uint32_t(fChars.size()), uint32_t(str.size())});
+        fChars += str;
+        fStringMap[str] = index;
+        return index;
+    }
+
+    template <class T>
+    void writeSection(std::ostream* out, int kind, const T* data, size_t count, uint32_t& offset)
+    {
+        static const char padding[8] = {0};
+        size_t            size        = count * sizeof(T);
+        fHeader.fSections[kind]       = {offset, uint32_t(count)};
+        if (size > 0) {
+            out->write(reinterpret_cast<const char*>(data), size);
+        }
+        size_t pad = (8 - size % 8) % 8;
+        out->write(padding, pad);
+        offset += uint32_t(size + pad);
+    }
+
+    void write(std::ostream* out)
+    {
+        // Compute the section offsets with a first pass on a null stream
+        std::ostream null_stream(nullptr);
+        writeSections(&null_stream);
+        out->write(reinterpret_cast<const char*>(&fHeader), sizeof(FBCBinaryHeader));
+        writeSections(out);
+    }
+
+   private:
+    void writeSections(std::ostream* out)
+    {
+        uint32_t offset = sizeof(FBCBinaryHeader);
+        writeSection(out, kFBCStringSection, fStrings.data(), fStrings.size(), offset);
+        writeSection(out, kFBCCharSection, fChars.data(), fChars.size(), offset);
+        writeSection(out, kFBCMetaSection, fMetas.data(), fMetas.size(), offset);
+        writeSection(out, kFBCUISection, fUIs.data(), fUIs.size(), offset);
+        writeSection(out, kFBCCodeSection, fCode.data(), fCode.size(), offset);
+        writeSection(out, kFBCIntSection, fIntPool.data(), fIntPool.size(), offset);
+        writeSection(out, kFBCRealSection, fRealPool.data(), fRealPool.size(), offset);
+        fHeader.fSize = offset;
+    }
+};
+
+// Checks the header and the bounds of all sections, then gives a direct access to the records
+template <class REAL>
+struct FBCBinaryReader {
+    const char*            fBuffer;
+    const FBCBinaryHeader* fHeader;
+    std::vector<uint64_t>  fAligned;  // Copy of the buffer if it is not 8 bytes aligned
+
+    static void error() { throw faustexception("ERROR : corrupted binary FBC file\n"); }
+
+    FBCBinaryReader(const char* buffer, size_t size) : fBuffer(buffer)
+    {
+        if (size < sizeof(FBCBinaryHeader) || !isFBCBinary(buffer, size)) {
+            error();
+        }
+        if (reinterpret_cast<uintptr_t>(buffer) % 8 != 0) {
+            fAligned.resize((size + 7) / 8);
+            memcpy(fAligned.data(), buffer, size);
+            fBuffer = reinterpret_cast<const char*>(fAligned.data());
+        }
+        fHeader = reinterpret_cast<const FBCBinaryHeader*>(fBuffer);
+        if (fHeader->fFormatVersion != FBC_BINARY_VERSION || fHeader->fEndian != FBC_BINARY_ENDIAN) {
+            throw faustexception("ERROR : incompatible binary FBC file\n");
+        }
+        if (fHeader->fRealSize != sizeof(REAL) || fHeader->fSize > size) {
+            error();
+        }
+        checkSection<FBCBinaryString>(kFBCStringSection);
+        checkSection<char>(kFBCCharSection);
+        checkSection<FBCBinaryMeta>(kFBCMetaSection);
+        checkSection<FBCBinaryUI>(kFBCUISection);
+        checkSection<FBCBinaryInstruction>(kFBCCodeSection);
+        checkSection<int32_t>(kFBCIntSection);
+        checkSection<REAL>(kFBCRealSection);
+        // Strings are all checked once, so that getString does not have to
+        const FBCBinaryString* strings = getSection<FBCBinaryString>(kFBCStringSection);
+        uint32_t               chars   = count(kFBCCharSection);
+        for (uint32_t i = 0; i < count(kFBCStringSection); i++) {
+            if (strings[i].fOffset > chars || strings[i].fSize > chars - strings[i].fOffset) {
+                error();
+            }
+        }
+    }
+
+    template <class T>
+    void checkSection(int kind)
+    {
+        const FBCBinarySection& section = fHeader->fSections[kind];
+        if (section.fOffset % 8 != 0 || section.fOffset > fHeader->fSize ||
+            uint64_t(section.fCount) * sizeof(T) > fHeader->fSize - section.fOffset) {
+            error();
+        }
+    }
+
+    template <class T>
+    const T* getSection(int kind)
+    {
+        return reinterpret_cast<const T*>(fBuffer + fHeader->fSections[kind].fOffset);
+    }
+
+    uint32_t count(int kind) { return fHeader->fSections[kind].fCount; }
+
+    std::string getString(uint32_t index)
+    {
+        if (index >= count(kFBCStringSection)) {
+            error();
+        }
+        const FBCBinaryString& str = getSection<FBCBinaryString>(kFBCStringSection)[index];
+        return std::string(getSection<char>(kFBCCharSection) + str.fOffset, str.fSize);
+    }
+
+    // Index of the first record of a block, after checking its header
+    const FBCBinaryInstruction* getBlock(int64_t index, int& size)
+    {
+        const FBCBinaryInstruction* code = getSection<FBCBinaryInstruction>(kFBCCodeSection);
+        if (index < 0 || index >= count(kFBCCodeSection) || code[index].fOpcode != FBC_BINARY_BLOCK ||
+            code[index].fIntValue < 0 || code[index].fIntValue > count(kFBCCodeSection) - index - 1) {
+            error();
+        }
+        size = code[index].fIntValue;
+        return &code[index + 1];
+    }
+};
+
+#endif
@@ -46,6 +46,9 @@ class FBCExecutor {
     // Possibly compile (when using LLVM or MIR)
     virtual void compileBlock(FBCBlockInstruction<REAL>* block) {}
 
+    // Possibly pre-decode a block (with the threaded interpreter), before it is executed
+    virtual void threadBlock(FBCBlockInstruction<REAL>* block) {}
+
     virtual void setIntValue(int offset, int value) {}
     virtual int  getIntValue(int offset) { return -1; }
 
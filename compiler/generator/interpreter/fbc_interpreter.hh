@@ -34,6 +34,7 @@
 #include "dsp_aux.hh"
 #include "exception.hh"
 #include "fbc_executor.hh"
+#include "fbc_vec_interpreter.hh"
 #include "interpreter_bytecode.hh"
 
 // #define INTERP_MIR_BUILD 1
@@ -126,6 +127,11 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     REAL** fInputs;
     REAL** fOutputs;
 
+#if !defined(_WIN32)
+    // Executes the non-recursive loops on several iterations at once
+    FBCVecInterpreter<REAL, FBC_VEC_LANES> fVecInterpreter;
+#endif
+
     std::map<int, int64_t> fRealStats;
 
     /*
@@ -2707,7 +2713,26 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         assertInterp(real_stack_index == 0 && int_stack_index == 0);
     }
 #else
-    void executeBlock(FBCBlockInstruction<REAL>* block)
+    void executeBlock(FBCBlockInstruction<REAL>* block) { executeBlockAux(block, false); }
+
+    // Pre-decode a block as direct-threaded code, done once when the factory blocks are loaded
+    virtual void threadBlock(FBCBlockInstruction<REAL>* block) { executeBlockAux(block, true); }
+
+    // Lane compilation of the non-recursive loops (marked with a 'fIntValue' greater than 1 in -vec mode),
+    // done by the first instance since the blocks are shared by all instances of the factory
+    void compileVecLoops(FBCBlockInstruction<REAL>* block)
+    {
+        for (const auto& it : block->fInstructions) {
+            if (it->fOpcode == FBCInstruction::kLoop && it->fIntValue > 1 && !it->fBranch2->fVecBlock) {
+                it->fBranch2->fVecBlock = fVecInterpreter.compile(it);
+            }
+            // Inner loops of the remaining ones
+            if (it->getBranch1() && !it->getBranch1()->fVecBlock) compileVecLoops(it->getBranch1());
+            if (it->getBranch2() && !it->getBranch2()->fVecBlock) compileVecLoops(it->getBranch2());
+        }
+    }
+
+    void executeBlockAux(FBCBlockInstruction<REAL>* block, bool thread)
     {
         static void* fDispatchTable[] = {
 
@@ -2821,9 +2846,31 @@ class FBCInterpreter : public FBCExecutor<REAL> {
             &&do_kLoop, &&do_kReturn,
 
             // Select/if
-            &&do_kIf, &&do_kSelectReal, &&do_kSelectInt, &&do_kCondBranch
+            &&do_kIf, &&do_kSelectReal, &&do_kSelectInt, &&do_kCondBranch,
+
+            // User Interface and kNop (not in code blocks)
+            nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+            nullptr, nullptr, nullptr, nullptr,
+
+            // Superinstructions
+            &&do_kLoadDelayReal, &&do_kLoadDelayRealMult, &&do_kStoreDelayReal,
+            &&do_kLoadIndexedRealStore, &&do_kMultAddRealValue, &&do_kMultAddRealValueStore,
+            &&do_kMultAddRealHeap, &&do_kMultAddRealHeapStack, &&do_kAddRealStore,
+            &&do_kAddRealStackStore, &&do_kStoreMultRealHeap, &&do_kStoreMultRealValue,
+            &&do_kMoveReal2, &&do_kLoadInputIndexed, &&do_kLoadInputIndexedStore,
+            &&do_kStoreOutputIndexed, &&do_kLoopIncLTHeap, &&do_kLoopIncLTValue
 
         };
+        static_assert(sizeof(fDispatchTable) / sizeof(void*) == kSuperInstructionEnd,
+                      "fDispatchTable must have an entry for each opcode and superinstruction");
+
+        // The opcode addresses are only known here, so they are resolved in the threaded code,
+        // when the instance is built (see 'threadBlock'), and never while computing
+        if (thread) {
+            block->thread(fDispatchTable, fFactory->fFuse);
+            return;
+        }
+        faustassert(!block->fThreadedCode.empty());
 
         int real_stack_index = 0;
         int int_stack_index  = 0;
@@ -2831,20 +2878,20 @@ class FBCInterpreter : public FBCExecutor<REAL> {
 
         REAL          real_stack[512];
         int           int_stack[512];
-        InstructionIT address_stack[64];
+        ThreadedIT    address_stack[64];
 
         memset(real_stack, 0, sizeof(REAL) * 512);
         memset(int_stack, 0, sizeof(int) * 512);
-        memset(address_stack, 0, sizeof(InstructionIT) * 64);
+        memset(address_stack, 0, sizeof(ThreadedIT) * 64);
 
 #define dispatchFirstScal()                   \
     {                                         \
-        goto* fDispatchTable[(*it)->fOpcode]; \
+        goto*(it->fLabel);                    \
     }
 #define dispatchNextScal()                                                                  \
     {                                                                                       \
         if (TRACE >= 4) {                                                                   \
-            traceInstruction(it, int_stack[int_stack_index], real_stack[real_stack_index]); \
+            traceInstruction(it->fInstruction, int_stack[int_stack_index], real_stack[real_stack_index]); \
         }                                                                                   \
         it++;                                                                               \
         dispatchFirstScal();                                                                \
@@ -2852,22 +2899,22 @@ class FBCInterpreter : public FBCExecutor<REAL> {
 
 #define dispatchBranch1Scal()                        \
     {                                                \
-        it = (*it)->fBranch1->fInstructions.begin(); \
+        it = it->fBranch1; \
         dispatchFirstScal();                         \
     }
 #define dispatchBranch2Scal()                        \
     {                                                \
-        it = (*it)->fBranch2->fInstructions.begin(); \
+        it = it->fBranch2; \
         dispatchFirstScal();                         \
     }
 
 #define pushBranch1Scal()                                  \
     {                                                      \
-        pushAddr_((*it)->fBranch1->fInstructions.begin()); \
+        pushAddr_(it->fBranch1); \
     }
 #define pushBranch2Scal()                                  \
     {                                                      \
-        pushAddr_((*it)->fBranch2->fInstructions.begin()); \
+        pushAddr_(it->fBranch2); \
     }
 
 #define dispatchReturnScal() \
@@ -2886,24 +2933,24 @@ class FBCInterpreter : public FBCExecutor<REAL> {
             block->check();
         }
 
-        InstructionIT it = block->fInstructions.begin();
+        ThreadedIT it = block->fThreadedCode.data();
         dispatchFirstScal();
 
     // Number operations
     do_kRealValue: {
-        pushReal(it, (*it)->fRealValue);
+        pushReal(it->fInstruction, it->fRealValue);
         dispatchNextScal();
     }
 
     do_kInt32Value: {
-        pushInt((*it)->fIntValue);
+        pushInt(it->fIntValue);
         dispatchNextScal();
     }
 
     // Memory operations
     do_kLoadSoundFieldInt: {
-        faustassert(this->fSoundTable.find((*it)->fName) != this->fSoundTable.end());
-        Soundfile* sf = this->fSoundTable[(*it)->fName];
+        faustassert(this->fSoundTable.find((*it->fInstruction)->fName) != this->fSoundTable.end());
+        Soundfile* sf = this->fSoundTable[(*it->fInstruction)->fName];
         faustassert(sf);
         int  field_index = popInt();
         int  part        = popInt();
@@ -2930,50 +2977,50 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     }
 
     do_kLoadSoundFieldReal: {
-        faustassert(this->fSoundTable.find((*it)->fName) != this->fSoundTable.end());
-        Soundfile* sf = this->fSoundTable[(*it)->fName];
+        faustassert(this->fSoundTable.find((*it->fInstruction)->fName) != this->fSoundTable.end());
+        Soundfile* sf = this->fSoundTable[(*it->fInstruction)->fName];
         faustassert(sf);
         // field_index (unused)
         popInt();
         int   chan   = popInt();
         int   offset = popInt();
         REAL* buffer = reinterpret_cast<REAL**>(sf->fBuffers)[chan];
-        pushReal(it, buffer[offset]);
+        pushReal(it->fInstruction, buffer[offset]);
         dispatchNextScal();
     }
 
     do_kLoadReal: {
         if (TRACE > 0) {
-            pushReal(it, fRealHeap[assertLoadRealHeap(it, (*it)->fOffset1)]);
+            pushReal(it->fInstruction, fRealHeap[assertLoadRealHeap(it->fInstruction, it->fOffset1)]);
         } else {
-            pushReal(it, fRealHeap[(*it)->fOffset1]);
+            pushReal(it->fInstruction, fRealHeap[it->fOffset1]);
         }
         dispatchNextScal();
     }
 
     do_kLoadInt: {
         if (TRACE > 0) {
-            pushInt(fIntHeap[assertLoadIntHeap(it, (*it)->fOffset1)]);
+            pushInt(fIntHeap[assertLoadIntHeap(it->fInstruction, it->fOffset1)]);
         } else {
-            pushInt(fIntHeap[(*it)->fOffset1]);
+            pushInt(fIntHeap[it->fOffset1]);
         }
         dispatchNextScal();
     }
 
     do_kStoreReal: {
         if (TRACE > 0) {
-            fRealHeap[assertStoreRealHeap(it, (*it)->fOffset1)] = popReal(it);
+            fRealHeap[assertStoreRealHeap(it->fInstruction, it->fOffset1)] = popReal(it->fInstruction);
         } else {
-            fRealHeap[(*it)->fOffset1] = popReal(it);
+            fRealHeap[it->fOffset1] = popReal(it->fInstruction);
         }
         dispatchNextScal();
     }
 
     do_kStoreInt: {
         if (TRACE > 0) {
-            fIntHeap[assertStoreIntHeap(it, (*it)->fOffset1)] = popInt();
+            fIntHeap[assertStoreIntHeap(it->fInstruction, it->fOffset1)] = popInt();
         } else {
-            fIntHeap[(*it)->fOffset1] = popInt();
+            fIntHeap[it->fOffset1] = popInt();
         }
         dispatchNextScal();
     }
@@ -2981,18 +3028,18 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     // Directly store a value
     do_kStoreRealValue: {
         if (TRACE > 0) {
-            fRealHeap[assertStoreRealHeap(it, (*it)->fOffset1)] = (*it)->fRealValue;
+            fRealHeap[assertStoreRealHeap(it->fInstruction, it->fOffset1)] = it->fRealValue;
         } else {
-            fRealHeap[(*it)->fOffset1] = (*it)->fRealValue;
+            fRealHeap[it->fOffset1] = it->fRealValue;
         }
         dispatchNextScal();
     }
 
     do_kStoreIntValue: {
         if (TRACE > 0) {
-            fIntHeap[assertStoreIntHeap(it, (*it)->fOffset1)] = (*it)->fIntValue;
+            fIntHeap[assertStoreIntHeap(it->fInstruction, it->fOffset1)] = it->fIntValue;
         } else {
-            fIntHeap[(*it)->fOffset1] = (*it)->fIntValue;
+            fIntHeap[it->fOffset1] = it->fIntValue;
         }
         dispatchNextScal();
     }
@@ -3000,10 +3047,10 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     do_kLoadIndexedReal: {
         int offset = popInt();
         if (TRACE > 0) {
-            pushReal(it,
-                     fRealHeap[assertLoadRealHeap(it, (*it)->fOffset1 + offset, (*it)->fOffset2)]);
+            pushReal(it->fInstruction,
+                     fRealHeap[assertLoadRealHeap(it->fInstruction, it->fOffset1 + offset, it->fOffset2)]);
         } else {
-            pushReal(it, fRealHeap[(*it)->fOffset1 + offset]);
+            pushReal(it->fInstruction, fRealHeap[it->fOffset1 + offset]);
         }
         dispatchNextScal();
     }
@@ -3011,9 +3058,9 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     do_kLoadIndexedInt: {
         int offset = popInt();
         if (TRACE > 0) {
-            pushInt(fIntHeap[assertLoadIntHeap(it, (*it)->fOffset1 + offset, (*it)->fOffset2)]);
+            pushInt(fIntHeap[assertLoadIntHeap(it->fInstruction, it->fOffset1 + offset, it->fOffset2)]);
         } else {
-            pushInt(fIntHeap[(*it)->fOffset1 + offset]);
+            pushInt(fIntHeap[it->fOffset1 + offset]);
         }
         dispatchNextScal();
     }
@@ -3021,10 +3068,10 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     do_kStoreIndexedReal: {
         int offset = popInt();
         if (TRACE > 0) {
-            fRealHeap[assertStoreRealHeap(it, (*it)->fOffset1 + offset, (*it)->fOffset2)] =
-                popReal(it);
+            fRealHeap[assertStoreRealHeap(it->fInstruction, it->fOffset1 + offset, it->fOffset2)] =
+                popReal(it->fInstruction);
         } else {
-            fRealHeap[(*it)->fOffset1 + offset] = popReal(it);
+            fRealHeap[it->fOffset1 + offset] = popReal(it->fInstruction);
         }
         dispatchNextScal();
     }
@@ -3032,16 +3079,16 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     do_kStoreIndexedInt: {
         int offset = popInt();
         if (TRACE > 0) {
-            fIntHeap[assertStoreIntHeap(it, (*it)->fOffset1 + offset, (*it)->fOffset2)] = popInt();
+            fIntHeap[assertStoreIntHeap(it->fInstruction, it->fOffset1 + offset, it->fOffset2)] = popInt();
         } else {
-            fIntHeap[(*it)->fOffset1 + offset] = popInt();
+            fIntHeap[it->fOffset1 + offset] = popInt();
         }
         dispatchNextScal();
     }
 
     do_kBlockStoreReal: {
         FIRBlockStoreRealInstruction<REAL>* inst =
-            static_cast<FIRBlockStoreRealInstruction<REAL>*>(*it);
+            static_cast<FIRBlockStoreRealInstruction<REAL>*>(*it->fInstruction);
         assertInterp(inst);
         for (int i = 0; i < inst->fOffset2; i++) {
             fRealHeap[inst->fOffset1 + i] = inst->fNumTable[i];
@@ -3051,7 +3098,7 @@ class FBCInterpreter : public FBCExecutor<REAL> {
 
     do_kBlockStoreInt: {
         FIRBlockStoreIntInstruction<REAL>* inst =
-            static_cast<FIRBlockStoreIntInstruction<REAL>*>(*it);
+            static_cast<FIRBlockStoreIntInstruction<REAL>*>(*it->fInstruction);
         assertInterp(inst);
         for (int i = 0; i < inst->fOffset2; i++) {
             fIntHeap[inst->fOffset1 + i] = inst->fNumTable[i];
@@ -3060,50 +3107,50 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     }
 
     do_kMoveReal: {
-        fRealHeap[(*it)->fOffset1] = fRealHeap[(*it)->fOffset2];
+        fRealHeap[it->fOffset1] = fRealHeap[it->fOffset2];
         dispatchNextScal();
     }
 
     do_kMoveInt: {
-        fIntHeap[(*it)->fOffset1] = fIntHeap[(*it)->fOffset2];
+        fIntHeap[it->fOffset1] = fIntHeap[it->fOffset2];
         dispatchNextScal();
     }
 
     do_kPairMoveReal: {
-        fRealHeap[(*it)->fOffset1] = fRealHeap[(*it)->fOffset1 - 1];
-        fRealHeap[(*it)->fOffset2] = fRealHeap[(*it)->fOffset2 - 1];
+        fRealHeap[it->fOffset1] = fRealHeap[it->fOffset1 - 1];
+        fRealHeap[it->fOffset2] = fRealHeap[it->fOffset2 - 1];
         dispatchNextScal();
     }
 
     do_kPairMoveInt: {
-        fIntHeap[(*it)->fOffset1] = fIntHeap[(*it)->fOffset1 - 1];
-        fIntHeap[(*it)->fOffset2] = fIntHeap[(*it)->fOffset2 - 1];
+        fIntHeap[it->fOffset1] = fIntHeap[it->fOffset1 - 1];
+        fIntHeap[it->fOffset2] = fIntHeap[it->fOffset2 - 1];
         dispatchNextScal();
     }
 
     do_kBlockPairMoveReal: {
-        for (int i = (*it)->fOffset1; i < (*it)->fOffset2; i += 2) {
+        for (int i = it->fOffset1; i < it->fOffset2; i += 2) {
             fRealHeap[i + 1] = fRealHeap[i];
         }
         dispatchNextScal();
     }
 
     do_kBlockPairMoveInt: {
-        for (int i = (*it)->fOffset1; i < (*it)->fOffset2; i += 2) {
+        for (int i = it->fOffset1; i < it->fOffset2; i += 2) {
             fIntHeap[i + 1] = fIntHeap[i];
         }
         dispatchNextScal();
     }
 
     do_kBlockShiftReal: {
-        for (int i = (*it)->fOffset1; i > (*it)->fOffset2; i -= 1) {
+        for (int i = it->fOffset1; i > it->fOffset2; i -= 1) {
             fRealHeap[i] = fRealHeap[i - 1];
         }
         dispatchNextScal();
     }
 
     do_kBlockShiftInt: {
-        for (int i = (*it)->fOffset1; i > (*it)->fOffset2; i -= 1) {
+        for (int i = it->fOffset1; i > it->fOffset2; i -= 1) {
             fIntHeap[i] = fIntHeap[i - 1];
         }
         dispatchNextScal();
@@ -3112,54 +3159,54 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     // Input/output access
     do_kLoadInput: {
         if (TRACE > 0) {
-            pushReal(it, fInputs[(*it)->fOffset1][assertAudioBuffer(it, popInt())]);
+            pushReal(it->fInstruction, fInputs[it->fOffset1][assertAudioBuffer(it->fInstruction, popInt())]);
         } else {
-            pushReal(it, fInputs[(*it)->fOffset1][popInt()]);
+            pushReal(it->fInstruction, fInputs[it->fOffset1][popInt()]);
         }
         dispatchNextScal();
     }
 
     do_kStoreOutput: {
         if (TRACE > 0) {
-            fOutputs[(*it)->fOffset1][assertAudioBuffer(it, popInt())] = popReal(it);
+            fOutputs[it->fOffset1][assertAudioBuffer(it->fInstruction, popInt())] = popReal(it->fInstruction);
         } else {
-            fOutputs[(*it)->fOffset1][popInt()] = popReal(it);
+            fOutputs[it->fOffset1][popInt()] = popReal(it->fInstruction);
         }
         dispatchNextScal();
     }
 
     // Cast operations
     do_kCastReal: {
-        pushReal(it, REAL(popInt()));
+        pushReal(it->fInstruction, REAL(popInt()));
         dispatchNextScal();
     }
 
     do_kCastRealHeap: {
-        pushReal(it, REAL(fIntHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, REAL(fIntHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kCastInt: {
         if (TRACE >= 3) {
-            pushInt(int(checkCastIntOverflow(it, popReal(it))));
+            pushInt(int(checkCastIntOverflow(it->fInstruction, popReal(it->fInstruction))));
         } else {
-            pushInt(int(popReal(it)));
+            pushInt(int(popReal(it->fInstruction)));
         }
         dispatchNextScal();
     }
 
     do_kCastIntHeap: {
         if (TRACE >= 3) {
-            pushInt(int(checkCastIntOverflow(it, fRealHeap[(*it)->fOffset1])));
+            pushInt(int(checkCastIntOverflow(it->fInstruction, fRealHeap[it->fOffset1])));
         } else {
-            pushInt(int(fRealHeap[(*it)->fOffset1]));
+            pushInt(int(fRealHeap[it->fOffset1]));
         }
         dispatchNextScal();
     }
 
     // Bitcast operations
     do_kBitcastInt: {
-        REAL v1 = popReal(it);
+        REAL v1 = popReal(it->fInstruction);
         int  v2 = *reinterpret_cast<int*>(&v1);
         pushInt(v2);
         dispatchNextScal();
@@ -3168,7 +3215,7 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     do_kBitcastReal: {
         int  v1 = popInt();
         REAL v2 = *reinterpret_cast<REAL*>(&v1);
-        pushReal(it, v2);
+        pushReal(it->fInstruction, v2);
         dispatchNextScal();
     }
 
@@ -3177,9 +3224,9 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         //-------------------------------------------------------
 
     do_kAddReal: {
-        REAL v1 = popReal(it);
-        REAL v2 = popReal(it);
-        pushReal(it, v1 + v2);
+        REAL v1 = popReal(it->fInstruction);
+        REAL v2 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, v1 + v2);
         dispatchNextScal();
     }
 
@@ -3189,7 +3236,7 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         if (TRACE > 0) {
             int res;
             if (__builtin_sadd_overflow(v1, v2, &res)) {
-                warningOverflow(it, "kAddInt");
+                warningOverflow(it->fInstruction, "kAddInt");
             }
             pushInt(res);
         } else {
@@ -3199,9 +3246,9 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     }
 
     do_kSubReal: {
-        REAL v1 = popReal(it);
-        REAL v2 = popReal(it);
-        pushReal(it, v1 - v2);
+        REAL v1 = popReal(it->fInstruction);
+        REAL v2 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, v1 - v2);
         dispatchNextScal();
     }
 
@@ -3211,7 +3258,7 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         if (TRACE > 0) {
             int res;
             if (__builtin_ssub_overflow(v1, v2, &res)) {
-                warningOverflow(it, "kSubInt");
+                warningOverflow(it->fInstruction, "kSubInt");
             }
             pushInt(res);
         } else {
@@ -3221,9 +3268,9 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     }
 
     do_kMultReal: {
-        REAL v1 = popReal(it);
-        REAL v2 = popReal(it);
-        pushReal(it, v1 * v2);
+        REAL v1 = popReal(it->fInstruction);
+        REAL v2 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, v1 * v2);
         dispatchNextScal();
     }
 
@@ -3233,7 +3280,7 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         if (TRACE > 0) {
             int res;
             if (__builtin_smul_overflow(v1, v2, &res)) {
-                warningOverflow(it, "kMultInt");
+                warningOverflow(it->fInstruction, "kMultInt");
             }
             pushInt(res);
         } else {
@@ -3243,12 +3290,12 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     }
 
     do_kDivReal: {
-        REAL v1 = popReal(it);
-        REAL v2 = popReal(it);
+        REAL v1 = popReal(it->fInstruction);
+        REAL v2 = popReal(it->fInstruction);
         if (TRACE > 0) {
-            checkDivZero(it, v2);
+            checkDivZero(it->fInstruction, v2);
         }
-        pushReal(it, v1 / v2);
+        pushReal(it->fInstruction, v1 / v2);
         dispatchNextScal();
     }
 
@@ -3256,19 +3303,19 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         int v1 = popInt();
         int v2 = popInt();
         if (TRACE > 0) {
-            checkDivZero(it, v2);
+            checkDivZero(it->fInstruction, v2);
         }
         pushInt(v1 / v2);
         dispatchNextScal();
     }
 
     do_kRemReal: {
-        REAL v1 = popReal(it);
-        REAL v2 = popReal(it);
+        REAL v1 = popReal(it->fInstruction);
+        REAL v2 = popReal(it->fInstruction);
         if (TRACE > 0) {
-            checkDivZero(it, v2);
+            checkDivZero(it->fInstruction, v2);
         }
-        pushReal(it, std::remainder(v1, v2));
+        pushReal(it->fInstruction, std::remainder(v1, v2));
         dispatchNextScal();
     }
 
@@ -3276,7 +3323,7 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         int v1 = popInt();
         int v2 = popInt();
         if (TRACE > 0) {
-            checkDivZero(it, v2);
+            checkDivZero(it->fInstruction, v2);
         }
         pushInt(v1 % v2);
         dispatchNextScal();
@@ -3287,7 +3334,7 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         int v1 = popInt();
         int v2 = popInt();
         if (TRACE > 0) {
-            pushInt(v1 << warningBitshift(it, v2));
+            pushInt(v1 << warningBitshift(it->fInstruction, v2));
         } else {
             pushInt(v1 << v2);
         }
@@ -3298,7 +3345,7 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         int v1 = popInt();
         int v2 = popInt();
         if (TRACE > 0) {
-            pushInt(v1 >> warningBitshift(it, v2));
+            pushInt(v1 >> warningBitshift(it->fInstruction, v2));
         } else {
             pushInt(v1 >> v2);
         }
@@ -3310,7 +3357,7 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         int v1 = popInt();
         int v2 = popInt();
         if (TRACE > 0) {
-            pushInt(v1 >> warningBitshift(it, v2));
+            pushInt(v1 >> warningBitshift(it->fInstruction, v2));
         } else {
             pushInt(v1 >> v2);
         }
@@ -3362,43 +3409,43 @@ class FBCInterpreter : public FBCExecutor<REAL> {
 
     // Comparaison Real
     do_kGTReal: {
-        REAL v1 = popReal(it);
-        REAL v2 = popReal(it);
+        REAL v1 = popReal(it->fInstruction);
+        REAL v2 = popReal(it->fInstruction);
         pushInt(v1 > v2);
         dispatchNextScal();
     }
 
     do_kLTReal: {
-        REAL v1 = popReal(it);
-        REAL v2 = popReal(it);
+        REAL v1 = popReal(it->fInstruction);
+        REAL v2 = popReal(it->fInstruction);
         pushInt(v1 < v2);
         dispatchNextScal();
     }
 
     do_kGEReal: {
-        REAL v1 = popReal(it);
-        REAL v2 = popReal(it);
+        REAL v1 = popReal(it->fInstruction);
+        REAL v2 = popReal(it->fInstruction);
         pushInt(v1 >= v2);
         dispatchNextScal();
     }
 
     do_kLEReal: {
-        REAL v1 = popReal(it);
-        REAL v2 = popReal(it);
+        REAL v1 = popReal(it->fInstruction);
+        REAL v2 = popReal(it->fInstruction);
         pushInt(v1 <= v2);
         dispatchNextScal();
     }
 
     do_kEQReal: {
-        REAL v1 = popReal(it);
-        REAL v2 = popReal(it);
+        REAL v1 = popReal(it->fInstruction);
+        REAL v2 = popReal(it->fInstruction);
         pushInt(v1 == v2);
         dispatchNextScal();
     }
 
     do_kNEReal: {
-        REAL v1 = popReal(it);
-        REAL v2 = popReal(it);
+        REAL v1 = popReal(it->fInstruction);
+        REAL v2 = popReal(it->fInstruction);
         pushInt(v1 != v2);
         dispatchNextScal();
     }
@@ -3430,158 +3477,158 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         //-----------------------------------------------------
 
     do_kAddRealHeap: {
-        pushReal(it, fRealHeap[(*it)->fOffset1] + fRealHeap[(*it)->fOffset2]);
+        pushReal(it->fInstruction, fRealHeap[it->fOffset1] + fRealHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kAddIntHeap: {
-        pushInt(fIntHeap[(*it)->fOffset1] + fIntHeap[(*it)->fOffset2]);
+        pushInt(fIntHeap[it->fOffset1] + fIntHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kSubRealHeap: {
-        pushReal(it, fRealHeap[(*it)->fOffset1] - fRealHeap[(*it)->fOffset2]);
+        pushReal(it->fInstruction, fRealHeap[it->fOffset1] - fRealHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kSubIntHeap: {
-        pushInt(fIntHeap[(*it)->fOffset1] - fIntHeap[(*it)->fOffset2]);
+        pushInt(fIntHeap[it->fOffset1] - fIntHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kMultRealHeap: {
-        pushReal(it, fRealHeap[(*it)->fOffset1] * fRealHeap[(*it)->fOffset2]);
+        pushReal(it->fInstruction, fRealHeap[it->fOffset1] * fRealHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kMultIntHeap: {
-        pushInt(fIntHeap[(*it)->fOffset1] * fIntHeap[(*it)->fOffset2]);
+        pushInt(fIntHeap[it->fOffset1] * fIntHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kDivRealHeap: {
-        pushReal(it, fRealHeap[(*it)->fOffset1] / fRealHeap[(*it)->fOffset2]);
+        pushReal(it->fInstruction, fRealHeap[it->fOffset1] / fRealHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kDivIntHeap: {
-        pushInt(fIntHeap[(*it)->fOffset1] / fIntHeap[(*it)->fOffset2]);
+        pushInt(fIntHeap[it->fOffset1] / fIntHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kRemRealHeap: {
-        pushReal(it, std::remainder(fRealHeap[(*it)->fOffset1], fRealHeap[(*it)->fOffset2]));
+        pushReal(it->fInstruction, std::remainder(fRealHeap[it->fOffset1], fRealHeap[it->fOffset2]));
         dispatchNextScal();
     }
 
     do_kRemIntHeap: {
-        pushInt(fIntHeap[(*it)->fOffset1] % fIntHeap[(*it)->fOffset2]);
+        pushInt(fIntHeap[it->fOffset1] % fIntHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     // Shift operation
     do_kLshIntHeap: {
         if (TRACE > 0) {
-            pushInt(fIntHeap[(*it)->fOffset1] << warningBitshift(it, fIntHeap[(*it)->fOffset2]));
+            pushInt(fIntHeap[it->fOffset1] << warningBitshift(it->fInstruction, fIntHeap[it->fOffset2]));
         } else {
-            pushInt(fIntHeap[(*it)->fOffset1] << fIntHeap[(*it)->fOffset2]);
+            pushInt(fIntHeap[it->fOffset1] << fIntHeap[it->fOffset2]);
         }
         dispatchNextScal();
     }
 
     do_kARshIntHeap: {
         if (TRACE > 0) {
-            pushInt(fIntHeap[(*it)->fOffset1] >> warningBitshift(it, fIntHeap[(*it)->fOffset2]));
+            pushInt(fIntHeap[it->fOffset1] >> warningBitshift(it->fInstruction, fIntHeap[it->fOffset2]));
         } else {
-            pushInt(fIntHeap[(*it)->fOffset1] >> fIntHeap[(*it)->fOffset2]);
+            pushInt(fIntHeap[it->fOffset1] >> fIntHeap[it->fOffset2]);
         }
         dispatchNextScal();
     }
 
     do_kLRshIntHeap: {
         if (TRACE > 0) {
-            pushInt(fIntHeap[(*it)->fOffset1] >> warningBitshift(it, fIntHeap[(*it)->fOffset2]));
+            pushInt(fIntHeap[it->fOffset1] >> warningBitshift(it->fInstruction, fIntHeap[it->fOffset2]));
         } else {
-            pushInt(fIntHeap[(*it)->fOffset1] >> fIntHeap[(*it)->fOffset2]);
+            pushInt(fIntHeap[it->fOffset1] >> fIntHeap[it->fOffset2]);
         }
         dispatchNextScal();
     }
 
     // Comparaison Int
     do_kGTIntHeap: {
-        pushInt(fIntHeap[(*it)->fOffset1] > fIntHeap[(*it)->fOffset2]);
+        pushInt(fIntHeap[it->fOffset1] > fIntHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kLTIntHeap: {
-        pushInt(fIntHeap[(*it)->fOffset1] < fIntHeap[(*it)->fOffset2]);
+        pushInt(fIntHeap[it->fOffset1] < fIntHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kGEIntHeap: {
-        pushInt(fIntHeap[(*it)->fOffset1] >= fIntHeap[(*it)->fOffset2]);
+        pushInt(fIntHeap[it->fOffset1] >= fIntHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kLEIntHeap: {
-        pushInt(fIntHeap[(*it)->fOffset1] <= fIntHeap[(*it)->fOffset2]);
+        pushInt(fIntHeap[it->fOffset1] <= fIntHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kEQIntHeap: {
-        pushInt(fIntHeap[(*it)->fOffset1] == fIntHeap[(*it)->fOffset2]);
+        pushInt(fIntHeap[it->fOffset1] == fIntHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kNEIntHeap: {
-        pushInt(fIntHeap[(*it)->fOffset1] != fIntHeap[(*it)->fOffset2]);
+        pushInt(fIntHeap[it->fOffset1] != fIntHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     // Comparaison Real
     do_kGTRealHeap: {
-        pushInt(fRealHeap[(*it)->fOffset1] > fRealHeap[(*it)->fOffset2]);
+        pushInt(fRealHeap[it->fOffset1] > fRealHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kLTRealHeap: {
-        pushInt(fRealHeap[(*it)->fOffset1] < fRealHeap[(*it)->fOffset2]);
+        pushInt(fRealHeap[it->fOffset1] < fRealHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kGERealHeap: {
-        pushInt(fRealHeap[(*it)->fOffset1] >= fRealHeap[(*it)->fOffset2]);
+        pushInt(fRealHeap[it->fOffset1] >= fRealHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kLERealHeap: {
-        pushInt(fRealHeap[(*it)->fOffset1] <= fRealHeap[(*it)->fOffset2]);
+        pushInt(fRealHeap[it->fOffset1] <= fRealHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kEQRealHeap: {
-        pushInt(fRealHeap[(*it)->fOffset1] == fRealHeap[(*it)->fOffset2]);
+        pushInt(fRealHeap[it->fOffset1] == fRealHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kNERealHeap: {
-        pushInt(fRealHeap[(*it)->fOffset1] != fRealHeap[(*it)->fOffset2]);
+        pushInt(fRealHeap[it->fOffset1] != fRealHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     // Logical operations
     do_kANDIntHeap: {
-        pushInt(fIntHeap[(*it)->fOffset1] & fIntHeap[(*it)->fOffset2]);
+        pushInt(fIntHeap[it->fOffset1] & fIntHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kORIntHeap: {
-        pushInt(fIntHeap[(*it)->fOffset1] | fIntHeap[(*it)->fOffset2]);
+        pushInt(fIntHeap[it->fOffset1] | fIntHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
     do_kXORIntHeap: {
-        pushInt(fIntHeap[(*it)->fOffset1] ^ fIntHeap[(*it)->fOffset2]);
+        pushInt(fIntHeap[it->fOffset1] ^ fIntHeap[it->fOffset2]);
         dispatchNextScal();
     }
 
@@ -3590,62 +3637,62 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         //------------------------------------------------------
 
     do_kAddRealStack: {
-        REAL v1 = popReal(it);
-        pushReal(it, fRealHeap[(*it)->fOffset1] + v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, fRealHeap[it->fOffset1] + v1);
         dispatchNextScal();
     }
 
     do_kAddIntStack: {
         int v1 = popInt();
-        pushInt(fIntHeap[(*it)->fOffset1] + v1);
+        pushInt(fIntHeap[it->fOffset1] + v1);
         dispatchNextScal();
     }
 
     do_kSubRealStack: {
-        REAL v1 = popReal(it);
-        pushReal(it, fRealHeap[(*it)->fOffset1] - v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, fRealHeap[it->fOffset1] - v1);
         dispatchNextScal();
     }
 
     do_kSubIntStack: {
         int v1 = popInt();
-        pushInt(fIntHeap[(*it)->fOffset1] - v1);
+        pushInt(fIntHeap[it->fOffset1] - v1);
         dispatchNextScal();
     }
 
     do_kMultRealStack: {
-        REAL v1 = popReal(it);
-        pushReal(it, fRealHeap[(*it)->fOffset1] * v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, fRealHeap[it->fOffset1] * v1);
         dispatchNextScal();
     }
 
     do_kMultIntStack: {
         int v1 = popInt();
-        pushInt(fIntHeap[(*it)->fOffset1] * v1);
+        pushInt(fIntHeap[it->fOffset1] * v1);
         dispatchNextScal();
     }
 
     do_kDivRealStack: {
-        REAL v1 = popReal(it);
-        pushReal(it, fRealHeap[(*it)->fOffset1] / v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, fRealHeap[it->fOffset1] / v1);
         dispatchNextScal();
     }
 
     do_kDivIntStack: {
         int v1 = popInt();
-        pushInt(fIntHeap[(*it)->fOffset1] / v1);
+        pushInt(fIntHeap[it->fOffset1] / v1);
         dispatchNextScal();
     }
 
     do_kRemRealStack: {
-        REAL v1 = popReal(it);
-        pushReal(it, std::remainder(fRealHeap[(*it)->fOffset1], v1));
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::remainder(fRealHeap[it->fOffset1], v1));
         dispatchNextScal();
     }
 
     do_kRemIntStack: {
         int v1 = popInt();
-        pushInt(fIntHeap[(*it)->fOffset1] % v1);
+        pushInt(fIntHeap[it->fOffset1] % v1);
         dispatchNextScal();
     }
 
@@ -3653,9 +3700,9 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     do_kLshIntStack: {
         int v1 = popInt();
         if (TRACE > 0) {
-            pushInt(fIntHeap[(*it)->fOffset1] << warningBitshift(it, v1));
+            pushInt(fIntHeap[it->fOffset1] << warningBitshift(it->fInstruction, v1));
         } else {
-            pushInt(fIntHeap[(*it)->fOffset1] << v1);
+            pushInt(fIntHeap[it->fOffset1] << v1);
         }
         dispatchNextScal();
     }
@@ -3663,9 +3710,9 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     do_kARshIntStack: {
         int v1 = popInt();
         if (TRACE > 0) {
-            pushInt(fIntHeap[(*it)->fOffset1] >> warningBitshift(it, v1));
+            pushInt(fIntHeap[it->fOffset1] >> warningBitshift(it->fInstruction, v1));
         } else {
-            pushInt(fIntHeap[(*it)->fOffset1] >> v1);
+            pushInt(fIntHeap[it->fOffset1] >> v1);
         }
         dispatchNextScal();
     }
@@ -3674,9 +3721,9 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         // TODO
         int v1 = popInt();
         if (TRACE > 0) {
-            pushInt(fIntHeap[(*it)->fOffset1] >> warningBitshift(it, v1));
+            pushInt(fIntHeap[it->fOffset1] >> warningBitshift(it->fInstruction, v1));
         } else {
-            pushInt(fIntHeap[(*it)->fOffset1] >> v1);
+            pushInt(fIntHeap[it->fOffset1] >> v1);
         }
         dispatchNextScal();
     }
@@ -3684,93 +3731,93 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     // Comparaison Int
     do_kGTIntStack: {
         int v1 = popInt();
-        pushInt(fIntHeap[(*it)->fOffset1] > v1);
+        pushInt(fIntHeap[it->fOffset1] > v1);
         dispatchNextScal();
     }
 
     do_kLTIntStack: {
         int v1 = popInt();
-        pushInt(fIntHeap[(*it)->fOffset1] < v1);
+        pushInt(fIntHeap[it->fOffset1] < v1);
         dispatchNextScal();
     }
 
     do_kGEIntStack: {
         int v1 = popInt();
-        pushInt(fIntHeap[(*it)->fOffset1] >= v1);
+        pushInt(fIntHeap[it->fOffset1] >= v1);
         dispatchNextScal();
     }
 
     do_kLEIntStack: {
         int v1 = popInt();
-        pushInt(fIntHeap[(*it)->fOffset1] <= v1);
+        pushInt(fIntHeap[it->fOffset1] <= v1);
         dispatchNextScal();
     }
 
     do_kEQIntStack: {
         int v1 = popInt();
-        pushInt(fIntHeap[(*it)->fOffset1] == v1);
+        pushInt(fIntHeap[it->fOffset1] == v1);
         dispatchNextScal();
     }
 
     do_kNEIntStack: {
         int v1 = popInt();
-        pushInt(fIntHeap[(*it)->fOffset1] != v1);
+        pushInt(fIntHeap[it->fOffset1] != v1);
         dispatchNextScal();
     }
 
     // Comparaison Real
     do_kGTRealStack: {
-        REAL v1 = popReal(it);
-        pushInt(fRealHeap[(*it)->fOffset1] > v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushInt(fRealHeap[it->fOffset1] > v1);
         dispatchNextScal();
     }
 
     do_kLTRealStack: {
-        REAL v1 = popReal(it);
-        pushInt(fRealHeap[(*it)->fOffset1] < v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushInt(fRealHeap[it->fOffset1] < v1);
         dispatchNextScal();
     }
 
     do_kGERealStack: {
-        REAL v1 = popReal(it);
-        pushInt(fRealHeap[(*it)->fOffset1] >= v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushInt(fRealHeap[it->fOffset1] >= v1);
         dispatchNextScal();
     }
 
     do_kLERealStack: {
-        REAL v1 = popReal(it);
-        pushInt(fRealHeap[(*it)->fOffset1] <= v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushInt(fRealHeap[it->fOffset1] <= v1);
         dispatchNextScal();
     }
 
     do_kEQRealStack: {
-        REAL v1 = popReal(it);
-        pushInt(fRealHeap[(*it)->fOffset1] == v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushInt(fRealHeap[it->fOffset1] == v1);
         dispatchNextScal();
     }
 
     do_kNERealStack: {
-        REAL v1 = popReal(it);
-        pushInt(fRealHeap[(*it)->fOffset1] != v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushInt(fRealHeap[it->fOffset1] != v1);
         dispatchNextScal();
     }
 
     // Logical operations
     do_kANDIntStack: {
         int v1 = popInt();
-        pushInt(fIntHeap[(*it)->fOffset1] & v1);
+        pushInt(fIntHeap[it->fOffset1] & v1);
         dispatchNextScal();
     }
 
     do_kORIntStack: {
         int v1 = popInt();
-        pushInt(fIntHeap[(*it)->fOffset1] | v1);
+        pushInt(fIntHeap[it->fOffset1] | v1);
         dispatchNextScal();
     }
 
     do_kXORIntStack: {
         int v1 = popInt();
-        pushInt(fIntHeap[(*it)->fOffset1] ^ v1);
+        pushInt(fIntHeap[it->fOffset1] ^ v1);
         dispatchNextScal();
     }
 
@@ -3779,62 +3826,62 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         //-------------------------------------------------------
 
     do_kAddRealStackValue: {
-        REAL v1 = popReal(it);
-        pushReal(it, (*it)->fRealValue + v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, it->fRealValue + v1);
         dispatchNextScal();
     }
 
     do_kAddIntStackValue: {
         int v1 = popInt();
-        pushInt((*it)->fIntValue + v1);
+        pushInt(it->fIntValue + v1);
         dispatchNextScal();
     }
 
     do_kSubRealStackValue: {
-        REAL v1 = popReal(it);
-        pushReal(it, (*it)->fRealValue - v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, it->fRealValue - v1);
         dispatchNextScal();
     }
 
     do_kSubIntStackValue: {
         int v1 = popInt();
-        pushInt((*it)->fIntValue - v1);
+        pushInt(it->fIntValue - v1);
         dispatchNextScal();
     }
 
     do_kMultRealStackValue: {
-        REAL v1 = popReal(it);
-        pushReal(it, (*it)->fRealValue * v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, it->fRealValue * v1);
         dispatchNextScal();
     }
 
     do_kMultIntStackValue: {
         int v1 = popInt();
-        pushInt((*it)->fIntValue * v1);
+        pushInt(it->fIntValue * v1);
         dispatchNextScal();
     }
 
     do_kDivRealStackValue: {
-        REAL v1 = popReal(it);
-        pushReal(it, (*it)->fRealValue / v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, it->fRealValue / v1);
         dispatchNextScal();
     }
 
     do_kDivIntStackValue: {
         int v1 = popInt();
-        pushInt((*it)->fIntValue / v1);
+        pushInt(it->fIntValue / v1);
         dispatchNextScal();
     }
 
     do_kRemRealStackValue: {
-        REAL v1 = popReal(it);
-        pushReal(it, std::remainder((*it)->fRealValue, v1));
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::remainder(it->fRealValue, v1));
         dispatchNextScal();
     }
 
     do_kRemIntStackValue: {
         int v1 = popInt();
-        pushInt((*it)->fIntValue % v1);
+        pushInt(it->fIntValue % v1);
         dispatchNextScal();
     }
 
@@ -3842,9 +3889,9 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     do_kLshIntStackValue: {
         int v1 = popInt();
         if (TRACE > 0) {
-            pushInt((*it)->fIntValue << warningBitshift(it, v1));
+            pushInt(it->fIntValue << warningBitshift(it->fInstruction, v1));
         } else {
-            pushInt((*it)->fIntValue << v1);
+            pushInt(it->fIntValue << v1);
         }
         dispatchNextScal();
     }
@@ -3852,9 +3899,9 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     do_kARshIntStackValue: {
         int v1 = popInt();
         if (TRACE > 0) {
-            pushInt((*it)->fIntValue >> warningBitshift(it, v1));
+            pushInt(it->fIntValue >> warningBitshift(it->fInstruction, v1));
         } else {
-            pushInt((*it)->fIntValue >> v1);
+            pushInt(it->fIntValue >> v1);
         }
         dispatchNextScal();
     }
@@ -3862,9 +3909,9 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     do_kLRshIntStackValue: {
         int v1 = popInt();
         if (TRACE > 0) {
-            pushInt((*it)->fIntValue >> warningBitshift(it, v1));
+            pushInt(it->fIntValue >> warningBitshift(it->fInstruction, v1));
         } else {
-            pushInt((*it)->fIntValue >> v1);
+            pushInt(it->fIntValue >> v1);
         }
         dispatchNextScal();
     }
@@ -3872,93 +3919,93 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     // Comparaison Int
     do_kGTIntStackValue: {
         int v1 = popInt();
-        pushInt((*it)->fIntValue > v1);
+        pushInt(it->fIntValue > v1);
         dispatchNextScal();
     }
 
     do_kLTIntStackValue: {
         int v1 = popInt();
-        pushInt((*it)->fIntValue < v1);
+        pushInt(it->fIntValue < v1);
         dispatchNextScal();
     }
 
     do_kGEIntStackValue: {
         int v1 = popInt();
-        pushInt((*it)->fIntValue >= v1);
+        pushInt(it->fIntValue >= v1);
         dispatchNextScal();
     }
 
     do_kLEIntStackValue: {
         int v1 = popInt();
-        pushInt((*it)->fIntValue <= v1);
+        pushInt(it->fIntValue <= v1);
         dispatchNextScal();
     }
 
     do_kEQIntStackValue: {
         int v1 = popInt();
-        pushInt((*it)->fIntValue == v1);
+        pushInt(it->fIntValue == v1);
         dispatchNextScal();
     }
 
     do_kNEIntStackValue: {
         int v1 = popInt();
-        pushInt((*it)->fIntValue != v1);
+        pushInt(it->fIntValue != v1);
         dispatchNextScal();
     }
 
     // Comparaison Real
     do_kGTRealStackValue: {
-        REAL v1 = popReal(it);
-        pushInt((*it)->fRealValue > v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushInt(it->fRealValue > v1);
         dispatchNextScal();
     }
 
     do_kLTRealStackValue: {
-        REAL v1 = popReal(it);
-        pushInt((*it)->fRealValue < v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushInt(it->fRealValue < v1);
         dispatchNextScal();
     }
 
     do_kGERealStackValue: {
-        REAL v1 = popReal(it);
-        pushInt((*it)->fRealValue >= v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushInt(it->fRealValue >= v1);
         dispatchNextScal();
     }
 
     do_kLERealStackValue: {
-        REAL v1 = popReal(it);
-        pushInt((*it)->fRealValue <= v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushInt(it->fRealValue <= v1);
         dispatchNextScal();
     }
 
     do_kEQRealStackValue: {
-        REAL v1 = popReal(it);
-        pushInt((*it)->fRealValue == v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushInt(it->fRealValue == v1);
         dispatchNextScal();
     }
 
     do_kNERealStackValue: {
-        REAL v1 = popReal(it);
-        pushInt((*it)->fRealValue != v1);
+        REAL v1 = popReal(it->fInstruction);
+        pushInt(it->fRealValue != v1);
         dispatchNextScal();
     }
 
     // Logical operations
     do_kANDIntStackValue: {
         int v1 = popInt();
-        pushInt((*it)->fIntValue & v1);
+        pushInt(it->fIntValue & v1);
         dispatchNextScal();
     }
 
     do_kORIntStackValue: {
         int v1 = popInt();
-        pushInt((*it)->fIntValue | v1);
+        pushInt(it->fIntValue | v1);
         dispatchNextScal();
     }
 
     do_kXORIntStackValue: {
         int v1 = popInt();
-        pushInt((*it)->fIntValue ^ v1);
+        pushInt(it->fIntValue ^ v1);
         dispatchNextScal();
     }
 
@@ -3967,158 +4014,158 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         //------------------------------------------------------
 
     do_kAddRealValue: {
-        pushReal(it, (*it)->fRealValue + fRealHeap[(*it)->fOffset1]);
+        pushReal(it->fInstruction, it->fRealValue + fRealHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kAddIntValue: {
-        pushInt((*it)->fIntValue + fIntHeap[(*it)->fOffset1]);
+        pushInt(it->fIntValue + fIntHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kSubRealValue: {
-        pushReal(it, (*it)->fRealValue - fRealHeap[(*it)->fOffset1]);
+        pushReal(it->fInstruction, it->fRealValue - fRealHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kSubIntValue: {
-        pushInt((*it)->fIntValue - fIntHeap[(*it)->fOffset1]);
+        pushInt(it->fIntValue - fIntHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kMultRealValue: {
-        pushReal(it, (*it)->fRealValue * fRealHeap[(*it)->fOffset1]);
+        pushReal(it->fInstruction, it->fRealValue * fRealHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kMultIntValue: {
-        pushInt((*it)->fIntValue * fIntHeap[(*it)->fOffset1]);
+        pushInt(it->fIntValue * fIntHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kDivRealValue: {
-        pushReal(it, (*it)->fRealValue / fRealHeap[(*it)->fOffset1]);
+        pushReal(it->fInstruction, it->fRealValue / fRealHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kDivIntValue: {
-        pushInt((*it)->fIntValue / fIntHeap[(*it)->fOffset1]);
+        pushInt(it->fIntValue / fIntHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kRemRealValue: {
-        pushReal(it, std::remainder((*it)->fRealValue, fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::remainder(it->fRealValue, fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kRemIntValue: {
-        pushInt((*it)->fIntValue % fIntHeap[(*it)->fOffset1]);
+        pushInt(it->fIntValue % fIntHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     // Shift operation
     do_kLshIntValue: {
         if (TRACE > 0) {
-            pushInt((*it)->fIntValue << warningBitshift(it, fIntHeap[(*it)->fOffset1]));
+            pushInt(it->fIntValue << warningBitshift(it->fInstruction, fIntHeap[it->fOffset1]));
         } else {
-            pushInt((*it)->fIntValue << fIntHeap[(*it)->fOffset1]);
+            pushInt(it->fIntValue << fIntHeap[it->fOffset1]);
         }
         dispatchNextScal();
     }
 
     do_kARshIntValue: {
         if (TRACE > 0) {
-            pushInt((*it)->fIntValue >> warningBitshift(it, fIntHeap[(*it)->fOffset1]));
+            pushInt(it->fIntValue >> warningBitshift(it->fInstruction, fIntHeap[it->fOffset1]));
         } else {
-            pushInt((*it)->fIntValue >> fIntHeap[(*it)->fOffset1]);
+            pushInt(it->fIntValue >> fIntHeap[it->fOffset1]);
         }
         dispatchNextScal();
     }
 
     do_kLRshIntValue: {
         if (TRACE > 0) {
-            pushInt((*it)->fIntValue >> warningBitshift(it, fIntHeap[(*it)->fOffset1]));
+            pushInt(it->fIntValue >> warningBitshift(it->fInstruction, fIntHeap[it->fOffset1]));
         } else {
-            pushInt((*it)->fIntValue >> fIntHeap[(*it)->fOffset1]);
+            pushInt(it->fIntValue >> fIntHeap[it->fOffset1]);
         }
         dispatchNextScal();
     }
 
     // Comparaison Int
     do_kGTIntValue: {
-        pushInt((*it)->fIntValue > fIntHeap[(*it)->fOffset1]);
+        pushInt(it->fIntValue > fIntHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kLTIntValue: {
-        pushInt((*it)->fIntValue < fIntHeap[(*it)->fOffset1]);
+        pushInt(it->fIntValue < fIntHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kGEIntValue: {
-        pushInt((*it)->fIntValue >= fIntHeap[(*it)->fOffset1]);
+        pushInt(it->fIntValue >= fIntHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kLEIntValue: {
-        pushInt((*it)->fIntValue <= fIntHeap[(*it)->fOffset1]);
+        pushInt(it->fIntValue <= fIntHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kEQIntValue: {
-        pushInt((*it)->fIntValue == fIntHeap[(*it)->fOffset1]);
+        pushInt(it->fIntValue == fIntHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kNEIntValue: {
-        pushInt((*it)->fIntValue != fIntHeap[(*it)->fOffset1]);
+        pushInt(it->fIntValue != fIntHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     // Comparaison Real
     do_kGTRealValue: {
-        pushInt((*it)->fRealValue > fRealHeap[(*it)->fOffset1]);
+        pushInt(it->fRealValue > fRealHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kLTRealValue: {
-        pushInt((*it)->fRealValue < fRealHeap[(*it)->fOffset1]);
+        pushInt(it->fRealValue < fRealHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kGERealValue: {
-        pushInt((*it)->fRealValue >= fRealHeap[(*it)->fOffset1]);
+        pushInt(it->fRealValue >= fRealHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kLERealValue: {
-        pushInt((*it)->fRealValue <= fRealHeap[(*it)->fOffset1]);
+        pushInt(it->fRealValue <= fRealHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kEQRealValue: {
-        pushInt((*it)->fRealValue == fRealHeap[(*it)->fOffset1]);
+        pushInt(it->fRealValue == fRealHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kNERealValue: {
-        pushInt((*it)->fRealValue != fRealHeap[(*it)->fOffset1]);
+        pushInt(it->fRealValue != fRealHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     // Logical operations
     do_kANDIntValue: {
-        pushInt((*it)->fIntValue & fIntHeap[(*it)->fOffset1]);
+        pushInt(it->fIntValue & fIntHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kORIntValue: {
-        pushInt((*it)->fIntValue | fIntHeap[(*it)->fOffset1]);
+        pushInt(it->fIntValue | fIntHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
     do_kXORIntValue: {
-        pushInt((*it)->fIntValue ^ fIntHeap[(*it)->fOffset1]);
+        pushInt(it->fIntValue ^ fIntHeap[it->fOffset1]);
         dispatchNextScal();
     }
 
@@ -4128,102 +4175,102 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         //----------------------------------------------------
 
     do_kSubRealValueInvert: {
-        pushReal(it, fRealHeap[(*it)->fOffset1] - (*it)->fRealValue);
+        pushReal(it->fInstruction, fRealHeap[it->fOffset1] - it->fRealValue);
         dispatchNextScal();
     }
 
     do_kSubIntValueInvert: {
-        pushInt(fIntHeap[(*it)->fOffset1] - (*it)->fIntValue);
+        pushInt(fIntHeap[it->fOffset1] - it->fIntValue);
         dispatchNextScal();
     }
 
     do_kDivRealValueInvert: {
-        pushReal(it, fRealHeap[(*it)->fOffset1] / (*it)->fRealValue);
+        pushReal(it->fInstruction, fRealHeap[it->fOffset1] / it->fRealValue);
         dispatchNextScal();
     }
 
     do_kDivIntValueInvert: {
-        pushInt(fIntHeap[(*it)->fOffset1] / (*it)->fIntValue);
+        pushInt(fIntHeap[it->fOffset1] / it->fIntValue);
         dispatchNextScal();
     }
 
     do_kRemRealValueInvert: {
-        pushReal(it, std::remainder(fRealHeap[(*it)->fOffset1], (*it)->fRealValue));
+        pushReal(it->fInstruction, std::remainder(fRealHeap[it->fOffset1], it->fRealValue));
         dispatchNextScal();
     }
 
     do_kRemIntValueInvert: {
-        pushInt(fIntHeap[(*it)->fOffset1] % (*it)->fIntValue);
+        pushInt(fIntHeap[it->fOffset1] % it->fIntValue);
         dispatchNextScal();
     }
 
     // Shift operation
     do_kLshIntValueInvert: {
         if (TRACE > 0) {
-            pushInt(fIntHeap[(*it)->fOffset1] << warningBitshift(it, (*it)->fIntValue));
+            pushInt(fIntHeap[it->fOffset1] << warningBitshift(it->fInstruction, it->fIntValue));
         } else {
-            pushInt(fIntHeap[(*it)->fOffset1] << (*it)->fIntValue);
+            pushInt(fIntHeap[it->fOffset1] << it->fIntValue);
         }
         dispatchNextScal();
     }
 
     do_kARshIntValueInvert: {
         if (TRACE > 0) {
-            pushInt(fIntHeap[(*it)->fOffset1] >> warningBitshift(it, (*it)->fIntValue));
+            pushInt(fIntHeap[it->fOffset1] >> warningBitshift(it->fInstruction, it->fIntValue));
         } else {
-            pushInt(fIntHeap[(*it)->fOffset1] >> (*it)->fIntValue);
+            pushInt(fIntHeap[it->fOffset1] >> it->fIntValue);
         }
         dispatchNextScal();
     }
 
     do_kLRshIntValueInvert: {
         if (TRACE > 0) {
-            pushInt(fIntHeap[(*it)->fOffset1] >> warningBitshift(it, (*it)->fIntValue));
+            pushInt(fIntHeap[it->fOffset1] >> warningBitshift(it->fInstruction, it->fIntValue));
         } else {
-            pushInt(fIntHeap[(*it)->fOffset1] >> (*it)->fIntValue);
+            pushInt(fIntHeap[it->fOffset1] >> it->fIntValue);
         }
         dispatchNextScal();
     }
 
     // Comparaison Int
     do_kGTIntValueInvert: {
-        pushInt(fIntHeap[(*it)->fOffset1] > (*it)->fIntValue);
+        pushInt(fIntHeap[it->fOffset1] > it->fIntValue);
         dispatchNextScal();
     }
 
     do_kLTIntValueInvert: {
-        pushInt(fIntHeap[(*it)->fOffset1] < (*it)->fIntValue);
+        pushInt(fIntHeap[it->fOffset1] < it->fIntValue);
         dispatchNextScal();
     }
 
     do_kGEIntValueInvert: {
-        pushInt(fIntHeap[(*it)->fOffset1] >= (*it)->fIntValue);
+        pushInt(fIntHeap[it->fOffset1] >= it->fIntValue);
         dispatchNextScal();
     }
 
     do_kLEIntValueInvert: {
-        pushInt(fIntHeap[(*it)->fOffset1] <= (*it)->fIntValue);
+        pushInt(fIntHeap[it->fOffset1] <= it->fIntValue);
         dispatchNextScal();
     }
 
     // Comparaison Real
     do_kGTRealValueInvert: {
-        pushInt(fRealHeap[(*it)->fOffset1] > (*it)->fRealValue);
+        pushInt(fRealHeap[it->fOffset1] > it->fRealValue);
         dispatchNextScal();
     }
 
     do_kLTRealValueInvert: {
-        pushInt(fRealHeap[(*it)->fOffset1] < (*it)->fRealValue);
+        pushInt(fRealHeap[it->fOffset1] < it->fRealValue);
         dispatchNextScal();
     }
 
     do_kGERealValueInvert: {
-        pushInt(fRealHeap[(*it)->fOffset1] >= (*it)->fRealValue);
+        pushInt(fRealHeap[it->fOffset1] >= it->fRealValue);
         dispatchNextScal();
     }
 
     do_kLERealValueInvert: {
-        pushInt(fRealHeap[(*it)->fOffset1] <= (*it)->fRealValue);
+        pushInt(fRealHeap[it->fOffset1] <= it->fRealValue);
         dispatchNextScal();
     }
 
@@ -4238,139 +4285,139 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     }
 
     do_kAbsf: {
-        REAL v = popReal(it);
-        pushReal(it, std::fabs(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::fabs(v));
         dispatchNextScal();
     }
 
     do_kAcosf: {
-        REAL v = popReal(it);
-        pushReal(it, std::acos(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::acos(v));
         dispatchNextScal();
     }
 
     do_kAcoshf: {
-        REAL v = popReal(it);
-        pushReal(it, std::acosh(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::acosh(v));
         dispatchNextScal();
     }
 
     do_kAsinf: {
-        REAL v = popReal(it);
-        pushReal(it, std::asin(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::asin(v));
         dispatchNextScal();
     }
 
     do_kAsinhf: {
-        REAL v = popReal(it);
-        pushReal(it, std::asinh(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::asinh(v));
         dispatchNextScal();
     }
 
     do_kAtanf: {
-        REAL v = popReal(it);
-        pushReal(it, std::atan(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::atan(v));
         dispatchNextScal();
     }
 
     do_kAtanhf: {
-        REAL v = popReal(it);
-        pushReal(it, std::atanh(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::atanh(v));
         dispatchNextScal();
     }
 
     do_kCeilf: {
-        REAL v = popReal(it);
-        pushReal(it, std::ceil(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::ceil(v));
         dispatchNextScal();
     }
 
     do_kCosf: {
-        REAL v = popReal(it);
-        pushReal(it, std::cos(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::cos(v));
         dispatchNextScal();
     }
 
     do_kCoshf: {
-        REAL v = popReal(it);
-        pushReal(it, std::cosh(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::cosh(v));
         dispatchNextScal();
     }
 
     do_kExpf: {
-        REAL v = popReal(it);
-        pushReal(it, std::exp(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::exp(v));
         dispatchNextScal();
     }
 
     do_kFloorf: {
-        REAL v = popReal(it);
-        pushReal(it, std::floor(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::floor(v));
         dispatchNextScal();
     }
 
     do_kLogf: {
-        REAL v = popReal(it);
-        pushReal(it, std::log(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::log(v));
         dispatchNextScal();
     }
 
     do_kLog10f: {
-        REAL v = popReal(it);
-        pushReal(it, std::log10(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::log10(v));
         dispatchNextScal();
     }
 
     do_kRintf: {
-        REAL v = popReal(it);
-        pushReal(it, std::rint(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::rint(v));
         dispatchNextScal();
     }
 
     do_kRoundf: {
-        REAL v = popReal(it);
-        pushReal(it, std::round(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::round(v));
         dispatchNextScal();
     }
 
     do_kSinf: {
-        REAL v = popReal(it);
-        pushReal(it, std::sin(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::sin(v));
         dispatchNextScal();
     }
 
     do_kSinhf: {
-        REAL v = popReal(it);
-        pushReal(it, std::sinh(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::sinh(v));
         dispatchNextScal();
     }
 
     do_kSqrtf: {
-        REAL v = popReal(it);
-        pushReal(it, std::sqrt(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::sqrt(v));
         dispatchNextScal();
     }
 
     do_kTanf: {
-        REAL v = popReal(it);
-        pushReal(it, std::tan(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::tan(v));
         dispatchNextScal();
     }
 
     do_kTanhf: {
-        REAL v = popReal(it);
-        pushReal(it, std::tanh(v));
+        REAL v = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::tanh(v));
         dispatchNextScal();
     }
 
     do_kIsnanf: {
-        REAL v = popReal(it);
+        REAL v = popReal(it->fInstruction);
         pushInt(std::isnan(v));
         dispatchNextScal();
     }
 
     do_kIsinff: {
-        REAL v = popReal(it);
+        REAL v = popReal(it->fInstruction);
         pushInt(std::isinf(v));
         dispatchNextScal();
     }
@@ -4380,112 +4427,112 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         ///-----------------------------------
 
     do_kAbsHeap: {
-        pushInt(std::abs(fIntHeap[(*it)->fOffset1]));
+        pushInt(std::abs(fIntHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kAbsfHeap: {
-        pushReal(it, std::fabs(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::fabs(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kAcosfHeap: {
-        pushReal(it, std::acos(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::acos(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kAcoshfHeap: {
-        pushReal(it, std::acosh(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::acosh(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kAsinfHeap: {
-        pushReal(it, std::asin(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::asin(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kAsinhfHeap: {
-        pushReal(it, std::asinh(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::asinh(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kAtanfHeap: {
-        pushReal(it, std::atan(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::atan(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kAtanhfHeap: {
-        pushReal(it, std::atanh(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::atanh(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kCeilfHeap: {
-        pushReal(it, std::ceil(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::ceil(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kCosfHeap: {
-        pushReal(it, std::cos(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::cos(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kCoshfHeap: {
-        pushReal(it, std::cosh(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::cosh(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kExpfHeap: {
-        pushReal(it, std::exp(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::exp(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kFloorfHeap: {
-        pushReal(it, std::floor(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::floor(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kLogfHeap: {
-        pushReal(it, std::log(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::log(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kLog10fHeap: {
-        pushReal(it, std::log10(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::log10(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kRintfHeap: {
-        pushReal(it, std::rint(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::rint(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kRoundfHeap: {
-        pushReal(it, std::round(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::round(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kSinfHeap: {
-        pushReal(it, std::sin(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::sin(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kSinhfHeap: {
-        pushReal(it, std::sinh(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::sinh(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kSqrtfHeap: {
-        pushReal(it, std::sqrt(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::sqrt(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kTanfHeap: {
-        pushReal(it, std::tan(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::tan(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kTanhfHeap: {
-        pushReal(it, std::tanh(fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::tanh(fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
@@ -4494,23 +4541,23 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         //----------------------
 
     do_kAtan2f: {
-        REAL v1 = popReal(it);
-        REAL v2 = popReal(it);
-        pushReal(it, std::atan2(v1, v2));
+        REAL v1 = popReal(it->fInstruction);
+        REAL v2 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::atan2(v1, v2));
         dispatchNextScal();
     }
 
     do_kFmodf: {
-        REAL v1 = popReal(it);
-        REAL v2 = popReal(it);
-        pushReal(it, std::fmod(v1, v2));
+        REAL v1 = popReal(it->fInstruction);
+        REAL v2 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::fmod(v1, v2));
         dispatchNextScal();
     }
 
     do_kPowf: {
-        REAL v1 = popReal(it);
-        REAL v2 = popReal(it);
-        pushReal(it, std::pow(v1, v2));
+        REAL v1 = popReal(it->fInstruction);
+        REAL v2 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::pow(v1, v2));
         dispatchNextScal();
     }
 
@@ -4522,9 +4569,9 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     }
 
     do_kMaxf: {
-        REAL v1 = popReal(it);
-        REAL v2 = popReal(it);
-        pushReal(it, std::max(v1, v2));
+        REAL v1 = popReal(it->fInstruction);
+        REAL v2 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::max(v1, v2));
         dispatchNextScal();
     }
 
@@ -4536,16 +4583,16 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     }
 
     do_kMinf: {
-        REAL v1 = popReal(it);
-        REAL v2 = popReal(it);
-        pushReal(it, std::min(v1, v2));
+        REAL v1 = popReal(it->fInstruction);
+        REAL v2 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::min(v1, v2));
         dispatchNextScal();
     }
 
     do_kCopysignf: {
-        REAL v1 = popReal(it);
-        REAL v2 = popReal(it);
-        pushReal(it, std::copysign(v1, v2));
+        REAL v1 = popReal(it->fInstruction);
+        REAL v2 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::copysign(v1, v2));
         dispatchNextScal();
     }
 
@@ -4554,37 +4601,37 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         //-------------------------------------
 
     do_kAtan2fHeap: {
-        pushReal(it, std::atan2(fRealHeap[(*it)->fOffset1], fRealHeap[(*it)->fOffset2]));
+        pushReal(it->fInstruction, std::atan2(fRealHeap[it->fOffset1], fRealHeap[it->fOffset2]));
         dispatchNextScal();
     }
 
     do_kFmodfHeap: {
-        pushReal(it, std::fmod(fRealHeap[(*it)->fOffset1], fRealHeap[(*it)->fOffset2]));
+        pushReal(it->fInstruction, std::fmod(fRealHeap[it->fOffset1], fRealHeap[it->fOffset2]));
         dispatchNextScal();
     }
 
     do_kPowfHeap: {
-        pushReal(it, std::pow(fRealHeap[(*it)->fOffset1], fRealHeap[(*it)->fOffset2]));
+        pushReal(it->fInstruction, std::pow(fRealHeap[it->fOffset1], fRealHeap[it->fOffset2]));
         dispatchNextScal();
     }
 
     do_kMaxHeap: {
-        pushInt(std::max(fIntHeap[(*it)->fOffset1], fIntHeap[(*it)->fOffset2]));
+        pushInt(std::max(fIntHeap[it->fOffset1], fIntHeap[it->fOffset2]));
         dispatchNextScal();
     }
 
     do_kMaxfHeap: {
-        pushReal(it, std::max(fRealHeap[(*it)->fOffset1], fRealHeap[(*it)->fOffset2]));
+        pushReal(it->fInstruction, std::max(fRealHeap[it->fOffset1], fRealHeap[it->fOffset2]));
         dispatchNextScal();
     }
 
     do_kMinHeap: {
-        pushInt(std::min(fIntHeap[(*it)->fOffset1], fIntHeap[(*it)->fOffset2]));
+        pushInt(std::min(fIntHeap[it->fOffset1], fIntHeap[it->fOffset2]));
         dispatchNextScal();
     }
 
     do_kMinfHeap: {
-        pushReal(it, std::min(fRealHeap[(*it)->fOffset1], fRealHeap[(*it)->fOffset2]));
+        pushReal(it->fInstruction, std::min(fRealHeap[it->fOffset1], fRealHeap[it->fOffset2]));
         dispatchNextScal();
     }
 
@@ -4593,44 +4640,44 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         //--------------------------------------
 
     do_kAtan2fStack: {
-        REAL v1 = popReal(it);
-        pushReal(it, std::atan2(fRealHeap[(*it)->fOffset1], v1));
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::atan2(fRealHeap[it->fOffset1], v1));
         dispatchNextScal();
     }
 
     do_kFmodfStack: {
-        REAL v1 = popReal(it);
-        pushReal(it, std::fmod(fRealHeap[(*it)->fOffset1], v1));
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::fmod(fRealHeap[it->fOffset1], v1));
         dispatchNextScal();
     }
 
     do_kPowfStack: {
-        REAL v1 = popReal(it);
-        pushReal(it, std::pow(fRealHeap[(*it)->fOffset1], v1));
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::pow(fRealHeap[it->fOffset1], v1));
         dispatchNextScal();
     }
 
     do_kMaxStack: {
         int v1 = popInt();
-        pushInt(std::max(fIntHeap[(*it)->fOffset1], v1));
+        pushInt(std::max(fIntHeap[it->fOffset1], v1));
         dispatchNextScal();
     }
 
     do_kMaxfStack: {
-        REAL v1 = popReal(it);
-        pushReal(it, std::max(fRealHeap[(*it)->fOffset1], v1));
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::max(fRealHeap[it->fOffset1], v1));
         dispatchNextScal();
     }
 
     do_kMinStack: {
         int v1 = popInt();
-        pushInt(std::min(fIntHeap[(*it)->fOffset1], v1));
+        pushInt(std::min(fIntHeap[it->fOffset1], v1));
         dispatchNextScal();
     }
 
     do_kMinfStack: {
-        REAL v1 = popReal(it);
-        pushReal(it, std::min(fRealHeap[(*it)->fOffset1], v1));
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::min(fRealHeap[it->fOffset1], v1));
         dispatchNextScal();
     }
 
@@ -4639,44 +4686,44 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         //--------------------------------------------
 
     do_kAtan2fStackValue: {
-        REAL v1 = popReal(it);
-        pushReal(it, std::atan2((*it)->fRealValue, v1));
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::atan2(it->fRealValue, v1));
         dispatchNextScal();
     }
 
     do_kFmodfStackValue: {
-        REAL v1 = popReal(it);
-        pushReal(it, std::fmod((*it)->fRealValue, v1));
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::fmod(it->fRealValue, v1));
         dispatchNextScal();
     }
 
     do_kPowfStackValue: {
-        REAL v1 = popReal(it);
-        pushReal(it, std::pow((*it)->fRealValue, v1));
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::pow(it->fRealValue, v1));
         dispatchNextScal();
     }
 
     do_kMaxStackValue: {
         int v1 = popInt();
-        pushInt(std::max((*it)->fIntValue, v1));
+        pushInt(std::max(it->fIntValue, v1));
         dispatchNextScal();
     }
 
     do_kMaxfStackValue: {
-        REAL v1 = popReal(it);
-        pushReal(it, std::max((*it)->fRealValue, v1));
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::max(it->fRealValue, v1));
         dispatchNextScal();
     }
 
     do_kMinStackValue: {
         int v1 = popInt();
-        pushInt(std::min((*it)->fIntValue, v1));
+        pushInt(std::min(it->fIntValue, v1));
         dispatchNextScal();
     }
 
     do_kMinfStackValue: {
-        REAL v1 = popReal(it);
-        pushReal(it, std::min((*it)->fRealValue, v1));
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, std::min(it->fRealValue, v1));
         dispatchNextScal();
     }
 
@@ -4685,37 +4732,37 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         //-------------------------------------
 
     do_kAtan2fValue: {
-        pushReal(it, std::atan2((*it)->fRealValue, fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::atan2(it->fRealValue, fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kFmodfValue: {
-        pushReal(it, std::fmod((*it)->fRealValue, fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::fmod(it->fRealValue, fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kPowfValue: {
-        pushReal(it, std::pow((*it)->fRealValue, fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::pow(it->fRealValue, fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kMaxValue: {
-        pushInt(std::max((*it)->fIntValue, fIntHeap[(*it)->fOffset1]));
+        pushInt(std::max(it->fIntValue, fIntHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kMaxfValue: {
-        pushReal(it, std::max((*it)->fRealValue, fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::max(it->fRealValue, fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kMinValue: {
-        pushInt(std::min((*it)->fIntValue, fIntHeap[(*it)->fOffset1]));
+        pushInt(std::min(it->fIntValue, fIntHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
     do_kMinfValue: {
-        pushReal(it, std::min((*it)->fRealValue, fRealHeap[(*it)->fOffset1]));
+        pushReal(it->fInstruction, std::min(it->fRealValue, fRealHeap[it->fOffset1]));
         dispatchNextScal();
     }
 
@@ -4724,17 +4771,17 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         //-------------------------------------------------------------------
 
     do_kAtan2fValueInvert: {
-        pushReal(it, std::atan2(fRealHeap[(*it)->fOffset1], (*it)->fRealValue));
+        pushReal(it->fInstruction, std::atan2(fRealHeap[it->fOffset1], it->fRealValue));
         dispatchNextScal();
     }
 
     do_kFmodfValueInvert: {
-        pushReal(it, std::fmod(fRealHeap[(*it)->fOffset1], (*it)->fRealValue));
+        pushReal(it->fInstruction, std::fmod(fRealHeap[it->fOffset1], it->fRealValue));
         dispatchNextScal();
     }
 
     do_kPowfValueInvert: {
-        pushReal(it, std::pow(fRealHeap[(*it)->fOffset1], (*it)->fRealValue));
+        pushReal(it->fInstruction, std::pow(fRealHeap[it->fOffset1], it->fRealValue));
         dispatchNextScal();
     }
 
@@ -4757,12 +4804,12 @@ class FBCInterpreter : public FBCExecutor<REAL> {
 
         if (popInt()) {
             // Execute new block
-            assertInterp((*it)->fBranch1);
+            assertInterp(it->fBranch1);
             dispatchBranch1Scal();
             // No value (If)
         } else {
             // Execute new block
-            assertInterp((*it)->fBranch2);
+            assertInterp(it->fBranch2);
             dispatchBranch2Scal();
             // No value (If)
         }
@@ -4774,12 +4821,12 @@ class FBCInterpreter : public FBCExecutor<REAL> {
 
         if (popInt()) {
             // Execute new block
-            assertInterp((*it)->fBranch1);
+            assertInterp(it->fBranch1);
             dispatchBranch1Scal();
             // Real value
         } else {
             // Execute new block
-            assertInterp((*it)->fBranch2);
+            assertInterp(it->fBranch2);
             dispatchBranch2Scal();
             // Real value
         }
@@ -4791,12 +4838,12 @@ class FBCInterpreter : public FBCExecutor<REAL> {
 
         if (popInt()) {
             // Execute new block
-            assertInterp((*it)->fBranch1);
+            assertInterp(it->fBranch1);
             dispatchBranch1Scal();
             // Int value
         } else {
             // Execute new block
-            assertInterp((*it)->fBranch2);
+            assertInterp(it->fBranch2);
             dispatchBranch2Scal();
             // Int value
         }
@@ -4805,7 +4852,7 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     do_kCondBranch: {
         // If condition is true, just branch back on the block beginning
         if (popInt()) {
-            assertInterp((*it)->fBranch1);
+            assertInterp(it->fBranch1);
             dispatchBranch1Scal();
         } else {
             // Just continue after 'loop block' (do the final 'return')
@@ -4814,18 +4861,150 @@ class FBCInterpreter : public FBCExecutor<REAL> {
     }
 
     do_kLoop: {
+        // Full chunks of lane compiled loops are executed by the vector interpreter,
+        // the remaining iterations by the scalar loop body (without its init block)
+        if (TRACE == 0) {
+            FBCVecBlock<REAL>* vec = (*it->fInstruction)->fBranch2->fVecBlock;
+            if (vec) {
+                int bound  = (vec->fBoundOffset >= 0) ? fIntHeap[vec->fBoundOffset] : vec->fBound;
+                int chunks = (bound > vec->fLoopStart) ? (bound - vec->fLoopStart) / FBC_VEC_LANES : 0;
+                if (chunks > 0) {
+                    fVecInterpreter.execute(vec, vec->fLoopStart, chunks);
+                    int next                   = vec->fLoopStart + chunks * FBC_VEC_LANES;
+                    fIntHeap[vec->fLoopOffset] = next;
+                    if (next == bound) {
+                        dispatchNextScal();
+                    } else {
+                        saveReturnScal();
+                        dispatchBranch2Scal();
+                    }
+                }
+            }
+        }
+
         // Keep next instruction
         saveReturnScal();
 
         // Push branch2 (loop content)
-        assertInterp((*it)->fBranch2);
+        assertInterp(it->fBranch2);
         pushBranch2Scal();
 
         // And start branch1 loop variable declaration block
-        assertInterp((*it)->fBranch1);
+        assertInterp(it->fBranch1);
         dispatchBranch1Scal();
     }
 
+    // Superinstructions (only generated when TRACE is 0)
+    do_kLoadDelayReal: {
+        pushReal(it->fInstruction,
+                 fRealHeap[it->fOffset1 + ((fIntHeap[it->fOffset2] - it->fIntValue) & it->fOffset3)]);
+        dispatchNextScal();
+    }
+
+    do_kLoadDelayRealMult: {
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction,
+                 fRealHeap[it->fOffset1 + ((fIntHeap[it->fOffset2] - it->fIntValue) & it->fOffset3)] * v1);
+        dispatchNextScal();
+    }
+
+    do_kStoreDelayReal: {
+        fRealHeap[it->fOffset1 + (fIntHeap[it->fOffset2] & it->fOffset3)] = popReal(it->fInstruction);
+        dispatchNextScal();
+    }
+
+    do_kLoadIndexedRealStore: {
+        int offset              = popInt();
+        fRealHeap[it->fOffset2] = fRealHeap[it->fOffset1 + offset];
+        dispatchNextScal();
+    }
+
+    do_kMultAddRealValue: {
+        pushReal(it->fInstruction, fRealHeap[it->fOffset2] + it->fRealValue * fRealHeap[it->fOffset1]);
+        dispatchNextScal();
+    }
+
+    do_kMultAddRealValueStore: {
+        fRealHeap[it->fOffset3] = fRealHeap[it->fOffset2] + it->fRealValue * fRealHeap[it->fOffset1];
+        dispatchNextScal();
+    }
+
+    do_kMultAddRealHeap: {
+        pushReal(it->fInstruction,
+                 fRealHeap[it->fOffset3] + fRealHeap[it->fOffset1] * fRealHeap[it->fOffset2]);
+        dispatchNextScal();
+    }
+
+    do_kMultAddRealHeapStack: {
+        REAL v1 = popReal(it->fInstruction);
+        pushReal(it->fInstruction, fRealHeap[it->fOffset1] * fRealHeap[it->fOffset2] + v1);
+        dispatchNextScal();
+    }
+
+    do_kAddRealStore: {
+        REAL v1                 = popReal(it->fInstruction);
+        REAL v2                 = popReal(it->fInstruction);
+        fRealHeap[it->fOffset1] = v1 + v2;
+        dispatchNextScal();
+    }
+
+    do_kAddRealStackStore: {
+        REAL v1                 = popReal(it->fInstruction);
+        fRealHeap[it->fOffset2] = fRealHeap[it->fOffset1] + v1;
+        dispatchNextScal();
+    }
+
+    do_kStoreMultRealHeap: {
+        fRealHeap[it->fOffset3] = popReal(it->fInstruction);
+        pushReal(it->fInstruction, fRealHeap[it->fOffset1] * fRealHeap[it->fOffset2]);
+        dispatchNextScal();
+    }
+
+    do_kStoreMultRealValue: {
+        fRealHeap[it->fOffset2] = popReal(it->fInstruction);
+        pushReal(it->fInstruction, it->fRealValue * fRealHeap[it->fOffset1]);
+        dispatchNextScal();
+    }
+
+    do_kMoveReal2: {
+        fRealHeap[it->fOffset1] = fRealHeap[it->fOffset2];
+        fRealHeap[it->fOffset3] = fRealHeap[it->fIntValue];
+        dispatchNextScal();
+    }
+
+    do_kLoadInputIndexed: {
+        pushReal(it->fInstruction, fInputs[it->fOffset1][fIntHeap[it->fOffset2]]);
+        dispatchNextScal();
+    }
+
+    do_kLoadInputIndexedStore: {
+        fRealHeap[it->fOffset3] = fInputs[it->fOffset1][fIntHeap[it->fOffset2]];
+        dispatchNextScal();
+    }
+
+    do_kStoreOutputIndexed: {
+        fOutputs[it->fOffset1][fIntHeap[it->fOffset2]] = popReal(it->fInstruction);
+        dispatchNextScal();
+    }
+
+    do_kLoopIncLTHeap: {
+        fIntHeap[it->fOffset1] += it->fIntValue;
+        if (fIntHeap[it->fOffset1] < fIntHeap[it->fOffset2]) {
+            dispatchBranch1Scal();
+        } else {
+            dispatchNextScal();
+        }
+    }
+
+    do_kLoopIncLTValue: {
+        fIntHeap[it->fOffset1] += it->fIntValue;
+        if (fIntHeap[it->fOffset1] < it->fOffset2) {
+            dispatchBranch1Scal();
+        } else {
+            dispatchNextScal();
+        }
+    }
+
     end:
         // Check stack coherency
         assertInterp(real_stack_index == 0 && int_stack_index == 0);
@@ -4903,6 +5082,28 @@ class FBCInterpreter : public FBCExecutor<REAL> {
         fRealStats[FP_SUBNORMAL]      = 0;
         fRealStats[CAST_INT_OVERFLOW] = 0;
         fRealStats[NEGATIVE_BITSHIFT] = 0;
+
+#if !defined(_WIN32)
+        fVecInterpreter.init(fIntHeap, fRealHeap, fInputs, fOutputs);
+        if (fFactory->fLanes) {
+            compileVecLoops(fFactory->fComputeDSPBlock);
+        }
+
+        // Threaded code is generated once for the (already optimized) factory blocks,
+        // instances being created under the factory 'fInstanceLock'
+        bool first = fFactory->fComputeDSPBlock->fThreadedCode.empty();
+        threadBlock(fFactory->fStaticInitBlock);
+        threadBlock(fFactory->fInitBlock);
+        threadBlock(fFactory->fResetUIBlock);
+        threadBlock(fFactory->fClearBlock);
+        threadBlock(fFactory->fComputeBlock);
+        threadBlock(fFactory->fComputeDSPBlock);
+        if (first && getenv("FAUST_INTERP_STATS")) {
+            FBCBlockInstruction<REAL>* block = fFactory->fComputeDSPBlock;
+            std::cout << "FBC compute : " << block->fThreadedInstructions << " instructions, "
+                      << block->fThreadedCode.size() << " threaded instructions" << std::endl;
+        }
+#endif
     }
 
     virtual ~FBCInterpreter()
@@ -22,2552 +22,1003 @@
 #ifndef _FBC_VEC_INTERPRETER_H
 #define _FBC_VEC_INTERPRETER_H
 
-#include <string.h>
+#include <algorithm>
 #include <cmath>
-#include <iostream>
 #include <map>
-#include <sstream>
-#include <string>
+#include <vector>
 
-#include "exception.hh"
-#include "faust/gui/CGlue.h"
-#include "fbc_executor.hh"
 #include "interpreter_bytecode.hh"
 
-// #define interp_assert(exp) faustassert(exp)
-#define interp_assert(exp)
+// Number of loop iterations executed at once, chosen so that each lane operation
+// is compiled as a few SSE/AVX/NEON instructions by the C++ compiler
+#ifndef FBC_VEC_LANES
+#define FBC_VEC_LANES 8
+#endif
 
-template <class REAL, int TRACE>
-struct interpreter_dsp_factory_aux;
+// Maximum stack depth and number of private variables of a lane loop
+#define FBC_VEC_STACK 64
+#define FBC_VEC_SLOTS 64
 
-// FBC interpreter
-template <class REAL, int VEC>
-class FBCVecInterpreter : public FBCExecutor<REAL> {
-   protected:
-    interpreter_dsp_factory_aux<T, 0>* fFactory;
+/*
+ Lane interpreter for the non-recursive loops (kLoop instructions
+ with a 'fIntValue' greater than 1).
+
+ The loop body is lowered once in a 'lane' code where heap OP stack/value fused instructions are
+ expanded back to their stack form, and where the scalar variables written in the loop body (the loop
+ variable and local temporaries) become private lane slots. Each lane instruction is then executed
+ on VEC consecutive iterations, so that the dispatch cost is shared by VEC samples and the
+ arithmetic is done by fixed size loops that the C++ compiler vectorizes.
 
-    int*  fIntHeap;
-    REAL* fRealHeap;
+ Only full chunks of VEC iterations are executed here, the remaining ones are executed by the
+ scalar loop body. Loops with nested control flow, side effects in select branches, or scalar
+ variables read before being written (that is a dependency between iterations) stay scalar.
+ */
 
+template <class REAL, int VEC>
+class FBCVecInterpreter {
+   protected:
+    int*   fIntHeap;
+    REAL*  fRealHeap;
     REAL** fInputs;
     REAL** fOutputs;
 
-#define POP_INT() (int_stack[--int_stack_index])
+    int  fIntStack[FBC_VEC_STACK][VEC];
+    REAL fRealStack[FBC_VEC_STACK][VEC];
+    int  fIntSlots[FBC_VEC_SLOTS][VEC];
+    REAL fRealSlots[FBC_VEC_SLOTS][VEC];
+
+    // Lane only opcodes, numbered after the FBC ones that are directly used for the other instructions
+    enum VecOpcode {
+        kLoadPrivateReal = FBCInstruction::kNop + 1,
+        kLoadPrivateInt,
+        kStorePrivateReal,
+        kStorePrivateInt,
+        kVecEnd,
+        kVecOpcodes
+    };
+
+    // Address of the lane code of an opcode
+    struct VecLabel {
+        int   fOpcode;
+        void* fLabel;
+    };
+
+    // State of the lowering of a loop body
+    struct Lowering {
+        std::vector<void*>                   fLabels;  // Opcode => lane code, nullptr if not supported
+        std::vector<FBCVecInstruction<REAL>> fCode;
+        std::map<int, int>                   fIntSlots;  // Heap offset => private slot
+        std::map<int, int>                   fRealSlots;
+        std::map<int, bool>                  fIntShared;  // Heap offsets read before being written
+        std::map<int, bool>                  fRealShared;
+        std::map<int, int>                   fIntArrays;  // Heap offset => 1 if read, 2 if written
+        std::map<int, int>                   fRealArrays;
+        int                                  fIntDepth  = 0;
+        int                                  fRealDepth = 0;
+        int                                  fMaxDepth  = 0;
+
+        void emit(int opcode, int offset = 0, int int_value = 0, REAL real_value = 0)
+        {
+            FBCVecInstruction<REAL> inst;
+            inst.fLabel     = fLabels[opcode];
+            inst.fOffset1   = offset;
+            inst.fIntValue  = int_value;
+            inst.fRealValue = real_value;
+            fCode.push_back(inst);
+        }
+
+        void move(int int_move, int real_move)
+        {
+            fIntDepth += int_move;
+            fRealDepth += real_move;
+            fMaxDepth = std::max(fMaxDepth, std::max(fIntDepth, fRealDepth));
+        }
+
+        void loadInt(int offset)
+        {
+            if (fIntSlots.find(offset) != fIntSlots.end()) {
+                emit(kLoadPrivateInt, fIntSlots[offset]);
+            } else {
+                fIntShared[offset] = true;
+                emit(FBCInstruction::kLoadInt, offset);
+            }
+            move(1, 0);
+        }
+
+        void loadReal(int offset)
+        {
+            if (fRealSlots.find(offset) != fRealSlots.end()) {
+                emit(kLoadPrivateReal, fRealSlots[offset]);
+            } else {
+                fRealShared[offset] = true;
+                emit(FBCInstruction::kLoadReal, offset);
+            }
+            move(0, 1);
+        }
+
+        // A scalar written after having been read (in a previous iteration) cannot be private
+        bool storeInt(int offset)
+        {
+            if (fIntShared.find(offset) != fIntShared.end()) {
+                return false;
+            }
+            if (fIntSlots.find(offset) == fIntSlots.end()) {
+                int slot          = int(fIntSlots.size());
+                fIntSlots[offset] = slot;
+            }
+            emit(kStorePrivateInt, fIntSlots[offset]);
+            move(-1, 0);
+            return true;
+        }
+
+        bool storeReal(int offset)
+        {
+            if (fRealShared.find(offset) != fRealShared.end()) {
+                return false;
+            }
+            if (fRealSlots.find(offset) == fRealSlots.end()) {
+                int slot           = int(fRealSlots.size());
+                fRealSlots[offset] = slot;
+            }
+            emit(kStorePrivateReal, fRealSlots[offset]);
+            move(0, -1);
+            return true;
+        }
+
+        // Lanes of an array both read and written in the loop could see each other's values
+        bool access(bool real, int offset, int mode)
+        {
+            int& access = (real) ? fRealArrays[offset] : fIntArrays[offset];
+            access |= mode;
+            return access != 3;
+        }
+
+        void load(bool real, int offset) { (real) ? loadReal(offset) : loadInt(offset); }
+
+        void value(bool real, FBCBasicInstruction<REAL>* inst)
+        {
+            if (real) {
+                emit(FBCInstruction::kRealValue, 0, 0, inst->fRealValue);
+                move(0, 1);
+            } else {
+                emit(FBCInstruction::kInt32Value, 0, inst->fIntValue);
+                move(1, 0);
+            }
+        }
+
+        // Stack operation with its effect on both stacks
+        void operation(FBCInstruction::Opcode opcode)
+        {
+            emit(opcode);
+            switch (opcode) {
+                case FBCInstruction::kCastReal:
+                case FBCInstruction::kBitcastReal:
+                    move(-1, 1);
+                    break;
+                case FBCInstruction::kCastInt:
+                case FBCInstruction::kBitcastInt:
+                case FBCInstruction::kIsnanf:
+                case FBCInstruction::kIsinff:
+                    move(1, -1);
+                    break;
+                case FBCInstruction::kGTReal:
+                case FBCInstruction::kLTReal:
+                case FBCInstruction::kGEReal:
+                case FBCInstruction::kLEReal:
+                case FBCInstruction::kEQReal:
+                case FBCInstruction::kNEReal:
+                    move(1, -2);
+                    break;
+                case FBCInstruction::kSelectReal:
+                    move(-1, -1);
+                    break;
+                case FBCInstruction::kSelectInt:
+                    move(-2, 0);
+                    break;
+                default:
+                    if (isBinary(opcode)) {
+                        (isRealOperation(opcode)) ? move(0, -1) : move(-1, 0);
+                    }
+                    break;
+            }
+        }
+    };
+
+    static bool isBinary(FBCInstruction::Opcode opcode)
+    {
+        return FBCInstruction::isMath(opcode) ||
+               (opcode >= FBCInstruction::kAtan2f && opcode <= FBCInstruction::kCopysignf);
+    }
+
+    // Type of the operands of a stack operation
+    static bool isRealOperation(FBCInstruction::Opcode opcode)
+    {
+        return FBCInstruction::isRealType(opcode) ||
+               (opcode >= FBCInstruction::kGTReal && opcode <= FBCInstruction::kNEReal) ||
+               (opcode == FBCInstruction::kIsnanf) || (opcode == FBCInstruction::kIsinff);
+    }
 
-#define pushAddr(addr) (address_stack[addr_stack_index++] = addr)
-#define popAddr() (address_stack[--addr_stack_index])
+    // Integer division traps, so cannot be speculatively executed in select branches
+    static bool isIntDivision(FBCInstruction::Opcode opcode)
+    {
+        return opcode == FBCInstruction::kDivInt || opcode == FBCInstruction::kRemInt;
+    }
 
-    virtual void ExecuteBuildUserInterface(FIRUserInterfaceBlockInstruction<T>* block,
-                                           UIInterface*                         glue)
+    // Lower instructions [begin, end[ of a block, 'branch' is true in select branches
+    // that are executed for all lanes and so cannot have side effects
+    static bool lower(Lowering& lowering, FBCBlockInstruction<REAL>* block, size_t begin,
+                      size_t end, bool branch)
     {
-        for (const auto& it : block->fInstructions) {
-            // it->write(&std::cout);
+        static const FBCInstruction::Opcode math_invert[] = {
+            FBCInstruction::kSubReal, FBCInstruction::kSubInt,  FBCInstruction::kDivReal,
+            FBCInstruction::kDivInt,  FBCInstruction::kRemReal, FBCInstruction::kRemInt,
+            FBCInstruction::kLshInt,  FBCInstruction::kARshInt, FBCInstruction::kLRshInt,
+            FBCInstruction::kGTInt,   FBCInstruction::kLTInt,   FBCInstruction::kGEInt,
+            FBCInstruction::kLEInt,   FBCInstruction::kGTReal,  FBCInstruction::kLTReal,
+            FBCInstruction::kGEReal,  FBCInstruction::kLEReal};
+
+        for (size_t i = begin; i < end; i++) {
+            FBCBasicInstruction<REAL>* inst   = block->fInstructions[i];
+            FBCInstruction::Opcode     opcode = inst->fOpcode;
+
+            // Operation and operands form of the fused math instructions
+            FBCInstruction::Opcode base = opcode;
+            enum { kStack, kHeap, kHeapStack, kValueStack, kValueHeap, kHeapValue } form = kStack;
+
+            if (opcode >= FBCInstruction::kAddRealHeap && opcode <= FBCInstruction::kXORIntHeap) {
+                base = FBCInstruction::Opcode(opcode - FBCInstruction::kAddRealHeap + FBCInstruction::kAddReal);
+                form = kHeap;
+            } else if (opcode >= FBCInstruction::kAddRealStack && opcode <= FBCInstruction::kXORIntStack) {
+                base = FBCInstruction::Opcode(opcode - FBCInstruction::kAddRealStack + FBCInstruction::kAddReal);
+                form = kHeapStack;
+            } else if (opcode >= FBCInstruction::kAddRealStackValue &&
+                       opcode <= FBCInstruction::kXORIntStackValue) {
+                base = FBCInstruction::Opcode(opcode - FBCInstruction::kAddRealStackValue + FBCInstruction::kAddReal);
+                form = kValueStack;
+            } else if (opcode >= FBCInstruction::kAddRealValue && opcode <= FBCInstruction::kXORIntValue) {
+                base = FBCInstruction::Opcode(opcode - FBCInstruction::kAddRealValue + FBCInstruction::kAddReal);
+                form = kValueHeap;
+            } else if (opcode >= FBCInstruction::kSubRealValueInvert &&
+                       opcode <= FBCInstruction::kLERealValueInvert) {
+                base = math_invert[opcode - FBCInstruction::kSubRealValueInvert];
+                form = kHeapValue;
+            } else if (opcode >= FBCInstruction::kAbsHeap && opcode <= FBCInstruction::kTanhfHeap) {
+                base = FBCInstruction::Opcode(opcode - FBCInstruction::kAbsHeap + FBCInstruction::kAbs);
+                form = kHeap;
+            } else if (opcode >= FBCInstruction::kAtan2fHeap && opcode <= FBCInstruction::kMinfHeap) {
+                base = FBCInstruction::Opcode(opcode - FBCInstruction::kAtan2fHeap + FBCInstruction::kAtan2f);
+                form = kHeap;
+            } else if (opcode >= FBCInstruction::kAtan2fStack && opcode <= FBCInstruction::kMinfStack) {
+                base = FBCInstruction::Opcode(opcode - FBCInstruction::kAtan2fStack + FBCInstruction::kAtan2f);
+                form = kHeapStack;
+            } else if (opcode >= FBCInstruction::kAtan2fStackValue &&
+                       opcode <= FBCInstruction::kMinfStackValue) {
+                base = FBCInstruction::Opcode(opcode - FBCInstruction::kAtan2fStackValue + FBCInstruction::kAtan2f);
+                form = kValueStack;
+            } else if (opcode >= FBCInstruction::kAtan2fValue && opcode <= FBCInstruction::kMinfValue) {
+                base = FBCInstruction::Opcode(opcode - FBCInstruction::kAtan2fValue + FBCInstruction::kAtan2f);
+                form = kValueHeap;
+            } else if (opcode >= FBCInstruction::kAtan2fValueInvert &&
+                       opcode <= FBCInstruction::kPowfValueInvert) {
+                base = FBCInstruction::Opcode(opcode - FBCInstruction::kAtan2fValueInvert + FBCInstruction::kAtan2f);
+                form = kHeapValue;
+            }
 
-            switch (it->fOpcode) {
-                case FBCInstruction::kOpenVerticalBox:
-                    glue->openVerticalBox(it->fLabel.c_str());
+            if ((base >= FBCInstruction::kAddReal && base <= FBCInstruction::kXORInt) ||
+                (base >= FBCInstruction::kAbs && base <= FBCInstruction::kIsinff) ||
+                (base >= FBCInstruction::kAtan2f && base <= FBCInstruction::kCopysignf)) {
+                if (branch && isIntDivision(base)) {
+                    return false;
+                }
+                // Stack operations use the top of the stack as their first operand
+                bool real = isRealOperation(base);
+                switch (form) {
+                    case kStack:
+                        break;
+                    case kHeap:
+                        if (isBinary(base)) {
+                            lowering.load(real, inst->fOffset2);
+                        }
+                        lowering.load(real, inst->fOffset1);
+                        break;
+                    case kHeapStack:
+                        lowering.load(real, inst->fOffset1);
+                        break;
+                    case kValueStack:
+                        lowering.value(real, inst);
+                        break;
+                    case kValueHeap:
+                        lowering.load(real, inst->fOffset1);
+                        lowering.value(real, inst);
+                        break;
+                    case kHeapValue:
+                        lowering.value(real, inst);
+                        lowering.load(real, inst->fOffset1);
+                        break;
+                }
+                lowering.operation(base);
+                continue;
+            }
+
+            switch (opcode) {
+                case FBCInstruction::kRealValue:
+                case FBCInstruction::kInt32Value:
+                    lowering.value(opcode == FBCInstruction::kRealValue, inst);
                     break;
 
-                case FBCInstruction::kOpenHorizontalBox:
-                    glue->openHorizontalBox(it->fLabel.c_str());
+                case FBCInstruction::kLoadReal:
+                case FBCInstruction::kLoadInt:
+                    lowering.load(opcode == FBCInstruction::kLoadReal, inst->fOffset1);
                     break;
 
-                case FBCInstruction::kOpenTabBox:
-                    glue->openTabBox(it->fLabel.c_str());
+                case FBCInstruction::kStoreRealValue:
+                case FBCInstruction::kStoreIntValue:
+                    if (branch) {
+                        return false;
+                    }
+                    lowering.value(opcode == FBCInstruction::kStoreRealValue, inst);
+                    if (!((opcode == FBCInstruction::kStoreRealValue) ? lowering.storeReal(inst->fOffset1)
+                                                                     : lowering.storeInt(inst->fOffset1))) {
+                        return false;
+                    }
                     break;
 
-                case FBCInstruction::kCloseBox:
-                    glue->closeBox();
+                case FBCInstruction::kStoreReal:
+                case FBCInstruction::kStoreInt:
+                    if (branch || !((opcode == FBCInstruction::kStoreReal) ? lowering.storeReal(inst->fOffset1)
+                                                                           : lowering.storeInt(inst->fOffset1))) {
+                        return false;
+                    }
                     break;
 
-                case FBCInstruction::kAddButton:
-                    glue->addButton(it->fLabel.c_str(), &fRealHeap[it->fOffset]);
+                case FBCInstruction::kMoveReal:
+                case FBCInstruction::kMoveInt:
+                    if (branch) {
+                        return false;
+                    }
+                    lowering.load(opcode == FBCInstruction::kMoveReal, inst->fOffset2);
+                    if (!((opcode == FBCInstruction::kMoveReal) ? lowering.storeReal(inst->fOffset1)
+                                                               : lowering.storeInt(inst->fOffset1))) {
+                        return false;
+                    }
                     break;
 
-                case FBCInstruction::kAddCheckButton:
-                    glue->addCheckButton(it->fLabel.c_str(), &fRealHeap[it->fOffset]);
+                // Indexed accesses may be out of bounds in a not selected branch
+                case FBCInstruction::kLoadIndexedReal:
+                case FBCInstruction::kLoadInput:
+                    if (branch || (opcode == FBCInstruction::kLoadIndexedReal &&
+                                   !lowering.access(true, inst->fOffset1, 1))) {
+                        return false;
+                    }
+                    lowering.emit(opcode, inst->fOffset1);
+                    lowering.move(-1, 1);
                     break;
 
-                case FBCInstruction::kAddHorizontalSlider:
-                    glue->addHorizontalSlider(it->fLabel.c_str(), &fRealHeap[it->fOffset],
-                                              it->fInit, it->fMin, it->fMax, it->fStep);
+                case FBCInstruction::kLoadIndexedInt:
+                    if (branch || !lowering.access(false, inst->fOffset1, 1)) {
+                        return false;
+                    }
+                    lowering.emit(opcode, inst->fOffset1);
                     break;
 
-                case FBCInstruction::kAddVerticalSlider:
-                    glue->addVerticalSlider(it->fLabel.c_str(), &fRealHeap[it->fOffset], it->fInit,
-                                            it->fMin, it->fMax, it->fStep);
+                case FBCInstruction::kStoreIndexedReal:
+                case FBCInstruction::kStoreOutput:
+                    if (branch || (opcode == FBCInstruction::kStoreIndexedReal &&
+                                   !lowering.access(true, inst->fOffset1, 2))) {
+                        return false;
+                    }
+                    lowering.emit(opcode, inst->fOffset1);
+                    lowering.move(-1, -1);
                     break;
 
-                case FBCInstruction::kAddNumEntry:
-                    glue->addNumEntry(it->fLabel.c_str(), &fRealHeap[it->fOffset], it->fInit,
-                                      it->fMin, it->fMax, it->fStep);
+                case FBCInstruction::kStoreIndexedInt:
+                    if (branch || !lowering.access(false, inst->fOffset1, 2)) {
+                        return false;
+                    }
+                    lowering.emit(opcode, inst->fOffset1);
+                    lowering.move(-2, 0);
                     break;
 
-                case FBCInstruction::kAddSoundfile:
-                    // fKey use for label, fValue used for URL, fLabel for SF field name
-                    glue->addSoundfile(it->fKey.c_str(), it->fValue.c_str(),
-                                       &this->fSoundTable[it->fLabel]);
+                case FBCInstruction::kCastReal:
+                case FBCInstruction::kCastInt:
+                case FBCInstruction::kBitcastInt:
+                case FBCInstruction::kBitcastReal:
+                    lowering.operation(opcode);
                     break;
 
-                case FBCInstruction::kAddHorizontalBargraph:
-                    glue->addHorizontalBargraph(it->fLabel.c_str(), &fRealHeap[it->fOffset],
-                                                it->fMin, it->fMax);
+                case FBCInstruction::kCastRealHeap:
+                    lowering.loadInt(inst->fOffset1);
+                    lowering.operation(FBCInstruction::kCastReal);
                     break;
 
-                case FBCInstruction::kAddVerticalBargraph:
-                    glue->addVerticalBargraph(it->fLabel.c_str(), &fRealHeap[it->fOffset], it->fMin,
-                                              it->fMax);
+                case FBCInstruction::kCastIntHeap:
+                    lowering.loadReal(inst->fOffset1);
+                    lowering.operation(FBCInstruction::kCastInt);
                     break;
 
-                case FBCInstruction::kDeclare:
-                    // Special case for "0" zone
-                    if (it->fOffset == -1) {
-                        glue->declare(static_cast<T*>(nullptr), it->fKey.c_str(),
-                                      it->fValue.c_str());
-                    } else {
-                        glue->declare(&fRealHeap[it->fOffset], it->fKey.c_str(),
-                                      it->fValue.c_str());
+                // Both branches are computed, then selected in each lane
+                case FBCInstruction::kSelectReal:
+                case FBCInstruction::kSelectInt: {
+                    FBCBlockInstruction<REAL>* branch1 = inst->fBranch1;
+                    FBCBlockInstruction<REAL>* branch2 = inst->fBranch2;
+                    if (!lowerBranch(lowering, branch1) || !lowerBranch(lowering, branch2)) {
+                        return false;
                     }
+                    lowering.operation(opcode);
                     break;
+                }
 
                 default:
-                    break;
+                    return false;
             }
         }
+
+        return true;
     }
 
-    // virtual void ExecuteVecLoop(FBCBasicInstruction<T>* block)
-    virtual void ExecuteBlock(FBCBlockInstruction<REAL>* block)
+    static bool lowerBranch(Lowering& lowering, FBCBlockInstruction<REAL>* block)
     {
-        static void* fDispatchTable[] = {
-
-            // Numbers
-            &&do_kRealValue, &&do_kInt32Value,
-
-            // Memory
-            &&do_kLoadReal, &&do_kLoadInt, &&do_kLoadSoundFieldInt, &&do_kLoadSoundFieldReal,
-            &&do_kStoreReal, &&do_kStoreInt, &&do_kStoreRealValue, &&do_kStoreIntValue,
-            &&do_kLoadIndexedReal, &&do_kLoadIndexedInt, &&do_kStoreIndexedReal,
-            &&do_kStoreIndexedInt, &&do_kBlockStoreReal, &&do_kBlockStoreInt, &&do_kMoveReal,
-            &&do_kMoveInt, &&do_kPairMoveReal, &&do_kPairMoveInt, &&do_kBlockPairMoveReal,
-            &&do_kBlockPairMoveInt, &&do_kBlockShiftReal, &&do_kBlockShiftInt, &&do_kLoadInput,
-            &&do_kStoreOutput,
-
-            // Cast/bitcast
-            &&do_kCastReal, &&do_kCastInt, &&do_kCastRealHeap, &&do_kCastIntHeap, &&do_kBitcastInt,
-            &&do_kBitcastReal,
-
-            // Standard math (stack OP stack)
-            &&do_kAddReal, &&do_kAddInt, &&do_kSubReal, &&do_kSubInt, &&do_kMultReal, &&do_kMultInt,
-            &&do_kDivReal, &&do_kDivInt, &&do_kRemReal, &&do_kRemInt, &&do_kLshInt, &&do_kARshInt,
-            &&do_kGTInt, &&do_kLTInt, &&do_kGEInt, &&do_kLEInt, &&do_kEQInt, &&do_kNEInt,
-            &&do_kGTReal, &&do_kLTReal, &&do_kGEReal, &&do_kLEReal, &&do_kEQReal, &&do_kNEReal,
-            &&do_kANDInt, &&do_kORInt, &&do_kXORInt,
-
-            // Standard math (heap OP heap)
-            &&do_kAddRealHeap, &&do_kAddIntHeap, &&do_kSubRealHeap, &&do_kSubIntHeap,
-            &&do_kMultRealHeap, &&do_kMultIntHeap, &&do_kDivRealHeap, &&do_kDivIntHeap,
-            &&do_kRemRealHeap, &&do_kRemIntHeap, &&do_kLshIntHeap, &&do_kARshIntHeap,
-            &&do_kGTIntHeap, &&do_kLTIntHeap, &&do_kGEIntHeap, &&do_kLEIntHeap, &&do_kEQIntHeap,
-            &&do_kNEIntHeap, &&do_kGTRealHeap, &&do_kLTRealHeap, &&do_kGERealHeap, &&do_kLERealHeap,
-            &&do_kEQRealHeap, &&do_kNERealHeap, &&do_kANDIntHeap, &&do_kORIntHeap, &&do_kXORIntHeap,
-
-            // Standard math (heap OP stack)
-            &&do_kAddRealStack, &&do_kAddIntStack, &&do_kSubRealStack, &&do_kSubIntStack,
-            &&do_kMultRealStack, &&do_kMultIntStack, &&do_kDivRealStack, &&do_kDivIntStack,
-            &&do_kRemRealStack, &&do_kRemIntStack, &&do_kLshIntStack, &&do_kARshIntStack,
-            &&do_kGTIntStack, &&do_kLTIntStack, &&do_kGEIntStack, &&do_kLEIntStack,
-            &&do_kEQIntStack, &&do_kNEIntStack, &&do_kGTRealStack, &&do_kLTRealStack,
-            &&do_kGERealStack, &&do_kLERealStack, &&do_kEQRealStack, &&do_kNERealStack,
-            &&do_kANDIntStack, &&do_kORIntStack, &&do_kXORIntStack,
-
-            // Standard math (value OP stack)
-            &&do_kAddRealStackValue, &&do_kAddIntStackValue, &&do_kSubRealStackValue,
-            &&do_kSubIntStackValue, &&do_kMultRealStackValue, &&do_kMultIntStackValue,
-            &&do_kDivRealStackValue, &&do_kDivIntStackValue, &&do_kRemRealStackValue,
-            &&do_kRemIntStackValue, &&do_kLshIntStackValue, &&do_kARshIntStackValue,
-            &&do_kGTIntStackValue, &&do_kLTIntStackValue, &&do_kGEIntStackValue,
-            &&do_kLEIntStackValue, &&do_kEQIntStackValue, &&do_kNEIntStackValue,
-            &&do_kGTRealStackValue, &&do_kLTRealStackValue, &&do_kGERealStackValue,
-            &&do_kLERealStackValue, &&do_kEQRealStackValue, &&do_kNERealStackValue,
-            &&do_kANDIntStackValue, &&do_kORIntStackValue, &&do_kXORIntStackValue,
-
-            // Standard math (value OP heap)
-            &&do_kAddRealValue, &&do_kAddIntValue, &&do_kSubRealValue, &&do_kSubIntValue,
-            &&do_kMultRealValue, &&do_kMultIntValue, &&do_kDivRealValue, &&do_kDivIntValue,
-            &&do_kRemRealValue, &&do_kRemIntValue, &&do_kLshIntValue, &&do_kARshIntValue,
-            &&do_kGTIntValue, &&do_kLTIntValue, &&do_kGEIntValue, &&do_kLEIntValue,
-            &&do_kEQIntValue, &&do_kNEIntValue, &&do_kGTRealValue, &&do_kLTRealValue,
-            &&do_kGERealValue, &&do_kLERealValue, &&do_kEQRealValue, &&do_kNERealValue,
-            &&do_kANDIntValue, &&do_kORIntValue, &&do_kXORIntValue,
-
-            // Standard math (value OP heap) : non commutative operations
-            &&do_kSubRealValueInvert, &&do_kSubIntValueInvert, &&do_kDivRealValueInvert,
-            &&do_kDivIntValueInvert, &&do_kRemRealValueInvert, &&do_kRemIntValueInvert,
-            &&do_kLshIntValueInvert, &&do_kARshIntValueInvert, &&do_kGTIntValueInvert,
-            &&do_kLTIntValueInvert, &&do_kGEIntValueInvert, &&do_kLEIntValueInvert,
-            &&do_kGTRealValueInvert, &&do_kLTRealValueInvert, &&do_kGERealValueInvert,
-            &&do_kLERealValueInvert,
-
-            // Extended unary math
-            &&do_kAbs, &&do_kAbsf, &&do_kAcosf, &&do_kAsinf, &&do_kAtanf, &&do_kCeilf, &&do_kCosf,
-            &&do_kCoshf, &&do_kExpf, &&do_kFloorf, &&do_kLogf, &&do_kLog10f, &&do_kRintf,
-            &&do_kRoundf, &&do_kSinf, &&do_kSinhf, &&do_kSqrtf, &&do_kTanf, &&do_kTanhf,
-
-            // Extended unary math (heap OP heap)
-            &&do_kAbsHeap, &&do_kAbsfHeap, &&do_kAcosfHeap, &&do_kAsinfHeap, &&do_kAtanfHeap,
-            &&do_kCeilfHeap, &&do_kCosfHeap, &&do_kCoshfHeap, &&do_kExpfHeap, &&do_kFloorfHeap,
-            &&do_kLogfHeap, &&do_kLog10fHeap, &&do_kRintfHeap, &&do_kRoundfHeap, &&do_kSinfHeap,
-            &&do_kSinhfHeap, &&do_kSqrtfHeap, &&do_kTanfHeap, &&do_kTanhfHeap,
-
-            // Extended binary math
-            &&do_kAtan2f, &&do_kFmodf, &&do_kPowf, &&do_kMax, &&do_kMaxf, &&do_kMin, &&do_kMinf,
-
-            // Extended binary math (heap version)
-            &&do_kAtan2fHeap, &&do_kFmodfHeap, &&do_kPowfHeap, &&do_kMaxHeap, &&do_kMaxfHeap,
-            &&do_kMinHeap, &&do_kMinfHeap,
-
-            // Extended binary math (stack version)
-            &&do_kAtan2fStack, &&do_kFmodfStack, &&do_kPowfStack, &&do_kMaxStack, &&do_kMaxfStack,
-            &&do_kMinStack, &&do_kMinfStack,
-
-            // Extended binary math (Stack/Value version)
-            &&do_kAtan2fStackValue, &&do_kFmodfStackValue, &&do_kPowfStackValue,
-            &&do_kMaxStackValue, &&do_kMaxfStackValue, &&do_kMinStackValue, &&do_kMinfStackValue,
-
-            // Extended binary math (Value version)
-            &&do_kAtan2fValue, &&do_kFmodfValue, &&do_kPowfValue, &&do_kMaxValue, &&do_kMaxfValue,
-            &&do_kMinValue, &&do_kMinfValue,
-
-            // Extended binary math (Value version) : non commutative operations
-            &&do_kAtan2fValueInvert, &&do_kFmodfValueInvert, &&do_kPowfValueInvert,
-
-            // Control
-            &&do_kLoop, &&do_kReturn,
-
-            // Select/if
-            &&do_kIf, &&do_kSelectReal, &&do_kSelectInt, &&do_kCondBranch
-
-        };
-
-        int real_stack_index  = 0;
-        int int_stack_index   = 0;
-        int sound_stack_index = 0;
-        int addr_stack_index  = 0;
-
-        REAL          real_stack[512];
-        int           int_stack[512];
-        InstructionIT address_stack[64];
-
-#define dispatchFirstVec()                    \
-    {                                         \
-        goto* fDispatchTable[(*it)->fOpcode]; \
+        size_t size = block->fInstructions.size();
+        return (size > 0) && (block->fInstructions[size - 1]->fOpcode == FBCInstruction::kReturn) &&
+               lower(lowering, block, 0, size - 1, true);
     }
-#define dispatchNextVec()                     \
-    {                                         \
-        it++;                                 \
-        goto* fDispatchTable[(*it)->fOpcode]; \
+
+   public:
+    FBCVecInterpreter() : fIntHeap(nullptr), fRealHeap(nullptr), fInputs(nullptr), fOutputs(nullptr)
+    {
     }
 
-#define dispatchBranch1Vec()                         \
-    {                                                \
-        it = (*it)->fBranch1->fInstructions.begin(); \
-        dispatchFirstVec();                          \
+    void init(int* int_heap, REAL* real_heap, REAL** inputs, REAL** outputs)
+    {
+        fIntHeap  = int_heap;
+        fRealHeap = real_heap;
+        fInputs   = inputs;
+        fOutputs  = outputs;
     }
-#define dispatchBranch2Vec()                         \
-    {                                                \
-        it = (*it)->fBranch2->fInstructions.begin(); \
-        dispatchFirstVec();                          \
+
+    /*
+     Compile the lane code of a kLoop instruction, or return nullptr if the loop has to be kept scalar.
+     The loop has to be in the form produced by the optimizer, that is :
+     - init block : 'kStoreIntValue var start' (or 'kInt32Value start, kStoreInt var')
+     - body block : code, 'kAddIntValue 1 var, kStoreInt var', 'kLTIntHeap var bound' or
+       'kLTIntValueInvert var bound', 'kCondBranch body', 'kReturn'
+     */
+    FBCVecBlock<REAL>* compile(FBCBasicInstruction<REAL>* loop)
+    {
+        FBCBlockInstruction<REAL>* init = loop->fBranch1;
+        FBCBlockInstruction<REAL>* body = loop->fBranch2;
+        if (!init || !body) {
+            return nullptr;
+        }
+
+        // Loop variable and start value
+        std::vector<FBCBasicInstruction<REAL>*>& init_code = init->fInstructions;
+        int                                      var, start;
+        if (init_code.size() == 2 && init_code[0]->fOpcode == FBCInstruction::kStoreIntValue) {
+            var   = init_code[0]->fOffset1;
+            start = init_code[0]->fIntValue;
+        } else if (init_code.size() == 3 && init_code[0]->fOpcode == FBCInstruction::kInt32Value &&
+                   init_code[1]->fOpcode == FBCInstruction::kStoreInt) {
+            var   = init_code[1]->fOffset1;
+            start = init_code[0]->fIntValue;
+        } else {
+            return nullptr;
+        }
+
+        // Increment, test and branch
+        std::vector<FBCBasicInstruction<REAL>*>& code = body->fInstructions;
+        size_t                                   size = code.size();
+        if (size < 5 || code[size - 5]->fOpcode != FBCInstruction::kAddIntValue ||
+            code[size - 5]->fIntValue != 1 || code[size - 5]->fOffset1 != var ||
+            code[size - 4]->fOpcode != FBCInstruction::kStoreInt || code[size - 4]->fOffset1 != var ||
+            code[size - 2]->fOpcode != FBCInstruction::kCondBranch || code[size - 2]->fBranch1 != body ||
+            code[size - 1]->fOpcode != FBCInstruction::kReturn) {
+            return nullptr;
+        }
+        FBCBasicInstruction<REAL>* test = code[size - 3];
+        int                        bound_offset, bound;
+        if (test->fOpcode == FBCInstruction::kLTIntHeap && test->fOffset1 == var) {
+            bound_offset = test->fOffset2;
+            bound        = 0;
+        } else if (test->fOpcode == FBCInstruction::kLTIntValueInvert && test->fOffset1 == var) {
+            bound_offset = -1;
+            bound        = test->fIntValue;
+        } else {
+            return nullptr;
+        }
+
+        // Get the labels from the static table of 'execute'
+        const VecLabel* labels = nullptr;
+        execute(nullptr, 0, 0, &labels);
+
+        // The loop variable is the first private slot, the bound has to stay constant
+        Lowering lowering;
+        lowering.fLabels.resize(kVecOpcodes, nullptr);
+        for (const VecLabel* label = labels; label->fOpcode != kVecOpcodes; label++) {
+            lowering.fLabels[label->fOpcode] = label->fLabel;
+        }
+        lowering.fIntSlots[var] = 0;
+        if (bound_offset >= 0) {
+            lowering.fIntShared[bound_offset] = true;
+        }
+        if (!lower(lowering, body, 0, size - 5, false) || lowering.fIntDepth != 0 ||
+            lowering.fRealDepth != 0 || lowering.fMaxDepth > FBC_VEC_STACK ||
+            lowering.fIntSlots.size() > FBC_VEC_SLOTS || lowering.fRealSlots.size() > FBC_VEC_SLOTS ||
+            lowering.fIntShared.find(var) != lowering.fIntShared.end()) {
+            return nullptr;
+        }
+        lowering.emit(kVecEnd);
+
+        FBCVecBlock<REAL>* block = new FBCVecBlock<REAL>();
+        block->fInstructions     = lowering.fCode;
+        block->fLoopOffset       = var;
+        block->fLoopStart        = start;
+        block->fBoundOffset      = bound_offset;
+        block->fBound            = bound;
+        block->fIntSlots.resize(lowering.fIntSlots.size());
+        for (const auto& it : lowering.fIntSlots) {
+            block->fIntSlots[it.second] = it.first;
+        }
+        block->fRealSlots.resize(lowering.fRealSlots.size());
+        for (const auto& it : lowering.fRealSlots) {
+            block->fRealSlots[it.second] = it.first;
+        }
+        return block;
     }
 
-#define pushBranch1Vec()                                  \
-    {                                                     \
-        pushAddr((*it)->fBranch1->fInstructions.begin()); \
+    /*
+     Execute 'chunks' x VEC iterations of a loop, starting with 'start' as loop variable.
+     Private variables are written back in the heap with their value in the last iteration.
+     When 'labels' is not null, it only gets the static table of the lane opcodes, ended by kVecOpcodes.
+     */
+    void execute(FBCVecBlock<REAL>* block, int start, int chunks, const VecLabel** labels = nullptr)
+    {
+#define LANES for (int j = 0; j < VEC; j++)
+#define vecDispatchNext() \
+    {                     \
+        it++;             \
+        goto* it->fLabel; \
     }
-#define pushBranch2Vec()                                  \
-    {                                                     \
-        pushAddr((*it)->fBranch2->fInstructions.begin()); \
+#define unaryReal(exp)                               \
+    {                                                \
+        REAL* v = fRealStack[real_stack_index - 1];  \
+        LANES v[j] = exp;                            \
+        vecDispatchNext();                           \
     }
-
-#define dispatchReturnVec() \
-    {                       \
-        it = popAddr();     \
-        dispatchFirstVec(); \
+#define binaryReal(exp)                              \
+    {                                                \
+        REAL* v1 = fRealStack[real_stack_index - 1]; \
+        REAL* v2 = fRealStack[real_stack_index - 2]; \
+        LANES v2[j] = exp;                           \
+        real_stack_index--;                          \
+        vecDispatchNext();                           \
     }
-#define saveReturnVec()   \
-    {                     \
-        pushAddr(it + 1); \
+#define binaryInt(exp)                             \
+    {                                              \
+        int* v1 = fIntStack[int_stack_index - 1];  \
+        int* v2 = fIntStack[int_stack_index - 2];  \
+        LANES v2[j] = exp;                         \
+        int_stack_index--;                         \
+        vecDispatchNext();                         \
     }
-#define emptyReturnVec() (addr_stack_index == 0)
-
-        // #pragma clang loop vectorize(enable) interleave(enable)
-
-#define VEC_LOOP(code)                  \
-    {                                   \
-        for (int j = 0; j < VEC; j++) { \
-            code;                       \
-        }                               \
+#define compareReal(exp)                             \
+    {                                                \
+        REAL* v1 = fRealStack[real_stack_index - 1]; \
+        REAL* v2 = fRealStack[real_stack_index - 2]; \
+        int*  r  = fIntStack[int_stack_index];       \
+        LANES r[j] = exp;                            \
+        real_stack_index -= 2;                       \
+        int_stack_index++;                           \
+        vecDispatchNext();                           \
     }
 
-#define STACK_UP_INT() int_stack_index += VEC
-#define STACK_DOWN_INT() int_stack_index -= VEC
-
-#define STACK_UP_REAL() real_stack_index += VEC
-#define STACK_DOWN_REAL() real_stack_index -= VEC
-
-#define PUSH_VEC_INT(val) int_stack[int_stack_index + j] = (val)
-#define PUSH_VEC_REAL(val) real_stack[real_stack_index + j] = (val)
-
-#define POP_VEC_INT() int_stack[int_stack_index - (j + 1)]
-#define POP_VEC_REAL() real_stack[real_stack_index - (j + 1)]
-
-#define WRITE_HEAP_VEC_REAL(off, val) fRealHeap[(off) + j] = (val)
-#define WRITE_HEAP_VEC_INT(off, val) fIntHeap[(off) + j] = (val)
-
-#define READ_HEAP_VEC_REAL(off) fRealHeap[(off) + j]
-#define READ_HEAP_VEC_INT(off) fIntHeap[(off) + j]
-
-        // Check block coherency
-        // block->check();
-
-        // std::cout << "ExecuteBlock : " << block->fInstructions.size() << "\n";
-        // block->write(&std::cout);
-
-        int  v1_int[VEC];
-        int  v2_int[VEC];
-        REAL v1_real[VEC];
-        REAL v2_real[VEC];
-
-        try {
-            InstructionIT it = block->fInstructions.begin();
-            dispatchFirstVec();
-
-        /*
-        // Execute VecLoop
-        InstructionIT it;
-
-        // Push branch2 (loop content)
-        interp_assert((*it)->fBranch2);
-        pushBranch2Vec();
+        static const VecLabel fLabelTable[] = {
+            {FBCInstruction::kRealValue, &&do_kRealValue},
+            {FBCInstruction::kInt32Value, &&do_kInt32Value},
+            {FBCInstruction::kLoadReal, &&do_kLoadReal},
+            {FBCInstruction::kLoadInt, &&do_kLoadInt},
+            {kLoadPrivateReal, &&do_kLoadPrivateReal},
+            {kLoadPrivateInt, &&do_kLoadPrivateInt},
+            {kStorePrivateReal, &&do_kStorePrivateReal},
+            {kStorePrivateInt, &&do_kStorePrivateInt},
+            {FBCInstruction::kLoadIndexedReal, &&do_kLoadIndexedReal},
+            {FBCInstruction::kLoadIndexedInt, &&do_kLoadIndexedInt},
+            {FBCInstruction::kStoreIndexedReal, &&do_kStoreIndexedReal},
+            {FBCInstruction::kStoreIndexedInt, &&do_kStoreIndexedInt},
+            {FBCInstruction::kLoadInput, &&do_kLoadInput},
+            {FBCInstruction::kStoreOutput, &&do_kStoreOutput},
+            {FBCInstruction::kCastReal, &&do_kCastReal},
+            {FBCInstruction::kCastInt, &&do_kCastInt},
+            {FBCInstruction::kBitcastInt, &&do_kBitcastInt},
+            {FBCInstruction::kBitcastReal, &&do_kBitcastReal},
+            {FBCInstruction::kAddReal, &&do_kAddReal},
+            {FBCInstruction::kAddInt, &&do_kAddInt},
+            {FBCInstruction::kSubReal, &&do_kSubReal},
+            {FBCInstruction::kSubInt, &&do_kSubInt},
+            {FBCInstruction::kMultReal, &&do_kMultReal},
+            {FBCInstruction::kMultInt, &&do_kMultInt},
+            {FBCInstruction::kDivReal, &&do_kDivReal},
+            {FBCInstruction::kDivInt, &&do_kDivInt},
+            {FBCInstruction::kRemReal, &&do_kRemReal},
+            {FBCInstruction::kRemInt, &&do_kRemInt},
+            {FBCInstruction::kLshInt, &&do_kLshInt},
+            {FBCInstruction::kARshInt, &&do_kARshInt},
+            {FBCInstruction::kLRshInt, &&do_kLRshInt},
+            {FBCInstruction::kGTInt, &&do_kGTInt},
+            {FBCInstruction::kLTInt, &&do_kLTInt},
+            {FBCInstruction::kGEInt, &&do_kGEInt},
+            {FBCInstruction::kLEInt, &&do_kLEInt},
+            {FBCInstruction::kEQInt, &&do_kEQInt},
+            {FBCInstruction::kNEInt, &&do_kNEInt},
+            {FBCInstruction::kGTReal, &&do_kGTReal},
+            {FBCInstruction::kLTReal, &&do_kLTReal},
+            {FBCInstruction::kGEReal, &&do_kGEReal},
+            {FBCInstruction::kLEReal, &&do_kLEReal},
+            {FBCInstruction::kEQReal, &&do_kEQReal},
+            {FBCInstruction::kNEReal, &&do_kNEReal},
+            {FBCInstruction::kANDInt, &&do_kANDInt},
+            {FBCInstruction::kORInt, &&do_kORInt},
+            {FBCInstruction::kXORInt, &&do_kXORInt},
+            {FBCInstruction::kAbs, &&do_kAbs},
+            {FBCInstruction::kAbsf, &&do_kAbsf},
+            {FBCInstruction::kAcosf, &&do_kAcosf},
+            {FBCInstruction::kAcoshf, &&do_kAcoshf},
+            {FBCInstruction::kAsinf, &&do_kAsinf},
+            {FBCInstruction::kAsinhf, &&do_kAsinhf},
+            {FBCInstruction::kAtanf, &&do_kAtanf},
+            {FBCInstruction::kAtanhf, &&do_kAtanhf},
+            {FBCInstruction::kCeilf, &&do_kCeilf},
+            {FBCInstruction::kCosf, &&do_kCosf},
+            {FBCInstruction::kCoshf, &&do_kCoshf},
+            {FBCInstruction::kExpf, &&do_kExpf},
+            {FBCInstruction::kFloorf, &&do_kFloorf},
+            {FBCInstruction::kLogf, &&do_kLogf},
+            {FBCInstruction::kLog10f, &&do_kLog10f},
+            {FBCInstruction::kRintf, &&do_kRintf},
+            {FBCInstruction::kRoundf, &&do_kRoundf},
+            {FBCInstruction::kSinf, &&do_kSinf},
+            {FBCInstruction::kSinhf, &&do_kSinhf},
+            {FBCInstruction::kSqrtf, &&do_kSqrtf},
+            {FBCInstruction::kTanf, &&do_kTanf},
+            {FBCInstruction::kTanhf, &&do_kTanhf},
+            {FBCInstruction::kIsnanf, &&do_kIsnanf},
+            {FBCInstruction::kIsinff, &&do_kIsinff},
+            {FBCInstruction::kAtan2f, &&do_kAtan2f},
+            {FBCInstruction::kFmodf, &&do_kFmodf},
+            {FBCInstruction::kPowf, &&do_kPowf},
+            {FBCInstruction::kMax, &&do_kMax},
+            {FBCInstruction::kMaxf, &&do_kMaxf},
+            {FBCInstruction::kMin, &&do_kMin},
+            {FBCInstruction::kMinf, &&do_kMinf},
+            {FBCInstruction::kCopysignf, &&do_kCopysignf},
+            {FBCInstruction::kSelectReal, &&do_kSelectReal},
+            {FBCInstruction::kSelectInt, &&do_kSelectInt},
+            {kVecEnd, &&do_kVecEnd},
+            {kVecOpcodes, nullptr}};
+
+        if (labels) {
+            *labels = fLabelTable;
+            return;
+        }
+
+        for (int chunk = 0; chunk < chunks; chunk++) {
+            int real_stack_index = 0;
+            int int_stack_index  = 0;
+
+            // Loop variable of each lane
+            int base = start + chunk * VEC;
+            LANES fIntSlots[0][j] = base + j;
+
+            FBCVecInstruction<REAL>* it = block->fInstructions.data();
+            goto* it->fLabel;
 
-        // And start branch1 loop variable declaration block
-        interp_assert((*it)->fBranch1);
-        dispatchBranch1Vec();
-        */
-
-        // Number operations
+            // Numbers
         do_kRealValue: {
-            VEC_LOOP(PUSH_VEC_REAL((*it)->fRealValue));
-            STACK_UP_REAL();
-            dispatchNextVec();
+            REAL* r = fRealStack[real_stack_index++];
+            LANES r[j] = it->fRealValue;
+            vecDispatchNext();
         }
 
         do_kInt32Value: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue));
-            STACK_UP_INT();
-            dispatchNextVec();
+            int* r = fIntStack[int_stack_index++];
+            LANES r[j] = it->fIntValue;
+            vecDispatchNext();
         }
 
-        // Memory operations
+            // Memory (scalar variables are either shared by all lanes or private)
         do_kLoadReal: {
-            VEC_LOOP(PUSH_VEC_REAL(READ_HEAP_VEC_REAL((*it)->fOffset1)));
-            STACK_UP_REAL();
-            dispatchNextVec();
+            REAL  v = fRealHeap[it->fOffset1];
+            REAL* r = fRealStack[real_stack_index++];
+            LANES r[j] = v;
+            vecDispatchNext();
         }
 
         do_kLoadInt: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLoadSoundFieldInt: {
-            // TODO
+            int  v = fIntHeap[it->fOffset1];
+            int* r = fIntStack[int_stack_index++];
+            LANES r[j] = v;
+            vecDispatchNext();
         }
 
-        do_kLoadSoundFieldReal: {
-            // TODO
+        do_kLoadPrivateReal: {
+            REAL* v = fRealSlots[it->fOffset1];
+            REAL* r = fRealStack[real_stack_index++];
+            LANES r[j] = v[j];
+            vecDispatchNext();
         }
 
-        do_kStoreReal: {
-            VEC_LOOP(WRITE_HEAP_VEC_REAL((*it)->fOffset1, POP_VEC_REAL()));
-            STACK_DOWN_REAL();
-            dispatchNextVec();
+        do_kLoadPrivateInt: {
+            int* v = fIntSlots[it->fOffset1];
+            int* r = fIntStack[int_stack_index++];
+            LANES r[j] = v[j];
+            vecDispatchNext();
         }
 
-        do_kStoreInt: {
-            VEC_LOOP(WRITE_HEAP_VEC_INT((*it)->fOffset1, POP_VEC_INT()));
-            STACK_DOWN_INT();
-            dispatchNextVec();
+        do_kStorePrivateReal: {
+            REAL* v = fRealStack[--real_stack_index];
+            REAL* r = fRealSlots[it->fOffset1];
+            LANES r[j] = v[j];
+            vecDispatchNext();
         }
 
-        // Directly store a value
-        do_kStoreRealValue: {
-            VEC_LOOP(WRITE_HEAP_VEC_REAL((*it)->fOffset1, (*it)->fRealValue));
-            dispatchNextVec();
-        }
-
-        do_kStoreIntValue: {
-            VEC_LOOP(WRITE_HEAP_VEC_INT((*it)->fOffset1, (*it)->fIntValue));
-            dispatchNextVec();
+        do_kStorePrivateInt: {
+            int* v = fIntStack[--int_stack_index];
+            int* r = fIntSlots[it->fOffset1];
+            LANES r[j] = v[j];
+            vecDispatchNext();
         }
 
         do_kLoadIndexedReal: {
-            VEC_LOOP(PUSH_VEC_REAL(READ_HEAP_VEC_REAL((*it)->fOffset1 + POP_VEC_INT())));
-            STACK_UP_REAL();
-            STACK_DOWN_INT();
-            dispatchNextVec();
+            int*  index = fIntStack[--int_stack_index];
+            REAL* r     = fRealStack[real_stack_index++];
+            REAL* heap  = &fRealHeap[it->fOffset1];
+            LANES r[j] = heap[index[j]];
+            vecDispatchNext();
         }
 
         do_kLoadIndexedInt: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1 + v1_int[j])));
-            STACK_UP_INT();
-            dispatchNextVec();
+            int* index = fIntStack[int_stack_index - 1];
+            int* heap  = &fIntHeap[it->fOffset1];
+            LANES index[j] = heap[index[j]];
+            vecDispatchNext();
         }
 
         do_kStoreIndexedReal: {
-            VEC_LOOP(WRITE_HEAP_VEC_REAL((*it)->fOffset1 + POP_VEC_INT(), POP_VEC_REAL()));
-            STACK_DOWN_REAL();
-            STACK_DOWN_INT();
-            dispatchNextVec();
+            int*  index = fIntStack[--int_stack_index];
+            REAL* v     = fRealStack[--real_stack_index];
+            REAL* heap  = &fRealHeap[it->fOffset1];
+            LANES heap[index[j]] = v[j];
+            vecDispatchNext();
         }
 
         do_kStoreIndexedInt: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(WRITE_HEAP_VEC_INT((*it)->fOffset1 + v1_int[j], POP_VEC_INT()));
-            STACK_DOWN_INT();
-            dispatchNextVec();
-        }
-
-        do_kBlockStoreReal: {
-            FIRBlockStoreRealInstruction<T>* inst =
-                static_cast<FIRBlockStoreRealInstruction<T>*>(*it);
-            interp_assert(inst);
-            for (int i = 0; i < inst->fOffset2; i++) {
-                fRealHeap[inst->fOffset1 + i] = inst->fNumTable[i];
-            }
-            dispatchNextVec();
-        }
-
-        do_kBlockStoreInt: {
-            FIRBlockStoreIntInstruction<T>* inst =
-                static_cast<FIRBlockStoreIntInstruction<T>*>(*it);
-            interp_assert(inst);
-            for (int i = 0; i < inst->fOffset2; i++) {
-                fIntHeap[inst->fOffset1 + i] = inst->fNumTable[i];
-            }
-            dispatchNextVec();
-        }
-
-        do_kMoveReal: {
-            fRealHeap[(*it)->fOffset1] = fRealHeap[(*it)->fOffset2];
-            dispatchNextVec();
-        }
-
-        do_kMoveInt: {
-            fIntHeap[(*it)->fOffset1] = fIntHeap[(*it)->fOffset2];
-            dispatchNextVec();
+            int* index = fIntStack[--int_stack_index];
+            int* v     = fIntStack[--int_stack_index];
+            int* heap  = &fIntHeap[it->fOffset1];
+            LANES heap[index[j]] = v[j];
+            vecDispatchNext();
         }
 
-        do_kPairMoveReal: {
-            fRealHeap[(*it)->fOffset1] = fRealHeap[(*it)->fOffset1 - 1];
-            fRealHeap[(*it)->fOffset2] = fRealHeap[(*it)->fOffset2 - 1];
-            dispatchNextVec();
-        }
-
-        do_kPairMoveInt: {
-            fIntHeap[(*it)->fOffset1] = fIntHeap[(*it)->fOffset1 - 1];
-            fIntHeap[(*it)->fOffset2] = fIntHeap[(*it)->fOffset2 - 1];
-            dispatchNextVec();
-        }
-
-        do_kBlockPairMoveReal: {
-            for (int i = (*it)->fOffset1; i < (*it)->fOffset2; i += 2) {
-                fRealHeap[i + 1] = fRealHeap[i];
-            }
-            dispatchNextVec();
-        }
-
-        do_kBlockPairMoveInt: {
-            for (int i = (*it)->fOffset1; i < (*it)->fOffset2; i += 2) {
-                fIntHeap[i + 1] = fIntHeap[i];
-            }
-            dispatchNextVec();
-        }
-
-        do_kBlockShiftReal: {
-            for (int i = (*it)->fOffset1; i > (*it)->fOffset2; i -= 1) {
-                fRealHeap[i] = fRealHeap[i - 1];
-            }
-            dispatchNextVec();
-        }
-
-        do_kBlockShiftInt: {
-            for (int i = (*it)->fOffset1; i > (*it)->fOffset2; i -= 1) {
-                fIntHeap[i] = fIntHeap[i - 1];
-            }
-            dispatchNextVec();
-        }
-
-        // Input/output access
         do_kLoadInput: {
-            VEC_LOOP(PUSH_VEC_REAL(fInputs[(*it)->fOffset1][POP_VEC_INT()]));
-            STACK_UP_REAL();
-            STACK_DOWN_INT();
-            dispatchNextVec();
+            int*  index = fIntStack[--int_stack_index];
+            REAL* r     = fRealStack[real_stack_index++];
+            REAL* input = fInputs[it->fOffset1];
+            LANES r[j] = input[index[j]];
+            vecDispatchNext();
         }
 
         do_kStoreOutput: {
-            VEC_LOOP(fOutputs[(*it)->fOffset1][POP_VEC_INT()] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            STACK_DOWN_INT();
-            dispatchNextVec();
+            int*  index  = fIntStack[--int_stack_index];
+            REAL* v      = fRealStack[--real_stack_index];
+            REAL* output = fOutputs[it->fOffset1];
+            LANES output[index[j]] = v[j];
+            vecDispatchNext();
         }
 
-        // Cast operations
+            // Cast/bitcast
         do_kCastReal: {
-            VEC_LOOP(PUSH_VEC_REAL(T(POP_VEC_INT())));
-            STACK_UP_REAL();
-            STACK_DOWN_INT();
-            dispatchNextVec();
-        }
-
-        do_kCastRealHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(T(READ_HEAP_VEC_INT((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
+            int*  v = fIntStack[--int_stack_index];
+            REAL* r = fRealStack[real_stack_index++];
+            LANES r[j] = REAL(v[j]);
+            vecDispatchNext();
         }
 
         do_kCastInt: {
-            VEC_LOOP(PUSH_VEC_INT(T(POP_VEC_REAL())));
-            STACK_DOWN_REAL();
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kCastIntHeap: {
-            VEC_LOOP(PUSH_VEC_INT(T(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_INT();
-            dispatchNextVec();
+            REAL* v = fRealStack[--real_stack_index];
+            int*  r = fIntStack[int_stack_index++];
+            LANES r[j] = int(v[j]);
+            vecDispatchNext();
         }
 
-        // Bitcast operations
         do_kBitcastInt: {
-            VEC_LOOP(T v1 = POP_VEC_REAL(); PUSH_VEC_INT(*reinterpret_cast<int*>(&v1)));
-            STACK_DOWN_REAL();
-            STACK_UP_INT();
-            dispatchNextVec();
+            REAL* v = fRealStack[--real_stack_index];
+            int*  r = fIntStack[int_stack_index++];
+            LANES r[j] = *reinterpret_cast<int*>(&v[j]);
+            vecDispatchNext();
         }
 
         do_kBitcastReal: {
-            VEC_LOOP(int v1 = POP_VEC_INT(); PUSH_VEC_REAL(*reinterpret_cast<T*>(&v1)));
-            STACK_UP_REAL();
-            STACK_DOWN_INT();
-            dispatchNextVec();
-        }
-
-            //-------------------------------------------------------
-            // Standard math operations : 'stack' OP 'stack' version
-            //-------------------------------------------------------
-
-        do_kAddReal: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(v2_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(v1_real[j] + v2_real[j]));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kAddInt: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(v2_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(v1_int[j] + v2_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kSubReal: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(v2_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(v1_real[j] - v2_real[j]));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kSubInt: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(v2_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(v1_int[j] - v2_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kMultReal: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(v2_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(v1_real[j] * v2_real[j]));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kMultInt: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(v2_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(v1_int[j] * v2_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kDivReal: {
-            VEC_LOOP(v1_int[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(v2_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(v1_int[j] / v2_real[j]));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kDivInt: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(v2_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(v1_int[j] / v2_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kRemReal: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(v2_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::remainder(v1_real[j], v2_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kRemInt: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(v2_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(v1_int[j] % v2_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Shift operation
-        do_kLshInt: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(v2_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(v1_int[j] << v2_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kARshInt: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(v2_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(v1_int[j] >> v2_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Comparaison Int
-        do_kGTInt: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(v2_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(v1_int[j] > v2_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLTInt: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(v2_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(v1_int[j] < v2_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kGEInt: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(v2_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(v1_int[j] >= v2_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLEInt: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(v2_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(v1_int[j] <= v2_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kEQInt: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(v2_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(v1_int[j] == v2_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kNEInt: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(v2_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(v1_int[j] != v2_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Comparaison Real
-        do_kGTReal: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(v2_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_INT(v1_real[j] > v2_real[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLTReal: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(v2_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_INT(v1_real[j] < v2_real[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kGEReal: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(v2_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_INT(v1_real[j] >= v2_real[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
+            int*  v = fIntStack[--int_stack_index];
+            REAL* r = fRealStack[real_stack_index++];
+            LANES r[j] = *reinterpret_cast<REAL*>(&v[j]);
+            vecDispatchNext();
+        }
+
+            // Standard math (first operand on the top of the stack)
+        do_kAddReal:
+            binaryReal(v1[j] + v2[j]);
+        do_kAddInt:
+            binaryInt(v1[j] + v2[j]);
+        do_kSubReal:
+            binaryReal(v1[j] - v2[j]);
+        do_kSubInt:
+            binaryInt(v1[j] - v2[j]);
+        do_kMultReal:
+            binaryReal(v1[j] * v2[j]);
+        do_kMultInt:
+            binaryInt(v1[j] * v2[j]);
+        do_kDivReal:
+            binaryReal(v1[j] / v2[j]);
+        do_kDivInt:
+            binaryInt(v1[j] / v2[j]);
+        do_kRemReal:
+            binaryReal(std::remainder(v1[j], v2[j]));
+        do_kRemInt:
+            binaryInt(v1[j] % v2[j]);
+        do_kLshInt:
+            binaryInt(v1[j] << v2[j]);
+        do_kARshInt:
+            binaryInt(v1[j] >> v2[j]);
+        do_kLRshInt:
+            binaryInt(v1[j] >> v2[j]);
+        do_kGTInt:
+            binaryInt(v1[j] > v2[j]);
+        do_kLTInt:
+            binaryInt(v1[j] < v2[j]);
+        do_kGEInt:
+            binaryInt(v1[j] >= v2[j]);
+        do_kLEInt:
+            binaryInt(v1[j] <= v2[j]);
+        do_kEQInt:
+            binaryInt(v1[j] == v2[j]);
+        do_kNEInt:
+            binaryInt(v1[j] != v2[j]);
+        do_kGTReal:
+            compareReal(v1[j] > v2[j]);
+        do_kLTReal:
+            compareReal(v1[j] < v2[j]);
+        do_kGEReal:
+            compareReal(v1[j] >= v2[j]);
+        do_kLEReal:
+            compareReal(v1[j] <= v2[j]);
+        do_kEQReal:
+            compareReal(v1[j] == v2[j]);
+        do_kNEReal:
+            compareReal(v1[j] != v2[j]);
+        do_kANDInt:
+            binaryInt(v1[j] & v2[j]);
+        do_kORInt:
+            binaryInt(v1[j] | v2[j]);
+        do_kXORInt:
+            binaryInt(v1[j] ^ v2[j]);
 
-        do_kLEReal: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(v2_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_INT(v1_real[j] <= v2_real[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kEQReal: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(v2_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_INT(v1_real[j] == v2_real[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kNEReal: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(v2_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_INT(v1_real[j] != v2_real[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Logical operations
-        do_kANDInt: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(v2_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(v1_int[j] & v2_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kORInt: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(v2_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(v1_int[j] | v2_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kXORInt: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(v2_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(v1_int[j] ^ v2_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-            //-----------------------------------------------------
-            // Standard math operations : 'heap' OP 'heap' version
-            //-----------------------------------------------------
-
-        do_kAddRealHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(READ_HEAP_VEC_REAL((*it)->fOffset1) +
-                                   READ_HEAP_VEC_REAL((*it)->fOffset2)));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kAddIntHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) +
-                                  READ_HEAP_VEC_INT((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kSubRealHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(READ_HEAP_VEC_REAL((*it)->fOffset1) -
-                                   READ_HEAP_VEC_REAL((*it)->fOffset2)));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kSubIntHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) -
-                                  READ_HEAP_VEC_INT((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kMultRealHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(READ_HEAP_VEC_REAL((*it)->fOffset1) *
-                                   READ_HEAP_VEC_REAL((*it)->fOffset2)));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kMultIntHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) *
-                                  READ_HEAP_VEC_INT((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kDivRealHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(READ_HEAP_VEC_REAL((*it)->fOffset1) /
-                                   READ_HEAP_VEC_REAL((*it)->fOffset2)));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kDivIntHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) /
-                                  READ_HEAP_VEC_INT((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kRemRealHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::remainder(READ_HEAP_VEC_REAL((*it)->fOffset1),
-                                                  READ_HEAP_VEC_REAL((*it)->fOffset2))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kRemIntHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) %
-                                  READ_HEAP_VEC_INT((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Shift operation
-        do_kLshIntHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1)
-                                  << READ_HEAP_VEC_INT((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kARshIntHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) >>
-                                  READ_HEAP_VEC_INT((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Comparaison Int
-        do_kGTIntHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) >
-                                  READ_HEAP_VEC_INT((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLTIntHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) <
-                                  READ_HEAP_VEC_INT((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kGEIntHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) >=
-                                  READ_HEAP_VEC_INT((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLEIntHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) <=
-                                  READ_HEAP_VEC_INT((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kEQIntHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) ==
-                                  READ_HEAP_VEC_INT((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kNEIntHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) !=
-                                  READ_HEAP_VEC_INT((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Comparaison Real
-        do_kGTRealHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_REAL((*it)->fOffset1) >
-                                  READ_HEAP_VEC_REAL((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLTRealHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_REAL((*it)->fOffset1) <
-                                  READ_HEAP_VEC_REAL((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kGERealHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_REAL((*it)->fOffset1) >=
-                                  READ_HEAP_VEC_REAL((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLERealHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_REAL((*it)->fOffset1) <=
-                                  READ_HEAP_VEC_REAL((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kEQRealHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_REAL((*it)->fOffset1) ==
-                                  READ_HEAP_VEC_REAL((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
+            // Extended unary math
+        do_kAbs: {
+            int* v = fIntStack[int_stack_index - 1];
+            LANES v[j] = std::abs(v[j]);
+            vecDispatchNext();
+        }
+        do_kAbsf:
+            unaryReal(std::fabs(v[j]));
+        do_kAcosf:
+            unaryReal(std::acos(v[j]));
+        do_kAcoshf:
+            unaryReal(std::acosh(v[j]));
+        do_kAsinf:
+            unaryReal(std::asin(v[j]));
+        do_kAsinhf:
+            unaryReal(std::asinh(v[j]));
+        do_kAtanf:
+            unaryReal(std::atan(v[j]));
+        do_kAtanhf:
+            unaryReal(std::atanh(v[j]));
+        do_kCeilf:
+            unaryReal(std::ceil(v[j]));
+        do_kCosf:
+            unaryReal(std::cos(v[j]));
+        do_kCoshf:
+            unaryReal(std::cosh(v[j]));
+        do_kExpf:
+            unaryReal(std::exp(v[j]));
+        do_kFloorf:
+            unaryReal(std::floor(v[j]));
+        do_kLogf:
+            unaryReal(std::log(v[j]));
+        do_kLog10f:
+            unaryReal(std::log10(v[j]));
+        do_kRintf:
+            unaryReal(std::rint(v[j]));
+        do_kRoundf:
+            unaryReal(std::round(v[j]));
+        do_kSinf:
+            unaryReal(std::sin(v[j]));
+        do_kSinhf:
+            unaryReal(std::sinh(v[j]));
+        do_kSqrtf:
+            unaryReal(std::sqrt(v[j]));
+        do_kTanf:
+            unaryReal(std::tan(v[j]));
+        do_kTanhf:
+            unaryReal(std::tanh(v[j]));
+
+        do_kIsnanf: {
+            REAL* v = fRealStack[--real_stack_index];
+            int*  r = fIntStack[int_stack_index++];
+            LANES r[j] = std::isnan(v[j]);
+            vecDispatchNext();
+        }
+
+        do_kIsinff: {
+            REAL* v = fRealStack[--real_stack_index];
+            int*  r = fIntStack[int_stack_index++];
+            LANES r[j] = std::isinf(v[j]);
+            vecDispatchNext();
         }
 
-        do_kNERealHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_REAL((*it)->fOffset1) !=
-                                  READ_HEAP_VEC_REAL((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
+            // Extended binary math
+        do_kAtan2f:
+            binaryReal(std::atan2(v1[j], v2[j]));
+        do_kFmodf:
+            binaryReal(std::fmod(v1[j], v2[j]));
+        do_kPowf:
+            binaryReal(std::pow(v1[j], v2[j]));
+        do_kMax:
+            binaryInt(std::max(v1[j], v2[j]));
+        do_kMaxf:
+            binaryReal(std::max(v1[j], v2[j]));
+        do_kMin:
+            binaryInt(std::min(v1[j], v2[j]));
+        do_kMinf:
+            binaryReal(std::min(v1[j], v2[j]));
+        do_kCopysignf:
+            binaryReal(std::copysign(v1[j], v2[j]));
+
+            // Select : condition, then both branches are on the stacks
+        do_kSelectReal: {
+            int*  cond = fIntStack[--int_stack_index];
+            REAL* v2   = fRealStack[--real_stack_index];
+            REAL* v1   = fRealStack[real_stack_index - 1];
+            LANES v1[j] = (cond[j]) ? v1[j] : v2[j];
+            vecDispatchNext();
         }
 
-        // Logical operations
-        do_kANDIntHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) &
-                                  READ_HEAP_VEC_INT((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
+        do_kSelectInt: {
+            int* v2   = fIntStack[--int_stack_index];
+            int* v1   = fIntStack[--int_stack_index];
+            int* cond = fIntStack[int_stack_index - 1];
+            LANES cond[j] = (cond[j]) ? v1[j] : v2[j];
+            vecDispatchNext();
         }
 
-        do_kORIntHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) |
-                                  READ_HEAP_VEC_INT((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
+        do_kVecEnd:
+            continue;
         }
 
-        do_kXORIntHeap: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) ^
-                                  READ_HEAP_VEC_INT((*it)->fOffset2)));
-            STACK_UP_INT();
-            dispatchNextVec();
+        // Private variables keep the value of the last iteration
+        for (size_t i = 0; i < block->fIntSlots.size(); i++) {
+            fIntHeap[block->fIntSlots[i]] = fIntSlots[i][VEC - 1];
         }
-
-            //------------------------------------------------------
-            // Standard math operations : 'stack' OP 'heap' version
-            //------------------------------------------------------
-
-        do_kAddRealStack: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(READ_HEAP_VEC_REAL((*it)->fOffset1) + v1_real[j]));
-            STACK_UP_REAL();
-            dispatchNextVec();
+        for (size_t i = 0; i < block->fRealSlots.size(); i++) {
+            fRealHeap[block->fRealSlots[i]] = fRealSlots[i][VEC - 1];
         }
 
-        do_kAddIntStack: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) + v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kSubRealStack: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(READ_HEAP_VEC_REAL((*it)->fOffset1) - v1_real[j]));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kSubIntStack: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) - v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kMultRealStack: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(READ_HEAP_VEC_REAL((*it)->fOffset1) * v1_real[j]));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kMultIntStack: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) * v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kDivRealStack: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(READ_HEAP_VEC_REAL((*it)->fOffset1) / v1_real[j]));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kDivIntStack: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) / v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kRemRealStack: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(
-                PUSH_VEC_REAL(std::remainder(READ_HEAP_VEC_REAL((*it)->fOffset1), v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kRemIntStack: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) % v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Shift operation
-        do_kLshIntStack: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) << v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kARshIntStack: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) >> v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Comparaison Int
-        do_kGTIntStack: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) > v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLTIntStack: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) < v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kGEIntStack: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) >= v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLEIntStack: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) <= v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kEQIntStack: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) == v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kNEIntStack: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) != v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Comparaison Real
-        do_kGTRealStack: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_REAL((*it)->fOffset1) > v1_real[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLTRealStack: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_REAL((*it)->fOffset1) < v1_real[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kGERealStack: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_REAL((*it)->fOffset1) >= v1_real[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLERealStack: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_REAL((*it)->fOffset1) <= v1_real[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kEQRealStack: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_REAL((*it)->fOffset1) == v1_real[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kNERealStack: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_REAL((*it)->fOffset1) != v1_real[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Logical operations
-        do_kANDIntStack: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) & v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kORIntStack: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) | v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kXORIntStack: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) ^ v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-            //-------------------------------------------------------
-            // Standard math operations : 'stack' OP 'value' version
-            //-------------------------------------------------------
-
-        do_kAddRealStackValue: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL((*it)->fRealValue + v1_real[j]));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kAddIntStackValue: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue + v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kSubRealStackValue: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL((*it)->fRealValue - v1_real[j]));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kSubIntStackValue: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue - v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kMultRealStackValue: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL((*it)->fRealValue * v1_real[j]));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kMultIntStackValue: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue * v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kDivRealStackValue: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL((*it)->fRealValue / v1_real[j]));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kDivIntStackValue: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue / v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kRemRealStackValue: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::remainder((*it)->fRealValue, v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kRemIntStackValue: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue % v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Shift operation
-        do_kLshIntStackValue: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue << v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kARshIntStackValue: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue >> v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Comparaison Int
-        do_kGTIntStackValue: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue > v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLTIntStackValue: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue < v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kGEIntStackValue: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue >= v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLEIntStackValue: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue <= v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kEQIntStackValue: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue == v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kNEIntStackValue: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue != v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Comparaison Real
-        do_kGTRealStackValue: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fRealValue > v1_real[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLTRealStackValue: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fRealValue < v1_real[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kGERealStackValue: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fRealValue >= v1_real[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLERealStackValue: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fRealValue <= v1_real[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kEQRealStackValue: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fRealValue == v1_real[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kNERealStackValue: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fRealValue != v1_real[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Logical operations
-        do_kANDIntStackValue: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue & v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kORIntStackValue: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue | v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kXORIntStackValue: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue ^ v1_int[j]));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-            //------------------------------------------------------
-            // Standard math operations : 'value' OP 'heap' version
-            //------------------------------------------------------
-
-        do_kAddRealValue: {
-            VEC_LOOP(PUSH_VEC_REAL((*it)->fRealValue + READ_HEAP_VEC_REAL((*it)->fOffset1)));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kAddIntValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue + READ_HEAP_VEC_INT((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kSubRealValue: {
-            VEC_LOOP(PUSH_VEC_REAL((*it)->fRealValue - READ_HEAP_VEC_REAL((*it)->fOffset1)));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kSubIntValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue - READ_HEAP_VEC_INT((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kMultRealValue: {
-            VEC_LOOP(PUSH_VEC_REAL((*it)->fRealValue * READ_HEAP_VEC_REAL((*it)->fOffset1)));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kMultIntValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue * READ_HEAP_VEC_INT((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kDivRealValue: {
-            VEC_LOOP(PUSH_VEC_REAL((*it)->fRealValue / READ_HEAP_VEC_REAL((*it)->fOffset1)));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kDivIntValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue / READ_HEAP_VEC_INT((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kRemRealValue: {
-            VEC_LOOP(PUSH_VEC_REAL(
-                std::remainder((*it)->fRealValue, READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kRemIntValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue % READ_HEAP_VEC_INT((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Shift operation
-        do_kLshIntValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue << READ_HEAP_VEC_INT((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kARshIntValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue >> READ_HEAP_VEC_INT((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Comparaison Int
-        do_kGTIntValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue > READ_HEAP_VEC_INT((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLTIntValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue < READ_HEAP_VEC_INT((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kGEIntValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue >= READ_HEAP_VEC_INT((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLEIntValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue <= READ_HEAP_VEC_INT((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kEQIntValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue == READ_HEAP_VEC_INT((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kNEIntValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue != READ_HEAP_VEC_INT((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Comparaison Real
-        do_kGTRealValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fRealValue > READ_HEAP_VEC_REAL((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLTRealValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fRealValue < READ_HEAP_VEC_REAL((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kGERealValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fRealValue >= READ_HEAP_VEC_REAL((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLERealValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fRealValue <= READ_HEAP_VEC_REAL((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kEQRealValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fRealValue == READ_HEAP_VEC_REAL((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kNERealValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fRealValue != READ_HEAP_VEC_REAL((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Logical operations
-        do_kANDIntValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue & READ_HEAP_VEC_INT((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kORIntValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue | READ_HEAP_VEC_INT((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kXORIntValue: {
-            VEC_LOOP(PUSH_VEC_INT((*it)->fIntValue ^ READ_HEAP_VEC_INT((*it)->fOffset1)));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-            //----------------------------------------------------
-            // Standard math operations : Value inverted version
-            // (non commutative operations)
-            //----------------------------------------------------
-
-        do_kSubRealValueInvert: {
-            VEC_LOOP(PUSH_VEC_REAL(READ_HEAP_VEC_REAL((*it)->fOffset1) - (*it)->fRealValue));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kSubIntValueInvert: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) - (*it)->fIntValue));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kDivRealValueInvert: {
-            VEC_LOOP(PUSH_VEC_REAL(READ_HEAP_VEC_REAL((*it)->fOffset1) / (*it)->fRealValue));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kDivIntValueInvert: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) / (*it)->fIntValue));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kRemRealValueInvert: {
-            VEC_LOOP(PUSH_VEC_REAL(
-                std::remainder(READ_HEAP_VEC_REAL((*it)->fOffset1), (*it)->fRealValue)));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kRemIntValueInvert: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) % (*it)->fIntValue));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Shift operation
-        do_kLshIntValueInvert: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) << (*it)->fIntValue));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kARshIntValueInvert: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) >> (*it)->fIntValue));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Comparaison Int
-        do_kGTIntValueInvert: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) > (*it)->fIntValue));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLTIntValueInvert: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) < (*it)->fIntValue));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kGEIntValueInvert: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) >= (*it)->fIntValue));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLEIntValueInvert: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_INT((*it)->fOffset1) <= (*it)->fIntValue));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        // Comparaison Real
-        do_kGTRealValueInvert: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_REAL((*it)->fOffset1) > (*it)->fRealValue));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLTRealValueInvert: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_REAL((*it)->fOffset1) < (*it)->fRealValue));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kGERealValueInvert: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_REAL((*it)->fOffset1) >= (*it)->fRealValue));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kLERealValueInvert: {
-            VEC_LOOP(PUSH_VEC_INT(READ_HEAP_VEC_REAL((*it)->fOffset1) <= (*it)->fRealValue));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-            //---------------------
-            // Extended unary math
-            //---------------------
-
-        do_kAbs: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(std::abs(v1_int[j])));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kAbsf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::fabs(v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kAcosf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::acos(v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kAsinf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::asin(v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kAtanf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::atan(v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kCeilf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::ceil(v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kCosf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::cos(v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kCoshf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::cosh(v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kExpf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::exp(v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kFloorf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::floor(v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kLogf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::log(v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kLog10f: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::log10(v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kRintf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::rint(v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kRoundf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::round(v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kSinf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::sin(v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kSinhf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::sinh(v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kSqrtf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::sqrt(v1_real[j])));
-            dispatchNextVec();
-        }
-
-        do_kTanf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::tan(v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kTanhf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::tanh(v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-            //------------------------------------
-            // Extended unary math (heap version)
-            ///-----------------------------------
-
-        do_kAbsHeap: {
-            VEC_LOOP(PUSH_VEC_INT(std::abs(READ_HEAP_VEC_INT((*it)->fOffset1))));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kAbsfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::fabs(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kAcosfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::acos(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kAsinfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::asin(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kAtanfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::atan(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kCeilfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::ceil(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kCosfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::cos(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kCoshfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::cosh(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kExpfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::exp(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kFloorfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::floor(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kLogfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::log(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kLog10fHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::log10(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kRintfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::rint(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kRoundfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::round(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kSinfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::sin(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kSinhfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::sinh(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kSqrtfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::sqrt(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kTanfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::tan(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kTanhfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::tanh(READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-            //----------------------
-            // Extended binary math
-            //----------------------
-
-        do_kAtan2f: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(v2_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::atan2(v1_real[j], v2_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kFmodf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(v2_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::fmod(v1_real[j], v2_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kPowf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(v2_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::pow(v1_real[j], v2_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kMax: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(v2_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(std::max(v1_int[j], v2_int[j])));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kMaxf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(v2_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::max(v1_real[j], v2_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kMin: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(v2_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(std::min(v1_int[j], v2_int[j])));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kMinf: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(v2_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::min(v1_real[j], v2_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-            //-------------------------------------
-            // Extended binary math (heap version)
-            //-------------------------------------
-
-        do_kAtan2fHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::atan2(READ_HEAP_VEC_REAL((*it)->fOffset1),
-                                              READ_HEAP_VEC_REAL((*it)->fOffset2))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kFmodfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::fmod(READ_HEAP_VEC_REAL((*it)->fOffset1),
-                                             READ_HEAP_VEC_REAL((*it)->fOffset2))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kPowfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::pow(READ_HEAP_VEC_REAL((*it)->fOffset1),
-                                            READ_HEAP_VEC_REAL((*it)->fOffset2))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kMaxHeap: {
-            VEC_LOOP(PUSH_VEC_INT(
-                std::max(READ_HEAP_VEC_INT((*it)->fOffset1), READ_HEAP_VEC_INT((*it)->fOffset2))));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kMaxfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::max(READ_HEAP_VEC_REAL((*it)->fOffset1),
-                                            READ_HEAP_VEC_REAL((*it)->fOffset2))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kMinHeap: {
-            VEC_LOOP(PUSH_VEC_INT(
-                std::min(READ_HEAP_VEC_INT((*it)->fOffset1), READ_HEAP_VEC_INT((*it)->fOffset2))));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kMinfHeap: {
-            VEC_LOOP(PUSH_VEC_REAL(std::min(READ_HEAP_VEC_REAL((*it)->fOffset1),
-                                            READ_HEAP_VEC_REAL((*it)->fOffset2))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-            //--------------------------------------
-            // Extended binary math (stack version)
-            //--------------------------------------
-
-        do_kAtan2fStack: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::atan2(READ_HEAP_VEC_REAL((*it)->fOffset1), v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kFmodfStack: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::fmod(READ_HEAP_VEC_REAL((*it)->fOffset1), v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kPowfStack: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::pow(READ_HEAP_VEC_REAL((*it)->fOffset1), v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kMaxStack: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(std::max(READ_HEAP_VEC_INT((*it)->fOffset1), v1_int[j])));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kMaxfStack: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::max(READ_HEAP_VEC_REAL((*it)->fOffset1), v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kMinStack: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(std::min(READ_HEAP_VEC_INT((*it)->fOffset1), v1_int[j])));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kMinfStack: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::min(READ_HEAP_VEC_REAL((*it)->fOffset1), v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-            //--------------------------------------------
-            // Extended binary math (stack/value version)
-            //--------------------------------------------
-
-        do_kAtan2fStackValue: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::atan2((*it)->fRealValue, v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kFmodfStackValue: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::fmod((*it)->fRealValue, v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kPowfStackValue: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::pow((*it)->fRealValue, v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kMaxStackValue: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(std::max((*it)->fIntValue, v1_int[j])));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kMaxfStackValue: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::max((*it)->fRealValue, v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kMinStackValue: {
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            VEC_LOOP(PUSH_VEC_INT(std::min((*it)->fIntValue, v1_int[j])));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kMinfStackValue: {
-            VEC_LOOP(v1_real[j] = POP_VEC_REAL());
-            STACK_DOWN_REAL();
-            VEC_LOOP(PUSH_VEC_REAL(std::min((*it)->fRealValue, v1_real[j])));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-            //-------------------------------------
-            // Extended binary math (Value version)
-            //-------------------------------------
-
-        do_kAtan2fValue: {
-            VEC_LOOP(
-                PUSH_VEC_REAL(std::atan2((*it)->fRealValue, READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kFmodfValue: {
-            VEC_LOOP(
-                PUSH_VEC_REAL(std::fmod((*it)->fRealValue, READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kPowfValue: {
-            VEC_LOOP(
-                PUSH_VEC_REAL(std::pow((*it)->fRealValue, READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kMaxValue: {
-            VEC_LOOP(PUSH_VEC_INT(std::max((*it)->fIntValue, READ_HEAP_VEC_INT((*it)->fOffset1))));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kMaxfValue: {
-            VEC_LOOP(
-                PUSH_VEC_REAL(std::max((*it)->fRealValue, READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kMinValue: {
-            VEC_LOOP(PUSH_VEC_INT(std::min((*it)->fIntValue, READ_HEAP_VEC_INT((*it)->fOffset1))));
-            STACK_UP_INT();
-            dispatchNextVec();
-        }
-
-        do_kMinfValue: {
-            VEC_LOOP(
-                PUSH_VEC_REAL(std::min((*it)->fRealValue, READ_HEAP_VEC_REAL((*it)->fOffset1))));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-            //-------------------------------------------------------------------
-            // Extended binary math (Value version) : non commutative operations
-            //-------------------------------------------------------------------
-
-        do_kAtan2fValueInvert: {
-            VEC_LOOP(
-                PUSH_VEC_REAL(std::atan2(READ_HEAP_VEC_REAL((*it)->fOffset1), (*it)->fRealValue)));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kFmodfValueInvert: {
-            VEC_LOOP(
-                PUSH_VEC_REAL(std::fmod(READ_HEAP_VEC_REAL((*it)->fOffset1), (*it)->fRealValue)));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-        do_kPowfValueInvert: {
-            VEC_LOOP(
-                PUSH_VEC_REAL(std::pow(READ_HEAP_VEC_REAL((*it)->fOffset1), (*it)->fRealValue)));
-            STACK_UP_REAL();
-            dispatchNextVec();
-        }
-
-            //---------
-            // Control
-            //---------
-
-        do_kReturn: {
-            // Empty addr stack = end of computation
-            if (emptyReturnVec()) {
-                goto end;
-            } else {
-                dispatchReturnVec();
-            }
-        }
-
-        do_kIf: {
-            // Keep next instruction
-            saveReturnVec();
-
-            if (POP_INT()) {
-                // Execute new block
-                interp_assert((*it)->fBranch1);
-                dispatchBranch1Vec();
-                // No value (If)
-            } else {
-                // Execute new block
-                interp_assert((*it)->fBranch2);
-                dispatchBranch2Vec();
-                // No value (If)
-            }
-        }
-
-        do_kSelectReal: {
-            // Keep next instruction
-            saveReturnVec();
-
-            // Compute condition vector
-
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            // Execute new block
-            VEC_LOOP(
-                if (v1_int[j]) { dispatchBranch1Vec(); } else { dispatchBranch2Vec(); });
-        }
-
-        do_kSelectInt: {
-            // Keep next instruction
-            saveReturnVec();
-
-            // Compute condition vector
-
-            VEC_LOOP(v1_int[j] = POP_VEC_INT());
-            STACK_DOWN_INT();
-            // Execute new block
-            VEC_LOOP(
-                if (v1_int[j]) { dispatchBranch1Vec(); } else { dispatchBranch2Vec(); });
-        }
-
-        do_kCondBranch: {
-            // If condition is true, just branch back on the block beginning
-            if (POP_INT()) {
-                interp_assert((*it)->fBranch1);
-                dispatchBranch1Vec();
-            } else {
-                // Just continue after 'loop block' (do the final 'return')
-                dispatchNextVec();
-            }
-        }
-
-        do_kLoop: {
-            // (*it)->fIntValue = vec_size
-
-            // this->ExecuteVecLoop((*it));
-
-            /*
-            if ((*it)->fIntValue == 1) {
-                this->ExecuteVecLoop<1, TRACE>((*it));
-            } else if ((*it)->fIntValue == 4) {
-                this->ExecuteVecLoop<4, TRACE>((*it));
-            } else if ((*it)->fIntValue == 8) {
-                this->ExecuteVecLoop<8, TRACE>((*it));
-            } else if ((*it)->fIntValue == 16) {
-                this->ExecuteVecLoop<16, TRACE>((*it));
-            } else if ((*it)->fIntValue == 32) {
-                this->ExecuteVecLoop<32, TRACE>((*it));
-            } else if ((*it)->fIntValue == 64) {
-                this->ExecuteVecLoop<64, TRACE>((*it));
-            } else {
-                this->ExecuteVecLoop<128, TRACE>((*it));
-            }
-            */
-
-            // Keep next instruction
-            saveReturnVec();
-
-            // Push branch2 (loop content)
-            interp_assert((*it)->fBranch2);
-            pushBranch2Vec();
-
-            // And start branch1 loop variable declaration block
-            interp_assert((*it)->fBranch1);
-            dispatchBranch1Vec();
-        }
-
-        end:
-            // printf("END real_stack_index = %d, int_stack_index = %d\n", real_stack_index,
-            // int_stack_index);
-
-            // Check stack coherency
-            interp_assert(real_stack_index == 0 && int_stack_index == 0 && sound_stack_index == 0);
-
-        } catch (faustexception& e) {
-            std::cout << e.Message();
-        }
+#undef LANES
+#undef vecDispatchNext
+#undef unaryReal
+#undef binaryReal
+#undef binaryInt
+#undef compareReal
     }
-
-   public:
-    FBCVecInterpreter(interpreter_dsp_factory_aux<REAL, 0>* factory)
-    {
-        /*
-        std::cout << "FBCVecInterpreter :"
-                << " int_heap_size " << int_heap_size
-                << " real_heap_size " << real_heap_size
-                << " sr_offset " << sr_offset
-                << " count_offset " << count_offset << std::endl;
-        */
-
-        fFactory = factory;
-
-        if (fFactory->getMemoryManager()) {
-            fRealHeap = static_cast<T*>(fFactory->allocate(sizeof(T) * fFactory->fRealHeapSize));
-            fIntHeap  = static_cast<int*>(fFactory->allocate(sizeof(T) * fFactory->fIntHeapSize));
-            fInputs   = static_cast<T**>(fFactory->allocate(sizeof(T*) * fFactory->fNumInputs));
-            fOutputs  = static_cast<T**>(fFactory->allocate(sizeof(T*) * fFactory->fNumOutputs));
-        } else {
-            fRealHeap = new T[fFactory->fRealHeapSize];
-            fIntHeap  = new int[fFactory->fIntHeapSize];
-            fInputs   = new T*[fFactory->fNumInputs];
-            fOutputs  = new T*[fFactory->fNumOutputs];
-        }
-
-        // std::cout << "==== FBCVecInterpreter ==== " << std::endl;
-        // std::cout << "fRealHeapSize = " << fFactory->fRealHeapSize << std::endl;
-        // std::cout << "fIntHeapSize = " << fFactory->fIntHeapSize << std::endl;
-
-        // Initialise HEAP with 0
-        memset(fRealHeap, 0, fFactory->fRealHeapSize * sizeof(REAL));
-        memset(fIntHeap, 0, fFactory->fIntHeapSize * sizeof(int));
-    }
-
-    FBCVecInterpreter(interpreter_dsp_factory_aux<REAL, 1>* factory)
-        : FBCVecInterpreter((interpreter_dsp_factory_aux<REAL, 0>*)factory)
-    {
-    }
-
-    FBCVecInterpreter(interpreter_dsp_factory_aux<REAL, 2>* factory)
-        : FBCVecInterpreter((interpreter_dsp_factory_aux<REAL, 0>*)factory)
-    {
-    }
-
-    FBCVecInterpreter(interpreter_dsp_factory_aux<REAL, 3>* factory)
-        : FBCVecInterpreter((interpreter_dsp_factory_aux<REAL, 0>*)factory)
-    {
-    }
-
-    FBCVecInterpreter(interpreter_dsp_factory_aux<REAL, 4>* factory)
-        : FBCVecInterpreter((interpreter_dsp_factory_aux<REAL, 0>*)factory)
-    {
-    }
-
-    FBCVecInterpreter(interpreter_dsp_factory_aux<REAL, 5>* factory)
-        : FBCVecInterpreter((interpreter_dsp_factory_aux<REAL, 0>*)factory)
-    {
-    }
-
-    FBCVecInterpreter(interpreter_dsp_factory_aux<REAL, 6>* factory)
-        : FBCVecInterpreter((interpreter_dsp_factory_aux<REAL, 0>*)factory)
-    {
-    }
-
-    FBCVecInterpreter(interpreter_dsp_factory_aux<REAL, 7>* factory)
-        : FBCVecInterpreter((interpreter_dsp_factory_aux<REAL, 0>*)factory)
-    {
-    }
-
-    virtual ~FBCVecInterpreter()
-    {
-        if (fFactory->getMemoryManager()) {
-            fFactory->destroy(fRealHeap);
-            fFactory->destroy(fIntHeap);
-            fFactory->destroy(fInputs);
-            fFactory->destroy(fOutputs);
-        } else {
-            delete[] fRealHeap;
-            delete[] fIntHeap;
-            delete[] fInputs;
-            delete[] fOutputs;
-        }
-    }
-
-    void setIntValue(int offset, int value) { fIntHeap[offset] = value; }
-    int  getIntValue(int offset) { return fIntHeap[offset]; }
-
-    virtual void setInput(int offset, REAL* buffer) { fInputs[offset] = buffer; }
-    virtual void setOutput(int offset, REAL* buffer) { fOutputs[offset] = buffer; }
 };
 
 #endif
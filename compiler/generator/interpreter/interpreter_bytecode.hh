@@ -24,6 +24,7 @@
 
 #include <math.h>
 #include <iostream>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -460,6 +461,76 @@ struct FIRMetaInstruction : public FBCInstruction {
 #define UIInstructionIT typename std::vector<FIRUserInterfaceInstruction<REAL>*>::iterator
 #define MetaInstructionIT std::vector<FIRMetaInstruction*>::iterator
 
+/*
+ Direct-threaded form of a FBCBasicInstruction: the opcode is replaced by the address of its
+ implementation in the interpreter loop, and branches directly point to their target
+ instruction, so that executing the code only follows pointers in a contiguous array.
+ */
+template <class REAL>
+struct FBCThreadedInstruction {
+    void*                         fLabel;
+    int                           fOffset1;
+    int                           fOffset2;
+    int                           fOffset3;  // Third operand of superinstructions
+    int                           fIntValue;
+    REAL                          fRealValue;
+    FBCThreadedInstruction<REAL>* fBranch1;
+    FBCThreadedInstruction<REAL>* fBranch2;
+    InstructionIT                 fInstruction;  // Original instruction, used for traces and checks
+};
+
+#define ThreadedIT FBCThreadedInstruction<REAL>*
+
+/*
+ Superinstructions of the threaded code, numbered after the FBC opcodes. They fuse the most frequent
+ sequences of the optimized code (found by profiling the DSP files of the 'benchmark' folder), and
+ read and write the heap directly, so that the values they compute do not go through the stacks.
+ */
+enum FBCSuperInstruction {
+    kLoadDelayReal = FBCInstruction::kNop + 1,  // push(heap[o1 + ((int_heap[o2] - iv) & o3)])
+    kLoadDelayRealMult,                         // push(pop * heap[o1 + ((int_heap[o2] - iv) & o3)])
+    kStoreDelayReal,                            // heap[o1 + (int_heap[o2] & o3)] = pop
+    kLoadIndexedRealStore,                      // heap[o2] = heap[o1 + pop]
+    kMultAddRealValue,                          // push(heap[o2] + rv * heap[o1])
+    kMultAddRealValueStore,                     // heap[o3] = heap[o2] + rv * heap[o1]
+    kMultAddRealHeap,                           // push(heap[o3] + heap[o1] * heap[o2])
+    kMultAddRealHeapStack,                      // push(heap[o1] * heap[o2] + pop)
+    kAddRealStore,                              // heap[o1] = pop + pop
+    kAddRealStackStore,                         // heap[o2] = heap[o1] + pop
+    kStoreMultRealHeap,                         // heap[o3] = pop, push(heap[o1] * heap[o2])
+    kStoreMultRealValue,                        // heap[o2] = pop, push(rv * heap[o1])
+    kMoveReal2,                                 // heap[o1] = heap[o2], heap[o3] = heap[iv]
+    kLoadInputIndexed,                          // push(input[o1][int_heap[o2]])
+    kLoadInputIndexedStore,                     // heap[o3] = input[o1][int_heap[o2]]
+    kStoreOutputIndexed,                        // output[o1][int_heap[o2]] = pop
+    kLoopIncLTHeap,                             // int_heap[o1] += iv, branch if int_heap[o1] < int_heap[o2]
+    kLoopIncLTValue,                            // int_heap[o1] += iv, branch if int_heap[o1] < o2
+    kSuperInstructionEnd
+};
+
+/*
+ Lane form of a non-recursive loop body (see FBCVecInterpreter): each instruction
+ is executed on several consecutive iterations of the loop at once.
+ */
+template <class REAL>
+struct FBCVecInstruction {
+    void* fLabel;
+    int   fOffset1;  // Heap offset, private slot or input/output channel
+    int   fIntValue;
+    REAL  fRealValue;
+};
+
+template <class REAL>
+struct FBCVecBlock {
+    std::vector<FBCVecInstruction<REAL>> fInstructions;
+    int                                  fLoopOffset;   // Loop variable, private slot 0
+    int                                  fLoopStart;
+    int                                  fBoundOffset;  // Int heap offset of the bound or -1
+    int                                  fBound;        // Constant bound
+    std::vector<int>                     fIntSlots;     // Heap offsets of the private slots
+    std::vector<int>                     fRealSlots;
+};
+
 template <class REAL>
 struct FIRUserInterfaceBlockInstruction : public FBCInstruction {
     std::vector<FIRUserInterfaceInstruction<REAL>*> fInstructions;
@@ -597,13 +668,19 @@ struct FIRMetaBlockInstruction : public FBCInstruction {
 
 template <class REAL>
 struct FBCBlockInstruction : public FBCInstruction {
-    std::vector<FBCBasicInstruction<REAL>*> fInstructions;
+    std::vector<FBCBasicInstruction<REAL>*>  fInstructions;
+    std::vector<FBCThreadedInstruction<REAL>> fThreadedCode;          // Computed once by 'thread'
+    int                                       fThreadedInstructions;  // Instructions in 'fThreadedCode'
+    FBCVecBlock<REAL>*                        fVecBlock;              // Lane form of a loop body, if any
+
+    FBCBlockInstruction() : fThreadedInstructions(0), fVecBlock(nullptr) {}
 
     virtual ~FBCBlockInstruction()
     {
         for (const auto& it : fInstructions) {
             delete it;
         }
+        delete fVecBlock;
     }
 
     // Check block coherency
@@ -634,6 +711,168 @@ struct FBCBlockInstruction : public FBCInstruction {
         }
     }
 
+    /*
+     Generate the direct-threaded code of the block: the block and all its branch blocks are
+     flattened in 'fThreadedCode', 'labels' gives the code address of each opcode (and superinstruction
+     if 'fuse' is true). A block referenced several times (like a loop body branching to itself) is generated once.
+     */
+    void thread(void** labels, bool fuse)
+    {
+        if (fThreadedCode.empty()) {
+            std::map<FBCBlockInstruction<REAL>*, int> starts;
+            std::vector<std::pair<int, int>>          branches;
+            threadAux(labels, fuse, fThreadedCode, branches, starts);
+            fThreadedInstructions = 0;
+            for (const auto& it : starts) {
+                fThreadedInstructions += int(it.first->fInstructions.size());
+            }
+            // Branch indexes are resolved when the array will no more be resized
+            for (size_t i = 0; i < fThreadedCode.size(); i++) {
+                fThreadedCode[i].fBranch1 = (branches[i].first >= 0) ? &fThreadedCode[branches[i].first] : nullptr;
+                fThreadedCode[i].fBranch2 = (branches[i].second >= 0) ? &fThreadedCode[branches[i].second] : nullptr;
+            }
+        }
+    }
+
+    int threadAux(void** labels, bool fuse, std::vector<FBCThreadedInstruction<REAL>>& code,
+                  std::vector<std::pair<int, int>>& branches, std::map<FBCBlockInstruction<REAL>*, int>& starts)
+    {
+        int start    = int(code.size());
+        starts[this] = start;
+        // Threaded instruction of each instruction, the branches of a superinstruction are the ones of its last instruction
+        std::vector<int> slots(fInstructions.size(), -1);
+        for (InstructionIT it = fInstructions.begin(); it != fInstructions.end();) {
+            FBCThreadedInstruction<REAL> inst;
+            inst.fLabel       = labels[(*it)->fOpcode];
+            inst.fOffset1     = (*it)->fOffset1;
+            inst.fOffset2     = (*it)->fOffset2;
+            inst.fOffset3     = -1;
+            inst.fIntValue    = (*it)->fIntValue;
+            inst.fRealValue   = (*it)->fRealValue;
+            inst.fBranch1     = nullptr;
+            inst.fBranch2     = nullptr;
+            inst.fInstruction = it;
+            int count         = (fuse) ? fuseInstructions(it, fInstructions.end(), labels, inst) : 0;
+            it += std::max(count, 1);
+            slots[(it - fInstructions.begin()) - 1] = int(code.size());
+            code.push_back(inst);
+            branches.push_back(std::make_pair(-1, -1));
+        }
+        // Branch blocks are appended after the block
+        for (size_t i = 0; i < fInstructions.size(); i++) {
+            FBCBlockInstruction<REAL>* branch1 = fInstructions[i]->fBranch1;
+            FBCBlockInstruction<REAL>* branch2 = fInstructions[i]->fBranch2;
+            if (branch1) {
+                branches[slots[i]].first = (starts.find(branch1) != starts.end())
+                                               ? starts[branch1]
+                                               : branch1->threadAux(labels, fuse, code, branches, starts);
+            }
+            if (branch2) {
+                branches[slots[i]].second = (starts.find(branch2) != starts.end())
+                                                ? starts[branch2]
+                                                : branch2->threadAux(labels, fuse, code, branches, starts);
+            }
+        }
+        return start;
+    }
+
+    /*
+     Match the longest superinstruction starting at 'it', fill 'inst' and return the number of fused
+     instructions, or 0 if none matches. Only the last fused instruction may have branches.
+     */
+    static int fuseInstructions(InstructionIT it, InstructionIT end, void** labels,
+                                FBCThreadedInstruction<REAL>& inst)
+    {
+        FBCBasicInstruction<REAL>* code[4] = {nullptr, nullptr, nullptr, nullptr};
+        FBCInstruction::Opcode     op[4]   = {FBCInstruction::kNop, FBCInstruction::kNop,
+                                              FBCInstruction::kNop, FBCInstruction::kNop};
+        for (int i = 0; i < 4 && it + i != end; i++) {
+            code[i] = *(it + i);
+            op[i]   = code[i]->fOpcode;
+        }
+
+        auto set = [&](int opcode, int off1, int off2, int off3, int count) {
+            inst.fLabel   = labels[opcode];
+            inst.fOffset1 = off1;
+            inst.fOffset2 = off2;
+            inst.fOffset3 = off3;
+            return count;
+        };
+
+        // Loop end : increment, test and branch back
+        if (op[0] == FBCInstruction::kAddIntValue && op[1] == FBCInstruction::kStoreInt &&
+            op[3] == FBCInstruction::kCondBranch && code[1]->fOffset1 == code[0]->fOffset1 &&
+            code[2]->fOffset1 == code[0]->fOffset1) {
+            if (op[2] == FBCInstruction::kLTIntHeap) {
+                return set(kLoopIncLTHeap, code[0]->fOffset1, code[2]->fOffset2, -1, 4);
+            } else if (op[2] == FBCInstruction::kLTIntValueInvert) {
+                return set(kLoopIncLTValue, code[0]->fOffset1, code[2]->fIntValue, -1, 4);
+            }
+        }
+
+        // Delay line read : heap[base + ((IOTA - delay) & mask)]
+        if (op[0] == FBCInstruction::kSubIntValueInvert && op[1] == FBCInstruction::kANDIntStackValue &&
+            op[2] == FBCInstruction::kLoadIndexedReal) {
+            return (op[3] == FBCInstruction::kMultReal)
+                       ? set(kLoadDelayRealMult, code[2]->fOffset1, code[0]->fOffset1, code[1]->fIntValue, 4)
+                       : set(kLoadDelayReal, code[2]->fOffset1, code[0]->fOffset1, code[1]->fIntValue, 3);
+        }
+
+        // Delay line write : heap[base + (IOTA & mask)]
+        if (op[0] == FBCInstruction::kANDIntValue && op[1] == FBCInstruction::kStoreIndexedReal) {
+            return set(kStoreDelayReal, code[1]->fOffset1, code[0]->fOffset1, code[0]->fIntValue, 2);
+        }
+
+        // Multiply-add
+        if (op[0] == FBCInstruction::kMultRealValue && op[1] == FBCInstruction::kAddRealStack) {
+            return (op[2] == FBCInstruction::kStoreReal)
+                       ? set(kMultAddRealValueStore, code[0]->fOffset1, code[1]->fOffset1, code[2]->fOffset1, 3)
+                       : set(kMultAddRealValue, code[0]->fOffset1, code[1]->fOffset1, -1, 2);
+        }
+        if (op[0] == FBCInstruction::kMultRealHeap && op[1] == FBCInstruction::kAddRealStack) {
+            return set(kMultAddRealHeap, code[0]->fOffset1, code[0]->fOffset2, code[1]->fOffset1, 2);
+        }
+        if (op[0] == FBCInstruction::kMultRealHeap && op[1] == FBCInstruction::kAddReal) {
+            return set(kMultAddRealHeapStack, code[0]->fOffset1, code[0]->fOffset2, -1, 2);
+        }
+
+        // Audio inputs and outputs
+        if (op[0] == FBCInstruction::kLoadInt && op[1] == FBCInstruction::kLoadInput) {
+            return (op[2] == FBCInstruction::kStoreReal)
+                       ? set(kLoadInputIndexedStore, code[1]->fOffset1, code[0]->fOffset1, code[2]->fOffset1, 3)
+                       : set(kLoadInputIndexed, code[1]->fOffset1, code[0]->fOffset1, -1, 2);
+        }
+        if (op[0] == FBCInstruction::kLoadInt && op[1] == FBCInstruction::kStoreOutput) {
+            return set(kStoreOutputIndexed, code[1]->fOffset1, code[0]->fOffset1, -1, 2);
+        }
+
+        // Stores of computed values
+        if (op[1] == FBCInstruction::kStoreReal) {
+            if (op[0] == FBCInstruction::kAddReal) {
+                return set(kAddRealStore, code[1]->fOffset1, -1, -1, 2);
+            } else if (op[0] == FBCInstruction::kAddRealStack) {
+                return set(kAddRealStackStore, code[0]->fOffset1, code[1]->fOffset1, -1, 2);
+            } else if (op[0] == FBCInstruction::kLoadIndexedReal) {
+                return set(kLoadIndexedRealStore, code[0]->fOffset1, code[1]->fOffset1, -1, 2);
+            }
+        }
+        if (op[0] == FBCInstruction::kStoreReal && op[1] == FBCInstruction::kMultRealHeap) {
+            return set(kStoreMultRealHeap, code[1]->fOffset1, code[1]->fOffset2, code[0]->fOffset1, 2);
+        }
+        if (op[0] == FBCInstruction::kStoreReal && op[1] == FBCInstruction::kMultRealValue) {
+            inst.fRealValue = code[1]->fRealValue;
+            return set(kStoreMultRealValue, code[1]->fOffset1, code[0]->fOffset1, -1, 2);
+        }
+
+        // One sample delays
+        if (op[0] == FBCInstruction::kMoveReal && op[1] == FBCInstruction::kMoveReal) {
+            inst.fIntValue = code[1]->fOffset2;
+            return set(kMoveReal2, code[0]->fOffset1, code[0]->fOffset2, code[1]->fOffset1, 2);
+        }
+
+        return 0;
+    }
+
     void stackMove(int& int_index, int& real_index)
     {
         std::cout << "FBCBlockInstruction::stackMove" << std::endl;
@@ -65,7 +65,7 @@ destroy time (after global memory allocation is implemented)
 */
 
 template <class REAL>
-map<string, FBCInstruction::Opcode> InterpreterInstVisitor<REAL>::gMathLibTable;
+thread_local map<string, FBCInstruction::Opcode> InterpreterInstVisitor<REAL>::gMathLibTable;
 
 template <class REAL>
 static FBCBlockInstruction<REAL>* getCurrentBlock()
@@ -72,6 +72,7 @@ struct interpreter_comp_dsp_aux : public interpreter_dsp_aux<REAL, TRACE> {
         this->fInitialized = false;
         this->fCycle       = 0;
         this->fTraceOutput = false;
+        std::lock_guard<std::mutex> lock(factory->fInstanceLock);
         this->fFBCExecutor = factory->createFBCExecutor();
     }
 };
@@ -185,6 +185,68 @@ interpreter_dsp_factory_aux<REAL, TRACE>* interpreter_dsp_factory_aux<REAL, TRAC
 #endif
 }
 
+// Binary factory reader
+template <class REAL, int TRACE>
+interpreter_dsp_factory_aux<REAL, TRACE>* interpreter_dsp_factory_aux<REAL, TRACE>::readBinary(
+    const char* buffer, size_t size)
+{
+    FBCBinaryReader<REAL>  reader(buffer, size);
+    const FBCBinaryHeader* header = reader.fHeader;
+
+    if (INTERP_FILE_VERSION != header->fFileVersion) {
+        std::stringstream error;
+        error << "ERROR : interpreter file format version '" << header->fFileVersion
+              << "' different from compiled one '" << INTERP_FILE_VERSION << "'" << std::endl;
+        throw faustexception(error.str());
+    }
+
+    std::string compile_options = reader.getString(header->fCompileOptions);
+    std::string factory_name    = reader.getString(header->fName);
+    std::string sha_key         = reader.getString(header->fSHAKey);
+
+    // Read meta block
+    std::unique_ptr<FIRMetaBlockInstruction> meta_block(new FIRMetaBlockInstruction());
+    const FBCBinaryMeta* metas = reader.template getSection<FBCBinaryMeta>(kFBCMetaSection);
+    for (uint32_t i = 0; i < reader.count(kFBCMetaSection); i++) {
+        meta_block->push(
+            new FIRMetaInstruction(reader.getString(metas[i].fKey), reader.getString(metas[i].fValue)));
+    }
+
+    // Read user interface block
+    std::unique_ptr<FIRUserInterfaceBlockInstruction<REAL>> ui_block(
+        new FIRUserInterfaceBlockInstruction<REAL>());
+    const FBCBinaryUI* uis = reader.template getSection<FBCBinaryUI>(kFBCUISection);
+    for (uint32_t i = 0; i < reader.count(kFBCUISection); i++) {
+        const FBCBinaryUI& ui = uis[i];
+        if (ui.fOpcode < 0 || ui.fOpcode > FBCInstruction::kNop) {
+            reader.error();
+        }
+        ui_block->push(new FIRUserInterfaceInstruction<REAL>(
+            FBCInstruction::Opcode(ui.fOpcode), ui.fOffset, reader.getString(ui.fLabel),
+            reader.getString(ui.fKey), reader.getString(ui.fValue), REAL(ui.fInit), REAL(ui.fMin),
+            REAL(ui.fMax), REAL(ui.fStep)));
+    }
+
+    // Read code blocks
+    std::vector<bool>                          visited(reader.count(kFBCCodeSection), false);
+    std::unique_ptr<FBCBlockInstruction<REAL>> blocks[kFBCBlockCount];
+    for (int i = 0; i < kFBCBlockCount; i++) {
+        blocks[i].reset(readBinaryBlock(reader, header->fBlocks[i], visited));
+    }
+
+#if defined(MACHINE) || defined(INTERP_COMP_BUILD)
+    return new interpreter_comp_dsp_factory_aux<REAL, TRACE>(
+#else
+    return new interpreter_dsp_factory_aux<REAL, TRACE>(
+#endif
+        factory_name, compile_options, sha_key, header->fFileVersion, header->fNumInputs,
+        header->fNumOutputs, header->fIntHeapSize, header->fRealHeapSize, header->fSROffset,
+        header->fCountOffset, header->fIOTAOffset, header->fOptLevel, meta_block.release(),
+        ui_block.release(), blocks[kFBCStaticInitBlock].release(), blocks[kFBCInitBlock].release(),
+        blocks[kFBCResetUIBlock].release(), blocks[kFBCClearBlock].release(),
+        blocks[kFBCComputeBlock].release(), blocks[kFBCComputeDSPBlock].release());
+}
+
 template <class REAL, int TRACE>
 void interpreter_dsp_factory_aux<REAL, TRACE>::optimize()
 {
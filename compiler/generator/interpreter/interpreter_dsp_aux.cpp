@@ -131,6 +131,41 @@ static string read_real_type(istream* in)
     return type;
 }
 
+static dsp_factory_base* readInterpreterDSPFactoryBinary(const string& bitcode)
+{
+    FBCBinaryHeader header;
+    if (bitcode.size() < sizeof(FBCBinaryHeader)) {
+        throw faustexception("ERROR : corrupted binary FBC file\n");
+    }
+    memcpy(&header, bitcode.data(), sizeof(FBCBinaryHeader));
+
+    if (header.fRealSize == sizeof(float)) {
+        return interpreter_dsp_factory_aux<float, 0>::readBinary(bitcode.data(), bitcode.size());
+    } else if (header.fRealSize == sizeof(double)) {
+        return interpreter_dsp_factory_aux<double, 0>::readBinary(bitcode.data(), bitcode.size());
+    } else {
+        throw faustexception("ERROR : unrecognized file format\n");
+    }
+}
+
+dsp_factory_base* readInterpreterDSPFactoryAux(const string& bitcode)
+{
+    if (isFBCBinary(bitcode.data(), bitcode.size())) {
+        return readInterpreterDSPFactoryBinary(bitcode);
+    }
+
+    stringstream reader(bitcode);
+    string       type = read_real_type(&reader);
+
+    if (type == "float") {
+        return interpreter_dsp_factory_aux<float, 0>::read(&reader);
+    } else if (type == "double") {
+        return interpreter_dsp_factory_aux<double, 0>::read(&reader);
+    } else {
+        throw faustexception("ERROR : unrecognized file format\n");
+    }
+}
+
 static interpreter_dsp_factory* readInterpreterDSPFactoryFromBitcodeAux(const string& bitcode,
                                                                         string&       error_msg)
 {
@@ -144,20 +179,8 @@ static interpreter_dsp_factory* readInterpreterDSPFactoryFromBitcodeAux(const st
             sfactory->addReference();
             return sfactory;
         } else {
-            interpreter_dsp_factory* factory = nullptr;
-            stringstream             reader(bitcode);
-            string                   type = read_real_type(&reader);
-
-            if (type == "float") {
-                factory = new interpreter_dsp_factory(
-                    interpreter_dsp_factory_aux<float, 0>::read(&reader));
-            } else if (type == "double") {
-                factory = new interpreter_dsp_factory(
-                    interpreter_dsp_factory_aux<double, 0>::read(&reader));
-            } else {
-                throw faustexception("ERROR : unrecognized file format\n");
-            }
-
+            interpreter_dsp_factory* factory =
+                new interpreter_dsp_factory(readInterpreterDSPFactoryAux(bitcode));
             gInterpreterFactoryTable.setFactory(factory);
             factory->setSHAKey(sha_key);
             factory->setDSPCode(bitcode);
@@ -179,8 +202,9 @@ LIBFAUST_API interpreter_dsp_factory* readInterpreterDSPFactoryFromBitcode(const
 LIBFAUST_API string writeInterpreterDSPFactoryToBitcode(interpreter_dsp_factory* factory)
 {
     LOCK_API
+    // Text format, since the bitcode is also returned as a C string
     stringstream writer;
-    factory->write(&writer, true);
+    factory->write(&writer, false);
     return writer.str();
 }
 
@@ -192,9 +216,13 @@ LIBFAUST_API interpreter_dsp_factory* readInterpreterDSPFactoryFromBitcodeFile(
     size_t pos  = bitcode_path.find(".fbc");
 
     if (pos != string::npos) {
-        ifstream reader(bitcode_path.c_str());
+        ifstream reader(bitcode_path.c_str(), ifstream::in | ifstream::binary);
         if (reader.is_open()) {
-            string bitcode(istreambuf_iterator<char>(reader), {});
+            // Text or binary format, read at once
+            reader.seekg(0, ios::end);
+            string bitcode(size_t(reader.tellg()), '\0');
+            reader.seekg(0, ios::beg);
+            reader.read(&bitcode[0], bitcode.size());
             return readInterpreterDSPFactoryFromBitcodeAux(bitcode, error_msg);
         } else {
             error_msg = "ERROR opening file '" + bitcode_path + "'\n";
@@ -210,7 +238,7 @@ LIBFAUST_API bool writeInterpreterDSPFactoryToBitcodeFile(interpreter_dsp_factor
                                                           const string&            bitcode_path)
 {
     LOCK_API
-    ofstream writer(bitcode_path.c_str());
+    ofstream writer(bitcode_path.c_str(), ofstream::out | ofstream::binary);
     if (writer.is_open()) {
         factory->write(&writer, true);
         return true;
@@ -23,10 +23,13 @@
 #define interpreter_dsp_aux_h
 
 #include <stdlib.h>
+#include <string.h>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 
@@ -34,6 +37,7 @@
 
 #include "dsp_aux.hh"
 #include "dsp_factory.hh"
+#include "fbc_binary.hh"
 #include "fbc_interpreter.hh"
 #include "interpreter_bytecode.hh"
 
@@ -81,6 +85,16 @@ struct interpreter_dsp_factory_aux : public dsp_factory_imp {
     bool        fOptimized;
     std::string fCompileOptions;
 
+    // Whether the threaded code uses superinstructions, decided once since the blocks are shared
+    bool fFuse;
+
+    // Whether the non-recursive loops are executed on lanes of samples ('-il' compile option)
+    bool fLanes;
+
+    // Serializes the optimization, threading and lane compilation of the shared blocks,
+    // done by the instances when they are built, possibly on several threads
+    std::mutex fInstanceLock;
+
     FIRMetaBlockInstruction*                fMetaBlock;
     FIRUserInterfaceBlockInstruction<REAL>* fUserInterfaceBlock;
     FBCBlockInstruction<REAL>*              fStaticInitBlock;
@@ -126,6 +140,9 @@ struct interpreter_dsp_factory_aux : public dsp_factory_imp {
 #else
         fCompileOptions = compile_options;
 #endif
+        const char* fuse = getenv("FAUST_INTERP_FUSION");
+        fFuse            = TRACE == 0 && !(fuse && strcmp(fuse, "0") == 0);
+        fLanes           = TRACE == 0 && (" " + compile_options + " ").find(" -il ") != std::string::npos;
     }
 
     virtual FBCExecutor<REAL>* createFBCExecutor() { return new FBCInterpreter<REAL, TRACE>(this); }
@@ -147,6 +164,10 @@ struct interpreter_dsp_factory_aux : public dsp_factory_imp {
 
     void write(std::ostream* out, bool binary = false, bool small = false)
     {
+        if (binary) {
+            writeBinary(out);
+            return;
+        }
         *out << std::setprecision(std::numeric_limits<REAL>::digits10 + 1);
         if (small) {
             *out << "i " << ((sizeof(REAL) == sizeof(double)) ? "double" : "float") << std::endl;
@@ -226,11 +247,95 @@ struct interpreter_dsp_factory_aux : public dsp_factory_imp {
         }
     }
 
+    void writeBinary(std::ostream* out)
+    {
+        FBCBinaryWriter<REAL> writer;
+        FBCBinaryHeader&      header = writer.fHeader;
+
+        header.fFileVersion    = INTERP_FILE_VERSION;
+        header.fFaustVersion   = writer.addString(FAUSTVERSION);
+        header.fCompileOptions = writer.addString(fCompileOptions);
+        header.fName           = writer.addString(fName);
+        header.fSHAKey         = writer.addString(fSHAKey);
+        header.fOptLevel       = fOptLevel;
+        header.fNumInputs      = fNumInputs;
+        header.fNumOutputs     = fNumOutputs;
+        header.fIntHeapSize    = fIntHeapSize;
+        header.fRealHeapSize   = fRealHeapSize;
+        header.fSROffset       = fSROffset;
+        header.fCountOffset    = fCountOffset;
+        header.fIOTAOffset     = fIOTAOffset;
+
+        for (const auto& it : fMetaBlock->fInstructions) {
+            writer.fMetas.push_back({writer.addString(it->fKey), writer.addString(it->fValue)});
+        }
+
+        for (const auto& it : fUserInterfaceBlock->fInstructions) {
+            writer.fUIs.push_back({it->fOpcode, it->fOffset, writer.addString(it->fLabel),
+                                   writer.addString(it->fKey), writer.addString(it->fValue), 0,
+                                   double(it->fInit), double(it->fMin), double(it->fMax),
+                                   double(it->fStep)});
+        }
+
+        header.fBlocks[kFBCStaticInitBlock] = writeBinaryBlock(writer, fStaticInitBlock);
+        header.fBlocks[kFBCInitBlock]       = writeBinaryBlock(writer, fInitBlock);
+        header.fBlocks[kFBCResetUIBlock]    = writeBinaryBlock(writer, fResetUIBlock);
+        header.fBlocks[kFBCClearBlock]      = writeBinaryBlock(writer, fClearBlock);
+        header.fBlocks[kFBCComputeBlock]    = writeBinaryBlock(writer, fComputeBlock);
+        header.fBlocks[kFBCComputeDSPBlock] = writeBinaryBlock(writer, fComputeDSPBlock);
+
+        writer.write(out);
+    }
+
+    // Write the block header and instructions, then the sub-blocks, and return the header index
+    static int32_t writeBinaryBlock(FBCBinaryWriter<REAL>& writer, FBCBlockInstruction<REAL>* block)
+    {
+        int32_t index = int32_t(writer.fCode.size());
+        writer.fCode.push_back(
+            {FBC_BINARY_BLOCK, int32_t(block->fInstructions.size()), -1, -1, 0, 0, 0, 0, 0.});
+
+        for (const auto& it : block->fInstructions) {
+            FBCBinaryInstruction inst = {it->fOpcode,  it->fIntValue, it->fOffset1,
+                                         it->fOffset2, 0,             0,
+                                         writer.addString(it->fName), 0,
+                                         double(it->fRealValue)};
+            if (it->fOpcode == FBCInstruction::kBlockStoreReal) {
+                std::vector<REAL>& table = static_cast<FIRBlockStoreRealInstruction<REAL>*>(it)->fNumTable;
+                inst.fIntValue = int32_t(table.size());
+                inst.fPool     = uint32_t(writer.fRealPool.size());
+                writer.fRealPool.insert(writer.fRealPool.end(), table.begin(), table.end());
+            } else if (it->fOpcode == FBCInstruction::kBlockStoreInt) {
+                std::vector<int>& table = static_cast<FIRBlockStoreIntInstruction<REAL>*>(it)->fNumTable;
+                inst.fIntValue = int32_t(table.size());
+                inst.fPool     = uint32_t(writer.fIntPool.size());
+                writer.fIntPool.insert(writer.fIntPool.end(), table.begin(), table.end());
+            }
+            writer.fCode.push_back(inst);
+        }
+
+        // kCondBranch loops on its enclosing block, which is not written as a branch
+        for (size_t i = 0; i < block->fInstructions.size(); i++) {
+            FBCBasicInstruction<REAL>* it  = block->fInstructions[i];
+            int32_t                    pos = index + 1 + int32_t(i);
+            if (it->getBranch1()) {
+                writer.fCode[pos].fBranch1 = writeBinaryBlock(writer, it->getBranch1()) - pos;
+            }
+            if (it->getBranch2()) {
+                writer.fCode[pos].fBranch2 = writeBinaryBlock(writer, it->getBranch2()) - pos;
+            }
+        }
+
+        return index;
+    }
+
     std::string getCompileOptions() { return fCompileOptions; };
 
     // Factory reader
     static interpreter_dsp_factory_aux<REAL, TRACE>* read(std::istream* in);
 
+    // Binary factory reader, 'buffer' is only accessed during the call
+    static interpreter_dsp_factory_aux<REAL, TRACE>* readBinary(const char* buffer, size_t size);
+
     static std::string parseStringToken(std::stringstream* inst)
     {
         std::string token;
@@ -372,6 +477,73 @@ struct interpreter_dsp_factory_aux : public dsp_factory_imp {
         return code_block;
     }
 
+    static FBCBlockInstruction<REAL>* readBinaryBlock(FBCBinaryReader<REAL>& reader, int64_t index,
+                                                      std::vector<bool>& visited)
+    {
+        int                         size;
+        const FBCBinaryInstruction* code = reader.getBlock(index, size);
+
+        // A block is only referenced once, which also rejects cycles
+        if (visited[index]) {
+            reader.error();
+        }
+        visited[index] = true;
+
+        std::unique_ptr<FBCBlockInstruction<REAL>> code_block(new FBCBlockInstruction<REAL>());
+        code_block->fInstructions.reserve(size);
+
+        for (int i = 0; i < size; i++) {
+            const FBCBinaryInstruction& inst   = code[i];
+            FBCInstruction::Opcode      opcode = FBCInstruction::Opcode(inst.fOpcode);
+            if (inst.fOpcode < 0 || inst.fOpcode > FBCInstruction::kNop) {
+                reader.error();
+            }
+
+            if (opcode == FBCInstruction::kBlockStoreReal || opcode == FBCInstruction::kBlockStoreInt) {
+                int kind = (opcode == FBCInstruction::kBlockStoreReal) ? kFBCRealSection : kFBCIntSection;
+                if (inst.fIntValue < 0 || inst.fPool > reader.count(kind) ||
+                    uint32_t(inst.fIntValue) > reader.count(kind) - inst.fPool) {
+                    reader.error();
+                }
+                if (opcode == FBCInstruction::kBlockStoreReal) {
+                    const REAL* table = reader.template getSection<REAL>(kind) + inst.fPool;
+                    code_block->push(new FIRBlockStoreRealInstruction<REAL>(
+                        opcode, inst.fOffset1, inst.fOffset2,
+                        std::vector<REAL>(table, table + inst.fIntValue)));
+                } else {
+                    const int32_t* table = reader.template getSection<int32_t>(kind) + inst.fPool;
+                    code_block->push(new FIRBlockStoreIntInstruction<REAL>(
+                        opcode, inst.fOffset1, inst.fOffset2,
+                        std::vector<int>(table, table + inst.fIntValue)));
+                }
+                continue;
+            }
+
+            // Sub-blocks are always written after the instruction
+            int64_t pos = index + 1 + i;
+            if (inst.fBranch1 < 0 || inst.fBranch2 < 0 ||
+                (opcode == FBCInstruction::kCondBranch && inst.fBranch1 != 0)) {
+                reader.error();
+            }
+            std::string name = reader.getString(inst.fName);
+            std::unique_ptr<FBCBlockInstruction<REAL>> branch1(
+                (inst.fBranch1 > 0) ? readBinaryBlock(reader, pos + inst.fBranch1, visited) : nullptr);
+            std::unique_ptr<FBCBlockInstruction<REAL>> branch2(
+                (inst.fBranch2 > 0) ? readBinaryBlock(reader, pos + inst.fBranch2, visited) : nullptr);
+
+            FBCBasicInstruction<REAL>* basic = new FBCBasicInstruction<REAL>(
+                opcode, name, inst.fIntValue, REAL(inst.fRealValue),
+                inst.fOffset1, inst.fOffset2, branch1.release(), branch2.release());
+            // Special case for loops
+            if (opcode == FBCInstruction::kCondBranch) {
+                basic->fBranch1 = code_block.get();
+            }
+            code_block->push(basic);
+        }
+
+        return code_block.release();
+    }
+
     static FBCBasicInstruction<REAL>* readCodeInstruction(std::istream* inst, std::istream* in)
     {
         int  opcode, offset1, offset2;
@@ -539,6 +711,7 @@ class interpreter_dsp_aux : public interpreter_dsp_base {
         fInitialized = false;
         fCycle       = 0;
         fTraceOutput = getenv("FAUST_INTERP_OUTPUT") != NULL;
+        std::lock_guard<std::mutex> lock(fFactory->fInstanceLock);
         // Done before createFBCExecutor that may compile blocks...
         fFactory->optimize();
         fFBCExecutor = factory->createFBCExecutor();
@@ -950,6 +1123,9 @@ class LIBFAUST_API interpreter_dsp_factory : public dsp_factory, public faust_sm
     }
 };
 
+// Create the internal factory from FBC bitcode, without accessing the factory table
+dsp_factory_base* readInterpreterDSPFactoryAux(const std::string& bitcode);
+
 LIBFAUST_API interpreter_dsp_factory* getInterpreterDSPFactoryFromSHAKey(
     const std::string& sha_key);
 
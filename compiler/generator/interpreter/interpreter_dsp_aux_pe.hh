@@ -63,8 +63,11 @@ class interpreter_dsp_aux_pe : public interpreter_dsp_aux<REAL, TRACE> {
          std::cout << "size " << fFactory->fComputeDSPBlock->size() << std::endl;
          */
 
-        this->fFactory     = factory;
-        this->fFBCExecutor = factory->createFBCExecutor();
+        this->fFactory = factory;
+        {
+            std::lock_guard<std::mutex> lock(factory->fInstanceLock);
+            this->fFBCExecutor = factory->createFBCExecutor();
+        }
 
         fStaticInitBlock = nullptr;
         fInitBlock       = nullptr;
@@ -174,6 +177,14 @@ class interpreter_dsp_aux_pe : public interpreter_dsp_aux<REAL, TRACE> {
             FBCInstructionOptimizer<T>::optimizeBlock(this->fComputeDSPBlock, 5, 6);
 #endif
 
+        // The specialized blocks are owned by the instance, and threaded before 'compute'
+        this->fFBCExecutor->threadBlock(this->fStaticInitBlock);
+        this->fFBCExecutor->threadBlock(this->fInitBlock);
+        this->fFBCExecutor->threadBlock(this->fResetUIBlock);
+        this->fFBCExecutor->threadBlock(this->fClearBlock);
+        this->fFBCExecutor->threadBlock(this->fComputeBlock);
+        this->fFBCExecutor->threadBlock(this->fComputeDSPBlock);
+
         /*
          this->fStaticInitBlock->write(&std::cout, false);
          this->fInitBlock->write(&std::cout, false);
@@ -26,12 +26,26 @@
 #endif  // defined(_WIN32)
 
 #include "Text.hh"
+#include "dsp_factory_cache.hh"
 #include "interpreter_dynamic_dsp_aux.hh"
 #include "libfaust.h"
 #include "lock_api.hh"
 
 using namespace std;
 
+static dsp_factory_base* readInterpreterDSPFactoryFromCache(const string& cache_key)
+{
+    vector<string> parts;
+    if (dsp_factory_cache::read(cache_key, parts) && parts.size() == 1) {
+        try {
+            return readInterpreterDSPFactoryAux(parts[0]);
+        } catch (faustexception& e) {
+            // Incompatible or corrupted entry, the DSP will be compiled again
+        }
+    }
+    return nullptr;
+}
+
 LIBFAUST_API interpreter_dsp_factory* createInterpreterDSPFactoryFromFile(const string& filename,
                                                                           int           argc,
                                                                           const char*   argv[],
@@ -53,49 +67,84 @@ LIBFAUST_API interpreter_dsp_factory* createInterpreterDSPFactoryFromString(
     const string& name_app, const string& dsp_content, int argc, const char* argv[],
     string& error_msg)
 {
-    LOCK_API
     string expanded_dsp_content, sha_key;
 
+    // The API lock is only taken to access the factory table, so that several DSP can be compiled in parallel
     if ((expanded_dsp_content = sha1FromDSP(name_app, dsp_content, argc, argv, sha_key)) == "") {
         return nullptr;
-    } else {
-        dsp_factory_table<SDsp_factory>::factory_iterator it;
+    }
+
+    dsp_factory_table<SDsp_factory>::factory_iterator it;
+    {
+        LOCK_API
         if (gInterpreterFactoryTable.getFactory(sha_key, it)) {
             SDsp_factory sfactory = (*it).first;
             sfactory->addReference();
             return sfactory;
-        } else {
-            try {
-                int         argc1 = 0;
-                const char* argv1[64];
-                argv1[argc1++] = "faust";
-                argv1[argc1++] = "-lang";
-                argv1[argc1++] = "interp";
-                argv1[argc1++] = "-o";
-                argv1[argc1++] = "string";
-                // Copy arguments
-                for (int i = 0; i < argc; i++) {
-                    argv1[argc1++] = argv[i];
+        }
+    }
+
+    try {
+        int         argc1 = 0;
+        const char* argv1[64];
+        argv1[argc1++] = "faust";
+        argv1[argc1++] = "-lang";
+        argv1[argc1++] = "interp";
+        argv1[argc1++] = "-o";
+        argv1[argc1++] = "string";
+        // Copy arguments
+        for (int i = 0; i < argc; i++) {
+            argv1[argc1++] = argv[i];
+        }
+        argv1[argc1] = nullptr;  // NULL terminated argv
+
+        // Load the factory from the persistent cache if possible, otherwise compile and save it
+        string            cache_key       = dsp_factory_cache::getKey("interp", sha_key);
+        dsp_factory_base* dsp_factory_aux = readInterpreterDSPFactoryFromCache(cache_key);
+        if (!dsp_factory_aux) {
+            // Possibly reuse the code of the same evaluated DSP
+            dsp_factory_cache_context cache("interp");
+            bool                      reused = false;
+            if (dsp_factory_cache::isActive()) {
+                dsp_factory_aux = createFactory(name_app, dsp_content, argc1, argv1, error_msg, cache);
+                if (cache.fCached) {
+                    dsp_factory_aux = readInterpreterDSPFactoryFromCache(cache.fProcessKey);
+                    reused          = (dsp_factory_aux != nullptr);
                 }
-                argv1[argc1] = nullptr;  // NULL terminated argv
-
-                dsp_factory_base* dsp_factory_aux =
-                    createFactory(name_app, dsp_content, argc1, argv1, error_msg, true);
-                if (dsp_factory_aux) {
-                    dsp_factory_aux->setName(name_app);
-                    interpreter_dsp_factory* factory = new interpreter_dsp_factory(dsp_factory_aux);
-                    gInterpreterFactoryTable.setFactory(factory);
-                    factory->setSHAKey(sha_key);
-                    factory->setDSPCode(expanded_dsp_content);
-                    return factory;
-                } else {
-                    return nullptr;
+            }
+            if (!dsp_factory_aux && error_msg == "") {
+                dsp_factory_aux = createFactory(name_app, dsp_content, argc1, argv1, error_msg, true);
+            }
+            if (dsp_factory_aux && dsp_factory_cache::isActive()) {
+                stringstream writer;
+                dsp_factory_aux->write(&writer, true);
+                dsp_factory_cache::write(cache_key, {writer.str()}, cache.fLibraries);
+                if (!reused && cache.fProcessKey != "") {
+                    dsp_factory_cache::write(cache.fProcessKey, {writer.str()});
                 }
-            } catch (faustexception& e) {
-                error_msg = e.what();
-                return nullptr;
             }
         }
+        if (dsp_factory_aux) {
+            LOCK_API
+            // The same DSP may have been compiled by another thread in the meantime
+            if (gInterpreterFactoryTable.getFactory(sha_key, it)) {
+                delete dsp_factory_aux;
+                SDsp_factory sfactory = (*it).first;
+                sfactory->addReference();
+                return sfactory;
+            }
+            dsp_factory_aux->setName(name_app);
+            interpreter_dsp_factory* factory = new interpreter_dsp_factory(dsp_factory_aux);
+            gInterpreterFactoryTable.setFactory(factory);
+            factory->setSHAKey(sha_key);
+            factory->setDSPCode(expanded_dsp_content);
+            return factory;
+        } else {
+            return nullptr;
+        }
+    } catch (faustexception& e) {
+        error_msg = e.what();
+        return nullptr;
     }
 }
 
@@ -38,7 +38,7 @@ struct InterpreterInstVisitor : public DispatchVisitor {
      Global functions names table as a static variable in the visitor
      so that each function prototype is generated as most once in the module.
     */
-    static std::map<std::string, FBCInstruction::Opcode> gMathLibTable;
+    static thread_local std::map<std::string, FBCInstruction::Opcode> gMathLibTable;
 
     int fRealHeapOffset;  // Offset in Real HEAP
     int fIntHeapOffset;   // Offset in Integer HEAP
@@ -34,17 +34,17 @@
 
 // Tables for math optimization
 
-static std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRMath2Heap;
-static std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRMath2Stack;
-static std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRMath2StackValue;
-static std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRMath2Value;
-static std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRMath2ValueInvert;
-
-static std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRExtendedMath2Heap;
-static std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRExtendedMath2Stack;
-static std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRExtendedMath2StackValue;
-static std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRExtendedMath2Value;
-static std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRExtendedMath2ValueInvert;
+static thread_local std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRMath2Heap;
+static thread_local std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRMath2Stack;
+static thread_local std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRMath2StackValue;
+static thread_local std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRMath2Value;
+static thread_local std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRMath2ValueInvert;
+
+static thread_local std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRExtendedMath2Heap;
+static thread_local std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRExtendedMath2Stack;
+static thread_local std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRExtendedMath2StackValue;
+static thread_local std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRExtendedMath2Value;
+static thread_local std::map<FBCInstruction::Opcode, FBCInstruction::Opcode> gFIRExtendedMath2ValueInvert;
 
 //=========================================================================
 // FBC Optimization:
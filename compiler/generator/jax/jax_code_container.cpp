@@ -58,7 +58,7 @@ using namespace std;
  used to generate global functions and move global variables declaration at DSP structure level.
 */
 
-map<string, bool> JAXInstVisitor::gFunctionSymbolTable;
+thread_local map<string, bool> JAXInstVisitor::gFunctionSymbolTable;
 
 dsp_factory_base* JAXCodeContainer::produceFactory()
 {
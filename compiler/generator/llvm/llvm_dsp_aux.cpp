@@ -91,10 +91,24 @@ extern "C" LIBFAUST_API void printPtr(void* val)
 
 // Factories instances management
 int                             llvm_dsp_factory_aux::gInstance = 0;
+mutex                           llvm_dsp_factory_aux::gInstanceLock;
 dsp_factory_table<SDsp_factory> llvm_dsp_factory_aux::gLLVMFactoryTable;
 
 // Set of externally defined functions, to be linked with the LLVM module
 set<string> llvm_dsp_factory_aux::gForeignFunctions;
+mutex       llvm_dsp_factory_aux::gForeignFunctionsLock;
+
+void llvm_dsp_factory_aux::addForeignFunction(const string& name)
+{
+    lock_guard<mutex> lock(gForeignFunctionsLock);
+    gForeignFunctions.insert(name);
+}
+
+bool llvm_dsp_factory_aux::isForeignFunction(const string& name)
+{
+    lock_guard<mutex> lock(gForeignFunctionsLock);
+    return gForeignFunctions.count(name) > 0;
+}
 
 uint64_t llvm_dsp_factory_aux::loadOptimize(const string& function)
 {
@@ -119,6 +133,8 @@ bool llvm_dsp_factory_aux::crossCompile(const string& target)
 
 void llvm_dsp_factory_aux::startLLVMLibrary()
 {
+    // The counter and the handler are process-wide, and factories are created outside LOCK_API
+    lock_guard<mutex> lock(gInstanceLock);
     if (llvm_dsp_factory_aux::gInstance++ == 0) {
         // Install the LLVM error handler
 #if defined(__APPLE__) && LLVM_VERSION_MAJOR >= 11
@@ -131,6 +147,7 @@ void llvm_dsp_factory_aux::startLLVMLibrary()
 
 void llvm_dsp_factory_aux::stopLLVMLibrary()
 {
+    lock_guard<mutex> lock(gInstanceLock);
     if (--llvm_dsp_factory_aux::gInstance == 0) {
         // Remove the LLVM error handler
 #if defined(__APPLE__) && LLVM_VERSION_MAJOR >= 11
@@ -649,8 +666,7 @@ LIBFAUST_API void llvm_dsp::operator delete(void* ptr)
 // Register an externally defined function
 LIBFAUST_API void registerForeignFunction(const string& name)
 {
-    LOCK_API
-    llvm_dsp_factory_aux::gForeignFunctions.insert(name);
+    llvm_dsp_factory_aux::addForeignFunction(name);
 }
 
 // Public C interface : lock management is done by called C++ API
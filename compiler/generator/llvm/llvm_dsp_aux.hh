@@ -23,6 +23,7 @@
 #define LLVM_DSP_AUX_H
 
 #include <map>
+#include <mutex>
 #include <set>
 #include <string>
 #include <utility>
@@ -270,10 +271,15 @@ class llvm_dsp_factory_aux : public dsp_factory_imp {
 
     // Factory instance management
     static int                             gInstance;
+    static std::mutex                      gInstanceLock;  // Factories may be created concurrently
     static dsp_factory_table<SDsp_factory> gLLVMFactoryTable;
 
-    // Set of custom foreign functions
+    // Set of custom foreign functions, read by concurrent compilations
     static std::set<std::string> gForeignFunctions;
+    static std::mutex            gForeignFunctionsLock;
+
+    static void addForeignFunction(const std::string& name);
+    static bool isForeignFunction(const std::string& name);
 };
 
 // Public C++ interface
@@ -30,6 +30,7 @@
 
 #include "Text.hh"
 #include "compatibility.hh"
+#include "dsp_factory_cache.hh"
 #include "global.hh"
 #include "libfaust.h"
 #include "llvm_dynamic_dsp_aux.hh"
@@ -653,59 +654,115 @@ LIBFAUST_API llvm_dsp_factory* createDSPFactoryFromFile(const string& filename,
     }
 }
 
+// Restore the factory from the machine code kept in the persistent cache
+static llvm_dsp_factory_aux* readDSPFactoryFromCache(const string& cache_key, const string& sha_key,
+                                                     const string& target)
+{
+    vector<string> parts;
+    if (dsp_factory_cache::read(cache_key, parts) && parts.size() == 1) {
+        llvm_dsp_factory_aux* factory_aux =
+            new llvm_dsp_factory_aux(sha_key, base64_decode(parts[0]), target);
+        string                error_msg;
+        LOCK_API
+        if (factory_aux->initJIT(error_msg)) {
+            return factory_aux;
+        }
+        // Incompatible or corrupted entry, the DSP will be compiled again
+        delete factory_aux;
+    }
+    return nullptr;
+}
+
 LIBFAUST_API llvm_dsp_factory* createDSPFactoryFromString(const string& name_app,
                                                           const string& dsp_content, int argc,
                                                           const char* argv[], const string& target,
                                                           string& error_msg, int opt_level)
 {
-    LOCK_API
     string expanded_dsp_content, sha_key;
 
+    // The API lock is only taken to access the factory table and JIT the module,
+    // so that several DSP can be compiled in parallel
     if ((expanded_dsp_content = sha1FromDSP(name_app, dsp_content, argc, argv, sha_key)) == "") {
         return nullptr;
-    } else {
-        dsp_factory_table<SDsp_factory>::factory_iterator it;
+    }
+
+    dsp_factory_table<SDsp_factory>::factory_iterator it;
+    {
+        LOCK_API
         if (llvm_dsp_factory_aux::gLLVMFactoryTable.getFactory(sha_key, it)) {
             SDsp_factory sfactory = (*it).first;
             sfactory->addReference();
             return sfactory;
-        } else {
-            try {
-                int         argc1 = 0;
-                const char* argv1[64];
-                argv1[argc1++] = "faust";
-                argv1[argc1++] = "-lang";
-                argv1[argc1++] = "llvm";
-                argv1[argc1++] = "-o";
-                argv1[argc1++] = "string";
-                // Copy arguments
-                for (int i = 0; i < argc; i++) {
-                    argv1[argc1++] = argv[i];
-                }
-                argv1[argc1] = nullptr;  // NULL terminated argv
-
-                llvm_dynamic_dsp_factory_aux* factory_aux =
-                    static_cast<llvm_dynamic_dsp_factory_aux*>(
-                        createFactory(name_app, dsp_content, argc1, argv1, error_msg, true));
-                if (factory_aux && factory_aux->initJIT(error_msg)) {
-                    factory_aux->setTarget(target);
-                    factory_aux->setOptlevel(opt_level);
-                    factory_aux->setClassName(getParam(argc, argv, "-cn", "mydsp"));
-                    factory_aux->setName(name_app);
-                    llvm_dsp_factory* factory = new llvm_dsp_factory(factory_aux);
-                    llvm_dsp_factory_aux::gLLVMFactoryTable.setFactory(factory);
-                    factory->setSHAKey(sha_key);
-                    factory->setDSPCode(expanded_dsp_content);
-                    return factory;
-                } else {
-                    delete factory_aux;
-                    return nullptr;
+        }
+    }
+
+    try {
+        int         argc1 = 0;
+        const char* argv1[64];
+        argv1[argc1++] = "faust";
+        argv1[argc1++] = "-lang";
+        argv1[argc1++] = "llvm";
+        argv1[argc1++] = "-o";
+        argv1[argc1++] = "string";
+        // Copy arguments
+        for (int i = 0; i < argc; i++) {
+            argv1[argc1++] = argv[i];
+        }
+        argv1[argc1] = nullptr;  // NULL terminated argv
+
+        // Machine code depends on the target and optimization level, which are part of the cache key
+        string cache_key_backend =
+            "llvm " + ((target == "") ? getDSPMachineTarget() : target) + " " + to_string(opt_level);
+        string cache_key = dsp_factory_cache::getKey(cache_key_backend, sha_key);
+        llvm_dsp_factory_aux* factory_aux = readDSPFactoryFromCache(cache_key, sha_key, target);
+        bool                  cached      = (factory_aux != nullptr);
+        bool                  reused      = false;
+        dsp_factory_cache_context cache(cache_key_backend);
+        if (!cached && dsp_factory_cache::isActive()) {
+            // Possibly reuse the code of the same evaluated DSP
+            factory_aux = static_cast<llvm_dynamic_dsp_factory_aux*>(
+                createFactory(name_app, dsp_content, argc1, argv1, error_msg, cache));
+            if (cache.fCached) {
+                factory_aux = readDSPFactoryFromCache(cache.fProcessKey, sha_key, target);
+                reused      = (factory_aux != nullptr);
+            }
+        }
+        if (!factory_aux && error_msg == "") {
+            factory_aux = static_cast<llvm_dynamic_dsp_factory_aux*>(
+                createFactory(name_app, dsp_content, argc1, argv1, error_msg, true));
+        }
+        LOCK_API
+        // The same DSP may have been compiled by another thread in the meantime
+        if (factory_aux && llvm_dsp_factory_aux::gLLVMFactoryTable.getFactory(sha_key, it)) {
+            delete factory_aux;
+            SDsp_factory sfactory = (*it).first;
+            sfactory->addReference();
+            return sfactory;
+        }
+        if (factory_aux && (cached || reused || factory_aux->initJIT(error_msg))) {
+            if (!cached && dsp_factory_cache::isActive()) {
+                vector<string> parts = {factory_aux->writeDSPFactoryToMachine("")};
+                dsp_factory_cache::write(cache_key, parts, cache.fLibraries);
+                if (!reused && cache.fProcessKey != "") {
+                    dsp_factory_cache::write(cache.fProcessKey, parts);
                 }
-            } catch (faustexception& e) {
-                error_msg = e.what();
-                return nullptr;
             }
+            factory_aux->setTarget(target);
+            factory_aux->setOptlevel(opt_level);
+            factory_aux->setClassName(getParam(argc, argv, "-cn", "mydsp"));
+            factory_aux->setName(name_app);
+            llvm_dsp_factory* factory = new llvm_dsp_factory(factory_aux);
+            llvm_dsp_factory_aux::gLLVMFactoryTable.setFactory(factory);
+            factory->setSHAKey(sha_key);
+            factory->setDSPCode(expanded_dsp_content);
+            return factory;
+        } else {
+            delete factory_aux;
+            return nullptr;
         }
+    } catch (faustexception& e) {
+        error_msg = e.what();
+        return nullptr;
     }
 }
 
@@ -121,9 +121,7 @@ StatementInst* OpenMPCodeContainer::generateDAGLoopOMP(const string& counter)
     // Generates the loop DAG
     lclgraph dag;
     CodeLoop::sortGraph(fCurLoop, dag);
-    int  loop_num = 0;
-    bool is_single =
-        false;  // Generates "#pragma omp single" once when we stay if a sequence of "single" loops
+    int loop_num = 0;
 
     for (int l = int(dag.size()) - 1; l >= 0; l--) {
         BlockInst* omp_sections_block = IB::genBlockInst();
@@ -134,21 +132,16 @@ StatementInst* OpenMPCodeContainer::generateDAGLoopOMP(const string& counter)
         for (const auto& p : dag[l]) {
             BlockInst* omp_section_block = IB::genBlockInst();
             if (dag[l].size() == 1) {  // Only one loop
-                if (!p->isRecursive() && gGlobal->gOpenMPLoop) {
+                if (p->isVectorizable() && gGlobal->gOpenMPLoop) {
                     generateDAGLoopAux(p, omp_section_block, count_dec->load(), loop_num++, true);
                 } else {
+                    // Each "single" loop needs its own directive, since it only applies to the
+                    // following block
                     omp_section_block->setIndent(true);
-                    if (!is_single) {
-                        omp_sections_block->pushBackInst(IB::genLabelInst("#pragma omp single"));
-                        is_single = true;
-                    } else {
-                        omp_sections_block->pushBackInst(
-                            IB::genLabelInst("/* Still in a single section */"));
-                    }
+                    omp_sections_block->pushBackInst(IB::genLabelInst("#pragma omp single"));
                     generateDAGLoopAux(p, omp_section_block, count_dec->load(), loop_num++);
                 }
             } else {
-                is_single = false;
                 omp_section_block->setIndent(true);
                 omp_sections_block->pushBackInst(IB::genLabelInst("#pragma omp section"));
                 generateDAGLoopAux(p, omp_section_block, count_dec->load(), loop_num++);
@@ -2,8 +2,8 @@
 #include <algorithm>
 #include <functional>
 
-int Vertex::input_counter  = 0;
-int Vertex::output_counter = 0;
+thread_local int Vertex::input_counter  = 0;
+thread_local int Vertex::output_counter = 0;
 
 // Retiming values for each vertex
 typedef std::vector<int> Retiming;
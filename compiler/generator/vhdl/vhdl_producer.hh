@@ -38,8 +38,8 @@ const float MASTER_CLOCK_FREQUENCY = 667000;
  * stages
  */
 struct Vertex {
-    static int input_counter;
-    static int output_counter;
+    static thread_local int input_counter;
+    static thread_local int output_counter;
     Tree       signal;
     size_t     node_hash;
     int        nature;
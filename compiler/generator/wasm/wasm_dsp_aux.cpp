@@ -598,23 +598,29 @@ LIBFAUST_API void wasm_dsp_factory::deleteDSPInstance(wasm_dsp* dsp)
 
 // Static constructor
 
-string wasm_dsp_factory::gErrorMessage = "";
+// Kept per thread so that parallel compilations do not overwrite each other's message
+static thread_local string gErrorMessage;
+
+string& getWasmErrorMessage()
+{
+    return gErrorMessage;
+}
 
 LIBFAUST_API const string& wasm_dsp_factory::getErrorMessage()
 {
-    return wasm_dsp_factory::gErrorMessage;
+    return gErrorMessage;
 }
 
 LIBFAUST_API wasm_dsp_factory* wasm_dsp_factory::readWasmDSPFactoryFromMachineFile2(
     const string& machine_code_path)
 {
-    return readWasmDSPFactoryFromMachineFile(machine_code_path, wasm_dsp_factory::gErrorMessage);
+    return readWasmDSPFactoryFromMachineFile(machine_code_path, gErrorMessage);
 }
 
 LIBFAUST_API wasm_dsp_factory* wasm_dsp_factory::readWasmDSPFactoryFromMachine2(
     const string& machine_code)
 {
-    return readWasmDSPFactoryFromMachine(machine_code, wasm_dsp_factory::gErrorMessage);
+    return readWasmDSPFactoryFromMachine(machine_code, gErrorMessage);
 }
 
 LIBFAUST_API bool wasm_dsp_factory::deleteWasmDSPFactory2(wasm_dsp_factory* factory)
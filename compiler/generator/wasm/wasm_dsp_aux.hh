@@ -415,13 +415,14 @@ class LIBFAUST_API wasm_dsp_factory : public dsp_factory, public faust_smartable
 
     static std::string extractJSON(const std::string& code);
 
-    static std::string gErrorMessage;
-
     static const std::string& getErrorMessage();
 
     static dsp_factory_table<SDsp_factory> gWasmFactoryTable;
 };
 
+// Error message of the last failing call on the current thread, used by the '2' API variants (not exported)
+std::string& getWasmErrorMessage();
+
 LIBFAUST_API bool deleteWasmDSPFactory(wasm_dsp_factory* factory);
 
 LIBFAUST_API void deleteAllWasmDSPFactories();
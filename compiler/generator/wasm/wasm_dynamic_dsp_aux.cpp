@@ -26,6 +26,7 @@
 #include "wasm_dynamic_dsp_aux.hh"
 #include "Text.hh"
 #include "compatibility.hh"
+#include "dsp_factory_cache.hh"
 
 using namespace std;
 
@@ -51,7 +52,7 @@ wasm_dsp_factory* wasm_dynamic_dsp_factory::createWasmDSPFactoryFromString2(
     argv1[argc1] = nullptr;  // NULL terminated argv
 
     return createWasmDSPFactoryFromString(name_app, dsp_content, argc1, argv1,
-                                          wasm_dsp_factory::gErrorMessage, internal_memory);
+                                          getWasmErrorMessage(), internal_memory);
 }
 
 string wasm_dynamic_dsp_factory::generateWasmFromString2(const string&         name_app,
@@ -67,7 +68,7 @@ string wasm_dynamic_dsp_factory::generateWasmFromString2(const string&         n
     argv1[argc1] = nullptr;  // NULL terminated argv
 
     return generateWasmFromString(name_app, dsp_content, argc1, argv1,
-                                  wasm_dsp_factory::gErrorMessage, internal_memory);
+                                  getWasmErrorMessage(), internal_memory);
 }
 
 // C++ API
@@ -88,6 +89,16 @@ LIBFAUST_API wasm_dsp_factory* createWasmDSPFactoryFromFile(const string& filena
     }
 }
 
+// Restore the factory from the code and helpers kept in the persistent cache
+static dsp_factory_base* readWasmDSPFactoryFromCache(const string& name_app, const string& cache_key)
+{
+    vector<string> parts;
+    if (dsp_factory_cache::read(cache_key, parts) && parts.size() == 2) {
+        return new text_dsp_factory_aux(name_app, "", "", parts[0], parts[1]);
+    }
+    return nullptr;
+}
+
 LIBFAUST_API wasm_dsp_factory* createWasmDSPFactoryFromString(const string& name_app,
                                                               const string& dsp_content, int argc,
                                                               const char* argv[], string& error_msg,
@@ -117,8 +128,35 @@ LIBFAUST_API wasm_dsp_factory* createWasmDSPFactoryFromString(const string& name
             }
             argv1[argc1] = nullptr;  // NULL terminated argv
 
-            dsp_factory_base* dsp_factory_aux =
-                createFactory(name_app, dsp_content, argc1, argv1, error_msg, true);
+            // Load the factory from the persistent cache if possible, otherwise compile and save it
+            string cache_key = dsp_factory_cache::getKey(argv1[2], sha_key);
+            dsp_factory_base* dsp_factory_aux = readWasmDSPFactoryFromCache(name_app, cache_key);
+            if (!dsp_factory_aux) {
+                // Possibly reuse the code of the same evaluated DSP
+                dsp_factory_cache_context cache(argv1[2]);
+                bool                      reused = false;
+                if (dsp_factory_cache::isActive()) {
+                    dsp_factory_aux =
+                        createFactory(name_app, dsp_content, argc1, argv1, error_msg, cache);
+                    if (cache.fCached) {
+                        dsp_factory_aux = readWasmDSPFactoryFromCache(name_app, cache.fProcessKey);
+                        reused          = (dsp_factory_aux != nullptr);
+                    }
+                }
+                if (!dsp_factory_aux && error_msg == "") {
+                    dsp_factory_aux =
+                        createFactory(name_app, dsp_content, argc1, argv1, error_msg, true);
+                }
+                if (dsp_factory_aux && dsp_factory_cache::isActive()) {
+                    stringstream helpers;
+                    dsp_factory_aux->writeHelper(&helpers);
+                    vector<string> parts = {dsp_factory_aux->getBinaryCode(), helpers.str()};
+                    dsp_factory_cache::write(cache_key, parts, cache.fLibraries);
+                    if (!reused && cache.fProcessKey != "") {
+                        dsp_factory_cache::write(cache.fProcessKey, parts);
+                    }
+                }
+            }
             if (dsp_factory_aux) {
                 dsp_factory_aux->setName(name_app);
                 wasm_dsp_factory* factory = new wasm_dsp_factory(dsp_factory_aux);
@@ -39,6 +39,7 @@
 #include "fmodprim.hh"
 #include "global.hh"
 #include "instructions.hh"
+#include "lock_api.hh"
 #include "log10prim.hh"
 #include "logprim.hh"
 #include "maxprim.hh"
@@ -126,11 +127,12 @@ using namespace std;
 extern FILE*       FAUSTin;
 extern const char* FAUSTfilename;
 
-// Garbageable globals
-list<Garbageable*> global::gObjectTable;
-bool               global::gHeapCleanup = false;
+// Garbageable globals: 'gThreadArena' is the arena owned by the thread itself
+static thread_local GarbageableArena gThreadArena;
+thread_local GarbageableArena*       global::gArena       = &gThreadArena;
+thread_local bool                    global::gHeapCleanup = false;
 
-// Just after gObjectTable initialisation for FaustAlgebra constructor to correctly work
+// Just after gArena initialisation for FaustAlgebra constructor to correctly work
 itv::interval_algebra gAlgebra;
 
 global::global()
@@ -418,6 +420,7 @@ void global::reset()
     gExpandedDefList = nullptr;
 
     gDetailsSwitch    = false;
+    gTreeStats        = false;
     gDrawSignals      = false;
     gDrawRouteFrame   = false;
     gShadowBlur       = false;  // note: svg2pdf doesn't like the blur filter
@@ -431,6 +434,7 @@ void global::reset()
     gMaxCopyDelay     = 16;    // Maximal delay too choose a copy representation
     gMaxDenseDelay    = 1024;  // Maximal delay too choose a dense representation
     gMinDensity       = 33;    // Minimal density d/100 to choose a dense representation
+    gMinBlockDelay    = INT_MAX;  // Minimal delay to choose a block ring buffer representation
 
     gVectorSwitch      = false;
     gDeepFirstSwitch   = false;
@@ -445,6 +449,8 @@ void global::reset()
     gGroupTaskSwitch = false;
     gFunTaskSwitch   = false;
 
+    gTaskCostThreshold = 0;
+
     gUIMacroSwitch = false;
     gDumpNorm      = -1;
     gFTZMode       = 0;
@@ -496,6 +502,9 @@ void global::reset()
     gOneSample            = false;
     gOneSampleControl     = false;
     gExtControl           = false;
+    gControlEvents        = false;
+    gBatchSize            = 0;
+    gInterpLanes          = false;
     gInlineTable          = false;
     gComputeMix           = false;
     gBool2Int             = false;
@@ -518,8 +527,9 @@ void global::reset()
 
     gFileNum = 0;
 
-    gBoxCounter    = 0;
-    gSignalCounter = 0;
+    gBoxCounter      = 0;
+    gSignalCounter   = 0;
+    gCodeLoopCounter = 0;
 
     gCountInferences = 0;
     gCountMaximal    = 0;
@@ -616,6 +626,7 @@ void global::init()
 
     // Essential predefined types
     gMemoizedTypes          = new property<AudioType*>();
+    gFirTypeProperty        = new property<DeclareTypeInst*>();
     gAllocationCount        = 0;
     gMaskDelayLineThreshold = INT_MAX;
 
@@ -660,8 +671,12 @@ void global::init()
     PROPAGATEPROPERTY = symbol("PropagateProperty");
 
     // FAUSTfilename is defined in errormsg.cpp but must be redefined at each compilation.
-    FAUSTfilename = "";
-    FAUSTin       = nullptr;
+    {
+        // Parser globals may be used by another compilation
+        LOCK_PARSER
+        FAUSTfilename = "";
+        FAUSTin       = nullptr;
+    }
 
     gLatexheaderfilename = "latexheader.tex";
     gDocTextsDefaultFile = "mathdoctexts-default.txt";
@@ -798,6 +813,9 @@ void global::printCompilationOptions(stringstream& dst, bool backend)
     if (gComputeMix) {
         dst << "-cm ";
     }
+    if (gInterpLanes) {
+        dst << "-il ";
+    }
     if (gInlineTable) {
         dst << "-it ";
     }
@@ -816,6 +834,12 @@ void global::printCompilationOptions(stringstream& dst, bool backend)
     if (gExtControl) {
         dst << "-ec ";
     }
+    if (gControlEvents) {
+        dst << "-cev ";
+    }
+    if (gBatchSize > 0) {
+        dst << "-bs " << gBatchSize << " ";
+    }
     dst << "-ct " << gCheckTable << " ";
     if (gMathApprox) {
         dst << "-mapp ";
@@ -857,6 +881,9 @@ void global::printCompilationOptions(stringstream& dst, bool backend)
     dst << "-mcd " << gMaxCopyDelay << " ";
     dst << "-mdd " << gMaxDenseDelay << " ";
     dst << "-mdy " << gMinDensity << " ";
+    if (gMinBlockDelay != INT_MAX) {
+        dst << "-mbd " << gMinBlockDelay << " ";
+    }
     if (gUIMacroSwitch) {
         dst << "-uim ";
     }
@@ -867,6 +894,9 @@ void global::printCompilationOptions(stringstream& dst, bool backend)
             << "-lv " << gVectorLoopVariant << " "
             << "-vs " << gVecSize << " " << ((gFunTaskSwitch) ? "-fun " : "")
             << ((gGroupTaskSwitch) ? "-g " : "") << ((gDeepFirstSwitch) ? "-dfs " : "");
+        if (gTaskCostThreshold > 0) {
+            dst << "-pct " << gTaskCostThreshold << " ";
+        }
     }
 
     // Add 'compile_options' metadata
@@ -948,7 +978,7 @@ bool global::hasForeignFunction(const string& name, const string& inc_file)
     static vector<string> inc_list = {"<math.h>", "<cmath>", "<stdlib.h>"};
     bool                  is_inc = find(begin(inc_list), end(inc_list), inc_file) != inc_list.end();
     // or custom added ones
-    bool is_ff       = llvm_dsp_factory_aux::gForeignFunctions.count(name) > 0;
+    bool is_ff       = llvm_dsp_factory_aux::isForeignFunction(name);
     bool is_linkable = (gOutputLang == "llvm") && (is_inc || is_ff);
 #else
     bool is_linkable = false;
@@ -1105,7 +1135,7 @@ bool global::isOpt(const string& opt_val)
  *****************************************************************/
 
 // Timing can be used outside of the scope of 'gGlobal'
-extern bool gTimingSwitch;
+extern thread_local bool gTimingSwitch;
 
 static bool isCmd(const char* cmd, const char* kw1)
 {
@@ -1272,6 +1302,10 @@ bool global::processCmdline(int argc, const char* argv[])
             gMinDensity = std::atoi(argv[i + 1]);
             i += 2;
 
+        } else if (isCmd(argv[i], "-mbd", "--min-block-delay") && (i + 1 < argc)) {
+            gMinBlockDelay = std::atoi(argv[i + 1]);
+            i += 2;
+
         } else if (isCmd(argv[i], "-dlt", "-delay-line-threshold") && (i + 1 < argc)) {
             gMaskDelayLineThreshold = std::atoi(argv[i + 1]);
             i += 2;
@@ -1345,6 +1379,10 @@ bool global::processCmdline(int argc, const char* argv[])
             gFunTaskSwitch = true;
             i += 1;
 
+        } else if (isCmd(argv[i], "-pct", "--parallel-cost-threshold") && (i + 1 < argc)) {
+            gTaskCostThreshold = std::atoi(argv[i + 1]);
+            i += 2;
+
         } else if (isCmd(argv[i], "-uim", "--user-interface-macros")) {
             gUIMacroSwitch = true;
             i += 1;
@@ -1357,6 +1395,10 @@ bool global::processCmdline(int argc, const char* argv[])
             gTimingSwitch = true;
             i += 1;
 
+        } else if (isCmd(argv[i], "-ts", "--tree-stats")) {
+            gTreeStats = true;
+            i += 1;
+
             // 'real' options
         } else if (isCmd(argv[i], "-single", "--single-precision-floats")) {
             if (float_size && gFloatSize != 1) {
@@ -1463,6 +1505,26 @@ bool global::processCmdline(int argc, const char* argv[])
             gExtControl = true;
             i += 1;
 
+        } else if (isCmd(argv[i], "-cev", "--control-events")) {
+            gControlEvents = true;
+            i += 1;
+
+        } else if (isCmd(argv[i], "-bs", "--batch-size") && (i + 1 < argc)) {
+            char* end;
+            long  size = strtol(argv[i + 1], &end, 10);
+            if (end == argv[i + 1] || *end != 0 || size <= 0 || size > INT_MAX) {
+                stringstream error;
+                error << "ERROR : '-bs' option must be a positive integer, got '" << argv[i + 1]
+                      << "'\n";
+                throw faustexception(error.str());
+            }
+            gBatchSize = int(size);
+            i += 2;
+
+        } else if (isCmd(argv[i], "-il", "--interp-lanes")) {
+            gInterpLanes = true;
+            i += 1;
+
         } else if (isCmd(argv[i], "-it", "--inline-table")) {
             gInlineTable = true;
             i += 1;
@@ -1660,6 +1722,30 @@ bool global::processCmdline(int argc, const char* argv[])
         throw faustexception("ERROR : '-os' option can only be used in scalar mode\n");
     }
 
+    if (gControlEvents && gOutputLang != "cpp") {
+        throw faustexception("ERROR : '-cev' option can only be used with the 'cpp' backend\n");
+    }
+
+    if (gControlEvents && (gVectorSwitch || gOneSample || gExtControl)) {
+        throw faustexception(
+            "ERROR : '-cev' option can only be used in scalar mode, without '-os' or '-ec'\n");
+    }
+
+    if (gInterpLanes && gOutputLang != "interp") {
+        throw faustexception("ERROR : '-il' option can only be used with the 'interp' backend\n");
+    }
+
+    if (gBatchSize > 0 && gOutputLang != "cpp") {
+        throw faustexception("ERROR : '-bs' option can only be used with the 'cpp' backend\n");
+    }
+
+    if (gBatchSize > 0 && (gVectorSwitch || gOneSample || gExtControl || gInlineTable ||
+                           gMemoryManager >= 0 || gFloatSize == 4)) {
+        throw faustexception(
+            "ERROR : '-bs' option can only be used in scalar mode, without '-os', '-ec', '-it', "
+            "'-mem' or '-fx'\n");
+    }
+
     if (gVectorLoopVariant < 0 || gVectorLoopVariant > 2) {
         stringstream error;
         error << "ERROR : invalid loop variant [-lv = " << gVectorLoopVariant
@@ -1674,6 +1760,13 @@ bool global::processCmdline(int argc, const char* argv[])
         throw faustexception(error.str());
     }
 
+    if (gTaskCostThreshold < 0) {
+        stringstream error;
+        error << "ERROR : invalid cost threshold [-pct = " << gTaskCostThreshold
+              << "] should be positive" << endl;
+        throw faustexception(error.str());
+    }
+
     if (gFunTaskSwitch) {
         if (!(gOutputLang == "c" || gOutputLang == "cpp" || gOutputLang == "llvm" ||
               gOutputLang == "fir")) {
@@ -1700,6 +1793,10 @@ bool global::processCmdline(int argc, const char* argv[])
             "'ocpp' backend\n");
     }
 
+    if (gMinBlockDelay < INT_MAX && !gVectorSwitch) {
+        throw faustexception("ERROR : -mbd can only be used in vector mode\n");
+    }
+
     // gInlinetable check
     if (gInlineTable && (gOutputLang != "cpp" && gOutputLang != "c")) {
         throw faustexception("ERROR : -it can only be used with 'cpp' and 'c' backends\n");
@@ -2157,6 +2254,18 @@ string global::printHelp()
     sstr << tab
          << "-ec         --external-control          separated 'control' and 'compute' functions."
          << endl;
+    sstr << tab
+         << "-cev        --control-events            generate 'computeEvents' applying sample accurate "
+            "control events inside the loop (cpp backend, scalar mode)."
+         << endl;
+    sstr << tab
+         << "-bs <n>     --batch-size <n>            generate a batch class computing <n> instances "
+            "in lockstep, with their state laid out as structure of arrays (cpp backend, scalar mode)."
+         << endl;
+    sstr << tab
+         << "-il         --interp-lanes              execute the non-recursive loops on lanes of "
+            "samples (interp backend)."
+         << endl;
     sstr << tab
          << "-it         --inline-table              inline rdtable/rwtable code in the main class."
          << endl;
@@ -2196,6 +2305,10 @@ string global::printHelp()
             "delays "
             "(ocpp only, default 33)."
          << endl;
+    sstr << tab
+         << "-mbd <n>    --min-block-delay <n>       use a block ring buffer (indexed without "
+            "wrapping) from max delay <n> (vector mode only, default INT_MAX samples)."
+         << endl;
     sstr << tab
          << "-dlt <n>    --delay-line-threshold <n>  use a mask-based ring buffer delays up to max "
             "delay <n> and a "
@@ -2291,6 +2404,11 @@ string global::printHelp()
             "(in -vec, -sch, or "
             "-omp mode)."
          << endl;
+    sstr << tab
+         << "-pct <n>    --parallel-cost-threshold <n> group loops whose estimated cost for a "
+            "block of samples is below <n> "
+            "(in -vec, -sch, or -omp mode) and print the decisions."
+         << endl;
     sstr << tab
          << "-fm <file>  --fast-math <file>          use optimized versions of mathematical "
             "functions implemented in "
@@ -2392,6 +2510,9 @@ string global::printHelp()
     sstr << tab
          << "-time       --compilation-time          display compilation phases timing information."
          << endl;
+    sstr << tab
+         << "-ts         --tree-stats                display the tree hash table statistics."
+         << endl;
     sstr << tab
          << "-flist      --file-list                 print file list (including libraries) used to "
             "eval process."
@@ -2536,61 +2657,161 @@ void global::clear()
 }
 
 // Memory management
-void Garbageable::cleanup()
+void* GarbageableArena::allocate(size_t size)
+{
+    size_t total = blockSize(size);
+    size_t index = total / kAlign;
+    char*  block;
+
+    if (index < fFreeLists.size() && fFreeLists[index]) {
+        // Reuse a deleted block of the same size
+        block             = reinterpret_cast<char*>(fFreeLists[index]);
+        fFreeLists[index] = fFreeLists[index]->fNext;
+    } else if (total > kChunkSize / 8) {
+        // Large objects get their own block
+        block = static_cast<char*>(malloc(total));
+        if (!block) throw std::bad_alloc();
+        fChunks.push_back(block);
+    } else {
+        if (fCurrent + total > fEnd) {
+            fCurrent = static_cast<char*>(malloc(kChunkSize));
+            if (!fCurrent) throw std::bad_alloc();
+            fEnd = fCurrent + kChunkSize;
+            fChunks.push_back(fCurrent);
+        }
+        block = fCurrent;
+        fCurrent += total;
+    }
+
+    Header* header = reinterpret_cast<Header*>(block);
+    header->fPrev  = nullptr;
+    header->fNext  = fObjects;
+    if (fObjects) fObjects->fPrev = header;
+    fObjects = header;
+    return object(header);
+}
+
+void GarbageableArena::unlink(void* ptr, size_t size)
 {
-    list<Garbageable*>::iterator it;
+    Header* header = reinterpret_cast<Header*>(static_cast<char*>(ptr) - kHeaderSize);
+    if (header->fPrev) {
+        header->fPrev->fNext = header->fNext;
+    } else {
+        fObjects = header->fNext;
+    }
+    if (header->fNext) header->fNext->fPrev = header->fPrev;
 
-    // Here removing the deleted pointer from the list is pointless
+    // Keep the block in the free list of its size
+    size_t index = blockSize(size) / kAlign;
+    if (index >= fFreeLists.size()) fFreeLists.resize(index + 1, nullptr);
+    header->fNext     = fFreeLists[index];
+    fFreeLists[index] = header;
+}
+
+void GarbageableArena::release()
+{
+    for (char* chunk : fChunks) {
+        free(chunk);
+    }
+    fChunks.clear();
+    fFreeLists.clear();
+    fCurrent = fEnd = nullptr;
+    fObjects        = nullptr;
+}
+
+void Garbageable::cleanup()
+{
+    // Here unlinking the deleted objects is pointless
     // and takes time, thus we don't do it.
     global::gHeapCleanup = true;
-    for (it = global::gObjectTable.begin(); it != global::gObjectTable.end(); it++) {
+    GarbageableArena::Header* next;
+    for (GarbageableArena::Header* it = global::gArena->first(); it; it = next) {
+        next = it->fNext;
 #ifdef _WIN32
         // Hack : "this" and actual pointer are not the same: destructor cannot be called...
-        Garbageable::operator delete(*it);
+        Garbageable::operator delete(GarbageableArena::object(it), 0);
 #else
-        delete (*it);
+        delete static_cast<Garbageable*>(GarbageableArena::object(it));
 #endif
     }
 
-    // Reset to default state
-    global::gObjectTable.clear();
+    // Release all memory at once and reset to default state
+    global::gArena->release();
     global::gHeapCleanup = false;
 }
 
 void* Garbageable::operator new(size_t size)
 {
-    // HACK : add 16 bytes to avoid unsolved memory smashing bug...
-    Garbageable* res = (Garbageable*)malloc(size + 16);
-    global::gObjectTable.push_front(res);
-    return res;
+    return global::gArena->allocate(size);
 }
 
-void Garbageable::operator delete(void* ptr)
+void Garbageable::operator delete(void* ptr, size_t size)
 {
     // We may have cases when a pointer will be deleted during
-    // a compilation, thus the pointer has to be removed from the list.
+    // a compilation, thus the object has to be unlinked from the arena.
     if (!global::gHeapCleanup) {
-        global::gObjectTable.remove(static_cast<Garbageable*>(ptr));
+        global::gArena->unlink(ptr, size);
     }
-    free(ptr);
 }
 
 void* Garbageable::operator new[](size_t size)
 {
-    // HACK : add 16 bytes to avoid unsolved memory smashing bug...
-    Garbageable* res = (Garbageable*)malloc(size + 16);
-    global::gObjectTable.push_front(res);
-    return res;
+    return global::gArena->allocate(size);
 }
 
-void Garbageable::operator delete[](void* ptr)
+void Garbageable::operator delete[](void* ptr, size_t size)
 {
     // We may have cases when a pointer will be deleted during
-    // a compilation, thus the pointer has to be removed from the list.
+    // a compilation, thus the object has to be unlinked from the arena.
     if (!global::gHeapCleanup) {
-        global::gObjectTable.remove(static_cast<Garbageable*>(ptr));
+        global::gArena->unlink(ptr, size);
     }
-    free(ptr);
+}
+
+// Thread-local state transfer
+extern thread_local bool gTimingSwitch;
+extern thread_local int  gTimingIndex;
+
+void ThreadState::save()
+{
+    fGlobal       = gGlobal;
+    fArena        = global::gArena;
+    fHeapCleanup  = global::gHeapCleanup;
+    CTree::saveState(*this);
+    Symbol::saveState(*this);
+    fWarningMessages = std::move(gWarningMessages);
+    fAllWarning      = gAllWarning;
+    fTimingSwitch    = gTimingSwitch;
+    fTimingIndex     = gTimingIndex;
+}
+
+void ThreadState::restore()
+{
+    gGlobal              = fGlobal;
+    global::gArena       = fArena;
+    global::gHeapCleanup = fHeapCleanup;
+    CTree::restoreState(*this);
+    Symbol::restoreState(*this);
+    gWarningMessages = std::move(fWarningMessages);
+    gAllWarning      = fAllWarning;
+    gTimingSwitch    = fTimingSwitch;
+    gTimingIndex     = fTimingIndex;
+}
+
+struct ThreadedCall {
+    threaded_fun fFun;
+    void*        fArg;
+    ThreadState  fState;
+};
+
+// Run the function with the state of the calling thread, and give the state back when done
+static void* callFunAux(void* arg)
+{
+    ThreadedCall* call = static_cast<ThreadedCall*>(arg);
+    call->fState.restore();
+    void* res = call->fFun(call->fArg);
+    call->fState.save();
+    return res;
 }
 
 // Threaded calls API
@@ -2599,9 +2820,14 @@ void callFun(threaded_fun fun, void* arg)
 #if defined(EMCC)
     // No thread support in JavaScript
     fun(arg);
-#elif defined(_WIN32)
+#else
+    ThreadedCall call;
+    call.fFun = fun;
+    call.fArg = arg;
+    call.fState.save();
+#if defined(_WIN32)
     DWORD  id;
-    HANDLE thread = CreateThread(NULL, MAX_STACK_SIZE, LPTHREAD_START_ROUTINE(fun), arg, 0, &id);
+    HANDLE thread = CreateThread(NULL, MAX_STACK_SIZE, LPTHREAD_START_ROUTINE(callFunAux), &call, 0, &id);
     faustassert(thread != NULL);
     WaitForSingleObject(thread, INFINITE);
 #else
@@ -2610,8 +2836,10 @@ void callFun(threaded_fun fun, void* arg)
     faustassert(pthread_attr_init(&attr) == 0);
     faustassert(pthread_attr_setstacksize(&attr, MAX_STACK_SIZE) == 0);
     faustassert(pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE) == 0);
-    faustassert(pthread_create(&thread, &attr, fun, arg) == 0);
+    faustassert(pthread_create(&thread, &attr, callFunAux, &call) == 0);
     faustassert(pthread_join(thread, nullptr) == 0);
     faustassert(pthread_attr_destroy(&attr) == 0);
+#endif
+    call.fState.restore();
 #endif
 }
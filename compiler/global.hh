@@ -67,6 +67,7 @@ class TemplateInstVisitor;
 class CodeboxInstVisitor;
 struct TableSizeVisitor;
 struct DeclareStructTypeInst;
+struct DeclareTypeInst;
 
 struct Typed;
 struct BasicTyped;
@@ -83,9 +84,9 @@ struct comp_str {
 typedef std::map<Tree, std::set<Tree>, comp_str> MetaDataSet;
 typedef std::map<Tree, std::set<Tree>>           FunMDSet;  // foo -> {(file/foo/key,value)...}
 
-// Global outside of the global context
-extern std::vector<std::string> gWarningMessages;
-extern bool                     gAllWarning;
+// Global outside of the global context (thread-local, see ThreadState)
+extern thread_local std::vector<std::string> gWarningMessages;
+extern thread_local bool                     gAllWarning;
 
 // Global singleton like compiler state
 struct global {
@@ -123,6 +124,7 @@ struct global {
 
     // compilation options
     bool        gDetailsSwitch;   // -d option
+    bool        gTreeStats;       // -ts option
     bool        gDrawSignals;     // -sg option
     bool        gDrawRouteFrame;  // -drf option
     bool        gShadowBlur;      // -blur option, note: svg2pdf doesn't like the blur filter
@@ -162,9 +164,11 @@ struct global {
     bool gCUDASwitch;         // -cuda option
     bool gGroupTaskSwitch;    // -g option
     bool gFunTaskSwitch;      // -fun option
+    int  gTaskCostThreshold;  // -pct option
     int  gMaxCopyDelay;       // -mcd threshold
     int  gMaxDenseDelay;      // -mdd threshold
     int  gMinDensity;         // -mdy threshold
+    int  gMinBlockDelay;      // -mbd threshold
     int  gFloatSize;  // -single/double/quad/fx option (1 for 'float', 2 for 'double', 3 for 'quad',
                       // 4 for 'fixed-point')
     int  gFixedPointSize;          // -fx-size (-1 by default = not used)
@@ -229,6 +233,9 @@ struct global {
     bool gOneSampleControl;  // -osX options, generate one sample computation control structure in
                              // DSP module
     int  gExtControl;        // separated 'control' and 'compute' functions
+    bool gControlEvents;     // -cev option, generate 'computeEvents' with sample accurate control events
+    int  gBatchSize;         // -bs option, generate a batch class computing several instances in lockstep
+    bool gInterpLanes;       // -il option, execute the non-recursive loops on lanes of samples (interp)
     bool gInlineTable;  // -it option, only in -cpp backend, to inline rdtable/rwtable code in the
                         // main class.
     bool        gComputeMix;         // -cm option, mix in outputs buffers
@@ -299,6 +306,9 @@ struct global {
     // To keep the signal tree traversing trace
     std::vector<std::string> gSignalTrace;
 
+    // Creation number of the CodeLoop objects, to order them independently of their address
+    int gCodeLoopCounter;
+
     // Typing
     int gCountInferences;
     int gCountMaximal;
@@ -437,6 +447,9 @@ struct global {
     // Memoized type contruction
     property<AudioType*>* gMemoizedTypes;
 
+    // Shared FIR types
+    property<DeclareTypeInst*>* gFirTypeProperty;
+
     // Symbols
     Sym UIFOLDER;
     Sym UIWIDGET;
@@ -615,9 +628,9 @@ struct global {
 
     int gTimeout;  // Time out to abort compiler (in seconds)
 
-    // Garbage collection
-    static std::list<Garbageable*> gObjectTable;
-    static bool                    gHeapCleanup;
+    // Garbage collection: the arena of the calling thread, shared with the threads started by 'callFun'
+    static thread_local GarbageableArena* gArena;
+    static thread_local bool              gHeapCleanup;
 
     ZoneArray* gIntZone;   // array of 'int32' intermediate zone values
     ZoneArray* gRealZone;  // array of 'real' intermediate zone values
@@ -704,8 +717,9 @@ struct global {
     void printDirectories();
 };
 
-// Unique shared global pointer
-extern global* gGlobal;
+// Global pointer on the compiler state of the current thread:
+// several compilations can be done in parallel on different threads
+extern thread_local global* gGlobal;
 
 #define FAUST_LIB_PATH "FAUST_LIB_PATH"
 #define MAX_MACHINE_STACK_SIZE 65536 * 16
@@ -713,21 +727,47 @@ extern global* gGlobal;
 
 #define MAX_ERROR_SIZE 192
 
+// Thread-local compiler state, transferred by 'callFun' from the calling thread
+// to the started thread, then back when it ends
+struct ThreadState {
+    global*                   fGlobal;
+    GarbageableArena*         fArena;
+    bool                      fHeapCleanup;
+    TreeHashTable*            fTreeTable;
+    size_t                    fTreeSerialCounter;
+    unsigned int              fTreeVisitTime;
+    bool                      fTreeDetails;
+    Symbol**                  fSymbolTable;
+    std::map<const char*, unsigned int> fSymbolPrefixCounters;
+    std::vector<std::string>  fWarningMessages;
+    bool                      fAllWarning;
+    bool                      fTimingSwitch;
+    int                       fTimingIndex;
+
+    // Move the state of the current thread in the object
+    void save();
+    // Move the object in the state of the current thread
+    void restore();
+};
+
 // Threaded calls API
 typedef void* (*threaded_fun)(void* arg);
 void callFun(threaded_fun fun, void* arg);
 
+struct dsp_factory_cache_context;
+
 // Used to pass parameters and possibly return a result
 struct CallContext {
-    std::string  fNameApp    = "";
-    std::string  fDSPContent = "";
-    int          fArgc       = 0;
-    const char** fArgv       = nullptr;
-    bool         fGenerate   = false;
-    int          fNumInputs  = -1;
-    int          fNumOutputs = -1;
-    Tree         fTree       = nullptr;  // Used for in/out
-    std::string  fRes        = "";       // Used for out
+    std::string                fNameApp    = "";
+    std::string                fDSPContent = "";
+    int                        fArgc       = 0;
+    const char**               fArgv       = nullptr;
+    bool                       fGenerate   = false;
+    int                        fNumInputs  = -1;
+    int                        fNumOutputs = -1;
+    Tree                       fTree       = nullptr;  // Used for in/out
+    std::string                fRes        = "";       // Used for out
+    dsp_factory_cache_context* fCache      = nullptr;  // Used for in/out
 };
 
 #endif
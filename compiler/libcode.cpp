@@ -40,6 +40,7 @@
 #include "description.hh"
 #include "doc.hh"
 #include "drawschema.hh"
+#include "dsp_factory_cache.hh"
 #include "enrobage.hh"
 #include "errormsg.hh"
 #include "eval.hh"
@@ -145,23 +146,23 @@ using namespace std;
  *****************************************************************/
 
 // File handling
-static unique_ptr<ifstream> gEnrobage;
-static unique_ptr<ostream>  gHelpers;
-static unique_ptr<ostream>  gDst;
-static string               gOutpath;
-static bool                 gUseCout = false;
+static thread_local unique_ptr<ifstream> gEnrobage;
+static thread_local unique_ptr<ostream>  gHelpers;
+static thread_local unique_ptr<ostream>  gDst;
+static thread_local string               gOutpath;
+static thread_local bool                 gUseCout = false;
 
 // Old CPP compiler
 #ifdef OCPP_BUILD
-static Compiler* gOldComp = nullptr;
+static thread_local Compiler* gOldComp = nullptr;
 #endif
 
 // FIR container
-static InstructionsCompiler* gNewComp   = nullptr;
-static CodeContainer*        gContainer = nullptr;
+static thread_local InstructionsCompiler* gNewComp   = nullptr;
+static thread_local CodeContainer*        gContainer = nullptr;
 
-// Shared compilation context
-global* gGlobal = nullptr;
+// Compilation context of the current thread
+thread_local global* gGlobal = nullptr;
 
 string reorganizeCompilationOptions(int argc, const char* argv[]);
 
@@ -217,7 +218,10 @@ static bool openOutfile()
     } else if (gGlobal->gOutputFile != "") {
         gOutpath = (gGlobal->gOutputDir != "") ? (gGlobal->gOutputDir + "/" + gGlobal->gOutputFile)
                                                : gGlobal->gOutputFile;
-        unique_ptr<ofstream> fdst = unique_ptr<ofstream>(new ofstream(gOutpath.c_str()));
+        // The interp and llvm backends write a binary factory in output files
+        bool binary = (gGlobal->gOutputLang == "interp") || (gGlobal->gOutputLang == "llvm");
+        unique_ptr<ofstream> fdst = unique_ptr<ofstream>(
+            new ofstream(gOutpath.c_str(), binary ? (ios::out | ios::binary) : ios::out));
         if (!fdst->is_open()) {
             stringstream error;
             error << "ERROR : file '" << gOutpath << "' cannot be opened\n";
@@ -1350,6 +1354,22 @@ static void* createFactoryAux1(void* arg)
             return nullptr;
         }
 
+        /****************************************************************
+         3.2 - possibly reuse the code of the same evaluated DSP kept in the cache
+         *****************************************************************/
+        dsp_factory_cache_context* cache = context->fCache;
+        if (cache) {
+            stringstream expanded;
+            expandDSPInternalAux(processTree, argc, argv, expanded);
+            cache->fProcessKey =
+                dsp_factory_cache::getKey(cache->fBackend, generateSHA1(name_app + expanded.str()));
+            cache->fLibraries = gGlobal->gReader.listLibraryFiles();
+            if (dsp_factory_cache::contains(cache->fProcessKey)) {
+                cache->fCached = true;
+                return nullptr;
+            }
+        }
+
         /****************************************************************
          4 - compute output signals of 'process'
         *****************************************************************/
@@ -1376,6 +1396,10 @@ static void* createFactoryAux1(void* arg)
         *****************************************************************/
         generateOutputFiles();
 
+        if (gGlobal->gTreeStats) {
+            CTree::printStats(cerr);
+        }
+
         return nullptr;
 
     } catch (faustexception& e) {
@@ -1438,6 +1462,10 @@ static void* createFactoryAux2(void* arg)
         gGlobal->gMetaDataSet[tree("name")].insert(tree(quote(name_app)));
         generateCode(signals2, numInputs, numOutputs, generate);
 
+        if (gGlobal->gTreeStats) {
+            CTree::printStats(cerr);
+        }
+
         return nullptr;
 
     } catch (faustexception& e) {
@@ -1471,6 +1499,29 @@ dsp_factory_base* createFactory(const string& name_app, const string& dsp_conten
     return factory;
 }
 
+dsp_factory_base* createFactory(const string& name_app, const string& dsp_content, int argc,
+                                const char* argv[], string& error_msg,
+                                dsp_factory_cache_context& cache)
+{
+    gGlobal = nullptr;
+    global::allocate();
+
+    // Threaded call
+    CallContext context;
+    context.fNameApp    = name_app;
+    context.fDSPContent = dsp_content;
+    context.fArgc       = argc;
+    context.fArgv       = argv;
+    context.fGenerate   = true;
+    context.fCache      = &cache;
+    callFun(createFactoryAux1, &context);
+    dsp_factory_base* factory = gGlobal->gDSPFactory;
+    error_msg                 = gGlobal->gErrorMessage;
+
+    global::destroy();
+    return factory;
+}
+
 dsp_factory_base* createFactory(const string& name_app, tvec signals, int argc, const char* argv[],
                                 string& error_msg)
 {
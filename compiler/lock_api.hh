@@ -23,8 +23,12 @@
 #include "faust/export.h"
 
 extern TLockAble* gDSPFactoriesLock;
+extern TLockAble* gDSPParserLock;
 
 #define LOCK_API TLock lock(gDSPFactoriesLock);
 
+// The flex/bison parser is not reentrant, so concurrent compilations have to be serialized while parsing
+#define LOCK_PARSER TLock parser_lock(gDSPParserLock);
+
 extern "C" LIBFAUST_API bool startMTDSPFactories();
 extern "C" LIBFAUST_API void stopMTDSPFactories();
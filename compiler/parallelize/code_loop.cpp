@@ -19,6 +19,7 @@
  ************************************************************************
  ************************************************************************/
 
+#include <algorithm>
 #include <list>
 #include <map>
 #include <set>
@@ -29,6 +30,7 @@
 #include "fir_to_fir.hh"
 #include "floats.hh"
 #include "global.hh"
+#include "instructions_complexity.hh"
 
 using namespace std;
 
@@ -58,6 +60,22 @@ ForLoopInst* CodeLoop::generateScalarLoop(const string& counter, bool loop_var_i
     return static_cast<ForLoopInst*>(loop->clone(&cloner));
 }
 
+ForLoopInst* CodeLoop::generateScalarSubLoop(const string& start, const string& end)
+{
+    DeclareVarInst* loop_decl =
+        IB::genDecLoopVar(fLoopIndex, IB::genInt32Typed(), IB::genLoadStackVar(start));
+
+    ValueInst*    loop_end       = IB::genLessThan(loop_decl->load(), IB::genLoadStackVar(end));
+    StoreVarInst* loop_increment = loop_decl->store(IB::genAdd(loop_decl->load(), 1));
+
+    BlockInst*   block = generateOneSample();
+    ForLoopInst* loop =
+        IB::genForLoopInst(loop_decl, loop_end, loop_increment, block, fIsRecursive);
+
+    BasicCloneVisitor cloner;
+    return static_cast<ForLoopInst*>(loop->clone(&cloner));
+}
+
 ForLoopInst* CodeLoop::generateFixedScalarLoop()
 {
     DeclareVarInst* loop_decl =
@@ -234,6 +252,54 @@ void CodeLoop::concat(CodeLoop* l)
     fBackwardLoopDependencies = l->fBackwardLoopDependencies;
 }
 
+/**
+ * Merge a loop which is independent of this one (typically found at the same level
+ * in the sorted graph): it is computed first as an extra loop.
+ * @param l the Loop to be merged
+ */
+void CodeLoop::merge(CodeLoop* l)
+{
+    fExtraLoops.push_back(l);
+    fBackwardLoopDependencies.insert(l->fBackwardLoopDependencies.begin(),
+                                     l->fBackwardLoopDependencies.end());
+}
+
+/**
+ * Estimate the cost of one iteration of the loop, pre and post code being
+ * amortized on the vector size.
+ */
+int CodeLoop::getCost()
+{
+    // Code is not typed since the DAG variables (like 'vsize') are not yet declared
+    InstComplexityVisitor compute(false);
+    fComputeInst->accept(&compute);
+    InstComplexityVisitor pre_post(false);
+    fPreInst->accept(&pre_post);
+    fPostInst->accept(&pre_post);
+
+    int cost = compute.cost() + pre_post.cost() / gGlobal->gVecSize;
+    for (const auto& s : fExtraLoops) {
+        cost += s->getCost();
+    }
+    return cost;
+}
+
+/**
+ * A loop is vectorizable when the loop itself and all its extra loops are not recursive.
+ */
+bool CodeLoop::isVectorizable()
+{
+    if (fIsRecursive) {
+        return false;
+    }
+    for (const auto& s : fExtraLoops) {
+        if (!s->isVectorizable()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 // Graph sorting
 
 void CodeLoop::setOrder(CodeLoop* l, int order, lclgraph& V)
@@ -338,3 +404,117 @@ void CodeLoop::groupSeqLoops(CodeLoop* l, set<CodeLoop*>& visited)
         }
     }
 }
+
+static void collectLoops(CodeLoop* l, set<CodeLoop*>& loops)
+{
+    if (loops.find(l) == loops.end()) {
+        loops.insert(l);
+        for (const auto& p : l->getBackwardLoopDependencies()) {
+            collectLoops(p, loops);
+        }
+    }
+}
+
+/**
+ * Cost model used to reduce the tasks overhead (in -vec, -omp and -sch modes):
+ * in each level of the sorted graph, loops whose cost for a block of gVecSize samples
+ * is below 'threshold' are packed together in loops of at least 'threshold' cost, a remaining
+ * cheaper one being attached to the cheapest loop of the level. Independent loops of a same
+ * level stay parallel tasks. Recursive loops keep being computed as scalar loops, and non
+ * recursive ones as vectorizable loops. Decisions are described on 'report' when not null.
+ */
+void CodeLoop::groupCheapLoops(CodeLoop* root, int threshold, ostream* report)
+{
+    lclgraph                  V;
+    set<CodeLoop*>            loops;
+    map<CodeLoop*, CodeLoop*> merged;
+    sortGraph(root, V);
+    collectLoops(root, loops);
+
+    if (report) {
+        *report << "Parallel cost model : threshold = " << threshold << " per block of "
+                << gGlobal->gVecSize << " samples" << endl;
+    }
+
+    // Loops of a level are ordered by cost, then by creation number, and not by address,
+    // so that the grouping and thus the generated code are reproducible
+    auto less_cost = [](const pair<int, CodeLoop*>& a, const pair<int, CodeLoop*>& b) {
+        return (a.first != b.first) ? (a.first < b.first) : (a.second->fNum < b.second->fNum);
+    };
+
+    for (int l = int(V.size()) - 1; l >= 0; l--) {
+        vector<CodeLoop*> level(V[l].begin(), V[l].end());
+        sort(level.begin(), level.end(), [](CodeLoop* a, CodeLoop* b) { return a->fNum < b->fNum; });
+        vector<pair<int, CodeLoop*>> cheap, groups;
+        for (const auto& p : level) {
+            int cost = p->getCost() * gGlobal->gVecSize;
+            if (cost < threshold) {
+                cheap.push_back(make_pair(cost, p));
+            } else {
+                groups.push_back(make_pair(cost, p));
+            }
+        }
+        if (cheap.size() == 0 || V[l].size() < 2) {
+            continue;
+        }
+
+        // Pack cheap loops until the threshold is reached
+        size_t first = groups.size();
+        for (const auto& it : cheap) {
+            if (groups.size() == first || groups.back().first >= threshold) {
+                groups.push_back(it);
+            } else {
+                groups.back().second->merge(it.second);
+                groups.back().first += it.first;
+                merged[it.second] = groups.back().second;
+            }
+        }
+
+        // Still too cheap to be a task: computed with the cheapest other one
+        if (groups.back().first < threshold && groups.size() > 1) {
+            pair<int, CodeLoop*> last = groups.back();
+            groups.pop_back();
+            auto target = min_element(groups.begin(), groups.end(), less_cost);
+            target->second->merge(last.second);
+            target->first += last.first;
+            merged[last.second] = target->second;
+        }
+
+        if (report) {
+            *report << cheap.size() << " loop(s) below threshold grouped, " << V[l].size()
+                    << " loop(s) computed as " << groups.size() << " task(s)" << endl;
+        }
+    }
+
+    // Redirect dependencies on merged loops to the loop that now computes them
+    for (const auto& p : loops) {
+        if (merged.find(p) == merged.end()) {
+            set<CodeLoop*> deps;
+            for (const auto& d : p->fBackwardLoopDependencies) {
+                CodeLoop* target = d;
+                while (merged.find(target) != merged.end()) {
+                    target = merged[target];
+                }
+                deps.insert(target);
+            }
+            p->fBackwardLoopDependencies = deps;
+        }
+    }
+
+    // Report the final schedule, loops being numbered as in the generated code
+    if (report) {
+        sortGraph(root, V);
+        int loop_num = 0;
+        for (int l = int(V.size()) - 1; l >= 0; l--) {
+            for (const auto& p : V[l]) {
+                *report << "Loop " << loop_num++ << " : "
+                        << ((p->isVectorizable()) ? "vectorizable" : "recursive (scalar)")
+                        << ", cost " << p->getCost() * gGlobal->gVecSize;
+                if (p->fExtraLoops.size() > 0) {
+                    *report << " (" << p->fExtraLoops.size() + 1 << " grouped loops)";
+                }
+                *report << ((V[l].size() > 1) ? ", parallel task" : ", sequential") << endl;
+            }
+        }
+    }
+}
@@ -69,6 +69,7 @@ class CodeLoop : public virtual Garbageable {
     int             fSize;           ///< number of iterations of the loop
     int             fOrder;          ///< used during topological sort
     int             fIndex;
+    const int       fNum;            ///< creation number, gives a deterministic order
 
     BlockInst* fPreInst;
     BlockInst* fComputeInst;
@@ -94,6 +95,7 @@ class CodeLoop : public virtual Garbageable {
 
     void absorb(CodeLoop* l);  ///< absorb a loop inside this one
     void concat(CodeLoop* l);
+    void merge(CodeLoop* l);  ///< merge an independent loop as an extra loop of this one
 
     // Graph sorting
     static void setOrder(CodeLoop* l, int order, lclgraph& V);
@@ -109,6 +111,7 @@ class CodeLoop : public virtual Garbageable {
           fSize(size),
           fOrder(-1),
           fIndex(-1),
+          fNum(gGlobal->gCodeLoopCounter++),
           fPreInst(new BlockInst()),
           fComputeInst(new BlockInst()),
           fPostInst(new BlockInst()),
@@ -125,6 +128,7 @@ class CodeLoop : public virtual Garbageable {
           fSize(size),
           fOrder(-1),
           fIndex(-1),
+          fNum(gGlobal->gCodeLoopCounter++),
           fPreInst(new BlockInst()),
           fComputeInst(new BlockInst()),
           fPostInst(new BlockInst()),
@@ -150,6 +154,7 @@ class CodeLoop : public virtual Garbageable {
     }
 
     bool isRecursive() { return fIsRecursive; }
+    bool isVectorizable();
 
     int getIndex() { return fIndex; }
 
@@ -160,6 +165,9 @@ class CodeLoop : public virtual Garbageable {
 
     ForLoopInst* generateScalarLoop(const std::string& counter, bool loop_var_in_bytes = false);
 
+    // For -cev : loop on the [start, end) sub-block, bounds being local variables
+    ForLoopInst* generateScalarSubLoop(const std::string& start, const std::string& end);
+
     // For SYFALA : loop with a fixed size (known at compile time)
     ForLoopInst* generateFixedScalarLoop();
 
@@ -185,9 +193,13 @@ class CodeLoop : public virtual Garbageable {
     bool hasRecDependencyIn(Tree S);  ///< returns true is this loop has recursive dependencies
     void addBackwardDependency(CodeLoop* ls) { fBackwardLoopDependencies.insert(ls); }
 
+    // Estimated cost of one iteration of the loop (including extra loops)
+    int getCost();
+
     static void sortGraph(CodeLoop* root, lclgraph& V);
     static void computeUseCount(CodeLoop* l);
     static void groupSeqLoops(CodeLoop* l, std::set<CodeLoop*>& visited);
+    static void groupCheapLoops(CodeLoop* root, int threshold, std::ostream* report);
 };
 
 #endif
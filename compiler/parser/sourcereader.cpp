@@ -46,6 +46,7 @@
 #include "ppbox.hh"
 #include "exception.hh"
 #include "global.hh"
+#include "lock_api.hh"
 #include "Text.hh"
 
 using namespace std;
@@ -216,6 +217,7 @@ inline bool isFILE(const char* name) { return strstr(name, "file://") != 0; }
 
 Tree SourceReader::parseFile(const char* fname)
 {
+    LOCK_PARSER
     FAUSTerr = 0;
     FAUSTlineno = 1;
     FAUSTfilename = fname;
@@ -299,6 +301,7 @@ Tree SourceReader::parseFile(const char* fname)
 
 Tree SourceReader::parseString(const char* fname)
 {
+    LOCK_PARSER
     FAUSTerr = 0;
     FAUSTlineno = 1;
     FAUSTfilename = fname;
@@ -137,35 +137,33 @@ static int position(Tree env, Tree t, int p)
 
 //-----------------------------------list recursive symbols-----------------------
 /**
- * Return the set of recursive symbols appearing in a signal.
+ * Collect the recursive symbols appearing in a signal.
  * @param sig the signal to analyze
- * @return the set of symbols
+ * @param visited the already visited signals
+ * @param symbols the set of symbols
  */
-static Tree symlistVisit(Tree sig, set<Tree>& visited)
+static void symlistVisit(Tree sig, set<Tree>& visited, set<Tree>& symbols)
 {
     Tree S;
 
     if (gGlobal->gSymListProp->get(sig, S)) {
-        return S;
-    } else if (visited.count(sig) > 0) {
-        return gGlobal->nil;
-    } else {
+        for (; !isNil(S); S = tl(S)) {
+            symbols.insert(hd(S));
+        }
+    } else if (visited.count(sig) == 0) {
         visited.insert(sig);
         Tree id, body;
         if (isRec(sig, id, body)) {
-            Tree U = singleton(sig);
-            for (int i = 0; i < len(body); i++) {
-                U = setUnion(U, symlistVisit(nth(body, i), visited));
+            symbols.insert(sig);
+            for (Tree l = body; isList(l); l = tl(l)) {
+                symlistVisit(hd(l), visited, symbols);
             }
-            return U;
         } else {
             tvec subsigs;
             int  n = getSubSignals(sig, subsigs, true);  // tables have to be visited also
-            Tree U = gGlobal->nil;
             for (int i = 0; i < n; i++) {
-                U = setUnion(U, symlistVisit(subsigs[i], visited));
+                symlistVisit(subsigs[i], visited, symbols);
             }
-            return U;
         }
     }
 }
@@ -180,8 +178,14 @@ Tree symlist(Tree sig)
     Tree S;
 
     if (!gGlobal->gSymListProp->get(sig, S)) {
-        set<Tree> visited;
-        S = symlistVisit(sig, visited);
+        // Symbols are collected in a std::set then converted in a list sorted like 'setUnion' does,
+        // since merging the lists of all subsignals is quadratic in the number of symbols
+        set<Tree> visited, symbols;
+        symlistVisit(sig, visited, symbols);
+        S = gGlobal->nil;
+        for (auto it = symbols.rbegin(); it != symbols.rend(); it++) {
+            S = cons(*it, S);
+        }
         gGlobal->gSymListProp->set(sig, S);
     }
     // cerr << "SYMLIST " << *S << " OF " << ppsig(sig) << endl;
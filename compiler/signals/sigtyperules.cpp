@@ -24,6 +24,8 @@
 #include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <set>
 
 #include "exception.hh"
 #include "global.hh"
@@ -34,6 +36,7 @@
 #include "sigprint.hh"
 #include "sigtype.hh"
 #include "sigtyperules.hh"
+#include "timing.hh"
 #include "tlib.hh"
 #include "xtended.hh"
 
@@ -179,11 +182,13 @@ static interval arithmetic(int opcode, const interval& x, const interval& y)
  * @param vdef definitions of all the recursive signal groups (vector of _lists_)
  * @param vdefSizes number of signals in each recursive signal groups
  * @param vtype types of the recursive signals
+ * @param vtyped already typed recursive signal groups used by the definitions
  * @param inter if set to false, the interval of the new type is the union of the old one and the
  * computed one, otherwise it is the intersection
  */
 static void updateRecTypes(vector<Tree>& vrec, const vector<Tree>& vdef,
-                           const vector<int>& vdefSizes, vector<Type>& vtype, const bool inter)
+                           const vector<int>& vdefSizes, vector<Type>& vtype,
+                           const vector<Tree>& vtyped, const bool inter)
 {
     Type         newType;
     vector<Type> newTuplet;
@@ -202,6 +207,11 @@ static void updateRecTypes(vector<Tree>& vrec, const vector<Tree>& vdef,
         vrec[i]->setVisited();
     }
 
+    // the already typed groups keep their type
+    for (const auto& rec : vtyped) {
+        rec->setVisited();
+    }
+
     // cerr << "compute recursive types" << endl;
     for (int i = 0; i < n; i++) {
         newType = T(vdef[i], gGlobal->NULLTYPEENV);
@@ -222,22 +232,92 @@ static void updateRecTypes(vector<Tree>& vrec, const vector<Tree>& vdef,
 }
 
 /**
- * Fully annotate every subtree of term with type information.
- * @param sig the signal term tree to annotate
- * @param causality when true check causality issues
+ * Collect the recursive signal groups directly used by a signal (that is not through other groups).
+ * @param sig the signal to analyze
+ * @param visited the already visited signals
+ * @param deps the set of recursive signal groups
  */
-void typeAnnotation(Tree sig, bool causality)
+static void recDependencies(Tree sig, set<Tree>& visited, set<Tree>& deps)
 {
-    gGlobal->gCausality = causality;
-    Tree sl             = symlist(sig);
-    int  n              = len(sl);
+    if (visited.count(sig) == 0) {
+        visited.insert(sig);
+        Tree id, body;
+        if (isRec(sig, id, body)) {
+            deps.insert(sig);
+        } else {
+            tvec subsigs;
+            int  n = getSubSignals(sig, subsigs, true);  // tables have to be visited also
+            for (int i = 0; i < n; i++) {
+                recDependencies(subsigs[i], visited, deps);
+            }
+        }
+    }
+}
+
+/**
+ * Tarjan's algorithm: the strongly connected components of the graph of the recursive signal
+ * groups, each one being added to 'components' after the ones it depends on.
+ */
+struct RecComponents {
+    const vector<vector<int>>& fDeps;
+    vector<int>                fIndex;
+    vector<int>                fLowLink;
+    vector<bool>               fOnStack;
+    vector<int>                fStack;
+    vector<vector<int>>        fComponents;
+    int                        fCounter = 0;
+
+    RecComponents(const vector<vector<int>>& deps)
+        : fDeps(deps), fIndex(deps.size(), -1), fLowLink(deps.size(), 0), fOnStack(deps.size(), false)
+    {
+        for (int i = 0; i < int(deps.size()); i++) {
+            if (fIndex[i] < 0) {
+                visit(i);
+            }
+        }
+    }
+
+    void visit(int i)
+    {
+        fIndex[i] = fLowLink[i] = fCounter++;
+        fStack.push_back(i);
+        fOnStack[i] = true;
+        for (int j : fDeps[i]) {
+            if (fIndex[j] < 0) {
+                visit(j);
+                fLowLink[i] = std::min(fLowLink[i], fLowLink[j]);
+            } else if (fOnStack[j]) {
+                fLowLink[i] = std::min(fLowLink[i], fIndex[j]);
+            }
+        }
+        if (fLowLink[i] == fIndex[i]) {
+            vector<int> component;
+            int         j;
+            do {
+                j = fStack.back();
+                fStack.pop_back();
+                fOnStack[j] = false;
+                component.push_back(j);
+            } while (j != i);
+            fComponents.push_back(component);
+        }
+    }
+};
 
-    int  size;
-    bool finished = false;
+/**
+ * Compute the types of mutually dependent recursive signal groups, as the least fixpoint of
+ * their definitions, the types of the groups they use being already known.
+ * @param vrec array of the recursive signal groups
+ * @param vdef definitions of the recursive signal groups (vector of _lists_)
+ * @param vdefSizes number of signals for each group
+ * @param vtyped already typed recursive signal groups used by the definitions
+ */
+static void typeRecGroups(vector<Tree>& vrec, const vector<Tree>& vdef,
+                          const vector<int>& vdefSizes, const vector<Tree>& vtyped)
+{
+    const int n        = vrec.size();
+    bool      finished = false;
 
-    vector<Tree> vrec;       ///< array of all the recursive signal groups
-    vector<Tree> vdef;       ///< definitions of all the recursive signal groups (vector of _lists_)
-    vector<int>  vdefSizes;  ///< number of signals for each group
     vector<Type> vtype;      ///< type of the recursive signals
     vector<Type> vtypeUp;    ///< an upperbound of the recursive signals type
     vector<TupletType> vUp;  ///< the unfolded version of the variable above
@@ -252,37 +332,17 @@ void typeAnnotation(Tree sig, bool causality)
     interval     newI(NAN, NAN);
     interval     oldI(NAN, NAN);
 
-    // cerr << "Symlist " << *sl << endl;
-    for (Tree l = sl; isList(l); l = tl(l)) {
-        Tree id, body;
-        faustassert(isRec(hd(l), id, body));
-        if (!isRec(hd(l), id, body)) {
-            continue;
-        }
-        vrec.push_back(hd(l));
-        vdef.push_back(body);
-
-        size = len(body);
-        vdefSizes.push_back(size);
-        vAgeMin.push_back(vector<int>(size, 0));
-        vAgeMax.push_back(vector<int>(size, 0));
-    }
-
     // init recursive types
     for (int i = 0; i < n; i++) {
         vtypeUp.push_back(maximalRecType(vdef[i]));
         vtype.push_back(initialRecType(vdef[i]));
+        vAgeMin.push_back(vector<int>(vdefSizes[i], 0));
+        vAgeMax.push_back(vector<int>(vdefSizes[i], 0));
     }
 
-    faustassert(int(vrec.size()) == n);
-    faustassert(int(vdef.size()) == n);
-    faustassert(int(vtype.size()) == n);
-    faustassert((int)vAgeMin.size() == n);
-    faustassert((int)vAgeMax.size() == n);
-
     // cerr << "compute upper bounds for recursive types" << endl;
     for (int k = 0; k < gGlobal->gNarrowingLimit; k++) {
-        updateRecTypes(vrec, vdef, vdefSizes, vtypeUp, true);
+        updateRecTypes(vrec, vdef, vdefSizes, vtypeUp, vtyped, true);
     }
 
     for (const auto& ty : vtypeUp) {
@@ -291,7 +351,7 @@ void typeAnnotation(Tree sig, bool causality)
 
     // cerr << "find an upperbound of the least fixpoint" << endl;
     while (!finished) {
-        updateRecTypes(vrec, vdef, vdefSizes, vtype, false);
+        updateRecTypes(vrec, vdef, vdefSizes, vtype, vtyped, false);
 
         // check finished
         finished = true;
@@ -336,8 +396,92 @@ void typeAnnotation(Tree sig, bool causality)
             }
         }
     }
-    // type full term
+}
+
+/**
+ * Fully annotate every subtree of term with type information.
+ * The recursive signal groups are partitioned in strongly connected components, each one being
+ * typed as a separated fixpoint once the components it depends on have been typed, so that the
+ * fixpoint iterations only type the definitions which are still changing.
+ * @param sig the signal term tree to annotate
+ * @param causality when true check causality issues
+ */
+void typeAnnotation(Tree sig, bool causality)
+{
+    gGlobal->gCausality = causality;
+
+    startTiming("recursive groups");
+    Tree sl = symlist(sig);
+    int  n  = len(sl);
+
+    vector<Tree>   vrec;       ///< array of all the recursive signal groups
+    vector<Tree>   vdef;       ///< definitions of all the recursive signal groups (vector of _lists_)
+    vector<int>    vdefSizes;  ///< number of signals for each group
+    map<Tree, int> vindex;     ///< index of each recursive signal group
+
+    // cerr << "Symlist " << *sl << endl;
+    for (Tree l = sl; isList(l); l = tl(l)) {
+        Tree id, body;
+        faustassert(isRec(hd(l), id, body));
+        if (!isRec(hd(l), id, body)) {
+            continue;
+        }
+        vindex[hd(l)] = int(vrec.size());
+        vrec.push_back(hd(l));
+        vdef.push_back(body);
+        vdefSizes.push_back(len(body));
+    }
+
+    faustassert(int(vrec.size()) == n);
+    faustassert(int(vdef.size()) == n);
+
+    // the groups directly used by each group definition
+    vector<vector<int>> vdeps(n);
+    for (int i = 0; i < n; i++) {
+        set<Tree> visited, deps;
+        for (Tree l = vdef[i]; isList(l); l = tl(l)) {
+            recDependencies(hd(l), visited, deps);
+        }
+        for (const auto& rec : deps) {
+            faustassert(vindex.find(rec) != vindex.end());
+            vdeps[i].push_back(vindex[rec]);
+        }
+    }
+
+    RecComponents components(vdeps);
+    endTiming("recursive groups");
+
+    startTiming("recursive types");
+    for (const auto& component : components.fComponents) {
+        vector<Tree> crec, cdef, ctyped;
+        vector<int>  csizes;
+        set<int>     members(component.begin(), component.end());
+        set<int>     typed;
+        for (int i : component) {
+            crec.push_back(vrec[i]);
+            cdef.push_back(vdef[i]);
+            csizes.push_back(vdefSizes[i]);
+            for (int j : vdeps[i]) {
+                if (members.count(j) == 0) {
+                    typed.insert(j);
+                }
+            }
+        }
+        for (int j : typed) {
+            ctyped.push_back(vrec[j]);
+        }
+        typeRecGroups(crec, cdef, csizes, ctyped);
+    }
+    endTiming("recursive types");
+
+    // type full term, with the final types of all the recursive signal groups
+    startTiming("full term");
+    CTree::startNewVisit();
+    for (const auto& rec : vrec) {
+        rec->setVisited();
+    }
     T(sig, gGlobal->NULLTYPEENV);
+    endTiming("full term");
     TRACE(cerr << "type success : " << endl << "BYE" << endl;)
 }
 
@@ -24,20 +24,33 @@
 #include <string.h>
 #include <cstring>
 #include <iostream>
+#include <memory>
 
 #include "compatibility.hh"
 #include "exception.hh"
+#include "global.hh"
 #include "symbol.hh"
 
 using namespace std;
 
 /**
- * Hash table used to store the symbols.
+ * Hash table used to store the symbols (thread-local, 'gSymbolTableOwner' keeps the table
+ * allocated by the thread itself).
  */
 
-Symbol* Symbol::gSymbolTable[kHashTableSize];
+static thread_local unique_ptr<Symbol*[]> gSymbolTableOwner;
+static thread_local Symbol**              gSymbolTable = nullptr;
 
-map<const char*, unsigned int> Symbol::gPrefixCounters;
+static thread_local map<const char*, unsigned int> gPrefixCounters;
+
+static inline Symbol** getSymbolTable()
+{
+    if (!gSymbolTable) {
+        gSymbolTableOwner.reset(new Symbol*[Symbol::kHashTableSize]());
+        gSymbolTable = gSymbolTableOwner.get();
+    }
+    return gSymbolTable;
+}
 
 /**
  * Search the hash table for the symbol of name \p str or returns a new one.
@@ -65,13 +78,14 @@ Symbol* Symbol::get(const char* rawstr)
         str[i] = (c >= 0 && c < 32) ? 32 : c;
     }
     unsigned int hsh  = calcHashKey(str.c_str());
-    int          bckt = hsh % kHashTableSize;
-    Symbol*      item = gSymbolTable[bckt];
+    int          bckt  = hsh % kHashTableSize;
+    Symbol**     table = getSymbolTable();
+    Symbol*      item  = table[bckt];
 
     while (item && !item->equiv(hsh, str.c_str())) {
         item = item->fNext;
     }
-    Symbol* r = item ? item : gSymbolTable[bckt] = new Symbol(str, hsh, gSymbolTable[bckt]);
+    Symbol* r = item ? item : table[bckt] = new Symbol(str, hsh, table[bckt]);
 
     return r;
 }
@@ -86,7 +100,7 @@ bool Symbol::isnew(const char* str)
 {
     unsigned int hsh  = calcHashKey(str);
     int          bckt = hsh % kHashTableSize;
-    Symbol*      item = gSymbolTable[bckt];
+    Symbol*      item = getSymbolTable()[bckt];
 
     while (item && !item->equiv(hsh, str)) {
         item = item->fNext;
@@ -172,5 +186,17 @@ ostream& Symbol::print(ostream& fout) const  ///< print a symbol on a stream
 void Symbol::init()
 {
     gPrefixCounters.clear();
-    memset(gSymbolTable, 0, sizeof(Symbol*) * kHashTableSize);
+    memset(getSymbolTable(), 0, sizeof(Symbol*) * kHashTableSize);
+}
+
+void Symbol::saveState(ThreadState& state)
+{
+    state.fSymbolTable          = getSymbolTable();
+    state.fSymbolPrefixCounters = std::move(gPrefixCounters);
+}
+
+void Symbol::restoreState(const ThreadState& state)
+{
+    gSymbolTable    = state.fSymbolTable;
+    gPrefixCounters = state.fSymbolPrefixCounters;
 }
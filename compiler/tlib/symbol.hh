@@ -45,15 +45,18 @@
 
 //--------------------------------SYMBOL-------------------------------------
 
+struct ThreadState;
+
 /**
  * Symbols are unique objects with a name stored in a hash table.
+ * The hash table and the prefix counters are thread-local (see symbol.cpp).
  */
 class Symbol : public virtual Garbageable {
-   private:
+   public:
     static const int kHashTableSize =
         511;  ///< Size of the hash table (a prime number is recommended)
-    static Symbol* gSymbolTable[kHashTableSize];  ///< Hash table used to store the symbols
-    static std::map<const char*, unsigned int> gPrefixCounters;
+
+   private:
 
     // Fields
     std::string fName;  ///< Name of the symbol
@@ -92,6 +95,9 @@ class Symbol : public virtual Garbageable {
     friend void  setUserData(Symbol* sym, void* d);
 
     static void init();
+
+    static void saveState(ThreadState& state);           ///< move the thread-local state in 'state'
+    static void restoreState(const ThreadState& state);  ///< set the thread-local state from 'state'
 };
 
 inline Symbol* symbol(const char* str)
@@ -77,10 +77,14 @@ storage of trees.
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <fstream>
+#include <memory>
 
 #include "exception.hh"
+#include "global.hh"
 #include "tree.hh"
 
 using namespace std;
@@ -96,10 +100,146 @@ using namespace std;
         throw faustexception(error.str()); \
     }
 
-Tree         CTree::gHashTable[kHashTableSize];
-bool         CTree::gDetails       = false;
-unsigned int CTree::gVisitTime     = 0;
-size_t       CTree::gSerialCounter = 0;
+/**
+ * Hash table used for "hash consing": trees are chained in the buckets using their 'fNext' field.
+ * The number of buckets (a power of two) is doubled each time the table contains more trees than
+ * buckets, so that the average chain length stays below 1 whatever the size of the program.
+ */
+class TreeHashTable {
+   private:
+    static const int kInitialBits = 16;  ///< the table starts with 2^16 buckets
+
+    vector<Tree> fBuckets;
+    int          fBits;   ///< log2 of the number of buckets
+    size_t       fCount;  ///< number of trees in the table
+
+    // Statistics
+    size_t fLookups;  ///< number of searched trees
+    size_t fHits;     ///< number of searched trees already in the table
+    size_t fProbes;   ///< number of trees compared while searching
+    size_t fResizes;  ///< number of times the table has grown
+
+    // Fibonacci hashing, to spread the (weakly mixed) tree hash keys on all buckets
+    size_t bucket(size_t hk) const
+    {
+        return size_t((uint64_t(hk) * 0x9E3779B97F4A7C15ULL) >> (64 - fBits));
+    }
+
+    void grow()
+    {
+        vector<Tree> buckets(fBuckets.size() * 2, nullptr);
+        fBits++;
+        fResizes++;
+        for (Tree t : fBuckets) {
+            while (t) {
+                Tree   next = t->fNext;
+                size_t j    = bucket(t->fHashKey);
+                t->fNext    = buckets[j];
+                buckets[j]  = t;
+                t           = next;
+            }
+        }
+        fBuckets.swap(buckets);
+    }
+
+   public:
+    TreeHashTable() { reset(); }
+
+    void reset()
+    {
+        fBits = kInitialBits;
+        fBuckets.assign(size_t(1) << fBits, nullptr);
+        fCount   = 0;
+        fLookups = 0;
+        fHits    = 0;
+        fProbes  = 0;
+        fResizes = 0;
+    }
+
+    Tree find(size_t hk, const Node& n, int ar, const Tree* br)
+    {
+        fLookups++;
+        Tree t = fBuckets[bucket(hk)];
+        while (t) {
+            fProbes++;
+            if (t->fHashKey == hk && t->equiv(n, ar, br)) {
+                fHits++;
+                return t;
+            }
+            t = t->fNext;
+        }
+        return nullptr;
+    }
+
+    void insert(Tree t)
+    {
+        if (++fCount > fBuckets.size()) {
+            grow();
+        }
+        size_t j    = bucket(t->fHashKey);
+        t->fNext    = fBuckets[j];
+        fBuckets[j] = t;
+    }
+
+    void remove(Tree t)
+    {
+        Tree* p = &fBuckets[bucket(t->fHashKey)];
+        while (*p != t) {
+            faustassert(*p);
+            p = &(*p)->fNext;
+        }
+        *p = t->fNext;
+        fCount--;
+    }
+
+    void control()
+    {
+        for (size_t i = 0; i < fBuckets.size(); i++) {
+            Tree t = fBuckets[i];
+            if (t) {
+                printf("%4d = ", int(i));
+                while (t) {
+                    /*t->print();*/
+                    printf(" => ");
+                    t = t->fNext;
+                }
+                printf("VOID\n");
+            }
+        }
+    }
+
+    void printStats(ostream& fout)
+    {
+        size_t used = 0, longest = 0;
+        for (Tree t : fBuckets) {
+            size_t len = 0;
+            for (; t; t = t->fNext) len++;
+            used += (len > 0);
+            longest = max(longest, len);
+        }
+        fout << "Tree hash table : " << fCount << " trees, " << fBuckets.size() << " buckets ("
+             << used << " used, longest chain " << longest << ", " << fResizes << " resizes)" << endl;
+        fout << "Tree hash table : " << fLookups << " lookups, " << fHits << " shared trees, "
+             << ((fLookups > 0) ? double(fProbes) / double(fLookups) : 0.) << " compared trees per lookup"
+             << endl;
+    }
+};
+
+// Thread-local state, 'gHashTableOwner' keeps the table allocated by the thread itself
+static thread_local unique_ptr<TreeHashTable> gHashTableOwner;
+static thread_local TreeHashTable*            gHashTable     = nullptr;  ///< hash table used for "hash consing"
+static thread_local bool                      gDetails       = false;    ///< print with more details when true
+static thread_local unsigned int              gVisitTime     = 0;        ///< incremented for each new visit
+static thread_local size_t                    gSerialCounter = 0;        ///< the serial number counter
+
+static inline TreeHashTable* getHashTable()
+{
+    if (!gHashTable) {
+        gHashTableOwner.reset(new TreeHashTable());
+        gHashTable = gHashTableOwner.get();
+    }
+    return gHashTable;
+}
 
 // Constructor : add the tree to the hash table
 CTree::CTree(size_t hk, const Node& n, const tvec& br)
@@ -112,67 +252,49 @@ CTree::CTree(size_t hk, const Node& n, const tvec& br)
       fBranch(br)
 {
     // link in the hash table
-    int j         = hk % kHashTableSize;
-    fNext         = gHashTable[j];
-    gHashTable[j] = this;
+    getHashTable()->insert(this);
 }
 
 // Destructor : remove the tree from the hash table
 CTree::~CTree()
 {
-    int  i = fHashKey % kHashTableSize;
-    Tree t = gHashTable[i];
-
     // printf("Delete of "); this->print(); printf("\n");
-    if (t == this) {
-        gHashTable[i] = fNext;
-    } else {
-        Tree p = nullptr;
-        while (t != this) {
-            p = t;
-            t = t->fNext;
-        }
-        faustassert(p);
-        p->fNext = fNext;
-    }
+    getHashTable()->remove(this);
 }
 
 // equivalence
-bool CTree::equiv(const Node& n, const tvec& br) const
+bool CTree::equiv(const Node& n, int ar, const Tree* br) const
 {
-    return (fNode == n) && (fBranch == br);
+    return (fNode == n) && (int(fBranch.size()) == ar) && std::equal(fBranch.begin(), fBranch.end(), br);
 }
 
-size_t CTree::calcTreeHash(const Node& n, const tvec& br)
+size_t CTree::calcTreeHash(const Node& n, int ar, const Tree* br)
 {
-    size_t               hk = size_t(n.getPointer());
-    tvec::const_iterator b  = br.begin();
-    tvec::const_iterator z  = br.end();
+    // Mix the node content (the low bits of pointers are always zero), then combine the branches
+    // keys, so that trees only differing by a deep subtree still get different keys
+    uint64_t hk = uint64_t(n.getInt64()) ^ uint64_t(n.type());
+    hk ^= hk >> 33;
+    hk *= 0xFF51AFD7ED558CCDULL;
+    hk ^= hk >> 33;
 
-    while (b != z) {
-        hk = (hk << 1) ^ (hk >> 20) ^ ((*b)->fHashKey);
-        ++b;
+    for (int i = 0; i < ar; i++) {
+        hk ^= uint64_t(br[i]->fHashKey) + 0x9E3779B97F4A7C15ULL + (hk << 6) + (hk >> 2);
     }
-    return hk;
+    return size_t(hk);
 }
 
+// The branches vector is only allocated when a new tree has to be created
 Tree CTree::make(const Node& n, int ar, Tree* tbl)
 {
-    tvec br(ar);
-    for (int i = 0; i < ar; i++) {
-        br[i] = tbl[i];
-    }
-    return CTree::make(n, br);
+    size_t hk = calcTreeHash(n, ar, tbl);
+    Tree   t  = getHashTable()->find(hk, n, ar, tbl);
+    return (t) ? t : new CTree(hk, n, tvec(tbl, tbl + ar));
 }
 
 Tree CTree::make(const Node& n, const tvec& br)
 {
-    size_t hk = calcTreeHash(n, br);
-    Tree   t  = gHashTable[hk % kHashTableSize];
-
-    while (t && !t->equiv(n, br)) {
-        t = t->fNext;
-    }
+    size_t hk = calcTreeHash(n, int(br.size()), br.data());
+    Tree   t  = getHashTable()->find(hk, n, int(br.size()), br.data());
     return (t) ? t : new CTree(hk, n, br);
 }
 
@@ -200,27 +322,52 @@ ostream& CTree::print(ostream& fout) const
 void CTree::control()
 {
     printf("\ngHashTable Content :\n\n");
-    for (int i = 0; i < kHashTableSize; i++) {
-        Tree t = gHashTable[i];
-        if (t) {
-            printf("%4d = ", i);
-            while (t) {
-                /*t->print();*/
-                printf(" => ");
-                t = t->fNext;
-            }
-            printf("VOID\n");
-        }
-    }
+    getHashTable()->control();
     printf("\nEnd gHashTable\n");
 }
 
+void CTree::printStats(ostream& fout)
+{
+    getHashTable()->printStats(fout);
+}
+
 void CTree::init()
 {
     gSerialCounter = 0;
     gVisitTime     = 0;
     gDetails       = false;
-    memset(gHashTable, 0, sizeof(Tree) * kHashTableSize);
+    getHashTable()->reset();
+}
+
+void CTree::saveState(ThreadState& state)
+{
+    state.fTreeTable         = getHashTable();
+    state.fTreeSerialCounter = gSerialCounter;
+    state.fTreeVisitTime     = gVisitTime;
+    state.fTreeDetails       = gDetails;
+}
+
+void CTree::restoreState(const ThreadState& state)
+{
+    gHashTable     = state.fTreeTable;
+    gSerialCounter = state.fTreeSerialCounter;
+    gVisitTime     = state.fTreeVisitTime;
+    gDetails       = state.fTreeDetails;
+}
+
+void CTree::startNewVisit()
+{
+    ++gVisitTime;
+}
+
+bool CTree::isAlreadyVisited()
+{
+    return fVisitTime == gVisitTime;
+}
+
+void CTree::setVisited()
+{
+    fVisitTime = gVisitTime;
 }
 
 // if t has a node of type int, return it, or float, return casted to int, otherwise error
@@ -101,16 +101,20 @@ typedef std::vector<Tree>    tvec;
  * WARNING : in the current implementation CTrees are allocated but never deleted.
  **/
 
-class LIBFAUST_API CTree : public virtual Garbageable {
-   private:
-    static const int kHashTableSize = 400009;     ///< size of the hash table (prime number)
-    static size_t    gSerialCounter;              ///< the serial number counter
-    static Tree      gHashTable[kHashTableSize];  ///< hash table used for "hash consing"
+struct ThreadState;
+class TreeHashTable;
 
-   public:
-    static bool gDetails;  ///< Ctree::print() print with more details when true
-    static unsigned int
-        gVisitTime;  ///< Should be incremented for each new visit to keep track of visited tree
+/**
+ * The hash table, the serial number counter and the visit time are thread-local (and defined in
+ * tree.cpp, since thread-local data cannot be exported), so that trees can be built concurrently on
+ * different threads. They are transferred to the threads started by 'callFun' using saveState and
+ * restoreState.
+ *
+ * The hash table grows with the number of trees, so that chains stay short on very large programs.
+ **/
+
+class LIBFAUST_API CTree : public virtual Garbageable {
+    friend class TreeHashTable;
 
    private:
     // fields
@@ -127,11 +131,11 @@ class LIBFAUST_API CTree : public virtual Garbageable {
     CTree(size_t hk, const Node& n,
           const tvec& br);  ///< construction is private, uses tree::make instead
 
-    bool          equiv(const Node& n,
-                        const tvec& br) const;  ///< used to check if an equivalent tree already exists
+    bool          equiv(const Node& n, int ar,
+                        const Tree* br) const;  ///< used to check if an equivalent tree already exists
     static size_t calcTreeHash(
-        const Node& n,
-        const tvec& br);  ///< compute the hash key of a tree according to its node and branches
+        const Node& n, int ar,
+        const Tree* br);  ///< compute the hash key of a tree according to its node and branches
     static int calcTreeAperture(const Node& n, const tvec& br);  ///< compute how open is a tree
 
    public:
@@ -162,17 +166,21 @@ class LIBFAUST_API CTree : public virtual Garbageable {
     std::ostream& print(
         std::ostream& fout) const;  ///< print recursively the content of a tree on a stream
     static void control();          ///< print the hash table content (for debug purpose)
+    static void printStats(std::ostream& fout);  ///< print the hash table statistics
 
     static void init();
 
+    static void saveState(ThreadState& state);           ///< move the thread-local state in 'state'
+    static void restoreState(const ThreadState& state);  ///< set the thread-local state from 'state'
+
     // type information
     void  setType(void* t) { fType = t; }
     void* getType() { return fType; }
 
     // Keep track of visited trees (WARNING : non reentrant)
-    static void startNewVisit() { ++gVisitTime; }
-    bool        isAlreadyVisited() { return fVisitTime == gVisitTime; }
-    void        setVisited() { fVisitTime = gVisitTime; }
+    static void startNewVisit();
+    bool        isAlreadyVisited();
+    void        setVisited();
 
     // Property list of a tree
     void setProperty(Tree key, Tree value) { fProperties[key] = value; }
@@ -0,0 +1,10 @@
+// Large generated program with many independent recursive signal groups, used to measure
+// the type inference time, to be compiled with: faust -time large_recursions.dsp
+// Increase N to stress the recursive groups collection and typing.
+
+N = 1000;
+
+lp(c) = *(1-c) : + ~ *(c);
+chain(i) = lp(0.1 + i*0.0001) : lp(0.2) : + ~ (@(i%50+1) : *(0.3)) : lp(0.3);
+
+process = _ <: par(i, N, chain(i)) :> _;
@@ -0,0 +1,13 @@
+// Large generated program used to measure the tree construction (hash consing) time
+// during evaluation and propagation, to be compiled with: faust -time -ts large_tree.dsp
+// Increase N to stress the tree hash table.
+
+N = 512;
+
+gain(i) = hslider("gain %i", 0.5, 0, 1, 0.01);
+cell(i) = *(gain(i)) : + ~ (*(0.5) : @(i+1));
+
+// Reverse the order of the N channels
+reverse(n) = route(n, n, par(i, n, (i+1, n-i)));
+
+process = _ <: par(i, N, cell(i)) : reverse(N) : par(i, N, *(i+1)) :> _;
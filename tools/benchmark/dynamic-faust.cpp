@@ -139,6 +139,9 @@ int main(int argc, char* argv[])
             } else {
                 optimal_options = bench(dsp_optimizer_real<float>(in_filename, argc1, argv1, opt_target, buffer_size, 1, -1, false), in_filename);
             }
+        } catch (std::exception& e) {
+            cerr << e.what() << endl;
+            exit(EXIT_FAILURE);
         } catch (...) {
             cerr << "libfaust error...\n";
             exit(EXIT_FAILURE);
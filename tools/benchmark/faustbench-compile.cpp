@@ -0,0 +1,126 @@
+/************************************************************************
+ FAUST Architecture File
+ Copyright (C) 2024 GRAME, Centre National de Creation Musicale
+ ---------------------------------------------------------------------
+ This Architecture section is free software; you can redistribute it
+ and/or modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 3 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+ EXCEPTION : As a special exception, you may create a larger work
+ that contains this FAUST architecture section and distribute
+ that work under terms of your choice, so long as this FAUST
+ architecture section is not modified.
+ ************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+#include "faust/dsp/interpreter-dsp.h"
+#include "faust/misc.h"
+
+using namespace std;
+
+/*
+ Compile a set of DSP files with the Interpreter backend, first on a single thread,
+ then on several threads in parallel, and display the speedup.
+ */
+
+static void compileFiles(const vector<string>& files, const vector<const char*>& options, int threads, int& failures)
+{
+    atomic<size_t> next(0);
+    atomic<int> errors(0);
+
+    auto worker = [&]() {
+        size_t index;
+        while ((index = next++) < files.size()) {
+            string error_msg;
+            interpreter_dsp_factory* factory = createInterpreterDSPFactoryFromFile(files[index],
+                                                                                   int(options.size()),
+                                                                                   (const char**)options.data(),
+                                                                                   error_msg);
+            if (factory) {
+                // The factory is deleted so that the next run really compiles the DSP again
+                deleteInterpreterDSPFactory(factory);
+            } else {
+                cerr << files[index] << " : " << error_msg;
+                errors++;
+            }
+        }
+    };
+
+    vector<thread> workers;
+    for (int i = 1; i < threads; i++) {
+        workers.push_back(thread(worker));
+    }
+    worker();
+    for (auto& it : workers) {
+        it.join();
+    }
+    failures = errors;
+}
+
+static double measure(const vector<string>& files, const vector<const char*>& options, int threads, int run, int& failures)
+{
+    double best = 0.;
+    for (int i = 0; i < run; i++) {
+        auto start = chrono::high_resolution_clock::now();
+        compileFiles(files, options, threads, failures);
+        double duration = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+        best = (i == 0) ? duration : min(best, duration);
+    }
+    return best;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || isopt(argv, "-h") || isopt(argv, "-help")) {
+        cout << "faustbench-compile [-threads <num>] [-run <num>] [additional Faust options (-vec -vs 8...)] foo1.dsp foo2.dsp..." << endl;
+        cout << "-threads <num> : number of compilation threads (default = hardware concurrency)" << endl;
+        cout << "-run <num> : run each measure <num> times and keep the best one (default = 1)" << endl;
+        return 0;
+    }
+
+    cout << "Libfaust version : " << getCLibFaustVersion() << endl;
+
+    int threads = int(lopt(argv, "-threads", max(1, int(thread::hardware_concurrency()))));
+    int run = int(lopt(argv, "-run", 1));
+
+    vector<string> files;
+    vector<const char*> options;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-threads") == 0 || strcmp(argv[i], "-run") == 0) {
+            i++;
+        } else if (string(argv[i]).find(".dsp") != string::npos) {
+            files.push_back(argv[i]);
+        } else {
+            options.push_back(argv[i]);
+        }
+    }
+
+    // Allows parallel compilations
+    startMTDSPFactories();
+
+    int failures = 0;
+    double serial = measure(files, options, 1, run, failures);
+    cout << files.size() << " files compiled on 1 thread in " << serial << " sec" << endl;
+    double parallel = measure(files, options, threads, run, failures);
+    cout << files.size() << " files compiled on " << threads << " threads in " << parallel << " sec" << endl;
+    cout << "Speedup : " << (serial / parallel) << endl;
+
+    stopMTDSPFactories();
+    return (failures > 0) ? 1 : 0;
+}
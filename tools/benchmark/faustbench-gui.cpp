@@ -0,0 +1,102 @@
+/************************************************************************
+ FAUST Architecture File
+ Copyright (C) 2022 GRAME, Centre National de Creation Musicale
+ ---------------------------------------------------------------------
+ This Architecture section is free software; you can redistribute it
+ and/or modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 3 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+ EXCEPTION : As a special exception, you may create a larger work
+ that contains this FAUST architecture section and distribute
+ that work under terms of your choice, so long as this FAUST
+ architecture section is not modified.
+ ************************************************************************/
+
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+
+#include "faust/gui/GUI.h"
+
+using namespace std;
+
+std::list<GUI*> GUI::fGuiList;
+ztimedmap GUI::gTimedZoneMap;
+
+// Measure the GUI::updateAllGuis refresh cost on a large generated UI
+
+#define GUI_COUNT 4
+#define ROUNDS 1000
+
+static int gReflected = 0;
+
+static void reflect(FAUSTFLOAT val, void* data)
+{
+    gReflected++;
+}
+
+// Each zone is controlled by two items (like an OSC and an HTTP controller)
+struct BenchUI : public GUI {
+
+    void addHorizontalSlider(const char* label, FAUSTFLOAT* zone, FAUSTFLOAT init, FAUSTFLOAT min, FAUSTFLOAT max, FAUSTFLOAT step)
+    {
+        addCallback(zone, reflect, nullptr);
+        addCallback(zone, reflect, nullptr);
+    }
+
+};
+
+// Change 'changed' zones between each refresh
+static void measure(vector<FAUSTFLOAT>& zones, size_t changed)
+{
+    gReflected = 0;
+    size_t step = (changed > 0) ? zones.size() / changed : 0;
+    auto start = chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (size_t i = 0; i < changed; i++) {
+            zones[i * step] = FAUSTFLOAT(round);
+        }
+        GUI::updateAllGuis();
+    }
+    double usec = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+    cout << "Changed zones : " << changed << " updateAllGuis : " << usec / ROUNDS << " usec (reflected items : " << gReflected / ROUNDS << ")" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t count = (argc > 1) ? size_t(atoi(argv[1])) : 10000;
+    vector<FAUSTFLOAT> zones(count);
+
+    vector<BenchUI*> guis;
+    for (int g = 0; g < GUI_COUNT; g++) {
+        BenchUI* ui = new BenchUI();
+        ui->openVerticalBox("params");
+        for (size_t i = 0; i < count; i++) {
+            ui->addHorizontalSlider(("p" + to_string(i)).c_str(), &zones[i], FAUSTFLOAT(0), FAUSTFLOAT(0), FAUSTFLOAT(1), FAUSTFLOAT(0.01));
+        }
+        ui->closeBox();
+        guis.push_back(ui);
+    }
+
+    // First refresh reflects all items
+    GUI::updateAllGuis();
+
+    cout << "Zones : " << count << " GUIs : " << GUI_COUNT << endl;
+    measure(zones, 0);
+    measure(zones, count / 100);
+    measure(zones, count);
+
+    for (const auto& it : guis) delete it;
+    return 0;
+}
@@ -22,6 +22,7 @@
  ************************************************************************/
 
 #include <iostream>
+#include <stdlib.h>
 
 #include "faust/dsp/interpreter-dsp.h"
 #include "faust/dsp/dsp-bench.h"
@@ -33,6 +34,11 @@ int main(int argc, char* argv[])
 {
     cout << "Libfaust version : " << getCLibFaustVersion() << endl;
     
+#ifndef _WIN32
+    // Display the number of FBC and threaded instructions of the compute loop (set FAUST_INTERP_FUSION=0 to compare)
+    setenv("FAUST_INTERP_STATS", "1", 0);
+#endif
+    
     string error_msg;
     dsp_factory* factory = createInterpreterDSPFactoryFromFile(argv[argc-1], argc-2, (const char**)&argv[1], error_msg);
     
@@ -47,6 +53,7 @@ int main(int argc, char* argv[])
     mes.measure();
     pair<double, double> res = mes.getStats();
     cout << argv[argc-1] << " : " << res.first << " " << "(DSP CPU % : " << (mes.getCPULoad() * 100) << ")" << endl;
+    cout << "Time per sample : " << (mes.getCPULoad() * 1e9 / BENCH_SAMPLE_RATE) << " ns" << endl;
     FAUSTBENCH_LOG<double>(res.first);
     
     // DSP deleted by mes
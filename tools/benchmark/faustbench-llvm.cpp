@@ -186,6 +186,9 @@ int main(int argc, char* argv[])
                                                is_trace);
             }
         }
+    } catch (std::exception& e) {
+        cerr << e.what() << endl;
+        exit(EXIT_FAILURE);
     } catch (...) {
         cerr << "libfaust error...\n";
         exit(EXIT_FAILURE);
@@ -0,0 +1,105 @@
+/************************************************************************
+ FAUST Architecture File
+ Copyright (C) 2022 GRAME, Centre National de Creation Musicale
+ ---------------------------------------------------------------------
+ This Architecture section is free software; you can redistribute it
+ and/or modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 3 of
+ the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; If not, see <http://www.gnu.org/licenses/>.
+
+ EXCEPTION : As a special exception, you may create a larger work
+ that contains this FAUST architecture section and distribute
+ that work under terms of your choice, so long as this FAUST
+ architecture section is not modified.
+ ************************************************************************/
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+
+#include "faust/gui/MapUI.h"
+#include "faust/gui/APIUI.h"
+#include "faust/gui/JSONUI.h"
+#include "faust/gui/JSONUIDecoder.h"
+
+using namespace std;
+
+// Measure the parameter set throughput of the string and index based APIs, on a synthetic UI
+
+#define GROUP_SIZE 100
+#define ROUNDS 20
+
+// Groups of GROUP_SIZE sliders, so that labels collide and only paths are unique
+static void buildUI(UI* ui, vector<FAUSTFLOAT>& zones)
+{
+    ui->openVerticalBox("params");
+    for (size_t i = 0; i < zones.size(); i += GROUP_SIZE) {
+        ui->openHorizontalBox(("group" + to_string(i / GROUP_SIZE)).c_str());
+        for (size_t j = i; j < min(i + GROUP_SIZE, zones.size()); j++) {
+            ui->addHorizontalSlider(("p" + to_string(j - i)).c_str(), &zones[j], FAUSTFLOAT(0), FAUSTFLOAT(0), FAUSTFLOAT(1), FAUSTFLOAT(0.01));
+        }
+        ui->closeBox();
+    }
+    ui->closeBox();
+}
+
+template <typename FUN>
+static void measure(const string& name, size_t count, FUN fun)
+{
+    auto start = chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (size_t i = 0; i < count; i++) {
+            fun(i, FAUSTFLOAT(round));
+        }
+    }
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << name << " : " << (double(count) * ROUNDS / sec) / 1e6 << " M sets/sec" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t count = (argc > 1) ? size_t(atoi(argv[1])) : 10000;
+    vector<FAUSTFLOAT> zones(count);
+
+    MapUI map_ui;
+    buildUI(&map_ui, zones);
+    APIUI api_ui;
+    buildUI(&api_ui, zones);
+    JSONUI json_ui(0, 0);
+    buildUI(&json_ui, zones);
+    JSONUIDecoder decoder(json_ui.JSON());
+
+    // Set the parameters in a random order, to defeat the caches like an actual controller would do
+    vector<string> paths;
+    for (int i = 0; i < map_ui.getParamsCount(); i++) {
+        paths.push_back(map_ui.getParamAddress(i));
+    }
+    shuffle(paths.begin(), paths.end(), mt19937(0));
+
+    vector<int> map_index, api_index;
+    for (const auto& it : paths) {
+        map_index.push_back(map_ui.getParamIndex(it));
+        api_index.push_back(api_ui.getParamIndex(it.c_str()));
+    }
+
+    cout << "Parameters : " << paths.size() << endl;
+    measure("MapUI::setParamValue(path)", paths.size(), [&](size_t i, FAUSTFLOAT v) { map_ui.setParamValue(paths[i], v); });
+    measure("MapUI::setParamValue(index)", paths.size(), [&](size_t i, FAUSTFLOAT v) { map_ui.setParamValue(map_index[i], v); });
+    measure("APIUI::setParamValue(path)", paths.size(), [&](size_t i, FAUSTFLOAT v) { api_ui.setParamValue(paths[i].c_str(), v); });
+    measure("APIUI::setParamValue(index)", paths.size(), [&](size_t i, FAUSTFLOAT v) { api_ui.setParamValue(api_index[i], v); });
+    measure("JSONUIDecoder::getInputControlIndex(path)", paths.size(), [&](size_t i, FAUSTFLOAT v) { zones[size_t(decoder.getInputControlIndex(paths[i]))] = v; });
+
+    return 0;
+}